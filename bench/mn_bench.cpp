@@ -0,0 +1,192 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mn_version.hpp"
+#include "mn_micros.hpp"
+
+#include "mn_bench.hpp"
+
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+    #define MN_BENCH_BOARD_NAME "host"
+#elif MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_ESP32
+    #define MN_BENCH_BOARD_NAME "esp32"
+#else
+    #define MN_BENCH_BOARD_NAME "other"
+#endif
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            inline int compare_double(const void* a, const void* b) {
+                const double _a = *static_cast<const double*>(a);
+                const double _b = *static_cast<const double*>(b);
+
+                return (_a < _b) ? -1 : ((_a > _b) ? 1 : 0);
+            }
+        }
+
+        //-----------------------------------
+        //  now_ns
+        //-----------------------------------
+        uint64_t now_ns() {
+        #if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+            struct timespec _ts;
+            clock_gettime(CLOCK_MONOTONIC, &_ts);
+
+            return uint64_t(_ts.tv_sec) * 1000000000ULL + uint64_t(_ts.tv_nsec);
+        #else
+            return uint64_t(mn::micros()) * 1000ULL;
+        #endif // MN_THREAD_CONFIG_BOARD
+        }
+
+        //-----------------------------------
+        //  basic_bench_samples::constructor
+        //-----------------------------------
+        basic_bench_samples::basic_bench_samples(size_t uiMaxSamples)
+            : m_pSamples(NULL), m_uiCount(0), m_uiMaxSamples(uiMaxSamples), m_bSorted(true) {
+
+            m_pSamples = static_cast<double*>(malloc(sizeof(double) * uiMaxSamples));
+            if(m_pSamples == NULL) m_uiMaxSamples = 0;
+        }
+
+        //-----------------------------------
+        //  basic_bench_samples::deconstructor
+        //-----------------------------------
+        basic_bench_samples::~basic_bench_samples() {
+            free(m_pSamples);
+        }
+
+        //-----------------------------------
+        //  basic_bench_samples::add
+        //-----------------------------------
+        void basic_bench_samples::add(double dNsPerOp) {
+            if(m_uiCount >= m_uiMaxSamples) return;
+
+            m_pSamples[m_uiCount++] = dNsPerOp;
+            m_bSorted = false;
+        }
+
+        //-----------------------------------
+        //  basic_bench_samples::merge
+        //-----------------------------------
+        void basic_bench_samples::merge(const basic_bench_samples& other) {
+            for(size_t i = 0; i < other.m_uiCount; i++)
+                add(other.m_pSamples[i]);
+        }
+
+        //-----------------------------------
+        //  basic_bench_samples::clear
+        //-----------------------------------
+        void basic_bench_samples::clear() {
+            m_uiCount = 0;
+            m_bSorted = true;
+        }
+
+        //-----------------------------------
+        //  basic_bench_samples::percentile
+        //-----------------------------------
+        double basic_bench_samples::percentile(double dPercent) {
+            if(m_uiCount == 0) return 0.0;
+
+            if(!m_bSorted) {
+                qsort(m_pSamples, m_uiCount, sizeof(double), internal::compare_double);
+                m_bSorted = true;
+            }
+            // nearest rank
+            size_t _rank = size_t( (dPercent / 100.0) * double(m_uiCount) + 0.999999 );
+
+            if(_rank < 1) _rank = 1;
+            if(_rank > m_uiCount) _rank = m_uiCount;
+
+            return m_pSamples[_rank - 1];
+        }
+
+        //-----------------------------------
+        //  basic_bench_samples::mean
+        //-----------------------------------
+        double basic_bench_samples::mean() const {
+            if(m_uiCount == 0) return 0.0;
+
+            double _sum = 0.0;
+            for(size_t i = 0; i < m_uiCount; i++)
+                _sum += m_pSamples[i];
+
+            return _sum / double(m_uiCount);
+        }
+
+        //-----------------------------------
+        //  basic_bench_reporter::constructor
+        //-----------------------------------
+        basic_bench_reporter::basic_bench_reporter(FILE* pOut)
+            : m_pOut(pOut), m_strFilter(NULL), m_uiResults(0) { }
+
+        //-----------------------------------
+        //  basic_bench_reporter::enabled
+        //-----------------------------------
+        bool basic_bench_reporter::enabled(const char* strGroup) const {
+            return (m_strFilter == NULL) || (strcmp(m_strFilter, strGroup) == 0);
+        }
+
+        //-----------------------------------
+        //  basic_bench_reporter::begin
+        //-----------------------------------
+        void basic_bench_reporter::begin() {
+            m_uiResults = 0;
+
+            fprintf(m_pOut, "{\n  \"library\": \"mnthread\",\n  \"version\": \"%s\",\n"
+                            "  \"board\": \"%s\",\n  \"results\": [",
+                    MN_VERSION_FULLVERSION_STRING, MN_BENCH_BOARD_NAME);
+        }
+
+        //-----------------------------------
+        //  basic_bench_reporter::report
+        //-----------------------------------
+        void basic_bench_reporter::report(const char* strGroup, const char* strName, unsigned int uiParam,
+                        uint64_t ulOps, uint64_t ulElapsedNs, basic_bench_samples& samples,
+                        unsigned int uiBatch) {
+
+            double _dOpsPerSec = (ulElapsedNs == 0) ? 0.0 : double(ulOps) * 1e9 / double(ulElapsedNs);
+
+            fprintf(m_pOut, "%s\n    { \"group\": \"%s\", \"name\": \"%s\", \"param\": %u, "
+                            "\"samples\": %u, \"batch\": %u, \"ops\": %llu, \"ops_per_sec\": %.1f, \"mean_ns\": %.1f, "
+                            "\"p50_ns\": %.1f, \"p99_ns\": %.1f, \"p999_ns\": %.1f }",
+                    (m_uiResults == 0) ? "" : ",",
+                    strGroup, strName, uiParam, (unsigned int)samples.size(), uiBatch,
+                    (unsigned long long)ulOps, _dOpsPerSec, samples.mean(),
+                    samples.percentile(50.0), samples.percentile(99.0), samples.percentile(99.9));
+            fflush(m_pOut);
+
+            m_uiResults++;
+        }
+
+        //-----------------------------------
+        //  basic_bench_reporter::end
+        //-----------------------------------
+        void basic_bench_reporter::end() {
+            fprintf(m_pOut, "\n  ]\n}\n");
+            fflush(m_pOut);
+        }
+    }
+}
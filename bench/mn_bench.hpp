@@ -0,0 +1,222 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINLIB_BENCH_H__
+#define __MINLIB_BENCH_H__
+
+#include "mn_config.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * Maximal number of contending tasks for the lock benchmarks
+ */
+#ifndef MN_BENCH_MAX_TASKS
+    #define MN_BENCH_MAX_TASKS              4
+#endif
+
+/**
+ * Number of samples for each benchmark
+ */
+#ifndef MN_BENCH_SAMPLES
+    #define MN_BENCH_SAMPLES                1000
+#endif
+
+/**
+ * Size of the buffer for the stack_allocator benchmark
+ */
+#ifndef MN_BENCH_STACK_ALLOCATOR_SIZE
+    #if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+        #define MN_BENCH_STACK_ALLOCATOR_SIZE   (1024 * 1024)
+    #else
+        #define MN_BENCH_STACK_ALLOCATOR_SIZE   (32 * 1024)
+    #endif
+#endif
+
+namespace mn {
+    namespace bench {
+        /**
+         * @brief The samples of one benchmark, the time for one operation in nanoseconds.
+         * When a sample is taken over a batch of operations, it is the mean of this batch.
+         */
+        class basic_bench_samples {
+        public:
+            /**
+             * @brief Construct the sample list.
+             * @param uiMaxSamples The maximal number of samples to hold.
+             */
+            explicit basic_bench_samples(size_t uiMaxSamples = MN_BENCH_SAMPLES);
+            ~basic_bench_samples();
+
+            /**
+             * @brief Add a sample.
+             * @param dNsPerOp The time of one operation in nanoseconds.
+             */
+            void add(double dNsPerOp);
+
+            /**
+             * @brief Add all samples from a other list.
+             */
+            void merge(const basic_bench_samples& other);
+
+            /**
+             * @brief Remove all samples.
+             */
+            void clear();
+
+            /**
+             * @brief Get the nearest-rank percentile of the samples.
+             * @param dPercent The percentile, 0.0 - 100.0.
+             * @return The percentile in nanoseconds or 0 when no samples exist.
+             */
+            double percentile(double dPercent);
+
+            /**
+             * @brief Get the mean of the samples in nanoseconds.
+             */
+            double mean() const;
+
+            /**
+             * @brief Get the number of samples.
+             */
+            size_t size() const { return m_uiCount; }
+        private:
+            basic_bench_samples(const basic_bench_samples&) = delete;
+            basic_bench_samples& operator = (const basic_bench_samples&) = delete;
+        private:
+            double* m_pSamples;
+            size_t m_uiCount;
+            size_t m_uiMaxSamples;
+            bool m_bSorted;
+        };
+
+        /**
+         * @brief Write the results of the benchmarks as one JSON document.
+         *
+         * "batch" is the number of operations of one sample. With a batch greater 1 the
+         * percentiles are percentiles of the batch means and not of single operations, so
+         * the tail of single operations is smoothed.
+         *
+         * @code{.json}
+         * { "library": "mnthread", "version": "2.29.8995.57", "board": "host",
+         *   "results": [ { "group": "queue", "name": "roundtrip", "param": 4, "samples": 1000,
+         *                  "batch": 64, "ops": 64000, "ops_per_sec": 2.1e+06, "mean_ns": 470.2,
+         *                  "p50_ns": 455.0, "p99_ns": 690.1, "p999_ns": 1820.4 } ] }
+         * @endcode
+         */
+        class basic_bench_reporter {
+        public:
+            /**
+             * @brief Construct the reporter.
+             * @param pOut The stream to write the JSON document.
+             */
+            explicit basic_bench_reporter(FILE* pOut = stdout);
+
+            /**
+             * @brief Set the group filter, only this group is running.
+             * @param strGroup The group name or NULL for all groups.
+             */
+            void set_filter(const char* strGroup) { m_strFilter = strGroup; }
+
+            /**
+             * @brief Is the given group enabled?
+             */
+            bool enabled(const char* strGroup) const;
+
+            /**
+             * @brief Begin the JSON document.
+             */
+            void begin();
+
+            /**
+             * @brief Write one result.
+             * @param strGroup The group of the benchmark, e.g. "queue".
+             * @param strName The name of the benchmark in the group.
+             * @param uiParam The parameter of this run, e.g. the number of tasks or the data size.
+             * @param ulOps The number of measured operations.
+             * @param ulElapsedNs The wall time of all operations in nanoseconds.
+             * @param samples The samples of this run.
+             * @param uiBatch The number of operations of one sample, 1 when each operation is timed.
+             */
+            void report(const char* strGroup, const char* strName, unsigned int uiParam,
+                        uint64_t ulOps, uint64_t ulElapsedNs, basic_bench_samples& samples,
+                        unsigned int uiBatch = 1);
+
+            /**
+             * @brief End the JSON document.
+             */
+            void end();
+        private:
+            FILE* m_pOut;
+            const char* m_strFilter;
+            unsigned int m_uiResults;
+        };
+
+        /**
+         * @brief Get the current time in nanoseconds, for the time stamps of the benchmarks.
+         */
+        uint64_t now_ns();
+
+        /**
+         * @brief Run a benchmark.
+         *
+         * Call uiSamples times the given function with uiBatch and add the mean time of one
+         * operation in this batch as sample. The clock is read once per batch, a batch of
+         * 1 times each operation but adds the overhead of now_ns() to each sample.
+         *
+         * @param reporter The reporter to write the result.
+         * @param strGroup The group of the benchmark.
+         * @param strName The name of the benchmark.
+         * @param uiParam The parameter of this run.
+         * @param uiSamples The number of samples.
+         * @param uiBatch The number of operations for one sample.
+         * @param fn The function to call, void fn(unsigned int batch)
+         */
+        template <typename TFunc>
+        inline void run(basic_bench_reporter& reporter, const char* strGroup, const char* strName,
+                        unsigned int uiParam, unsigned int uiSamples, unsigned int uiBatch, TFunc fn) {
+
+            basic_bench_samples _samples(uiSamples);
+            uint64_t _ulElapsed = 0;
+
+            for(unsigned int i = 0; i < uiSamples; i++) {
+                uint64_t _ulStart = now_ns();
+                fn(uiBatch);
+                uint64_t _ulTime = now_ns() - _ulStart;
+
+                _ulElapsed += _ulTime;
+                _samples.add( double(_ulTime) / uiBatch );
+            }
+            reporter.report(strGroup, strName, uiParam, uint64_t(uiSamples) * uiBatch, _ulElapsed, _samples, uiBatch);
+        }
+
+        void bench_queue(basic_bench_reporter& reporter);
+        void bench_queue_batch(basic_bench_reporter& reporter);
+        void bench_queue_mpmc(basic_bench_reporter& reporter);
+        void bench_lock(basic_bench_reporter& reporter);
+        void bench_rwlock(basic_bench_reporter& reporter);
+        void bench_workqueue(basic_bench_reporter& reporter);
+        void bench_task(basic_bench_reporter& reporter);
+        void bench_allocator(basic_bench_reporter& reporter);
+        void bench_container(basic_bench_reporter& reporter);
+    }
+}
+
+#endif // __MINLIB_BENCH_H__
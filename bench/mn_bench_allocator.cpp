@@ -0,0 +1,91 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include "mn_allocator.hpp"
+
+#include "mn_bench.hpp"
+
+#define MN_BENCH_ALLOCATOR_BATCH    64
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            /**
+             * @brief Allocate a batch of buffers and free them, the time of one allocate/deallocate pair.
+             */
+            template <class TAllocator>
+            void bench_allocator_size(basic_bench_reporter& reporter, const char* strName, TAllocator& allocator,
+                                      size_t uiSize, unsigned int uiSamples) {
+                void* _buffers[MN_BENCH_ALLOCATOR_BATCH];
+                const size_t _alignment = mn::alignment_for(uiSize);
+
+                run(reporter, "allocator", strName, uiSize, uiSamples, MN_BENCH_ALLOCATOR_BATCH, [&](unsigned int batch) {
+                    for(unsigned int i = 0; i < batch; i++)
+                        _buffers[i] = allocator.allocate(uiSize, _alignment);
+                    for(unsigned int i = 0; i < batch; i++)
+                        allocator.deallocate(_buffers[i], uiSize, _alignment);
+                });
+            }
+        }
+
+        //-----------------------------------
+        //  bench_allocator
+        //-----------------------------------
+        void bench_allocator(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("allocator")) return;
+
+            const size_t _sizes[] = { 16, 64, 256 };
+
+            memory::malloc_allocator<> _malloc;
+            for(size_t _size : _sizes) {
+                internal::bench_allocator_size(reporter, "malloc_allocator", _malloc, _size, MN_BENCH_SAMPLES);
+            }
+
+            // heap backed, the first batch of each size carves the slabs
+            memory::basic_slab_pool _pool;
+            memory::slab_pool_allocator<> _slab(_pool);
+            for(size_t _size : _sizes) {
+                internal::bench_allocator_size(reporter, "slab_allocator", _slab, _size, MN_BENCH_SAMPLES);
+            }
+
+            memory::tcache_allocator<> _tcache;
+            for(size_t _size : _sizes) {
+                internal::bench_allocator_size(reporter, "tcache_allocator", _tcache, _size, MN_BENCH_SAMPLES);
+            }
+            memory::basic_allocator_tcache_impl::flush();
+
+            memory::tlsf_allocator<MN_BENCH_STACK_ALLOCATOR_SIZE> _tlsf;
+            for(size_t _size : _sizes) {
+                internal::bench_allocator_size(reporter, "tlsf_allocator", _tlsf, _size, MN_BENCH_SAMPLES);
+            }
+
+            // the stack allocator never frees, so the samples of each size are limited by the buffer
+            memory::stack_allocator<MN_BENCH_STACK_ALLOCATOR_SIZE> _stack;
+            for(size_t _size : _sizes) {
+                unsigned int _samples = MN_BENCH_STACK_ALLOCATOR_SIZE / 3 / _size / MN_BENCH_ALLOCATOR_BATCH;
+
+                if(_samples > MN_BENCH_SAMPLES) _samples = MN_BENCH_SAMPLES;
+                if(_samples == 0) continue;
+
+                internal::bench_allocator_size(reporter, "stack_allocator", _stack, _size, _samples);
+            }
+        }
+    }
+}
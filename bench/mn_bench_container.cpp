@@ -0,0 +1,137 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include "container/mn_vector.hpp"
+#include "container/mn_basic_light_map.hpp"
+#include "container/mn_rb_tree.hpp"
+
+#include "mn_bench.hpp"
+
+#define MN_BENCH_CONTAINER_SAMPLES  64
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            /**
+             * @brief A key of a permutation of 0..n-1, so the trees are not filled in order.
+             */
+            inline int bench_key(unsigned int i, unsigned int n) {
+                return int( (i * 7919u) % n );
+            }
+
+            void bench_vector(basic_bench_reporter& reporter, unsigned int uiSize) {
+                volatile int _sink = 0;
+
+                run(reporter, "container", "vector_push_back", uiSize, MN_BENCH_CONTAINER_SAMPLES, uiSize,
+                    [&](unsigned int batch) {
+                        container::vector<int> _vector;
+                        for(unsigned int i = 0; i < batch; i++)
+                            _vector.push_back(int(i));
+                        _sink = _vector.back();
+                    });
+
+                container::vector<int> _vector;
+                for(unsigned int i = 0; i < uiSize; i++)
+                    _vector.push_back(int(i));
+
+                run(reporter, "container", "vector_iterate", uiSize, MN_BENCH_CONTAINER_SAMPLES, uiSize,
+                    [&](unsigned int batch) {
+                        int _sum = 0;
+                        for(unsigned int i = 0; i < batch; i++)
+                            _sum += _vector[i];
+                        _sink = _sum;
+                    });
+            }
+
+            void bench_light_map(basic_bench_reporter& reporter, unsigned int uiSize) {
+                volatile int _sink = 0;
+
+                run(reporter, "container", "light_map_insert", uiSize, MN_BENCH_CONTAINER_SAMPLES, uiSize,
+                    [&](unsigned int batch) {
+                        container::map<int, int> _map(batch);
+                        for(unsigned int i = 0; i < batch; i++)
+                            _map.insert(bench_key(i, batch), int(i));
+                        _sink = int(_map.size());
+                    });
+
+                container::map<int, int> _map(uiSize);
+                for(unsigned int i = 0; i < uiSize; i++)
+                    _map.insert(bench_key(i, uiSize), int(i));
+
+                run(reporter, "container", "light_map_find", uiSize, MN_BENCH_CONTAINER_SAMPLES, uiSize,
+                    [&](unsigned int batch) {
+                        for(unsigned int i = 0; i < batch; i++)
+                            _sink = *_map.find(int(i));
+                    });
+            }
+
+            void bench_rb_tree(basic_bench_reporter& reporter, unsigned int uiSize) {
+                volatile int _sink = 0;
+
+                run(reporter, "container", "rb_tree_insert", uiSize, MN_BENCH_CONTAINER_SAMPLES, uiSize,
+                    [&](unsigned int batch) {
+                        container::rb_tree<int> _tree;
+                        for(unsigned int i = 0; i < batch; i++)
+                            _tree.insert(bench_key(i, batch));
+                        _sink = int(_tree.size());
+                    });
+
+                container::rb_tree<int> _tree;
+                for(unsigned int i = 0; i < uiSize; i++)
+                    _tree.insert(bench_key(i, uiSize));
+
+                run(reporter, "container", "rb_tree_find", uiSize, MN_BENCH_CONTAINER_SAMPLES, uiSize,
+                    [&](unsigned int batch) {
+                        for(unsigned int i = 0; i < batch; i++)
+                            _sink = _tree.find_node(int(i))->value.get_key();
+                    });
+
+                run(reporter, "container", "rb_tree_insert_erase", uiSize, MN_BENCH_CONTAINER_SAMPLES, uiSize,
+                    [&](unsigned int batch) {
+                        for(unsigned int i = 0; i < batch; i++) {
+                            _tree.erase(bench_key(i, batch));
+                            _tree.insert(bench_key(i, batch));
+                        }
+                        _sink = int(_tree.size());
+                    });
+            }
+        }
+
+        //-----------------------------------
+        //  bench_container
+        //-----------------------------------
+        void bench_container(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("container")) return;
+
+            const unsigned int _sizes[] = { 16, 256, 4096 };
+
+            for(unsigned int _size : _sizes) {
+                internal::bench_vector(reporter, _size);
+                internal::bench_rb_tree(reporter, _size);
+            }
+            // the light map is a linear search, the biggest size is smaller
+            const unsigned int _mapSizes[] = { 16, 256, 1024 };
+
+            for(unsigned int _size : _mapSizes) {
+                internal::bench_light_map(reporter, _size);
+            }
+        }
+    }
+}
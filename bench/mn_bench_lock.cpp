@@ -0,0 +1,121 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <stdio.h>
+
+#include "mn_task.hpp"
+#include "mn_mutex.hpp"
+#include "mn_adaptive_mutex.hpp"
+#include "mn_binary_semaphore.hpp"
+#include "mn_eventgroup.hpp"
+
+#include "mn_bench.hpp"
+
+#define MN_BENCH_LOCK_BATCH         64
+#define MN_BENCH_LOCK_START_BIT     (1 << 0)
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            /**
+             * @brief Lock and unlock the given lock object, wait for the start bit before.
+             */
+            class bench_lock_task : public basic_task {
+            public:
+                bench_lock_task(const char* strName, ILockObject* pLock, basic_event_group* pStart)
+                    : basic_task(strName, basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                      m_pLock(pLock), m_pStart(pStart), m_Samples(MN_BENCH_SAMPLES) { }
+
+                virtual int on_task() override {
+                    m_pStart->wait(MN_BENCH_LOCK_START_BIT, false, true, portMAX_DELAY);
+
+                    for(unsigned int s = 0; s < MN_BENCH_SAMPLES; s++) {
+                        uint64_t _ulStart = now_ns();
+
+                        for(unsigned int i = 0; i < MN_BENCH_LOCK_BATCH; i++) {
+                            m_pLock->lock();
+                            m_pLock->unlock();
+                        }
+                        m_Samples.add( double(now_ns() - _ulStart) / MN_BENCH_LOCK_BATCH );
+                    }
+                    return ERR_TASK_OK;
+                }
+
+                basic_bench_samples& samples() { return m_Samples; }
+            private:
+                ILockObject* m_pLock;
+                basic_event_group* m_pStart;
+                basic_bench_samples m_Samples;
+            };
+
+            /**
+             * @brief Run the lock benchmark with 1 to MN_BENCH_MAX_TASKS contending tasks.
+             */
+            void bench_lock_contended(basic_bench_reporter& reporter, const char* strName, ILockObject* pLock) {
+                bench_lock_task* _tasks[MN_BENCH_MAX_TASKS];
+                char _name[32];
+
+                for(unsigned int n = 1; n <= MN_BENCH_MAX_TASKS; n++) {
+                    basic_event_group _start("bench_lock");
+                    if(_start.create() != NO_ERROR) return;
+
+                    for(unsigned int t = 0; t < n; t++) {
+                        snprintf(_name, sizeof(_name), "bench_lock_%u", t);
+                        _tasks[t] = new bench_lock_task(_name, pLock, &_start);
+                        _tasks[t]->start();
+                    }
+
+                    uint64_t _ulStart = now_ns();
+                    _start.set(MN_BENCH_LOCK_START_BIT);
+
+                    basic_bench_samples _samples(MN_BENCH_SAMPLES * n);
+
+                    for(unsigned int t = 0; t < n; t++) {
+                        _tasks[t]->join();
+                    }
+                    uint64_t _ulElapsed = now_ns() - _ulStart;
+
+                    for(unsigned int t = 0; t < n; t++) {
+                        _samples.merge(_tasks[t]->samples());
+                        delete _tasks[t];
+                    }
+                    reporter.report("lock", strName, n, uint64_t(n) * MN_BENCH_SAMPLES * MN_BENCH_LOCK_BATCH,
+                                    _ulElapsed, _samples, MN_BENCH_LOCK_BATCH);
+                }
+            }
+        }
+
+        //-----------------------------------
+        //  bench_lock
+        //-----------------------------------
+        void bench_lock(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("lock")) return;
+
+            mutex_t _mutex;
+            internal::bench_lock_contended(reporter, "mutex", &_mutex);
+
+            binary_semaphore_t _semaphore;
+            internal::bench_lock_contended(reporter, "binary_semaphore", &_semaphore);
+
+            adaptive_mutex_t _adaptive;
+            internal::bench_lock_contended(reporter, "adaptive_mutex", &_adaptive);
+        }
+    }
+}
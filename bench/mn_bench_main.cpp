@@ -0,0 +1,90 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_task.hpp"
+
+#include "mn_bench.hpp"
+
+namespace mn {
+    namespace bench {
+        /**
+         * @brief The task that runs all benchmarks and writes the JSON document to stdout.
+         */
+        class bench_main_task : public basic_task {
+        public:
+            bench_main_task(const char* strGroup)
+                : basic_task("bench_main", basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE * 4) {
+                m_Reporter.set_filter(strGroup);
+            }
+
+            virtual int on_task() override {
+                m_Reporter.begin();
+
+                bench_queue(m_Reporter);
+                bench_queue_batch(m_Reporter);
+                bench_queue_mpmc(m_Reporter);
+                bench_lock(m_Reporter);
+                bench_rwlock(m_Reporter);
+                bench_workqueue(m_Reporter);
+                bench_task(m_Reporter);
+                bench_allocator(m_Reporter);
+                bench_container(m_Reporter);
+
+                m_Reporter.end();
+
+            #if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+                exit(0);
+            #endif // MN_THREAD_CONFIG_BOARD
+                return ERR_TASK_OK;
+            }
+        private:
+            basic_bench_reporter m_Reporter;
+        };
+    }
+}
+
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+/**
+ * mn_bench [group] - group is one of queue, lock, workqueue, task, allocator or container
+ */
+int main(int argc, char** argv) {
+    static mn::bench::bench_main_task _bench( (argc > 1) ? argv[1] : NULL );
+
+    if(_bench.start() != ERR_TASK_OK) {
+        fprintf(stderr, "can't start the benchmark task\n");
+        return 1;
+    }
+    vTaskStartScheduler();
+
+    return 0;
+}
+#else
+extern "C" void app_main() {
+    static mn::bench::bench_main_task _bench(NULL);
+
+    _bench.start();
+}
+#endif // MN_THREAD_CONFIG_BOARD
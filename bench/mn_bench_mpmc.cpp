@@ -0,0 +1,134 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <stdio.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_task.hpp"
+#include "queue/mn_queue.hpp"
+#include "container/mn_atomic_queue.hpp"
+
+#include "mn_bench.hpp"
+
+#define MN_BENCH_MPMC_BATCH         64
+#define MN_BENCH_MPMC_SIZE          64
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            using bench_mpmc_queue_t = container::atomic_queue<int, MN_BENCH_MPMC_SIZE>;
+
+            inline void bench_push(queue::queue_t* pQueue, int iValue) {
+                pQueue->enqueue(&iValue, portMAX_DELAY);
+            }
+            inline void bench_push(bench_mpmc_queue_t* pQueue, int iValue) {
+                while(!pQueue->try_push(iValue)) taskYIELD();
+            }
+            inline void bench_pop(queue::queue_t* pQueue, int& iValue) {
+                pQueue->dequeue(&iValue, portMAX_DELAY);
+            }
+            inline void bench_pop(bench_mpmc_queue_t* pQueue, int& iValue) {
+                while(!pQueue->try_pop(iValue)) taskYIELD();
+            }
+
+            /**
+             * @brief Push uiItems items in the given queue.
+             */
+            template <class TQueue>
+            class bench_fanin_producer : public basic_task {
+            public:
+                bench_fanin_producer(const char* strName, TQueue* pQueue, unsigned int uiItems)
+                    : basic_task(strName, basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                      m_pQueue(pQueue), m_uiItems(uiItems) { }
+
+                virtual int on_task() override {
+                    for(unsigned int i = 0; i < m_uiItems; i++)
+                        bench_push(m_pQueue, int(i));
+
+                    return ERR_TASK_OK;
+                }
+            private:
+                TQueue* m_pQueue;
+                unsigned int m_uiItems;
+            };
+
+            /**
+             * @brief 1 to MN_BENCH_MAX_TASKS producer tasks and this task as consumer.
+             */
+            template <class TQueue>
+            void bench_fanin(basic_bench_reporter& reporter, const char* strName, TQueue* pQueue) {
+                bench_fanin_producer<TQueue>* _tasks[MN_BENCH_MAX_TASKS];
+                const unsigned int _uiTotal = MN_BENCH_SAMPLES * MN_BENCH_MPMC_BATCH;
+                char _name[32];
+
+                for(unsigned int n = 1; n <= MN_BENCH_MAX_TASKS; n++) {
+                    for(unsigned int t = 0; t < n; t++) {
+                        unsigned int _uiItems = _uiTotal / n + ((t == 0) ? _uiTotal % n : 0);
+
+                        snprintf(_name, sizeof(_name), "bench_prod_%u", t);
+                        _tasks[t] = new bench_fanin_producer<TQueue>(_name, pQueue, _uiItems);
+                        _tasks[t]->start();
+                    }
+
+                    run(reporter, "queue", strName, n, MN_BENCH_SAMPLES, MN_BENCH_MPMC_BATCH, [&](unsigned int batch) {
+                        int _value = 0;
+                        for(unsigned int i = 0; i < batch; i++)
+                            bench_pop(pQueue, _value);
+                    });
+
+                    for(unsigned int t = 0; t < n; t++) {
+                        _tasks[t]->join();
+                        delete _tasks[t];
+                    }
+                }
+            }
+        }
+
+        //-----------------------------------
+        //  bench_queue_mpmc
+        //-----------------------------------
+        void bench_queue_mpmc(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("queue")) return;
+
+            internal::bench_mpmc_queue_t* _mpmc = new internal::bench_mpmc_queue_t();
+            queue::queue_t _queue(MN_BENCH_MPMC_SIZE, sizeof(int));
+
+            if(_queue.create() != ERR_QUEUE_OK) { delete _mpmc; return; }
+
+            // push and pop from the same task, the cost of the queue itself
+            run(reporter, "queue", "mpmc_roundtrip", sizeof(int), MN_BENCH_SAMPLES, MN_BENCH_MPMC_BATCH, [&](unsigned int batch) {
+                int _value = 0;
+                for(unsigned int i = 0; i < batch; i++) {
+                    _mpmc->try_push(_value);
+                    _mpmc->try_pop(_value);
+                }
+            });
+
+            // many producer tasks and one consumer, the telemetry fan-in
+            internal::bench_fanin(reporter, "mpmc_fanin", _mpmc);
+            internal::bench_fanin(reporter, "queue_fanin", &_queue);
+
+            _queue.destroy();
+            delete _mpmc;
+        }
+    }
+}
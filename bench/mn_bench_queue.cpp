@@ -0,0 +1,189 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include "mn_task.hpp"
+#include "queue/mn_queue.hpp"
+#include "queue/mn_batch_queue.hpp"
+
+#include "mn_bench.hpp"
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            /**
+             * @brief Send each item from the ping queue back to the pong queue, -1 stops the task.
+             */
+            class bench_echo_task : public basic_task {
+            public:
+                bench_echo_task(queue::queue_t* ping, queue::queue_t* pong)
+                    : basic_task("bench_echo", basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                      m_pPing(ping), m_pPong(pong) { }
+
+                virtual int on_task() override {
+                    int _item = 0;
+
+                    while(m_pPing->dequeue(&_item) == ERR_QUEUE_OK) {
+                        if(_item == -1) break;
+
+                        m_pPong->enqueue(&_item);
+                    }
+                    return ERR_TASK_OK;
+                }
+            private:
+                queue::queue_t* m_pPing;
+                queue::queue_t* m_pPong;
+            };
+
+            /**
+             * @brief Send uiItems items with enqueue_n in batches of uiBatch items.
+             */
+            class bench_batch_producer : public basic_task {
+            public:
+                bench_batch_producer(queue::queue_t* queue, unsigned int uiItems, unsigned int uiBatch)
+                    : basic_task("bench_producer", basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                      m_pQueue(queue), m_uiItems(uiItems), m_uiBatch(uiBatch) { }
+
+                virtual int on_task() override {
+                    int _items[64] = { 0 };
+                    unsigned int _uiSent = 0;
+
+                    while(_uiSent < m_uiItems) {
+                        unsigned int _uiCount = m_uiItems - _uiSent;
+                        if(_uiCount > m_uiBatch) _uiCount = m_uiBatch;
+
+                        _uiSent += m_pQueue->enqueue_n(_items, _uiCount);
+                    }
+                    return ERR_TASK_OK;
+                }
+            private:
+                queue::queue_t* m_pQueue;
+                unsigned int m_uiItems;
+                unsigned int m_uiBatch;
+            };
+        }
+
+        //-----------------------------------
+        //  bench_queue
+        //-----------------------------------
+        void bench_queue(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("queue")) return;
+
+            const unsigned int _itemSizes[] = { 4, 16, 64 };
+            char _item[64] = { 0 };
+
+            // enqueue and dequeue from the same task, the cost of the queue itself
+            for(unsigned int _size : _itemSizes) {
+                queue::queue_t _queue(64, _size);
+                if(_queue.create() != ERR_QUEUE_OK) continue;
+
+                run(reporter, "queue", "roundtrip", _size, MN_BENCH_SAMPLES, 32, [&](unsigned int batch) {
+                    for(unsigned int i = 0; i < batch; i++) {
+                        _queue.enqueue(_item, 0);
+                        _queue.dequeue(_item, 0);
+                    }
+                });
+                _queue.destroy();
+            }
+
+            // ping pong between two tasks, the latency incl. the context switches
+            queue::queue_t _ping(1, sizeof(int));
+            queue::queue_t _pong(1, sizeof(int));
+
+            if(_ping.create() != ERR_QUEUE_OK || _pong.create() != ERR_QUEUE_OK) return;
+
+            internal::bench_echo_task _echo(&_ping, &_pong);
+            if(_echo.start() != ERR_TASK_OK) return;
+
+            run(reporter, "queue", "pingpong", sizeof(int), MN_BENCH_SAMPLES, 1, [&](unsigned int batch) {
+                int _value = 0;
+                for(unsigned int i = 0; i < batch; i++) {
+                    _ping.enqueue(&_value);
+                    _pong.dequeue(&_value);
+                }
+            });
+
+            int _stop = -1;
+            _ping.enqueue(&_stop);
+            _echo.join();
+
+            _ping.destroy();
+            _pong.destroy();
+        }
+
+        namespace internal {
+            /**
+             * @brief The batch benches for one queue, the queue must be created with 64 int items.
+             */
+            static void bench_queue_batch_on(basic_bench_reporter& reporter, queue::queue_t& queue,
+                                             const char* szRoundtrip, const char* szStream, unsigned int uiBatch) {
+                const unsigned int _uiItemsPerSample = 64;
+                int _items[64] = { 0 };
+
+                // enqueue_n and dequeue_n from the same task, the cost for one item
+                run(reporter, "queue", szRoundtrip, uiBatch, MN_BENCH_SAMPLES, _uiItemsPerSample, [&](unsigned int items) {
+                    for(unsigned int i = 0; i < items; i += uiBatch) {
+                        queue.enqueue_n(_items, uiBatch, 0);
+                        queue.dequeue_n(_items, uiBatch, 0);
+                    }
+                });
+
+                // a producer task with enqueue_n and the consumer with dequeue_n, incl. the context switches
+                bench_batch_producer _producer(&queue, MN_BENCH_SAMPLES * _uiItemsPerSample, uiBatch);
+                if(_producer.start() != ERR_TASK_OK) return;
+
+                run(reporter, "queue", szStream, uiBatch, MN_BENCH_SAMPLES, _uiItemsPerSample, [&](unsigned int items) {
+                    unsigned int _uiReceived = 0;
+
+                    while(_uiReceived < items)
+                        _uiReceived += queue.dequeue_n(_items, uiBatch);
+                });
+
+                _producer.join();
+            }
+        }
+
+        //-----------------------------------
+        //  bench_queue_batch
+        //-----------------------------------
+        void bench_queue_batch(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("queue")) return;
+
+            const unsigned int _batchSizes[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+            for(unsigned int _batch : _batchSizes) {
+                // the FreeRTOS queue, one copy and one kernel call for each item
+                queue::queue_t _queue(64, sizeof(int));
+
+                if(_queue.create() == ERR_QUEUE_OK) {
+                    internal::bench_queue_batch_on(reporter, _queue, "batch_roundtrip", "batch_stream", _batch);
+                    _queue.destroy();
+                }
+
+                // the batch queue, one copy and one notification for the batch
+                queue::batch_queue_t _ring(64, sizeof(int));
+
+                if(_ring.create() == ERR_QUEUE_OK) {
+                    internal::bench_queue_batch_on(reporter, _ring, "ring_batch_roundtrip", "ring_batch_stream", _batch);
+                    _ring.destroy();
+                }
+            }
+        }
+    }
+}
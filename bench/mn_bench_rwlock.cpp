@@ -0,0 +1,220 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <stdio.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_task.hpp"
+#include "mn_mutex.hpp"
+#include "mn_shared_mutex.hpp"
+#include "mn_seqlock.hpp"
+#include "mn_eventgroup.hpp"
+
+#include "mn_bench.hpp"
+
+#define MN_BENCH_RWLOCK_BATCH       64
+#define MN_BENCH_RWLOCK_START_BIT   (1 << 0)
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            /**
+             * @brief A small configuration table, the shared state of the benchmark.
+             */
+            struct bench_rw_table {
+                uint32_t uiValues[4];
+            };
+
+            /**
+             * @brief The lock under test, read and write the table.
+             */
+            class bench_rw_target {
+            public:
+                virtual ~bench_rw_target() { }
+                virtual void read(bench_rw_table& out) = 0;
+                virtual void write(uint32_t uiValue) = 0;
+            };
+
+            class bench_rw_mutex : public bench_rw_target {
+            public:
+                virtual void read(bench_rw_table& out) override {
+                    m_Lock.lock(); out = m_Table; m_Lock.unlock();
+                }
+                virtual void write(uint32_t uiValue) override {
+                    m_Lock.lock();
+                    for(uint32_t& v : m_Table.uiValues) v = uiValue;
+                    m_Lock.unlock();
+                }
+            private:
+                mutex_t m_Lock;
+                bench_rw_table m_Table = { };
+            };
+
+            class bench_rw_shared_mutex : public bench_rw_target {
+            public:
+                virtual void read(bench_rw_table& out) override {
+                    m_Lock.lock_shared(); out = m_Table; m_Lock.unlock_shared();
+                }
+                virtual void write(uint32_t uiValue) override {
+                    m_Lock.lock();
+                    for(uint32_t& v : m_Table.uiValues) v = uiValue;
+                    m_Lock.unlock();
+                }
+            private:
+                shared_mutex_t m_Lock;
+                bench_rw_table m_Table = { };
+            };
+
+            class bench_rw_seqlock : public bench_rw_target {
+            public:
+                virtual void read(bench_rw_table& out) override {
+                    m_Table.read(out);
+                }
+                virtual void write(uint32_t uiValue) override {
+                    m_Table.modify([uiValue](bench_rw_table& table) {
+                        for(uint32_t& v : table.uiValues) v = uiValue;
+                    });
+                }
+            private:
+                seqlock<bench_rw_table> m_Table;
+            };
+
+            /**
+             * @brief Read the table, wait for the start bit before.
+             */
+            class bench_rw_reader : public basic_task {
+            public:
+                bench_rw_reader(const char* strName, bench_rw_target* pTarget, basic_event_group* pStart)
+                    : basic_task(strName, basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                      m_pTarget(pTarget), m_pStart(pStart), m_Samples(MN_BENCH_SAMPLES) { }
+
+                virtual int on_task() override {
+                    bench_rw_table _table;
+
+                    m_pStart->wait(MN_BENCH_RWLOCK_START_BIT, false, true, portMAX_DELAY);
+
+                    for(unsigned int s = 0; s < MN_BENCH_SAMPLES; s++) {
+                        uint64_t _ulStart = now_ns();
+
+                        for(unsigned int i = 0; i < MN_BENCH_RWLOCK_BATCH; i++)
+                            m_pTarget->read(_table);
+
+                        m_Samples.add( double(now_ns() - _ulStart) / MN_BENCH_RWLOCK_BATCH );
+                    }
+                    return ERR_TASK_OK;
+                }
+
+                basic_bench_samples& samples() { return m_Samples; }
+            private:
+                bench_rw_target* m_pTarget;
+                basic_event_group* m_pStart;
+                basic_bench_samples m_Samples;
+            };
+
+            /**
+             * @brief Write the table until stopped, one write for each scheduling round.
+             */
+            class bench_rw_writer : public basic_task {
+            public:
+                bench_rw_writer(bench_rw_target* pTarget, basic_event_group* pStart)
+                    : basic_task("bench_rw_writer", basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                      m_pTarget(pTarget), m_pStart(pStart), m_bStop(false) { }
+
+                virtual int on_task() override {
+                    uint32_t _uiValue = 0;
+
+                    m_pStart->wait(MN_BENCH_RWLOCK_START_BIT, false, true, portMAX_DELAY);
+
+                    while(!m_bStop) {
+                        m_pTarget->write(++_uiValue);
+                        taskYIELD();
+                    }
+                    return ERR_TASK_OK;
+                }
+
+                void stop() { m_bStop = true; }
+            private:
+                bench_rw_target* m_pTarget;
+                basic_event_group* m_pStart;
+                volatile bool m_bStop;
+            };
+
+            /**
+             * @brief One writer and 1 to MN_BENCH_MAX_TASKS readers.
+             */
+            void bench_rw_contended(basic_bench_reporter& reporter, const char* strName, bench_rw_target* pTarget) {
+                bench_rw_reader* _readers[MN_BENCH_MAX_TASKS];
+                char _name[32];
+
+                for(unsigned int n = 1; n <= MN_BENCH_MAX_TASKS; n++) {
+                    basic_event_group _start("bench_rwlock");
+                    if(_start.create() != NO_ERROR) return;
+
+                    bench_rw_writer _writer(pTarget, &_start);
+                    _writer.start();
+
+                    for(unsigned int t = 0; t < n; t++) {
+                        snprintf(_name, sizeof(_name), "bench_reader_%u", t);
+                        _readers[t] = new bench_rw_reader(_name, pTarget, &_start);
+                        _readers[t]->start();
+                    }
+
+                    uint64_t _ulStart = now_ns();
+                    _start.set(MN_BENCH_RWLOCK_START_BIT);
+
+                    basic_bench_samples _samples(MN_BENCH_SAMPLES * n);
+
+                    for(unsigned int t = 0; t < n; t++) {
+                        _readers[t]->join();
+                    }
+                    uint64_t _ulElapsed = now_ns() - _ulStart;
+
+                    _writer.stop();
+                    _writer.join();
+
+                    for(unsigned int t = 0; t < n; t++) {
+                        _samples.merge(_readers[t]->samples());
+                        delete _readers[t];
+                    }
+                    reporter.report("lock", strName, n, uint64_t(n) * MN_BENCH_SAMPLES * MN_BENCH_RWLOCK_BATCH,
+                                    _ulElapsed, _samples, MN_BENCH_RWLOCK_BATCH);
+                }
+            }
+        }
+
+        //-----------------------------------
+        //  bench_rwlock
+        //-----------------------------------
+        void bench_rwlock(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("lock")) return;
+
+            internal::bench_rw_mutex _mutex;
+            internal::bench_rw_contended(reporter, "rw_mutex", &_mutex);
+
+            internal::bench_rw_shared_mutex _shared;
+            internal::bench_rw_contended(reporter, "rw_shared_mutex", &_shared);
+
+            internal::bench_rw_seqlock _seqlock;
+            internal::bench_rw_contended(reporter, "rw_seqlock", &_seqlock);
+        }
+    }
+}
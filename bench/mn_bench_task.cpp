@@ -0,0 +1,67 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include "mn_task.hpp"
+
+#include "mn_bench.hpp"
+
+#define MN_BENCH_TASK_SAMPLES       200
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            /**
+             * @brief A task that returns at once.
+             */
+            class bench_empty_task : public basic_task {
+            public:
+                bench_empty_task()
+                    : basic_task("bench_empty", basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE) { }
+
+                virtual int on_task() override { return ERR_TASK_OK; }
+            };
+        }
+
+        //-----------------------------------
+        //  bench_task
+        //-----------------------------------
+        void bench_task(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("task")) return;
+
+            basic_bench_samples _samples(MN_BENCH_TASK_SAMPLES);
+            uint64_t _ulElapsed = 0;
+
+            // the task object is created outside, only start and join are measured
+            for(unsigned int i = 0; i < MN_BENCH_TASK_SAMPLES; i++) {
+                internal::bench_empty_task _task;
+
+                uint64_t _ulStart = now_ns();
+                if(_task.start() != ERR_TASK_OK) break;
+                _task.join();
+
+                uint64_t _ulTime = now_ns() - _ulStart;
+
+                _ulElapsed += _ulTime;
+                _samples.add( double(_ulTime) );
+            }
+            reporter.report("task", "start_join", 1, _samples.size(), _ulElapsed, _samples);
+        }
+    }
+}
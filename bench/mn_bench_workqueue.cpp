@@ -0,0 +1,128 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_atomic_counter.hpp"
+#include "queue/mn_workqueue_multi.hpp"
+#include "queue/mn_workqueue_stealing.hpp"
+#include "queue/mn_workqueue_item.hpp"
+
+#include "mn_bench.hpp"
+
+#define MN_BENCH_WORKQUEUE_ITEMS    1024
+
+namespace mn {
+    namespace bench {
+        namespace internal {
+            /**
+             * @brief A work item, that store the time from queueing to the end of the work.
+             * The last item wakes the waiting bench task.
+             */
+            class bench_work_item : public queue::work_queue_item_t {
+            public:
+                bench_work_item()
+                    : work_queue_item(false), m_ulQueued(0), m_ulLatency(0), m_pDone(NULL), m_pWaiter(NULL) { }
+
+                void prepare(mn::atomic_counter* pDone, TaskHandle_t pWaiter) {
+                    m_pDone = pDone;
+                    m_pWaiter = pWaiter;
+                    m_ulQueued = now_ns();
+                }
+
+                virtual bool on_work() override {
+                    m_ulLatency = now_ns() - m_ulQueued;
+
+                    if(++(*m_pDone) == MN_BENCH_WORKQUEUE_ITEMS)
+                        xTaskNotifyGive(m_pWaiter);
+
+                    return true;
+                }
+
+                uint64_t get_latency() const { return m_ulLatency; }
+            private:
+                volatile uint64_t m_ulQueued;
+                volatile uint64_t m_ulLatency;
+                mn::atomic_counter* m_pDone;
+                TaskHandle_t m_pWaiter;
+            };
+
+            /**
+             * @brief Queue MN_BENCH_WORKQUEUE_ITEMS items in a work queue engine with 1 to
+             * MN_BENCH_MAX_TASKS workers and report the time from queueing to the end of the work.
+             */
+            template <class TWorkQueue>
+            void bench_workqueue_engine(basic_bench_reporter& reporter, const char* strName,
+                                        bench_work_item* pItems, basic_task::priority uiPriority,
+                                        uint16_t usStackDepth, uint8_t uiMaxWorkItems) {
+
+                for(unsigned int n = 1; n <= MN_BENCH_MAX_TASKS; n++) {
+                    TWorkQueue _workqueue(uiPriority, usStackDepth, uiMaxWorkItems, n);
+
+                    int _ret = _workqueue.create();
+                    if(_ret != ERR_WORKQUEUE_OK && _ret != ERR_WORKQUEUE_WARNING) continue;
+
+                    mn::atomic_counter _done;
+                    basic_bench_samples _samples(MN_BENCH_WORKQUEUE_ITEMS);
+
+                    uint64_t _ulStart = now_ns();
+
+                    for(unsigned int i = 0; i < MN_BENCH_WORKQUEUE_ITEMS; i++) {
+                        pItems[i].prepare(&_done, xTaskGetCurrentTaskHandle());
+                        _workqueue.queue(&pItems[i]);
+                    }
+                    while(_done < MN_BENCH_WORKQUEUE_ITEMS)
+                        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+                    uint64_t _ulElapsed = now_ns() - _ulStart;
+
+                    for(unsigned int i = 0; i < MN_BENCH_WORKQUEUE_ITEMS; i++) {
+                        _samples.add( double(pItems[i].get_latency()) );
+                    }
+                    reporter.report("workqueue", strName, n, MN_BENCH_WORKQUEUE_ITEMS, _ulElapsed, _samples);
+
+                    _workqueue.destroy();
+                }
+            }
+        }
+
+        //-----------------------------------
+        //  bench_workqueue
+        //-----------------------------------
+        void bench_workqueue(basic_bench_reporter& reporter) {
+            if(!reporter.enabled("workqueue")) return;
+
+            internal::bench_work_item* _items = new internal::bench_work_item[MN_BENCH_WORKQUEUE_ITEMS];
+            if(_items == NULL) return;
+
+            internal::bench_workqueue_engine<queue::multi_engine_workqueue_t>(reporter, "multi", _items,
+                                                           MN_THREAD_CONFIG_WORKQUEUE_MULTI_PRIORITY,
+                                                           MN_THREAD_CONFIG_WORKQUEUE_MULTI_STACKSIZE,
+                                                           MN_THREAD_CONFIG_WORKQUEUE_MULTI_MAXITEMS);
+
+            internal::bench_workqueue_engine<queue::stealing_engine_workqueue_t>(reporter, "stealing", _items,
+                                                           MN_THREAD_CONFIG_WORKQUEUE_STEALING_PRIORITY,
+                                                           MN_THREAD_CONFIG_WORKQUEUE_STEALING_STACKSIZE,
+                                                           MN_THREAD_CONFIG_WORKQUEUE_STEALING_MAXITEMS);
+            delete[] _items;
+        }
+    }
+}
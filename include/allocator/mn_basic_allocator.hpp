@@ -70,9 +70,9 @@ namespace mn {
 			pointer allocate(size_t size, size_t alignment) {
 				pointer _mem = nullptr;
 
-				if(m_fFilter.on_pre_alloc(size)) {
+				if(m_fFilter.on_pre_alloc(size, alignment)) {
 					_mem = TAllocator::allocate(size, alignment);
-					m_fFilter.on_alloc(size);
+					if(_mem != nullptr) m_fFilter.on_alloc(size, alignment);
 				}
 				return _mem;
 			}
@@ -95,7 +95,7 @@ namespace mn {
 			 * @param alignment
 			 * @return Pointer to new memory, or NULL if allocation fails.
 			 */
-			pointer allocate(size_t count, size_t size, size_t alignment = 0) {
+			pointer allocate(size_t count, size_t size, size_t alignment) {
 				return allocate(count * size, (alignment == 0) ? mn::alignment_for(size) : alignment);
 			}
 
@@ -107,9 +107,9 @@ namespace mn {
 			 * @param size The size of the Type
 			 */
 			void deallocate(pointer address, size_t size, size_t alignment) noexcept {
-				if(m_fFilter.on_pre_dealloc(size)) {
+				if(m_fFilter.on_pre_dealloc(size, alignment)) {
 					TAllocator::deallocate(address, size, alignment);
-					m_fFilter.on_dealloc(size);
+					m_fFilter.on_dealloc(size, alignment);
 				}
 			}
 
@@ -130,11 +130,7 @@ namespace mn {
 			 * @param alignment
 			 */
 			void deallocate(pointer address, size_t count, size_t size, size_t alignment) noexcept {
-				size = size * count;
-				if(m_fFilter.on_pre_dealloc(size)) {
-					TAllocator::deallocate(address, size, (alignment == 0) ? mn::alignment_for(size) : alignment);
-					m_fFilter.on_dealloc(size);
-				}
+				deallocate(address, size * count, (alignment == 0) ? mn::alignment_for(size) : alignment);
 			}
 
 			/**
@@ -174,6 +170,13 @@ namespace mn {
 				return TAllocator::get_max_alocator_size();
 			}
 
+			/**
+			 * @brief Get the filter of this allocator, e.g. to set the site of a profile filter.
+			 */
+			filter_type& get_filter() noexcept {
+				return m_fFilter;
+			}
+
 		private:
 			filter_type m_fFilter;
 		};
@@ -27,11 +27,13 @@ namespace mn {
 		template <size_t TMaxAlloc>
 		class basic_allocator_maximal_filter {
 		public:
-			bool on_preAlloc(size_t size) 	{ return get_left() >= size; }
-			bool on_preDealloc(size_t size) { return true; }
+			basic_allocator_maximal_filter() : m_sCurrentAlloc(0) { }
 
-			void on_alloc(size_t size) 		{ m_sCurrentAlloc += size; }
-			void on_dealloc(size_t size) 	{ m_sCurrentAlloc -= size; }
+			bool on_pre_alloc(size_t size, size_t alignment) 	{ return get_left() >= size; }
+			bool on_pre_dealloc(size_t size, size_t alignment) 	{ return true; }
+
+			void on_alloc(size_t size, size_t alignment) 		{ m_sCurrentAlloc += size; }
+			void on_dealloc(size_t size, size_t alignment) 		{ m_sCurrentAlloc -= size; }
 
 			size_t get_left() 				{ return TMaxAlloc - m_sCurrentAlloc; }
 			size_t get_current()			{ return m_sCurrentAlloc; }
@@ -0,0 +1,314 @@
+/**
+ * @file
+ * @brief Allocator filter for heap profiling
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_BASIC_ALLOCATOR_PROFILE_FILTER_H__
+#define __MINILIB_BASIC_ALLOCATOR_PROFILE_FILTER_H__
+
+#include "../mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Define a tag type for basic_allocator_profile_filter
+ * @code
+ * MN_HEAP_PROFILE_TAG(rx_tag, "rx packets");
+ * using rx_allocator = mn::memory::malloc_allocator<mn::memory::basic_allocator_profile_filter<rx_tag>>;
+ * @endcode
+ */
+#define MN_HEAP_PROFILE_TAG(type, str) struct type { static const char* name() { return str; } }
+
+namespace mn {
+	namespace memory {
+		/**
+		 * The number of size classes of the histograms: <= 8, <= 16, .. <= 8192 and > 8192 bytes
+		 */
+		#define MN_HEAP_PROFILE_CLASSES		12
+
+		/**
+		 * @brief A snapshot of the statistics of one tag
+		 */
+		struct heap_profile_stats {
+			const char* strName;		/*!< The name of the tag */
+			size_t uiLive;				/*!< The allocated and not freed bytes */
+			size_t uiPeak;				/*!< The maximal live bytes of this tag */
+			size_t uiAtPeak;			/*!< The live bytes of this tag, when all tags had the maximal live bytes */
+			uint32_t uiAllocs;			/*!< The number of allocations */
+			uint32_t uiFrees;			/*!< The number of deallocations */
+			size_t uiClassLive[MN_HEAP_PROFILE_CLASSES];	/*!< The live bytes per size class */
+			size_t uiClassPeak[MN_HEAP_PROFILE_CLASSES];	/*!< The maximal live bytes per size class */
+			uint32_t uiClassAllocs[MN_HEAP_PROFILE_CLASSES];/*!< The allocations per size class */
+		};
+
+		/**
+		 * @brief A recorded call site: a explicit site name or a return address,
+		 * the address is resolved with addr2line
+		 */
+		struct heap_profile_site {
+			const void* pAddress;		/*!< The return address, NULL when strSite is set */
+			const char* strSite;		/*!< The explicit site name, NULL when not set */
+			const char* strName;		/*!< The tag */
+			uint32_t uiSamples;			/*!< The number of sampled allocations */
+			size_t uiBytes;				/*!< The sampled bytes */
+		};
+
+		/**
+		 * @brief The output format for basic_heap_profiler::dump
+		 */
+		enum class heap_profile_format {
+			Text,		/*!< One line per tag and call site */
+			Json		/*!< A JSON object with the tags and the call sites */
+		};
+
+		/**
+		 * @brief The counters of one tag, the profiles of all tags are linked in the
+		 * basic_heap_profiler. All counters are updated with atomics.
+		 */
+		class basic_heap_profile {
+			friend class basic_heap_profiler;
+		public:
+			basic_heap_profile(const char* strName);
+			~basic_heap_profile();
+
+			basic_heap_profile(const basic_heap_profile&) = delete;
+			basic_heap_profile& operator = (const basic_heap_profile&) = delete;
+
+			void alloc(size_t size);
+			void dealloc(size_t size);
+
+			/**
+			 * Get a snapshot of the statistics
+			 */
+			void get_stats(heap_profile_stats& stats) const;
+			/**
+			 * Reset the peaks and the counters, the live bytes stay
+			 */
+			void reset();
+
+			const char* get_name() const { return m_strName; }
+
+			/**
+			 * Get the size class of the histograms
+			 */
+			static size_t get_class(size_t size) {
+				if(size <= 8) return 0;
+
+				size_t _uiClass = sizeof(unsigned long) * 8 - __builtin_clzl((unsigned long)(size - 1)) - 3;
+				return (_uiClass < MN_HEAP_PROFILE_CLASSES) ? _uiClass : MN_HEAP_PROFILE_CLASSES - 1;
+			}
+		private:
+			static void update_max(size_t& max, size_t value);
+		private:
+			const char* m_strName;
+
+			size_t m_uiLive;
+			size_t m_uiPeak;
+			size_t m_uiAtPeak;
+			uint32_t m_uiAllocs;
+			uint32_t m_uiFrees;
+			size_t m_uiClassLive[MN_HEAP_PROFILE_CLASSES];
+			size_t m_uiClassPeak[MN_HEAP_PROFILE_CLASSES];
+			uint32_t m_uiClassAllocs[MN_HEAP_PROFILE_CLASSES];
+
+			basic_heap_profile* m_pNext;
+		};
+
+		/**
+		 * @brief The list of all heap profiles, with the sampled call sites, the leak report
+		 * and the dump API.
+		 *
+		 * The profiler sums the live bytes of all tags. When the sum reaches a new maximum,
+		 * the live bytes of each tag are stored as uiAtPeak, so the dump shows which tags make
+		 * the high-water mark.
+		 *
+		 * @code
+		 * MN_HEAP_PROFILE_TAG(map_tag, "config map");
+		 * mn::container::rb_tree<int, mn::memory::malloc_allocator<
+		 *     mn::memory::basic_allocator_profile_filter<map_tag>>> tree;
+		 * ...
+		 * mn::memory::basic_heap_profiler::print(mn::memory::heap_profile_format::Json);
+		 * @endcode
+		 */
+		class basic_heap_profiler {
+			friend class basic_heap_profile;
+		public:
+			/**
+			 * @brief Get a snapshot of the statistics of all tags
+			 * @param stats Where the snapshots are returned to
+			 * @param max The size of the stats array
+			 * @return The number of all tags, can be greater then max
+			 */
+			static size_t snapshot(heap_profile_stats* stats, size_t max);
+			/**
+			 * @brief Get the recorded call sites
+			 * @return The number of recorded sites, can be greater then max
+			 */
+			static size_t sites(heap_profile_site* sites, size_t max);
+
+			/**
+			 * @brief Write the statistics of all tags and the call sites to a buffer
+			 * @param buffer The buffer
+			 * @param size The size of the buffer, the output is truncated and null terminated
+			 * @param format The output format
+			 * @return The length of the full output, like snprintf
+			 */
+			static size_t dump(char* buffer, size_t size, heap_profile_format format = heap_profile_format::Text);
+			/**
+			 * @brief Print the statistics with printf
+			 */
+			static void print(heap_profile_format format = heap_profile_format::Text);
+
+			/**
+			 * @brief Print the tags with live bytes, call it before shutdown
+			 * @return The number of tags with live bytes
+			 */
+			static size_t report_leaks();
+
+			/**
+			 * @brief Reset the statistics of all tags and the call sites
+			 */
+			static void reset();
+
+			/**
+			 * @brief Get the live bytes of all tags
+			 */
+			static size_t get_live() { return __atomic_load_n(&m_uiLive, __ATOMIC_RELAXED); }
+			/**
+			 * @brief Get the maximal live bytes of all tags
+			 */
+			static size_t get_peak() { return __atomic_load_n(&m_uiPeak, __ATOMIC_RELAXED); }
+
+			/**
+			 * @brief Is this allocation sampled for the call site?
+			 */
+			static bool sample() {
+#if MN_THREAD_CONFIG_HEAP_PROFILER_SAMPLE > 0
+				return (__atomic_add_fetch(&m_uiSampleCounter, 1, __ATOMIC_RELAXED) %
+						MN_THREAD_CONFIG_HEAP_PROFILER_SAMPLE) == 0;
+#else
+				return false;
+#endif
+			}
+			/**
+			 * @brief Record a sampled allocation
+			 * @param pAddress The return address, used when strSite is NULL
+			 * @param strSite The explicit site name or NULL
+			 * @param profile The profile of the tag
+			 * @param size The allocated bytes
+			 */
+			static void record_site(const void* pAddress, const char* strSite,
+									const basic_heap_profile& profile, size_t size);
+		private:
+			static void add(basic_heap_profile* profile);
+			static void remove(basic_heap_profile* profile);
+			static void on_alloc(size_t size);
+			static void on_dealloc(size_t size);
+			static size_t format(char* buffer, size_t size, const heap_profile_stats& stats,
+								 heap_profile_format format, bool first);
+		private:
+			static basic_heap_profile* m_pFirst;
+			static portMUX_TYPE m_Mux;
+
+			static size_t m_uiLive;
+			static size_t m_uiPeak;
+			static uint32_t m_uiSampleCounter;
+			static heap_profile_site m_Sites[MN_THREAD_CONFIG_HEAP_PROFILER_SITES];
+			static size_t m_uiSites;
+		};
+
+		/**
+		 * @brief The default tag of basic_allocator_profile_filter
+		 */
+		MN_HEAP_PROFILE_TAG(heap_profile_untagged, "untagged");
+
+		/**
+		 * @brief A allocator filter, that counts the allocations of all allocators with the
+		 * same tag in one basic_heap_profile.
+		 *
+		 * The filter sees only the sizes, not the addresses: a leak is reported as live
+		 * bytes of a tag, not as a pointer.
+		 *
+		 * A sampled allocation is recorded with the site name set by set_site(). Without a
+		 * site name the return address MN_THREAD_CONFIG_HEAP_PROFILER_FRAME frames above
+		 * on_alloc is recorded. With the default frame 0 this is the code that called
+		 * on_alloc, which is basic_allocator::allocate, or a container method when
+		 * allocate is inlined. So all allocations through the same container code collapse
+		 * into one site. Set a site name for each allocator instance, or set the frame and
+		 * build with -fno-omit-frame-pointer.
+		 *
+		 * @code
+		 * rx_allocator _alloc;
+		 * _alloc.get_filter().set_site("rx_parse");
+		 * @endcode
+		 *
+		 * @tparam TTag The tag type, defined with MN_HEAP_PROFILE_TAG
+		 */
+		template <class TTag = heap_profile_untagged>
+		class basic_allocator_profile_filter {
+		public:
+			basic_allocator_profile_filter() : m_strSite(NULL) { }
+
+			bool on_pre_alloc(size_t size, size_t alignment = 0) { return true; }
+			bool on_pre_dealloc(size_t size, size_t alignment = 0) { return true; }
+
+			/**
+			 * Not inlined, so that the return address points into the code, that called the allocator
+			 */
+			__attribute__((noinline)) void on_alloc(size_t size, size_t alignment = 0) {
+				profile().alloc(size);
+
+				if(basic_heap_profiler::sample()) {
+					if(m_strSite != NULL)
+						basic_heap_profiler::record_site(NULL, m_strSite, profile(), size);
+					else
+						basic_heap_profiler::record_site(
+							__builtin_return_address(MN_THREAD_CONFIG_HEAP_PROFILER_FRAME), NULL, profile(), size);
+				}
+			}
+			void on_dealloc(size_t size, size_t alignment = 0) {
+				profile().dealloc(size);
+			}
+
+			/**
+			 * @brief Set the site name for the sampled allocations of this filter
+			 * @param strSite The site name, must live as long as the profiler, or NULL to
+			 * record the return address
+			 */
+			void set_site(const char* strSite) { m_strSite = strSite; }
+
+			/**
+			 * @brief Get the site name or NULL
+			 */
+			const char* get_site() const { return m_strSite; }
+
+			/**
+			 * @brief Get the profile of the tag
+			 */
+			static basic_heap_profile& profile() {
+				static basic_heap_profile _profile(TTag::name());
+				return _profile;
+			}
+		private:
+			const char* m_strSite;
+		};
+	}
+}
+
+#endif // __MINILIB_BASIC_ALLOCATOR_PROFILE_FILTER_H__
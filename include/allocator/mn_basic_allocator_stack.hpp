@@ -40,20 +40,21 @@ namespace mn {
 		class basic_allocator_stack_impl {
 		public:
 			using allocator_category = std_allocator_tag();
-			using is_thread_safe = std::false_type  ;
+			using is_thread_safe = mn::false_type  ;
 
 			static void first() noexcept { }
 
 			static void* allocate(size_t size, size_t alignment) noexcept {
-				MN_UNUSED_VARIABLE(alignment);
+				if(alignment == 0) alignment = 1;
+
+				// the buffer is aligned with mn::max_alignment, so aligning the offset is enough
+				size_t _start = (m_bufferTop + alignment - 1) & ~(alignment - 1);
 
-				if(m_bufferTop < TBUFFERSIZE) {
-					if( (m_bufferTop+size) <= TBUFFERSIZE) {
-						char* ret = &m_aBuffer[0] + m_bufferTop;
-						m_bufferTop += size;
+				if(_start <= TBUFFERSIZE && size <= TBUFFERSIZE - _start) {
+					char* ret = &m_aBuffer[0] + _start;
+					m_bufferTop = _start + size;
 
-						return (void*)ret;
-					}
+					return (void*)ret;
 				}
 				return nullptr;
 			}
@@ -72,13 +73,13 @@ namespace mn {
 			}
 		private:
            	static size_t          m_bufferTop;
-            static char*           m_aBuffer[TBUFFERSIZE];
+            alignas(max_align_t) static char m_aBuffer[TBUFFERSIZE];
 		};
 
 		template <int TBUFFERSIZE>
 		size_t basic_allocator_stack_impl<TBUFFERSIZE>::m_bufferTop = 0;
 		template <int TBUFFERSIZE>
-		char* basic_allocator_stack_impl<TBUFFERSIZE>::m_aBuffer[TBUFFERSIZE];
+		alignas(max_align_t) char basic_allocator_stack_impl<TBUFFERSIZE>::m_aBuffer[TBUFFERSIZE];
 
 		template <int TBUFFERSIZE, class TFilter = basic_allocator_filter>
 		using stack_allocator = basic_allocator<basic_allocator_stack_impl<TBUFFERSIZE>, TFilter>;
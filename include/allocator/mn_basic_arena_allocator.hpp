@@ -0,0 +1,393 @@
+/**
+ * @file
+ * @brief Monotonic arena allocator with mark and rewind
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_BASIC_ARENA_ALLOCATOR_H__
+#define __MINILIB_BASIC_ARENA_ALLOCATOR_H__
+
+#include "../mn_config.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../mn_def.hpp"
+#include "mn_basic_allocator.hpp"
+#include "mn_allocator_typetraits.hpp"
+#include "mn_basic_malloc_allocator.hpp"
+
+namespace mn {
+	namespace memory {
+
+		/**
+		 * @brief A position in a arena, returned by mark and used by rewind
+		 */
+		struct arena_marker {
+			void* pChunk;		/*!< The current chunk */
+			size_t uiOffset;	/*!< The offset in the current chunk */
+			size_t uiUsed;		/*!< The allocated bytes */
+		};
+
+		/**
+		 * @brief A monotonic arena: allocate is a aligned pointer bump, deallocate does nothing.
+		 *
+		 * The memory is freed together with rewind to a marker or reset. The arena takes chunks
+		 * from the upstream allocator when the current chunk is full, the chunks are chained and
+		 * kept after rewind and reset, so the next round reuses them without upstream calls.
+		 *
+		 * @code
+		 * mn::memory::arena_t arena(2048);
+		 *
+		 * void on_packet(const packet& p) {
+		 *     mn::memory::arena_scope_t scope(arena);   // rewinds on return
+		 *     header* h = arena.construct<header>(p);
+		 *     ...
+		 * }
+		 * @endcode
+		 *
+		 * @tparam TUpstream The allocator impl for the chunks, like basic_malloc_allocator_impl
+		 * @note Not thread safe, use one arena per task.
+		 */
+		template <class TUpstream = basic_malloc_allocator_impl>
+		class basic_arena {
+			/**
+			 * The header of a chunk, the memory follows the header
+			 */
+			struct chunk {
+				chunk* pNext;
+				size_t uiSize;
+				bool bOwned;
+
+				char* data() { return reinterpret_cast<char*>(this) + header_size(); }
+			};
+		public:
+			using upstream_type = TUpstream;
+			using self_type = basic_arena<TUpstream>;
+
+			/**
+			 * @brief Construct a arena, the first chunk is taken at the first allocation
+			 * @param uiChunkSize The size of the chunks
+			 */
+			explicit basic_arena(size_t uiChunkSize = MN_THREAD_CONFIG_ARENA_CHUNK_SIZE) noexcept
+				: m_pFirst(nullptr), m_pCurrent(nullptr), m_uiOffset(0), m_uiUsed(0),
+				  m_uiChunkSize(uiChunkSize) { upstream_type::first(); }
+
+			/**
+			 * @brief Construct a arena, that use the given buffer as first chunk.
+			 * The upstream allocator is only used when the buffer is full.
+			 * @param pBuffer The buffer, is not freed by the arena
+			 * @param uiSize The size of the buffer
+			 * @param uiChunkSize The size of the upstream chunks
+			 */
+			basic_arena(void* pBuffer, size_t uiSize, size_t uiChunkSize = MN_THREAD_CONFIG_ARENA_CHUNK_SIZE) noexcept
+				: basic_arena(uiChunkSize) {
+
+				uintptr_t _uiStart = reinterpret_cast<uintptr_t>(pBuffer);
+				uintptr_t _uiAligned = (_uiStart + alignof(chunk) - 1) & ~(uintptr_t)(alignof(chunk) - 1);
+
+				if(pBuffer != nullptr && uiSize > (_uiAligned - _uiStart) + header_size()) {
+					m_pFirst = reinterpret_cast<chunk*>(_uiAligned);
+					m_pFirst->pNext = nullptr;
+					m_pFirst->uiSize = uiSize - (_uiAligned - _uiStart) - header_size();
+					m_pFirst->bOwned = false;
+
+					m_pCurrent = m_pFirst;
+				}
+			}
+
+			~basic_arena() { release(); }
+
+			basic_arena(const basic_arena&) = delete;
+			basic_arena& operator=(const basic_arena&) = delete;
+
+			/**
+			 * @brief Allocate a aligned block
+			 * @param size The size in bytes
+			 * @param alignment The alignment, a power of two
+			 * @return Pointer to the block, or nullptr when the upstream allocator fails
+			 */
+			void* allocate(size_t size, size_t alignment = mn::max_alignment) noexcept {
+				if(alignment == 0) alignment = 1;
+
+				if(m_pCurrent != nullptr) {
+					void* _pMem = bump(m_pCurrent, m_uiOffset, size, alignment);
+					if(_pMem != nullptr) return _pMem;
+				}
+				return allocate_slow(size, alignment);
+			}
+
+			/**
+			 * @brief Does nothing, the memory is freed with rewind or reset
+			 */
+			void deallocate(void* address, size_t size, size_t alignment) noexcept {
+				MN_UNUSED_VARIABLE(address);
+				MN_UNUSED_VARIABLE(size);
+				MN_UNUSED_VARIABLE(alignment);
+			}
+
+			/**
+			 * @brief Allocate and construct a object in the arena
+			 * @note The destructor is never called by the arena
+			 */
+			template <class Type, typename... Args>
+			Type* construct(Args&&... args) {
+				void* _mem = allocate(sizeof(Type), alignof(Type));
+				if(_mem == nullptr) return nullptr;
+
+				return ::new (_mem) Type(mn::forward<Args>(args)...);
+			}
+
+			/**
+			 * @brief Get the current position
+			 */
+			arena_marker mark() const noexcept {
+				arena_marker _marker = { m_pCurrent, m_uiOffset, m_uiUsed };
+				return _marker;
+			}
+
+			/**
+			 * @brief Free all allocations after the marker, the chunks are kept
+			 * @param marker The marker from mark
+			 */
+			void rewind(const arena_marker& marker) noexcept {
+				m_pCurrent = static_cast<chunk*>(marker.pChunk);
+				m_uiOffset = marker.uiOffset;
+				m_uiUsed = marker.uiUsed;
+
+				// a marker from the empty arena
+				if(m_pCurrent == nullptr) { m_pCurrent = m_pFirst; m_uiOffset = 0; }
+			}
+
+			/**
+			 * @brief Free all allocations in O(1), the chunks are kept
+			 */
+			void reset() noexcept {
+				m_pCurrent = m_pFirst;
+				m_uiOffset = 0;
+				m_uiUsed = 0;
+			}
+
+			/**
+			 * @brief Free all allocations and give the chunks back to the upstream allocator
+			 */
+			void release() noexcept {
+				chunk* _pChunk = m_pFirst;
+				chunk* _pKeep = nullptr;
+
+				while(_pChunk != nullptr) {
+					chunk* _pNext = _pChunk->pNext;
+
+					if(_pChunk->bOwned) {
+						upstream_type::deallocate(_pChunk, header_size() + _pChunk->uiSize, alignof(chunk));
+					} else {
+						_pKeep = _pChunk;
+						_pKeep->pNext = nullptr;
+					}
+					_pChunk = _pNext;
+				}
+				m_pFirst = m_pCurrent = _pKeep;
+				m_uiOffset = 0;
+				m_uiUsed = 0;
+			}
+
+			/**
+			 * @brief Get the number of allocated bytes, without the alignment padding
+			 */
+			size_t get_used() const noexcept { return m_uiUsed; }
+			/**
+			 * @brief Get the size of all chunks
+			 */
+			size_t get_capacity() const noexcept {
+				size_t _uiSize = 0;
+				for(chunk* _pChunk = m_pFirst; _pChunk != nullptr; _pChunk = _pChunk->pNext)
+					_uiSize += _pChunk->uiSize;
+				return _uiSize;
+			}
+			/**
+			 * @brief Get the number of chunks
+			 */
+			size_t get_chunks() const noexcept {
+				size_t _uiCount = 0;
+				for(chunk* _pChunk = m_pFirst; _pChunk != nullptr; _pChunk = _pChunk->pNext)
+					_uiCount++;
+				return _uiCount;
+			}
+		private:
+			static constexpr size_t header_size() {
+				return (sizeof(chunk) + mn::max_alignment - 1) & ~(mn::max_alignment - 1);
+			}
+
+			void* bump(chunk* pChunk, size_t uiOffset, size_t size, size_t alignment) noexcept {
+				uintptr_t _uiBase = reinterpret_cast<uintptr_t>(pChunk->data());
+				uintptr_t _uiStart = (_uiBase + uiOffset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+				size_t _uiEnd = (_uiStart - _uiBase) + size;
+
+				if(_uiEnd > pChunk->uiSize) return nullptr;
+
+				m_pCurrent = pChunk;
+				m_uiOffset = _uiEnd;
+				m_uiUsed += size;
+
+				return reinterpret_cast<void*>(_uiStart);
+			}
+
+			void* allocate_slow(size_t size, size_t alignment) noexcept {
+				// the chunks after the current one are free after rewind or reset
+				chunk* _pPrev = m_pCurrent;
+				chunk* _pNext = (m_pCurrent != nullptr) ? m_pCurrent->pNext : m_pFirst;
+
+				if(_pNext != nullptr) {
+					void* _pMem = bump(_pNext, 0, size, alignment);
+					if(_pMem != nullptr) return _pMem;
+				}
+
+				// a new chunk, between the current and the free chunks
+				size_t _uiSize = size + alignment;
+				if(_uiSize < m_uiChunkSize) _uiSize = m_uiChunkSize;
+
+				chunk* _pChunk = static_cast<chunk*>(upstream_type::allocate(header_size() + _uiSize, alignof(chunk)));
+				if(_pChunk == nullptr) return nullptr;
+
+				_pChunk->uiSize = _uiSize;
+				_pChunk->bOwned = true;
+				_pChunk->pNext = _pNext;
+
+				if(_pPrev != nullptr) _pPrev->pNext = _pChunk;
+				else m_pFirst = _pChunk;
+
+				return bump(_pChunk, 0, size, alignment);
+			}
+		private:
+			chunk* m_pFirst;
+			chunk* m_pCurrent;
+			size_t m_uiOffset;
+			size_t m_uiUsed;
+			size_t m_uiChunkSize;
+		};
+
+		/**
+		 * @brief Mark the arena and rewind it, when the scope ends
+		 */
+		template <class TArena>
+		class basic_arena_scope {
+		public:
+			explicit basic_arena_scope(TArena& arena) noexcept
+				: m_refArena(arena), m_marker(arena.mark()) { }
+
+			~basic_arena_scope() { m_refArena.rewind(m_marker); }
+
+			basic_arena_scope(const basic_arena_scope&) = delete;
+			basic_arena_scope& operator=(const basic_arena_scope&) = delete;
+		private:
+			TArena& m_refArena;
+			arena_marker m_marker;
+		};
+
+		/**
+		 * @brief A allocator for the containers, that allocates from a arena
+		 */
+		template <class TArena, class TFilter = basic_allocator_filter>
+		class basic_arena_allocator {
+		public:
+			using allocator_category = std_allocator_tag();
+			using is_thread_safe = mn::false_type;
+			using filter_type = TFilter;
+			using arena_type = TArena;
+
+			using value_type = void;
+			using pointer = void*;
+			using const_pointer = const void*;
+			using difference_type = mn::ptrdiff_t;
+			using size_type = size_t;
+
+			explicit basic_arena_allocator(arena_type& arena) noexcept
+				: m_pArena(&arena), m_fFilter() { }
+
+			pointer allocate(size_t size, size_t alignment) {
+				pointer _mem = nullptr;
+
+				if(m_fFilter.on_pre_alloc(size, alignment)) {
+					_mem = m_pArena->allocate(size, alignment);
+					if(_mem != nullptr) m_fFilter.on_alloc(size, alignment);
+				}
+				return _mem;
+			}
+
+			pointer allocate(size_t size) {
+				return allocate(size, mn::alignment_for(size));
+			}
+
+			pointer allocate(size_t count, size_t size, size_t alignment) {
+				return allocate(count * size, (alignment == 0) ? mn::alignment_for(size) : alignment);
+			}
+
+			void deallocate(pointer address, size_t size, size_t alignment) noexcept {
+				if(m_fFilter.on_pre_dealloc(size, alignment)) {
+					m_pArena->deallocate(address, size, alignment);
+					m_fFilter.on_dealloc(size, alignment);
+				}
+			}
+
+			void deallocate(pointer address, size_t size) noexcept {
+				deallocate(address, size, mn::alignment_for(size));
+			}
+
+			void deallocate(pointer address, size_t count, size_t size, size_t alignment) noexcept {
+				deallocate(address, size * count, (alignment == 0) ? mn::alignment_for(size) : alignment);
+			}
+
+			template <class Type, typename... Args>
+			Type* construct(Args&&... args) {
+				void* _mem = allocate(sizeof(Type), alignof(Type));
+				if(_mem == nullptr) return nullptr;
+
+				return ::new (_mem) Type(mn::forward<Args>(args)...);
+			}
+
+			template <class Type>
+			void destroy(Type* address) noexcept {
+				if(address == nullptr) return;
+
+				mn::destruct<Type>(address);
+				deallocate(address, sizeof(Type), alignof(Type));
+			}
+
+			size_t get_max_alocator_size() const noexcept {
+				return __SIZE_MAX__;
+			}
+
+			/**
+			 * @brief Get the using arena
+			 */
+			arena_type& get_arena() noexcept { return *m_pArena; }
+
+			bool operator == (const basic_arena_allocator& other) const noexcept { return m_pArena == other.m_pArena; }
+			bool operator != (const basic_arena_allocator& other) const noexcept { return m_pArena != other.m_pArena; }
+		private:
+			arena_type* m_pArena;
+			filter_type m_fFilter;
+		};
+
+		using arena_t = basic_arena<>;
+		using arena_scope_t = basic_arena_scope<arena_t>;
+
+		template <class TFilter = basic_allocator_filter>
+		using arena_allocator = basic_arena_allocator<arena_t, TFilter>;
+	}
+}
+
+#endif // __MINILIB_BASIC_ARENA_ALLOCATOR_H__
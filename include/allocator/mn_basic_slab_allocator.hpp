@@ -0,0 +1,367 @@
+/**
+ * @file
+ * @brief Slab allocator with per size class free lists
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_BASIC_SLAB_ALLOCATOR_H__
+#define __MINILIB_BASIC_SLAB_ALLOCATOR_H__
+
+#include "../mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../mn_def.hpp"
+#include "mn_basic_allocator.hpp"
+#include "mn_allocator_typetraits.hpp"
+
+namespace mn {
+	namespace memory {
+
+		/**
+		 * @brief The statistics of a size class of the slab pool
+		 */
+		struct slab_class_stats {
+			uint32_t uiBlockSize;	/*!< The size of a block in this class */
+			uint32_t uiTotal;		/*!< The number of carved blocks */
+			uint32_t uiFree;		/*!< The number of blocks in the free list */
+			uint32_t uiPeak;		/*!< The maximal number of used blocks */
+			uint32_t uiAllocs;		/*!< The number of allocations */
+			uint32_t uiFrees;		/*!< The number of deallocations */
+			uint32_t uiFailed;		/*!< The number of failed allocations */
+		};
+
+		/**
+		 * @brief A pool that carves slabs into the size classes 8, 16, 32 .. 512 bytes.
+		 *
+		 * Each class has a intrusive free list, so allocate and deallocate are O(1): the class
+		 * is computed from the size and the block is popped or pushed. A class gets a new slab
+		 * of MN_THREAD_CONFIG_SLAB_SIZE bytes, when the free list is empty. The slabs come
+		 * from a static buffer or, when no buffer is given, from the heap. Freed blocks go back
+		 * in the free list of the class, the slabs are released in the destructor.
+		 *
+		 * Requests bigger then 512 bytes use malloc in the heap backed version and fail in
+		 * the static version. Requests with a alignment bigger then mn::max_alignment fail
+		 * in both versions, malloc does not give this alignment.
+		 *
+		 * With MN_THREAD_CONFIG_MEMPOOL_USE_MAGIC each block is guarded with
+		 * MN_THREAD_CONFIG_MEMPOOL_MAGIC_START and MN_THREAD_CONFIG_MEMPOOL_MAGIC_END bytes,
+		 * deallocate checks the guards and counts a corrupt or double freed block. The free
+		 * list link is stored after the start guard, in the payload of the free block.
+		 *
+		 * @note The pool is guarded with a spinlock and can use from more tasks.
+		 */
+		class basic_slab_pool {
+			/**
+			 * A free block, the next pointer is stored in the payload behind the start guard
+			 */
+			struct free_block {
+				free_block* pNext;
+			};
+			/**
+			 * The header of a heap slab, for release in the destructor
+			 */
+			struct slab_header {
+				slab_header* pNext;
+			};
+		public:
+			/** The number of size classes */
+			static constexpr size_t CLASSES = 7;
+			/** The size of the smallest class */
+			static constexpr size_t MIN_BLOCK = 8;
+			/** The size of the biggest class */
+			static constexpr size_t MAX_BLOCK = MIN_BLOCK << (CLASSES - 1);
+#if MN_THREAD_CONFIG_MEMPOOL_USE_MAGIC == MN_THREAD_CONFIG_YES
+			/** The size of one guard, keeps the payload aligned */
+			static constexpr size_t GUARD = mn::max_alignment;
+#else
+			static constexpr size_t GUARD = 0;
+#endif
+			/**
+			 * @brief Construct a heap backed pool
+			 */
+			basic_slab_pool() noexcept;
+			/**
+			 * @brief Construct a pool, that carves the slabs from the given buffer
+			 * @param pBuffer The buffer, NULL for a heap backed pool
+			 * @param uiSize The size of the buffer in bytes
+			 */
+			basic_slab_pool(void* pBuffer, size_t uiSize) noexcept;
+
+			~basic_slab_pool();
+
+			basic_slab_pool(const basic_slab_pool&) = delete;
+			basic_slab_pool& operator=(const basic_slab_pool&) = delete;
+
+			/**
+			 * @brief Allocate a block
+			 * @param size The size in bytes
+			 * @param alignment The alignment, at most mn::max_alignment
+			 * @return Pointer to the block, or NULL if allocation fails
+			 */
+			void* allocate(size_t size, size_t alignment) noexcept;
+			/**
+			 * @brief Give a block back
+			 * @param address The block, the size and alignment must be the same as for allocate
+			 * @return false when the guards of the block are corrupt, the block is not reused
+			 */
+			bool deallocate(void* address, size_t size, size_t alignment) noexcept;
+
+			/**
+			 * @brief Allocate more blocks of one size class with one lock, for caches
+			 * @param uiClass The size class
+			 * @param pBlocks Where the blocks are returned to
+			 * @param uiCount The number of wanted blocks
+			 * @return The number of allocated blocks
+			 */
+			size_t allocate_batch(size_t uiClass, void** pBlocks, size_t uiCount) noexcept;
+			/**
+			 * @brief Give more blocks of one size class back with one lock
+			 * @param uiClass The size class
+			 * @param pBlocks The blocks
+			 * @param uiCount The number of blocks
+			 * @return The number of given back blocks, less when corrupt blocks are found
+			 */
+			size_t deallocate_batch(size_t uiClass, void* const* pBlocks, size_t uiCount) noexcept;
+
+			/**
+			 * @brief Get the statistics of a size class
+			 * @param uiClass The size class, 0 is 8 bytes and CLASSES - 1 is 512 bytes
+			 * @param stats The statistics
+			 * @return false if uiClass is out of range
+			 */
+			bool get_stats(size_t uiClass, slab_class_stats& stats) noexcept;
+
+			/**
+			 * @brief Get the number of detected corrupt or double freed blocks
+			 */
+			uint32_t get_corruptions() const noexcept { return m_uiCorruptions; }
+			/**
+			 * @brief Get the number of bytes taken for slabs
+			 */
+			size_t get_slab_bytes() const noexcept { return m_uiSlabBytes; }
+			/**
+			 * @brief Is the pool backed by a static buffer?
+			 */
+			bool is_static() const noexcept { return m_pBuffer != NULL; }
+
+			/**
+			 * @brief Get the size class for a size
+			 * @return The class or CLASSES when the size is too big
+			 */
+			static size_t get_class(size_t size) noexcept {
+				if(size <= MIN_BLOCK) return 0;
+				if(size > MAX_BLOCK) return CLASSES;
+
+				// ceil(log2(size)) - log2(MIN_BLOCK)
+				return (sizeof(unsigned int) * 8 - __builtin_clz(static_cast<unsigned int>(size - 1))) - 3;
+			}
+
+			/**
+			 * @brief Get the global heap backed pool
+			 */
+			static basic_slab_pool& instance() noexcept;
+		private:
+			size_t pop_n(size_t uiClass, void** pBlocks, size_t uiCount) noexcept;
+			bool check_block(char* pMem, size_t uiClass) noexcept;
+			bool refill(size_t uiClass) noexcept;
+			void* take_slab(size_t uiStride, size_t& uiBytes) noexcept;
+
+			static size_t get_stride(size_t uiClass) noexcept {
+				size_t _uiStride = (MIN_BLOCK << uiClass) + 2 * GUARD;
+				return (_uiStride + mn::max_alignment - 1) & ~(mn::max_alignment - 1);
+			}
+		private:
+			portMUX_TYPE m_Mux;
+			free_block* m_pFree[CLASSES];
+			slab_class_stats m_Stats[CLASSES];
+
+			char* m_pBuffer;
+			size_t m_uiBufferSize;
+			size_t m_uiBufferUsed;
+
+			slab_header* m_pSlabs;
+			size_t m_uiSlabBytes;
+			uint32_t m_uiCorruptions;
+		};
+
+		/**
+		 * @brief Slab allocator impl for basic_allocator, all allocators of the same type
+		 * use one static pool over a static buffer of TBytes bytes.
+		 * @tparam TBytes The size of the static buffer, 0 for a heap backed pool
+		 * @tparam TTag A tag type for more pools with the same size
+		 */
+		template <size_t TBytes, class TTag = void>
+		class basic_allocator_slab_impl {
+		public:
+			using allocator_category = std_allocator_tag();
+			using is_thread_safe = mn::true_type;
+
+			static void first() noexcept { pool(); }
+
+			static void* allocate(size_t size, size_t alignment) noexcept {
+				return pool().allocate(size, alignment);
+			}
+
+			static void deallocate(void* ptr, size_t size, size_t alignment) noexcept {
+				pool().deallocate(ptr, size, alignment);
+			}
+
+			static size_t max_node_size()  {
+				return basic_slab_pool::MAX_BLOCK;
+			}
+			static size_t get_max_alocator_size()  {
+				return TBytes == 0 ? __SIZE_MAX__ : TBytes;
+			}
+
+			/**
+			 * @brief Get the pool of this allocator type, for the statistics
+			 */
+			static basic_slab_pool& pool() noexcept {
+				alignas(max_align_t) static char _buffer[TBytes == 0 ? 1 : TBytes];
+				static basic_slab_pool _pool(TBytes == 0 ? NULL : _buffer, TBytes);
+				return _pool;
+			}
+		};
+
+		/**
+		 * @brief A slab allocator over a static buffer, the pool is selected by the type.
+		 *
+		 * @code
+		 * using node_alloc = mn::memory::slab_allocator<4096>;
+		 * mn::container::list<int, node_alloc> l;
+		 * @endcode
+		 */
+		template <size_t TBytes, class TFilter = basic_allocator_filter, class TTag = void>
+		using slab_allocator = basic_allocator<basic_allocator_slab_impl<TBytes, TTag>, TFilter>;
+
+		/**
+		 * @brief A slab allocator, that use a given pool, so each container instance can
+		 * select the pool. Default constructed it use basic_slab_pool::instance().
+		 *
+		 * @code
+		 * static char buffer[4096];
+		 * mn::memory::basic_slab_pool pool(buffer, sizeof(buffer));
+		 * mn::container::list<int, mn::memory::slab_pool_allocator<>> l(
+		 *     mn::memory::slab_pool_allocator<>(pool) );
+		 * @endcode
+		 */
+		template <class TFilter = basic_allocator_filter>
+		class basic_slab_pool_allocator {
+		public:
+			using allocator_category = std_allocator_tag();
+			using is_thread_safe = mn::true_type;
+			using filter_type = TFilter;
+
+			using value_type = void;
+			using pointer = void*;
+			using const_pointer = const void*;
+			using difference_type = mn::ptrdiff_t;
+			using size_type = size_t;
+
+			basic_slab_pool_allocator() noexcept
+				: m_pPool(&basic_slab_pool::instance()), m_fFilter() { }
+
+			explicit basic_slab_pool_allocator(basic_slab_pool& pool) noexcept
+				: m_pPool(&pool), m_fFilter() { }
+
+			/**
+			 * @brief Allocate a block from the pool and cheak with the given TFilter
+			 * is this okay to alloc
+			 * @param size		Size of desired buffer.
+			 * @param alignment
+			 * @return Pointer to new memory, or NULL if allocation fails.
+			 */
+			pointer allocate(size_t size, size_t alignment) {
+				pointer _mem = nullptr;
+
+				if(m_fFilter.on_pre_alloc(size, alignment)) {
+					_mem = m_pPool->allocate(size, alignment);
+					if(_mem != nullptr) m_fFilter.on_alloc(size, alignment);
+				}
+				return _mem;
+			}
+
+			pointer allocate(size_t size) {
+				return allocate(size, mn::alignment_for(size));
+			}
+
+			pointer allocate(size_t count, size_t size, size_t alignment) {
+				return allocate(count * size, (alignment == 0) ? mn::alignment_for(size) : alignment);
+			}
+
+			/**
+			 * @brief Give a block back to the pool
+			 * @param address The address to free.
+			 * @param size The size of the Type
+			 * @param alignment
+			 */
+			void deallocate(pointer address, size_t size, size_t alignment) noexcept {
+				if(m_fFilter.on_pre_dealloc(size, alignment)) {
+					m_pPool->deallocate(address, size, alignment);
+					m_fFilter.on_dealloc(size, alignment);
+				}
+			}
+
+			void deallocate(pointer address, size_t size) noexcept {
+				deallocate(address, size, mn::alignment_for(size));
+			}
+
+			void deallocate(pointer address, size_t count, size_t size, size_t alignment) noexcept {
+				deallocate(address, size * count, (alignment == 0) ? mn::alignment_for(size) : alignment);
+			}
+
+			template <class Type, typename... Args>
+			Type* construct(Args&&... args) {
+				auto _size = sizeof(Type);
+
+				void* _mem = allocate(_size, mn::alignment_for(_size) );
+				if(_mem == nullptr) return nullptr;
+
+				return ::new (_mem) Type(mn::forward<Args>(args)...);
+			}
+
+			template <class Type>
+			void destroy(Type* address) noexcept {
+				if(address == nullptr) return;
+
+				auto _size = sizeof(Type);
+
+				mn::destruct<Type>(address);
+				deallocate(address, _size, mn::alignment_for(_size));
+			}
+
+			size_t get_max_alocator_size() const noexcept {
+				return m_pPool->is_static() ? basic_slab_pool::MAX_BLOCK : __SIZE_MAX__;
+			}
+
+			/**
+			 * @brief Get the using pool
+			 */
+			basic_slab_pool& get_pool() noexcept { return *m_pPool; }
+		private:
+			basic_slab_pool* m_pPool;
+			filter_type m_fFilter;
+		};
+
+		template <class TFilter = basic_allocator_filter>
+		using slab_pool_allocator = basic_slab_pool_allocator<TFilter>;
+	}
+}
+
+#endif // __MINILIB_BASIC_SLAB_ALLOCATOR_H__
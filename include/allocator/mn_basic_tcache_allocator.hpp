@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @brief Allocator with per task caches in front of the slab pool
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_BASIC_TCACHE_ALLOCATOR_H__
+#define __MINILIB_BASIC_TCACHE_ALLOCATOR_H__
+
+#include "../mn_config.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mn_basic_allocator.hpp"
+#include "mn_allocator_typetraits.hpp"
+#include "mn_basic_slab_allocator.hpp"
+
+namespace mn {
+	namespace memory {
+
+		/**
+		 * @brief The statistics of the caching allocator, the sum of all task caches
+		 */
+		struct tcache_stats {
+			uint32_t uiHits;		/*!< The allocations served from a task cache */
+			uint32_t uiRefills;		/*!< How often a task cache is refilled from the shared pool */
+			uint32_t uiFlushes;		/*!< How often a task cache gives blocks back to the shared pool */
+			uint32_t uiRemoteFrees;	/*!< The frees from tasks without cache and from ISRs */
+			uint32_t uiCaches;		/*!< The number of used task caches */
+		};
+
+		/**
+		 * @brief Allocator impl with per task caches (magazines) in front of basic_slab_pool::instance().
+		 *
+		 * Each task gets on the first allocation a cache, found with the thread local storage
+		 * pointer MN_THREAD_CONFIG_TCACHE_TLS_INDEX (default -1: no task caches, set it to 1 or
+		 * higher, the index 0 is reserved for the ESP-IDF pthread storage). The cache holds up to
+		 * MN_THREAD_CONFIG_TCACHE_MAGAZINE free blocks per size class, so most allocate and
+		 * deallocate calls take no lock. An empty magazine is refilled and a full one flushed with
+		 * MN_THREAD_CONFIG_TCACHE_BATCH blocks, with one lock of the shared pool.
+		 *
+		 * Frees from ISRs and from tasks without a cache go to a lock-free remote free list per
+		 * size class, which the next refill takes first.
+		 *
+		 * @note deallocate can use in the ISR Context, allocate not: a refill of the shared pool
+		 * can call malloc.
+		 * @note Call flush() before a task is deleted, when the port has no thread local storage
+		 * delete callbacks, else the slot and the cached blocks stay used.
+		 */
+		class basic_allocator_tcache_impl {
+		public:
+			using allocator_category = std_allocator_tag();
+			using is_thread_safe = mn::true_type;
+
+			static void first() noexcept { basic_slab_pool::instance(); }
+
+			static void* allocate(size_t size, size_t alignment) noexcept;
+			static void deallocate(void* ptr, size_t size, size_t alignment) noexcept;
+
+			/**
+			 * @brief Give the cache of the calling task back to the shared pool
+			 */
+			static void flush() noexcept;
+			/**
+			 * @brief Get the statistics, the counters of the caches are read without lock
+			 */
+			static void get_stats(tcache_stats& stats) noexcept;
+
+			static size_t max_node_size()  {
+				return basic_slab_pool::MAX_BLOCK;
+			}
+			static size_t get_max_alocator_size()  {
+				return __SIZE_MAX__;
+			}
+		};
+
+		/**
+		 * @brief The caching allocator for the containers
+		 *
+		 * @code
+		 * mn::container::rb_tree<int, mn::memory::tcache_allocator<>> tree;
+		 * @endcode
+		 */
+		template <class TFilter = basic_allocator_filter>
+		using tcache_allocator = basic_allocator<basic_allocator_tcache_impl, TFilter>;
+	}
+}
+
+#endif // __MINILIB_BASIC_TCACHE_ALLOCATOR_H__
@@ -0,0 +1,236 @@
+/**
+ * @file
+ * @brief Two-level segregated fit (TLSF) heap
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_BASIC_TLSF_ALLOCATOR_H__
+#define __MINILIB_BASIC_TLSF_ALLOCATOR_H__
+
+#include "../mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../mn_def.hpp"
+#include "mn_basic_allocator.hpp"
+#include "mn_allocator_typetraits.hpp"
+
+namespace mn {
+	namespace memory {
+
+		/**
+		 * @brief The statistics of a TLSF heap
+		 */
+		struct tlsf_stats {
+			size_t uiFree;			/*!< The sum of the free blocks in bytes */
+			size_t uiUsed;			/*!< The sum of the used blocks in bytes */
+			size_t uiPeak;			/*!< The maximal used bytes */
+			size_t uiLargestFree;	/*!< The largest free block, the largest possible allocation */
+			uint32_t uiFragmentation; /*!< 100 - largest free block * 100 / free bytes, in percent */
+			uint32_t uiFailed;		/*!< The number of failed allocations */
+			uint32_t uiCorruptions;	/*!< The number of detected double frees */
+		};
+
+		/**
+		 * @brief A two-level segregated fit heap over one memory region.
+		 *
+		 * The free blocks are sorted in FL x SL lists: the first level is the power of two of
+		 * the size and the second level splits it in 2^MN_THREAD_CONFIG_TLSF_SL_INDEX_LOG2
+		 * parts. Two bitmaps mark the not empty lists, so a fitting list is found with two
+		 * find-first-set instructions. Allocate and deallocate are O(1), there is no walk over
+		 * the free blocks: allocate splits the found block, deallocate coalesces the block with
+		 * its free neighbours.
+		 *
+		 * @note The heap is guarded with a spinlock. Can not use in the ISR Context.
+		 */
+		class basic_tlsf_heap {
+			/**
+			 * The header of a block. pNextFree and pPrevFree exist only in free blocks,
+			 * in used blocks the payload starts there.
+			 */
+			struct block_header {
+				block_header* pPrevPhys;
+				size_t uiSize;
+				block_header* pNextFree;
+				block_header* pPrevFree;
+			};
+		public:
+			/** The alignment of all blocks */
+			static constexpr size_t ALIGN = 8;
+			static constexpr size_t SL_LOG2 = MN_THREAD_CONFIG_TLSF_SL_INDEX_LOG2;
+			static constexpr size_t SL_COUNT = size_t(1) << SL_LOG2;
+			static constexpr size_t FL_SHIFT = SL_LOG2 + 3;
+			static constexpr size_t FL_COUNT = MN_THREAD_CONFIG_TLSF_FL_INDEX_MAX - FL_SHIFT + 2;
+			/** Blocks smaller then this are all in the first level 0 */
+			static constexpr size_t SMALL_BLOCK = size_t(1) << FL_SHIFT;
+			/** The size of the used part of the header */
+			static constexpr size_t HEADER = (2 * sizeof(void*) + ALIGN - 1) & ~(ALIGN - 1);
+			/** The smallest payload, a free block must hold the list pointers */
+			static constexpr size_t MIN_BLOCK = (2 * sizeof(void*) + ALIGN - 1) & ~(ALIGN - 1);
+			/** The biggest block */
+			static constexpr size_t MAX_BLOCK = size_t(1) << MN_THREAD_CONFIG_TLSF_FL_INDEX_MAX;
+
+			static_assert(SL_LOG2 <= 5, "MN_THREAD_CONFIG_TLSF_SL_INDEX_LOG2 must be less or equal 5");
+			static_assert(FL_COUNT <= 31, "MN_THREAD_CONFIG_TLSF_FL_INDEX_MAX is too big");
+
+			/**
+			 * @brief Construct a heap over the given region
+			 * @param pMemory The region, is not freed by the heap
+			 * @param uiBytes The size of the region
+			 */
+			basic_tlsf_heap(void* pMemory, size_t uiBytes) noexcept;
+			/**
+			 * @brief Construct a heap over a block from the system heap
+			 * @param uiBytes The size of the region
+			 */
+			explicit basic_tlsf_heap(size_t uiBytes) noexcept;
+
+			~basic_tlsf_heap();
+
+			basic_tlsf_heap(const basic_tlsf_heap&) = delete;
+			basic_tlsf_heap& operator=(const basic_tlsf_heap&) = delete;
+
+			/**
+			 * @brief Allocate a block in O(1)
+			 * @param size The size in bytes
+			 * @param alignment The alignment, a power of two
+			 * @return Pointer to the block, or NULL if allocation fails
+			 */
+			void* allocate(size_t size, size_t alignment = ALIGN) noexcept;
+			/**
+			 * @brief Free a block in O(1) and coalesce it with the free neighbours
+			 * @param address The block
+			 */
+			void deallocate(void* address) noexcept;
+
+			/**
+			 * @brief Get the usable size of a allocated block
+			 */
+			size_t get_block_size(void* address) const noexcept;
+
+			/**
+			 * @brief Get the statistics, the largest free block is found in the highest
+			 * not empty list
+			 */
+			void get_stats(tlsf_stats& stats) noexcept;
+
+			/**
+			 * @brief Walk over all blocks and check the links
+			 * @return false when the heap is corrupt
+			 */
+			bool check() noexcept;
+
+			/**
+			 * @brief Is the heap usable, was the region big enough?
+			 */
+			bool is_valid() const noexcept { return m_pFirst != NULL; }
+		private:
+			void create(void* pMemory, size_t uiBytes) noexcept;
+
+			static void mapping_insert(size_t uiSize, size_t& fl, size_t& sl) noexcept;
+			static bool mapping_search(size_t uiSize, size_t& fl, size_t& sl) noexcept;
+			block_header* search_suitable(size_t& fl, size_t& sl) noexcept;
+
+			void insert_free(block_header* pBlock) noexcept;
+			void remove_free(block_header* pBlock) noexcept;
+			block_header* split(block_header* pBlock, size_t uiSize) noexcept;
+
+			static size_t get_size(const block_header* pBlock) noexcept { return pBlock->uiSize & ~size_t(1); }
+			static bool is_free(const block_header* pBlock) noexcept { return (pBlock->uiSize & 1) != 0; }
+			static char* get_payload(const block_header* pBlock) noexcept {
+				return reinterpret_cast<char*>(const_cast<block_header*>(pBlock)) + HEADER;
+			}
+			static block_header* from_payload(const void* pPayload) noexcept {
+				return reinterpret_cast<block_header*>(const_cast<char*>(static_cast<const char*>(pPayload)) - HEADER);
+			}
+			static block_header* get_next(const block_header* pBlock) noexcept {
+				return reinterpret_cast<block_header*>(get_payload(pBlock) + get_size(pBlock));
+			}
+		private:
+			portMUX_TYPE m_Mux;
+
+			uint32_t m_uiFlBitmap;
+			uint32_t m_uiSlBitmap[FL_COUNT];
+			block_header* m_pBlocks[FL_COUNT][SL_COUNT];
+
+			block_header* m_pFirst;
+			void* m_pOwned;
+
+			size_t m_uiFree;
+			size_t m_uiUsed;
+			size_t m_uiPeak;
+			uint32_t m_uiFailed;
+			uint32_t m_uiCorruptions;
+		};
+
+		/**
+		 * @brief TLSF allocator impl for basic_allocator, all allocators of the same type
+		 * use one heap over a static buffer of TBytes bytes.
+		 * @tparam TBytes The size of the static buffer
+		 * @tparam TTag A tag type for more heaps with the same size
+		 */
+		template <size_t TBytes, class TTag = void>
+		class basic_allocator_tlsf_impl {
+		public:
+			using allocator_category = std_allocator_tag();
+			using is_thread_safe = mn::true_type;
+
+			static void first() noexcept { heap(); }
+
+			static void* allocate(size_t size, size_t alignment) noexcept {
+				return heap().allocate(size, alignment);
+			}
+
+			static void deallocate(void* ptr, size_t size, size_t alignment) noexcept {
+				MN_UNUSED_VARIABLE(size);
+				MN_UNUSED_VARIABLE(alignment);
+
+				heap().deallocate(ptr);
+			}
+
+			static size_t max_node_size()  {
+				return TBytes;
+			}
+			static size_t get_max_alocator_size()  {
+				return TBytes;
+			}
+
+			/**
+			 * @brief Get the heap of this allocator type, for the statistics
+			 */
+			static basic_tlsf_heap& heap() noexcept {
+				alignas(basic_tlsf_heap::ALIGN) static char _buffer[TBytes];
+				static basic_tlsf_heap _heap(_buffer, TBytes);
+				return _heap;
+			}
+		};
+
+		/**
+		 * @brief A real time allocator with O(1) allocate and deallocate
+		 *
+		 * @code
+		 * using control_alloc = mn::memory::tlsf_allocator<32 * 1024>;
+		 * mn::container::rb_tree<int, control_alloc> tree;
+		 * @endcode
+		 */
+		template <size_t TBytes, class TFilter = basic_allocator_filter, class TTag = void>
+		using tlsf_allocator = basic_allocator<basic_allocator_tlsf_impl<TBytes, TTag>, TFilter>;
+	}
+}
+
+#endif // __MINILIB_BASIC_TLSF_ALLOCATOR_H__
@@ -87,31 +87,27 @@ namespace mn {
         value_type exchange (value_type v, memory_order order = memory_order::SeqCst)
             { return __atomic_exchange_n (&__tValue, v, static_cast<int>(order)); }
 
-        bool compare_exchange_n (value_type& expected, value_type& desired, bool b,
+        bool compare_exchange_n (value_type& expected, value_type desired, bool b,
 								 memory_order order = memory_order::SeqCst)
             { return __atomic_compare_exchange_n (&__tValue, &expected, desired, b,
-												order, static_cast<int>(order)); }
+												static_cast<int>(order), failure_order(order)); }
 
-        bool compare_exchange_t (value_type& expected, value_type& desired,
+        bool compare_exchange_t (value_type& expected, value_type desired,
 								memory_order order = memory_order::SeqCst)
-            { return compare_exchange_n (&expected, desired, true,
-										static_cast<int>(order)); }
+            { return compare_exchange_n (expected, desired, true, order); }
 
-        bool compare_exchange_f (value_type& expected, value_type& desired,
+        bool compare_exchange_f (value_type& expected, value_type desired,
 								memory_order order = memory_order::SeqCst)
-            { return compare_exchange_n (&expected, desired, false,
-										static_cast<int>(order)); }
+            { return compare_exchange_n (expected, desired, false, order); }
 
 
-        bool compare_exchange_strong(value_type& expected, value_type& desired,
+        bool compare_exchange_strong(value_type& expected, value_type desired,
 									memory_order order = memory_order::SeqCst)
-            { return _atomic_compare_exchange (&__tValue, &expected, &desired, 0,
-											order, static_cast<int>(order)); }
+            { return compare_exchange_n (expected, desired, false, order); }
 
-        bool compare_exchange_weak(value_type& expected, value_type& desired,
+        bool compare_exchange_weak(value_type& expected, value_type desired,
 								memory_order order = memory_order::SeqCst)
-            { return _atomic_compare_exchange (&__tValue, &expected, &desired, 1,
-											order, static_cast<int>(order)); }
+            { return compare_exchange_n (expected, desired, true, order); }
 
         value_type fetch_add (value_type v, memory_order order = memory_order::SeqCst )
             { return __atomic_fetch_add (&__tValue, v, static_cast<int>(order)); }
@@ -173,7 +169,30 @@ namespace mn {
         inline value_type operator  = (value_type v) volatile { store(v); return v; }
 
         volatile value_type __tValue;
+    private:
+        /**
+         * @brief The memory order for a failed compare exchange, it can't be a release order.
+         */
+        static constexpr int failure_order(memory_order order) {
+            return (order == memory_order::AcqRel) ? __ATOMIC_ACQUIRE :
+                   (order == memory_order::Release) ? __ATOMIC_RELAXED : static_cast<int>(order);
+        }
     };
+
+    /**
+     * @brief A memory fence with the given order between threads.
+     */
+    inline void atomic_thread_fence(memory_order order) {
+        __atomic_thread_fence(static_cast<int>(order));
+    }
+
+    /**
+     * @brief A memory fence with the given order between a thread and a signal handler (ISR)
+     * on the same core.
+     */
+    inline void atomic_signal_fence(memory_order order) {
+        __atomic_signal_fence(static_cast<int>(order));
+    }
 }
 
 #endif
@@ -18,127 +18,219 @@
 #ifndef __MINLIB_ATOMIC_QUEUE_H__
 #define __MINLIB_ATOMIC_QUEUE_H__
 
+#include "../mn_config.hpp"
 #include "../mn_atomic.hpp"
 
+#include <stdint.h>
+
 namespace mn {
 	namespace container {
 
 		/**
-         * @brief A basic lockfree atomic queue
+         * @brief A bounded lockfree multi-producer / multi-consumer queue (Vyukov).
+         *
+         * The queue is a array of TMAXITEMS slots, each slot has a sequence number that says
+         * whether the slot is free for the producer of this round or written for the consumer.
+         * A producer or consumer claims a slot with one CAS on the enqueue or dequeue position,
+         * there is no allocation after the construction. All functions never block, so the
+         * queue can be used from tasks on both cores and from ISRs.
+         *
+         * @code
+         * mn::container::atomic_queue<telemetry_t, 128> fanin;
          *
-         * @tparam T         The type of an element
-         * @tparam TMAXITEMS Maximal items can queue
+         * // any task or ISR
+         * fanin.try_push(sample);
+         *
+         * // the collector task
+         * telemetry_t batch[16];
+         * size_t n = fanin.pop_n(batch, 16);
+         * @endcode
+         *
+         * @tparam T         The type of an element, must be default constructible and copy assignable
+         * @tparam TMAXITEMS Maximal items can queue, must be a power of two
          */
         template <class T, mn::size_t TMAXITEMS >
         class basic_atomic_queue {
-		public:
-			struct node {
+			static_assert(TMAXITEMS >= 2 && (TMAXITEMS & (TMAXITEMS - 1)) == 0,
+						  "basic_atomic_queue: TMAXITEMS must be a power of two");
+
+			struct cell {
+				atomic_uint32_t sequence;
 				T data;
-				node * next;
+
+				cell() : sequence(0), data() { }
 			};
 		public:
 			using value_type = T;
 			using reference = T&;
-			using lreference = T&&;
-			using pointer = node*;
-
-			using const_value_type = const T;
 			using const_reference = const T&;
+			using pointer = T*;
+			using const_pointer = const T*;
+			using size_type = mn::size_t;
 
 			using self_type = basic_atomic_queue<T, TMAXITEMS>;
 
-			basic_atomic_queue()
-				: m_atHead(), m_curItems(0) { }
+			basic_atomic_queue() noexcept
+				: m_uiEnqueuePos(0), m_uiDequeuePos(0) {
+
+				for(uint32_t i = 0; i < TMAXITEMS; i++)
+					m_aCells[i].sequence.store(i, memory_order::Relaxed);
+			}
 
 			basic_atomic_queue(const self_type& other) = delete;
-			basic_atomic_queue(const self_type&& other) = delete;
+			self_type& operator = (const self_type& other) = delete;
 
 			/**
              * @brief Push a element to the queue
-             * @param pElement The element
+             * @param _Element The element
+             * @return true The element is in the queue and false when the queue is full
              */
-            bool push(reference _Element) noexcept {
-            	if(full()) return false;
+            bool try_push(const_reference _Element) noexcept {
+				uint32_t _uiPos = m_uiEnqueuePos.load(memory_order::Relaxed);
+				cell* _pCell;
+
+				for(;;) {
+					_pCell = &m_aCells[_uiPos & MASK];
+					int32_t _iDiff = int32_t(_pCell->sequence.load(memory_order::Acquire) - _uiPos);
+
+					if(_iDiff == 0) {
+						if(m_uiEnqueuePos.compare_exchange_weak(_uiPos, _uiPos + 1, memory_order::Relaxed))
+							break;
+					} else if(_iDiff < 0) {
+						// the slot is not consumed from the last round
+						return false;
+					} else {
+						_uiPos = m_uiEnqueuePos.load(memory_order::Relaxed);
+					}
+				}
 
-				node * n = new node;
-				n->data = _Element;
+				_pCell->data = _Element;
+				_pCell->sequence.store(_uiPos + 1, memory_order::Release);
 
-				node* stale_head = m_atHead.load(memory_order::Release);
-				m_curItems++;
+				return true;
+            }
 
-				do {
-					n->next = stale_head;
-				} while (!m_atHead.compare_exchange_weak(stale_head, n, memory_order::Release));
+			/**
+             * @brief Pop the oldest element from the queue
+             * @param _Element Where the element is returned to
+             * @return true A element was poped and false when the queue is empty
+             */
+            bool try_pop(reference _Element) noexcept {
+				uint32_t _uiPos = m_uiDequeuePos.load(memory_order::Relaxed);
+				cell* _pCell;
+
+				for(;;) {
+					_pCell = &m_aCells[_uiPos & MASK];
+					int32_t _iDiff = int32_t(_pCell->sequence.load(memory_order::Acquire) - (_uiPos + 1));
+
+					if(_iDiff == 0) {
+						if(m_uiDequeuePos.compare_exchange_weak(_uiPos, _uiPos + 1, memory_order::Relaxed))
+							break;
+					} else if(_iDiff < 0) {
+						// the slot is not written in this round
+						return false;
+					} else {
+						_uiPos = m_uiDequeuePos.load(memory_order::Relaxed);
+					}
+				}
+
+				_Element = _pCell->data;
+				_pCell->sequence.store(_uiPos + MASK + 1, memory_order::Release);
 
 				return true;
             }
 
-            pointer pop_all(void) noexcept {
-				T* last = m_atHead.exchange(0, memory_order::Consume), * first = nullptr;
-				while(last) {
-					T * tmp = last;
-					last = last->next;
-					tmp->next = first;
-					first = tmp;
-				}
-				return first;
+			/**
+             * @brief Push up to uiCount elements, stops when the queue is full
+             * @return The number of pushed elements
+             */
+			size_type push_n(const_pointer pElements, size_type uiCount) noexcept {
+				size_type _uiDone = 0;
+
+				while(_uiDone < uiCount && try_push(pElements[_uiDone]))
+					_uiDone++;
+
+				return _uiDone;
+			}
+
+			/**
+             * @brief Pop up to uiCount elements, stops when the queue is empty
+             * @return The number of poped elements
+             */
+			size_type pop_n(pointer pElements, size_type uiCount) noexcept {
+				size_type _uiDone = 0;
+
+				while(_uiDone < uiCount && try_pop(pElements[_uiDone]))
+					_uiDone++;
+
+				return _uiDone;
+			}
+
+			/**
+             * @brief Push a element to the queue, same as try_push
+             */
+			bool push(const_reference _Element) noexcept {
+				return try_push(_Element);
 			}
+
+			/**
+             * @brief Pop a element from the queue, same as try_pop
+             */
+			bool pop(reference _Element) noexcept {
+				return try_pop(_Element);
+			}
+
             /**
-             * @brief Clear the queue
+             * @brief Remove all elements, only when no other task use the queue
              */
-            constexpr void clear() noexcept {
-                m_queue.clear();
+            void clear() noexcept {
+				value_type _tmp;
+                while(try_pop(_tmp)) { }
             }
             /**
              * @brief Check, if queue is empty.
              *
              * @return true The queue is empty and false when not
              */
-            constexpr bool empty() noexcept {
-                return m_curItems.load() == 0;
+            bool empty() const noexcept {
+                return size() == 0;
             }
 
-            constexpr bool full() noexcept {
-				return m_curItems.load() == TMAXITEMS;
+            bool full() const noexcept {
+				return size() == TMAXITEMS;
             }
             /**
              * @brief How many items can queue
              * @return The maximal number of entries can queue
              */
-            constexpr  mn::size_t length() noexcept {
+            constexpr  mn::size_t length() const noexcept {
                 return TMAXITEMS;
             }
             /**
-             *  How many items are currently in the queue.
+             *  How many items are currently in the queue, only a snapshot.
              *  @return the number of items in the queue.
              */
-            constexpr  mn::size_t size() noexcept {
-                return m_curItems.load();
+            mn::size_t size() const noexcept {
+				int32_t _iSize = int32_t(m_uiEnqueuePos.load(memory_order::Relaxed) -
+										 m_uiDequeuePos.load(memory_order::Relaxed));
+
+				if(_iSize < 0) return 0;
+                return (mn::size_t(_iSize) > TMAXITEMS) ? TMAXITEMS : mn::size_t(_iSize);
             }
 
             /**
              *  How many empty spaves are currently left in the queue.
              *  @return the number of remaining spaces.
              */
-            constexpr mn::size_t left() noexcept {
-            	if(full()) return 0;
-                return TMAXITEMS - m_curItems.load();
+            mn::size_t left() const noexcept {
+                return TMAXITEMS - size();
             }
+		private:
+			static constexpr uint32_t MASK = TMAXITEMS - 1;
 
-            void swap(const self_type& other)  {
-				mn::swap(m_atHead, other.m_atHead);
-				mn::swap(m_curItems, other.m_curItems);
-			}
-
-            self_type& operator = (const self_type& other) {
-				m_atHead = other.m_atHead;
-				m_curItems = other.m_curItems;
-
-				return *this;
-            }
-		protected:
-			mn::_atomic<pointer> m_atHead;
-			mn::atomic_size_t m_curItems;
+			alignas(MN_THREAD_CONFIG_CACHE_LINE_SIZE) atomic_uint32_t m_uiEnqueuePos;
+			alignas(MN_THREAD_CONFIG_CACHE_LINE_SIZE) atomic_uint32_t m_uiDequeuePos;
+			alignas(MN_THREAD_CONFIG_CACHE_LINE_SIZE) cell m_aCells[TMAXITEMS];
         };
 
 		template <class T, mn::size_t TMAXITEMS = 64>
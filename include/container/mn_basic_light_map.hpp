@@ -63,7 +63,7 @@ namespace mn {
 			using self_type = basic_light_map < TKey, TValue, TALLOCATOR, TPairType, TContainer>;
 
 			basic_light_map(const size_type start_size = 32) noexcept
-				:  m_ayKeyValue(start_size) { }
+				:  m_ayKeyValue() { m_ayKeyValue.reserve(start_size); }
 
 			~basic_light_map() {
 				m_ayKeyValue.clear();
@@ -82,17 +82,11 @@ namespace mn {
 			}
 
 			mn::container::pair<iterator, bool> assign(const value_type& vValue) {
-				mn::container::pair<iterator, bool> _ret(vValue.seconde, false);
+				mn::container::pair<iterator, bool> _ret(find(vValue.first), false);
 
-				for(typename TContainer::iterator it = m_ayKeyValue.begin();
-							it != m_ayKeyValue.end(); it++) {
-					value_type _pair = *it;
-
-					if(_pair.first == vValue.first) {
-						m_ayKeyValue.erase(it);
-						m_ayKeyValue.insert(vValue);
-						_ret->second = true;
-					}
+				if(_ret.first != nullptr) {
+					*_ret.first = vValue.second;
+					_ret.second = true;
 				}
 				return _ret;
 			}
@@ -120,11 +114,12 @@ namespace mn {
 						prevented the insertion) and a bool denoting whether the insertion took place.
 			 */
 			mn::container::pair<iterator, bool> insert( const value_type& value ) {
-				mn::container::pair<iterator, bool> result(&value, false);
+				mn::container::pair<iterator, bool> result(find(value.first), false);
 
-				if(find(value.first) == nullptr) {
+				if(result.first == nullptr) {
 					m_ayKeyValue.push_back(value);
-					result.second = find(value.first) != nullptr;
+					result.first = &(m_ayKeyValue.back().second);
+					result.second = true;
 				}
 
 				return result;
@@ -159,7 +154,7 @@ namespace mn {
 			 *	 - False: The key already exists, no change is made
 			 */
 			bool insert(key_type&& key, mapped_type&& value) {
-				return insert(value_type( mn::forward(key), mn::forward(value)) ).second;
+				return insert(value_type( mn::forward<key_type>(key), mn::forward<mapped_type>(value)) ).second;
 			}
 
 
@@ -195,10 +190,9 @@ namespace mn {
 
 				for(typename TContainer::iterator it = m_ayKeyValue.begin();
 							it != m_ayKeyValue.end(); it++) {
-					value_type _pair = *it;
-
-					if(_pair.first == tKey) {
+					if(it->first == tKey) {
 						m_ayKeyValue.erase(it); _ret =  1;
+						break;
 					}
 				}
 
@@ -214,10 +208,9 @@ namespace mn {
 
 				for(typename TContainer::iterator it = m_ayKeyValue.begin();
 							it != m_ayKeyValue.end(); it++) {
-					value_type _pair = *it;
 
-					if(_pair.first == tKey) {
-						return &(_pair.second);
+					if(it->first == tKey) {
+						return &(it->second);
 					}
 				}
 
@@ -230,34 +223,23 @@ namespace mn {
 			 * setted alternative value.
 			 */
 			const_iterator find(const key_type& tKey) const noexcept {
-				if(empty()) return nullptr;
-
-				for(typename TContainer::iterator it = m_ayKeyValue.begin();
-							it != m_ayKeyValue.end(); it++) {
-					value_type _pair = *it;
-
-					if(_pair.first == tKey) {
-						return &(_pair.second);
-					}
-				}
-
-				return nullptr;
+				return const_cast<self_type*>(this)->find(tKey);
 			}
 
 			/**
 			 * @brief Is the map empty.
 			 * @return If true then is the map empty and if false then not.
 			 */
-			constexpr bool empty() const noexcept {
-				return m_ayKeyValue.is_empty();
+			bool empty() const noexcept {
+				return m_ayKeyValue.empty();
 			}
 
 			/**
 			 * @brief Get the number of map-members.
 			 * @return The number of map entries.
 			 */
-			constexpr size_type size() const noexcept {
-				return m_ayKeyValue.get_used();
+			size_type size() const noexcept {
+				return m_ayKeyValue.size();
 			}
 
 			/**
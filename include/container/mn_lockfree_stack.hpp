@@ -0,0 +1,166 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINLIB_LOCKFREE_STACK_H__
+#define __MINLIB_LOCKFREE_STACK_H__
+
+#include "../mn_config.hpp"
+#include "../mn_atomic.hpp"
+#include "../mn_allocator.hpp"
+#include "../mn_hazard_pointer.hpp"
+
+namespace mn {
+	namespace container {
+
+		/**
+         * @brief A unbounded lockfree stack (Treiber) with hazard pointer reclamation.
+         *
+         * Push and pop are one CAS on the head. A popping task protects the head with a
+         * hazard pointer, so the node can not freed or reused (ABA) by a other task, until the
+         * CAS is done. The removed nodes are retired to the basic_hazard_domain.
+         *
+         * @code
+         * mn::container::lockfree_stack<buffer_t*> free_buffers;
+         *
+         * free_buffers.push(buffer);   // any task
+         * if(free_buffers.try_pop(buffer)) { ... }
+         * @endcode
+         *
+         * @note Can not use in the ISR Context, the nodes are allocated with TAllocator.
+         * A popped node keeps a copy of the allocator, the node is freed from the task that
+         * scans its retired list, maybe after the stack is gone.
+         *
+         * @tparam T          The type of an element, must be copy constructible and copy assignable
+         * @tparam TAllocator The allocator for the nodes
+         */
+        template <class T, class TAllocator = memory::default_allocator>
+        class basic_lockfree_stack {
+			struct node {
+				T data;
+				node* pNext;
+				TAllocator allocator;
+
+				node(const T& value, const TAllocator& alloc)
+					: data(value), pNext(nullptr), allocator(alloc) { }
+			};
+		public:
+			using value_type = T;
+			using reference = T&;
+			using const_reference = const T&;
+			using allocator_type = TAllocator;
+			using size_type = mn::size_t;
+
+			using self_type = basic_lockfree_stack<T, TAllocator>;
+
+			explicit basic_lockfree_stack(const allocator_type& allocator = allocator_type()) noexcept
+				: m_pHead(nullptr), m_uiSize(0), m_allocator(allocator) { }
+
+			basic_lockfree_stack(const self_type& other) = delete;
+			self_type& operator=(const self_type& other) = delete;
+
+			/**
+			 * @brief Free all nodes, no other task may use the stack
+			 */
+			~basic_lockfree_stack() {
+				node* _pNode = m_pHead;
+
+				while(_pNode != nullptr) {
+					node* _pNext = _pNode->pNext;
+					free_node(nullptr, _pNode);
+					_pNode = _pNext;
+				}
+			}
+
+			/**
+			 * @brief Push a copy of the value
+			 * @return false when the node can not allocate
+			 */
+			bool push(const_reference value) {
+				node* _pNode = m_allocator.template construct<node>(value, m_allocator);
+				if(_pNode == nullptr) return false;
+
+				node* _pHead = __atomic_load_n(&m_pHead, __ATOMIC_RELAXED);
+				do {
+					_pNode->pNext = _pHead;
+				} while(!__atomic_compare_exchange_n(&m_pHead, &_pHead, _pNode, true,
+													 __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+				m_uiSize.fetch_add(1, memory_order::Relaxed);
+				return true;
+			}
+
+			/**
+			 * @brief Pop the top value
+			 * @param value Where the value is returned to
+			 * @return false when the stack is empty or the task has no free hazard slot
+			 */
+			bool try_pop(reference value) {
+				hazard_pointer_t _hp;
+				if(!_hp.is_valid()) return false;
+
+				while(true) {
+					node* _pHead = _hp.protect(&m_pHead);
+					if(_pHead == nullptr) return false;
+
+					// _pHead is protected, so pNext is valid and _pHead can not reused
+					node* _pNext = _pHead->pNext;
+
+					if(__atomic_compare_exchange_n(&m_pHead, &_pHead, _pNext, false,
+												   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+						value = _pHead->data;
+						_hp.reset();
+
+						m_uiSize.fetch_sub(1, memory_order::Relaxed);
+						basic_hazard_domain::instance().retire(_pHead, &self_type::free_node, nullptr);
+						return true;
+					}
+				}
+			}
+
+			/**
+			 * @brief Is the stack empty, only a snapshot
+			 */
+			bool empty() const		{ return __atomic_load_n(&m_pHead, __ATOMIC_RELAXED) == nullptr; }
+
+			/**
+			 * @brief Get the number of the elements, only a snapshot
+			 */
+			size_type size() const	{ return m_uiSize.load(memory_order::Relaxed); }
+
+			const allocator_type& get_allocator() const	{ return m_allocator; }
+		private:
+			static void free_node(void* context, void* object) {
+				(void)context;
+				node* _pNode = static_cast<node*>(object);
+
+				// the node is freed with its own copy, the stack can be gone
+				allocator_type _allocator(_pNode->allocator);
+				_allocator.template destroy<node>(_pNode);
+			}
+		private:
+			node* volatile m_pHead;
+			atomic_uint32_t m_uiSize;
+			allocator_type m_allocator;
+		};
+
+		template <class T, class TAllocator = memory::default_allocator>
+        using lockfree_stack =  basic_lockfree_stack<T, TAllocator>;
+	}
+}
+
+#endif // __MINLIB_LOCKFREE_STACK_H__
@@ -40,9 +40,9 @@ namespace mn {
 
 			basic_pair() { }
 
-			explicit basic_pair(const reference_first a) noexcept
+			explicit basic_pair(const_reference_first a) noexcept
 				: first(a) { }
-			basic_pair(const reference_first a, reference_second b)
+			basic_pair(const_reference_first a, const_reference_second b)
 				: first(a), second(b) { }
 
 			basic_pair(const self_type& other) noexcept
@@ -21,6 +21,7 @@
 #include "../mn_config.hpp"
 #include "../mn_typetraits.hpp"
 #include <stddef.h>
+#include <assert.h>
 #include "../mn_allocator.hpp"
 #include "../mn_algorithm.hpp"
 
@@ -272,7 +273,7 @@ namespace mn {
             }
             void validate() {
                 assert(m_root->color == rb_tree_color::black);
-                validate_node(m_root);
+                validate(m_root);
             }
             void validate(node_type* n)  {
                 // - we're child of our parent.
@@ -482,7 +483,7 @@ namespace mn {
             	//void* mem = m_allocator.allocate(NodeSize, mn::alignment_for(NodeSize) );
                 //return new (mem) node_type();
 
-                return m_allocator.construct<node_type>());
+                return m_allocator.template construct<node_type>();
             }
             void destruct_node(node_type* n) {
             	if(n == nullptr) return;
@@ -490,7 +491,7 @@ namespace mn {
                	// n->~node_type();
 			  	//	m_allocator.deallocate(n, NodeSize, mn::alignment_for(NodeSize));
 			  	//	n = nullptr;
-			  	m_allocator.destroy<node_type>(n));
+			  	m_allocator.template destroy<node_type>(n);
             }
         private:
             node_type*              m_root;
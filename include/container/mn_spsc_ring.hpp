@@ -0,0 +1,398 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_SPSC_RING_
+#define MINLIB_ESP32_SPSC_RING_
+
+#include "../mn_config.hpp"
+#include "../mn_atomic.hpp"
+#include "../mn_error.hpp"
+#include "../mn_typetraits.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <stdint.h>
+#include <string.h>
+
+namespace mn {
+    namespace container {
+        /**
+         * @brief A wait-free single-producer / single-consumer ring buffer.
+         *
+         * Only one task or ISR writes (try_push, push_n, reserve, commit) and only one task or
+         * ISR reads (try_pop, pop_n, peek, release). The head is written only from the producer
+         * and the tail only from the consumer, both live in their own cache line and are free
+         * running uint32_t values; the position in the buffer is the index masked with TCapacity - 1.
+         *
+         * The reserve/commit and peek/release functions give a contiguous part of the buffer,
+         * so a DMA or ISR producer can write in place and the consumer can read without a copy:
+         *
+         * @code
+         * mn::container::basic_spsc_ring<uint8_t, 1024> rx;
+         *
+         * // producer, e.g. the UART ISR
+         * uint32_t n;
+         * uint8_t* p = rx.reserve(64, n);
+         * n = uart_read_fifo(p, n);
+         * rx.commit(n);
+         *
+         * // consumer
+         * const uint8_t* q = rx.peek(rx.size(), n);
+         * parse(q, n);
+         * rx.release(n);
+         * @endcode
+         *
+         * @tparam T The type of the items, must be trivially copyable
+         * @tparam TCapacity The number of items, must be a power of two
+         * @ingroup container
+         */
+        template <typename T, uint32_t TCapacity>
+        class basic_spsc_ring {
+            static_assert(TCapacity > 0 && (TCapacity & (TCapacity - 1)) == 0,
+                          "basic_spsc_ring: the capacity must be a power of two");
+            static_assert(is_trivially_copyable<T>::value,
+                          "basic_spsc_ring: the items must be trivially copyable");
+        public:
+            using value_type = T;
+            using pointer = T*;
+            using const_pointer = const T*;
+            using size_type = uint32_t;
+            using self_type = basic_spsc_ring<T, TCapacity>;
+
+            basic_spsc_ring() noexcept
+                : m_uiHead(0), m_uiTailCache(0), m_uiTail(0), m_uiHeadCache(0) { }
+
+            /**
+             * Add one item, only from the producer.
+             * @return true when the item was added and false when the ring is full.
+             */
+            bool try_push(const value_type& item) noexcept {
+                uint32_t _uiHead = m_uiHead.load(memory_order::Relaxed);
+
+                if(free_space(_uiHead) == 0) return false;
+
+                m_aBuffer[_uiHead & MASK] = item;
+                m_uiHead.store(_uiHead + 1, memory_order::Release);
+
+                return true;
+            }
+
+            /**
+             * Remove one item, only from the consumer.
+             * @return true when a item was removed and false when the ring is empty.
+             */
+            bool try_pop(value_type& item) noexcept {
+                uint32_t _uiTail = m_uiTail.load(memory_order::Relaxed);
+
+                if(used_space(_uiTail) == 0) return false;
+
+                item = m_aBuffer[_uiTail & MASK];
+                m_uiTail.store(_uiTail + 1, memory_order::Release);
+
+                return true;
+            }
+
+            /**
+             * Add up to uiCount items, only from the producer.
+             * @return The number of added items.
+             */
+            size_type push_n(const_pointer items, size_type uiCount) noexcept {
+                size_type _uiDone = 0;
+
+                // at most two parts: up to the end of the buffer and from the begin
+                while(_uiDone < uiCount) {
+                    size_type _uiGranted = 0;
+                    pointer _pDest = reserve(uiCount - _uiDone, _uiGranted);
+
+                    if(_pDest == NULL) break;
+
+                    memcpy(_pDest, items + _uiDone, _uiGranted * sizeof(value_type));
+                    commit(_uiGranted);
+                    _uiDone += _uiGranted;
+                }
+                return _uiDone;
+            }
+
+            /**
+             * Remove up to uiCount items, only from the consumer.
+             * @return The number of removed items.
+             */
+            size_type pop_n(pointer items, size_type uiCount) noexcept {
+                size_type _uiDone = 0;
+
+                while(_uiDone < uiCount) {
+                    size_type _uiGranted = 0;
+                    const_pointer _pSrc = peek(uiCount - _uiDone, _uiGranted);
+
+                    if(_pSrc == NULL) break;
+
+                    memcpy(items + _uiDone, _pSrc, _uiGranted * sizeof(value_type));
+                    release(_uiGranted);
+                    _uiDone += _uiGranted;
+                }
+                return _uiDone;
+            }
+
+            /**
+             * Get a contiguous free part of the buffer for writing in place, only from the producer.
+             *
+             * @param uiWanted How many items the producer want to write.
+             * @param uiGranted The number of items that can be written, can be less than uiWanted
+             * when the ring is nearly full or the free part wraps around the end of the buffer.
+             * @return The begin of the free part or NULL when the ring is full.
+             */
+            pointer reserve(size_type uiWanted, size_type& uiGranted) noexcept {
+                uint32_t _uiHead = m_uiHead.load(memory_order::Relaxed);
+                uint32_t _uiIndex = _uiHead & MASK;
+
+                uiGranted = min3(uiWanted, free_space(_uiHead), TCapacity - _uiIndex);
+
+                return (uiGranted == 0) ? NULL : &m_aBuffer[_uiIndex];
+            }
+
+            /**
+             * Publish uiCount items written in the part from reserve(), only from the producer.
+             */
+            void commit(size_type uiCount) noexcept {
+                m_uiHead.store(m_uiHead.load(memory_order::Relaxed) + uiCount, memory_order::Release);
+            }
+
+            /**
+             * Get a contiguous part of the written items for reading in place, only from the consumer.
+             *
+             * @param uiWanted How many items the consumer want to read.
+             * @param uiGranted The number of items that can be read, can be less than uiWanted
+             * when less items are in the ring or the items wraps around the end of the buffer.
+             * @return The first item or NULL when the ring is empty.
+             */
+            const_pointer peek(size_type uiWanted, size_type& uiGranted) noexcept {
+                uint32_t _uiTail = m_uiTail.load(memory_order::Relaxed);
+                uint32_t _uiIndex = _uiTail & MASK;
+
+                uiGranted = min3(uiWanted, used_space(_uiTail), TCapacity - _uiIndex);
+
+                return (uiGranted == 0) ? NULL : &m_aBuffer[_uiIndex];
+            }
+
+            /**
+             * Give uiCount items from peek() back to the producer, only from the consumer.
+             */
+            void release(size_type uiCount) noexcept {
+                m_uiTail.store(m_uiTail.load(memory_order::Relaxed) + uiCount, memory_order::Release);
+            }
+
+            /**
+             * Get the number of items, only a snapshot when the other side is running.
+             */
+            size_type size() const noexcept {
+                return m_uiHead.load(memory_order::Acquire) - m_uiTail.load(memory_order::Acquire);
+            }
+
+            bool is_empty() const noexcept  { return size() == 0; }
+            bool is_full() const noexcept   { return size() == TCapacity; }
+
+            /**
+             * Get the maximal number of items.
+             */
+            static constexpr size_type capacity() noexcept { return TCapacity; }
+        private:
+            basic_spsc_ring(const self_type&) = delete;
+            self_type& operator = (const self_type&) = delete;
+
+            /**
+             * Free items for the producer, the tail is only reloaded when the cached copy says full.
+             */
+            size_type free_space(uint32_t uiHead) noexcept {
+                size_type _uiFree = TCapacity - (uiHead - m_uiTailCache);
+
+                if(_uiFree == 0) {
+                    m_uiTailCache = m_uiTail.load(memory_order::Acquire);
+                    _uiFree = TCapacity - (uiHead - m_uiTailCache);
+                }
+                return _uiFree;
+            }
+
+            /**
+             * Written items for the consumer, the head is only reloaded when the cached copy says empty.
+             */
+            size_type used_space(uint32_t uiTail) noexcept {
+                size_type _uiUsed = m_uiHeadCache - uiTail;
+
+                if(_uiUsed == 0) {
+                    m_uiHeadCache = m_uiHead.load(memory_order::Acquire);
+                    _uiUsed = m_uiHeadCache - uiTail;
+                }
+                return _uiUsed;
+            }
+
+            static size_type min3(size_type a, size_type b, size_type c) noexcept {
+                size_type _uiMin = (a < b) ? a : b;
+                return (_uiMin < c) ? _uiMin : c;
+            }
+        private:
+            static constexpr uint32_t MASK = TCapacity - 1;
+
+            /// written from the producer
+            alignas(MN_THREAD_CONFIG_CACHE_LINE_SIZE) atomic_uint32_t m_uiHead;
+            uint32_t m_uiTailCache;
+
+            /// written from the consumer
+            alignas(MN_THREAD_CONFIG_CACHE_LINE_SIZE) atomic_uint32_t m_uiTail;
+            uint32_t m_uiHeadCache;
+
+            alignas(MN_THREAD_CONFIG_CACHE_LINE_SIZE) value_type m_aBuffer[TCapacity];
+        };
+
+        /**
+         * @brief A basic_spsc_ring with a blocking pop for the consumer task.
+         *
+         * The consumer is parked with a task notification only when the ring is empty, the
+         * producer gives the notification only when a consumer is parked. The producer can be
+         * a task or a ISR, it never blocks.
+         *
+         * @tparam T The type of the items, must be trivially copyable
+         * @tparam TCapacity The number of items, must be a power of two
+         * @ingroup container
+         */
+        template <typename T, uint32_t TCapacity>
+        class basic_spsc_blocking_ring : public basic_spsc_ring<T, TCapacity> {
+            using base_type = basic_spsc_ring<T, TCapacity>;
+        public:
+            using value_type = typename base_type::value_type;
+            using pointer = typename base_type::pointer;
+            using const_pointer = typename base_type::const_pointer;
+            using size_type = typename base_type::size_type;
+
+            basic_spsc_blocking_ring() noexcept
+                : base_type(), m_pWaiter(NULL) { }
+
+            /**
+             * Add one item and wake the parked consumer, only from the producer.
+             * @return true when the item was added and false when the ring is full.
+             */
+            bool try_push(const value_type& item) noexcept {
+                if(!base_type::try_push(item)) return false;
+
+                wake();
+                return true;
+            }
+
+            /**
+             * Add up to uiCount items and wake the parked consumer, only from the producer.
+             * @return The number of added items.
+             */
+            size_type push_n(const_pointer items, size_type uiCount) noexcept {
+                size_type _uiDone = base_type::push_n(items, uiCount);
+
+                if(_uiDone > 0) wake();
+                return _uiDone;
+            }
+
+            /**
+             * Publish the items from reserve() and wake the parked consumer, only from the producer.
+             */
+            void commit(size_type uiCount) noexcept {
+                base_type::commit(uiCount);
+                wake();
+            }
+
+            /**
+             * Remove one item, wait when the ring is empty. Only from the consumer task.
+             *
+             * @param item Where the removed item is returned to.
+             * @param xTicksToWait How long to wait for a item.
+             * @return ERR_QUEUE_OK or ERR_QUEUE_REMOVE on timeout
+             */
+            int pop(value_type& item, unsigned int xTicksToWait = portMAX_DELAY) noexcept {
+                if(wait(xTicksToWait) != ERR_QUEUE_OK) return ERR_QUEUE_REMOVE;
+
+                return base_type::try_pop(item) ? ERR_QUEUE_OK : ERR_QUEUE_REMOVE;
+            }
+
+            /**
+             * Remove up to uiCount items, wait only when the ring is empty. Only from the consumer task.
+             * @return The number of removed items, 0 on timeout
+             */
+            size_type pop_n(pointer items, size_type uiCount, unsigned int xTicksToWait = portMAX_DELAY) noexcept {
+                if(wait(xTicksToWait) != ERR_QUEUE_OK) return 0;
+
+                return base_type::pop_n(items, uiCount);
+            }
+
+            /**
+             * Wait until the ring is not empty. Only from the consumer task.
+             * @return ERR_QUEUE_OK or ERR_QUEUE_REMOVE on timeout
+             */
+            int wait(unsigned int xTicksToWait = portMAX_DELAY) noexcept {
+                if(!base_type::is_empty()) return ERR_QUEUE_OK;
+                if(xTicksToWait == 0) return ERR_QUEUE_REMOVE;
+
+                __atomic_store_n(&m_pWaiter, xTaskGetCurrentTaskHandle(), __ATOMIC_SEQ_CST);
+                atomic_thread_fence(memory_order::SeqCst);
+
+                TickType_t _xStart = xTaskGetTickCount();
+                TickType_t _xLeft = xTicksToWait;
+
+                // check again after the waiter is visible, the producer may have missed it
+                while(base_type::is_empty()) {
+                    if(xTicksToWait != portMAX_DELAY) {
+                        TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                        if(_xElapsed >= xTicksToWait) break;
+
+                        _xLeft = xTicksToWait - _xElapsed;
+                    }
+                    ulTaskNotifyTake(pdTRUE, _xLeft);
+                }
+                __atomic_store_n(&m_pWaiter, (TaskHandle_t)NULL, __ATOMIC_SEQ_CST);
+
+                return base_type::is_empty() ? ERR_QUEUE_REMOVE : ERR_QUEUE_OK;
+            }
+        private:
+            void wake() noexcept {
+                atomic_thread_fence(memory_order::SeqCst);
+
+                if(__atomic_load_n(&m_pWaiter, __ATOMIC_SEQ_CST) == NULL) return;
+
+                TaskHandle_t _pWaiter = __atomic_exchange_n(&m_pWaiter, (TaskHandle_t)NULL, __ATOMIC_SEQ_CST);
+                if(_pWaiter == NULL) return;
+
+                if (xPortInIsrContext()) {
+                    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+                    vTaskNotifyGiveFromISR(_pWaiter, &xHigherPriorityTaskWoken);
+
+                    if(xHigherPriorityTaskWoken)
+                        _frxt_setup_switch();
+                } else {
+                    xTaskNotifyGive(_pWaiter);
+                }
+            }
+        private:
+            TaskHandle_t m_pWaiter;
+        };
+
+        template <typename T, uint32_t TCapacity>
+        using spsc_ring_t = basic_spsc_ring<T, TCapacity>;
+
+        template <typename T, uint32_t TCapacity>
+        using spsc_blocking_ring_t = basic_spsc_blocking_ring<T, TCapacity>;
+    }
+}
+
+#endif // MINLIB_ESP32_SPSC_RING_
@@ -49,8 +49,8 @@ namespace mn {
 
             void reallocate(size_type newCapacity, size_type oldSize) {
 
-            	void* mem = m_allocator.allocate(newCapacity, sizeof(value_type) );
-                pointer newBegin = new (mem) value_type();
+            	void* mem = m_allocator.allocate(newCapacity, sizeof(value_type), mn::alignment_for(sizeof(value_type)) );
+                pointer newBegin = static_cast<pointer>(mem);
 
                 const size_type newSize = oldSize < newCapacity ? oldSize : newCapacity;
                 // Copy old data if needed.
@@ -66,8 +66,8 @@ namespace mn {
             void reallocate_discard_old(size_type newCapacity) {
                 assert(newCapacity > size_type(m_capacityEnd - m_begin));
 
-                void* mem = m_allocator.allocate(newCapacity, sizeof(value_type) );
-                pointer newBegin = new (mem) value_type();
+                void* mem = m_allocator.allocate(newCapacity, sizeof(value_type), mn::alignment_for(sizeof(value_type)) );
+                pointer newBegin = static_cast<pointer>(mem);
 
 
                 const size_type currSize((size_type)(m_end - m_begin));
@@ -83,15 +83,11 @@ namespace mn {
             void destroy(pointer ptr, size_type n) {
                 mn::destruct_n(ptr, n);
 
-
-                if(mn::is_class<value_type>::value)
-					 ptr->~value_type();
-
-				m_allocator.deallocate(ptr, n, mn::alignment_for(sizeof(n)));
+				m_allocator.deallocate(ptr, n, sizeof(value_type), mn::alignment_for(sizeof(value_type)));
 
             }
             void reset()  {
-                if (m_begin) m_allocator.free(m_begin);
+                if (m_begin) destroy(m_begin, size_type(m_end - m_begin));
                 m_begin = m_end = 0;
                 m_capacityEnd = 0;
             }
@@ -176,7 +172,7 @@ namespace mn {
             size_type size() const                  { return size_type(m_end - m_begin); }
             bool empty() const                      { return m_begin == m_end; }
 
-            size_type capacity()                    { return size_type(m_capacityEnd - m_begin); }
+            size_type capacity() const              { return size_type(m_capacityEnd - m_begin); }
 
             pointer data()                          { return empty() ? 0 : m_begin; }
 
@@ -205,7 +201,7 @@ namespace mn {
             }
             void pop_back() {
                 assert(!empty()); --m_end;
-                mn::destruct<iterator>(m_end);
+                mn::destruct(m_end);
             }
 
             void assign(const pointer first, const pointer last) {
@@ -225,7 +221,7 @@ namespace mn {
                 assert(invariant());
             }
 
-            void insert(size_type index, size_type n, const reference val) {
+            void insert(size_type index, size_type n, const_reference val) {
                 assert(invariant());
 
                 const size_type indexEnd = index + n;
@@ -263,7 +259,7 @@ namespace mn {
                 m_end += n;
             }
 
-            void insert(iterator it, size_type n, const reference val) {
+            void insert(iterator it, size_type n, const_reference val) {
                 assert(validate_iterator(it));
                 assert(invariant());
                 insert(size_type(it - m_begin), n, val);
@@ -312,7 +308,7 @@ namespace mn {
                     move_down_1(it, int_to_type<has_trivial_copy<T>::value>());
                 }
                 --m_end;
-                mn::destruct<iterator>(m_end);
+                mn::destruct(m_end);
                 return it;
             }
             iterator erase(iterator first, iterator last) {
@@ -354,7 +350,7 @@ namespace mn {
                 reallocate(newCapacity, size());
             }
 
-            size_type index_of(const reference item, size_type index = 0) const {
+            size_type index_of(const_reference item, size_type index = 0) const {
                 assert(index >= 0 && index < size());
                 size_type _pos = npos;
 
@@ -366,7 +362,7 @@ namespace mn {
                 return _pos;
             }
 
-            iterator find(const reference item) {
+            iterator find(const_reference item) {
                 iterator itEnd = end();
 
                 for (iterator it = begin(); it != itEnd; ++it)
@@ -383,7 +379,7 @@ namespace mn {
             }
 
             bool validate_iterator(const_iterator it) const {
-                return it >= begin() && it <= end();
+                return it >= m_begin && it <= m_end;
             }
 
             basic_vector& operator=(const basic_vector& rhs) {
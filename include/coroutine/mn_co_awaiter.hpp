@@ -0,0 +1,167 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_CO_AWAITER_H_
+#define _MINLIB_MN_CO_AWAITER_H_
+
+#include "../mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include "../mn_error.hpp"
+#include "../mn_eventgroup.hpp"
+#include "../mn_timer.hpp"
+#include "../queue/mn_queue.hpp"
+#include "mn_co_executor.hpp"
+#include "mn_co_mutex.hpp"
+
+namespace mn {
+    /**
+     * Suspend the coroutine for a number of ticks, without blocking the executor task.
+     * The executor resumes the coroutine after the timeout, the awaiter has no event.
+     *
+     * @code
+     * co_await mn::co_delay(pdMS_TO_TICKS(100));
+     * @endcode
+     * @ingroup coroutine
+     */
+    class co_delay : public basic_co_awaiter {
+    public:
+        explicit co_delay(unsigned int xTicksToDelay)
+            : basic_co_awaiter(xTicksToDelay) { }
+
+        void await_resume() { }
+    protected:
+        virtual bool poll() override { return is_timeout(); }
+    };
+
+    /**
+     * Await a item from a queue, the enqueue of the queue resumes the coroutine
+     *
+     * @code
+     * int value;
+     * if(co_await mn::co_dequeue(queue, &value) == ERR_QUEUE_OK) { ... }
+     * @endcode
+     *
+     * @return ERR_QUEUE_OK or ERR_QUEUE_REMOVE on timeout
+     * @ingroup coroutine
+     */
+    class co_dequeue : public basic_co_awaiter {
+    public:
+        co_dequeue(queue::queue_t& queue, void* pItem,
+                   unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT)
+            : basic_co_awaiter(timeout), m_Queue(queue), m_pItem(pItem), m_iResult(ERR_QUEUE_REMOVE) { }
+
+        int await_resume() { return m_iResult; }
+    protected:
+        virtual bool poll() override {
+            m_iResult = m_Queue.dequeue(m_pItem, 0);
+            return m_iResult == ERR_QUEUE_OK;
+        }
+        virtual basic_co_event* get_event() override { return &m_Queue.get_co_event(); }
+    private:
+        queue::queue_t& m_Queue;
+        void* m_pItem;
+        int m_iResult;
+    };
+
+    /**
+     * Await the lock of a co_mutex, the unlock resumes the coroutine.
+     *
+     * @code
+     * if(co_await mn::co_lock(mutex) == ERR_MUTEX_OK) { ...; mutex.unlock(); }
+     * @endcode
+     *
+     * @return ERR_MUTEX_OK or ERR_MUTEX_LOCK on timeout
+     * @ingroup coroutine
+     */
+    class co_lock : public basic_co_awaiter {
+    public:
+        explicit co_lock(co_mutex_t& mutex, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT)
+            : basic_co_awaiter(timeout), m_Mutex(mutex), m_iResult(ERR_MUTEX_LOCK) { }
+
+        int await_resume() { return m_iResult; }
+    protected:
+        virtual bool poll() override {
+            m_iResult = m_Mutex.try_lock() ? ERR_MUTEX_OK : ERR_MUTEX_LOCK;
+            return m_iResult == ERR_MUTEX_OK;
+        }
+        virtual basic_co_event* get_event() override { return &m_Mutex.get_co_event(); }
+    private:
+        co_mutex_t& m_Mutex;
+        int m_iResult;
+    };
+
+    /**
+     * Await one or all bits of a event group, the set of the event group resumes the coroutine
+     *
+     * @return The value of the event group, like basic_event_group::wait
+     * @ingroup coroutine
+     */
+    class co_wait_bits : public basic_co_awaiter {
+    public:
+        co_wait_bits(event_group_t& group, const EventBits_t uxBitsToWaitFor,
+                     bool xClearOnExit, bool xWaitForAllBits, unsigned int timeout = portMAX_DELAY)
+            : basic_co_awaiter(timeout), m_Group(group), m_uxBitsToWaitFor(uxBitsToWaitFor),
+              m_bClearOnExit(xClearOnExit), m_bWaitForAllBits(xWaitForAllBits), m_uxResult(0) { }
+
+        EventBits_t await_resume() { return m_uxResult; }
+    protected:
+        virtual bool poll() override {
+            m_uxResult = m_Group.wait(m_uxBitsToWaitFor, m_bClearOnExit, m_bWaitForAllBits, 0);
+
+            return m_bWaitForAllBits ? ((m_uxResult & m_uxBitsToWaitFor) == m_uxBitsToWaitFor)
+                                     : ((m_uxResult & m_uxBitsToWaitFor) != 0);
+        }
+        virtual basic_co_event* get_event() override { return &m_Group.get_co_event(); }
+    private:
+        event_group_t& m_Group;
+        EventBits_t m_uxBitsToWaitFor;
+        bool m_bClearOnExit;
+        bool m_bWaitForAllBits;
+        EventBits_t m_uxResult;
+    };
+
+    /**
+     * Await the expiry of a active timer, the timer is expired when it is not running.
+     * The callback and the stop of the timer resumes the coroutine.
+     *
+     * @return true when the timer is expired, false on timeout
+     * @ingroup coroutine
+     */
+    class co_timer : public basic_co_awaiter {
+    public:
+        explicit co_timer(timer_t& timer, unsigned int timeout = portMAX_DELAY)
+            : basic_co_awaiter(timeout), m_Timer(timer), m_bExpired(false) { }
+
+        bool await_resume() { return m_bExpired; }
+    protected:
+        virtual bool poll() override {
+            m_bExpired = !m_Timer.is_running();
+            return m_bExpired;
+        }
+        virtual basic_co_event* get_event() override { return &m_Timer.get_co_event(); }
+    private:
+        timer_t& m_Timer;
+        bool m_bExpired;
+    };
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
+
+#endif
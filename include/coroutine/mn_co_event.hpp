@@ -0,0 +1,79 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_CO_EVENT_H_
+#define _MINLIB_MN_CO_EVENT_H_
+
+#include "../mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include <freertos/FreeRTOS.h>
+
+namespace mn {
+    class basic_co_awaiter;
+    class basic_co_executor;
+
+    /**
+     * The suspended coroutines, that wait for a object (a queue, event group, timer,
+     * co_mutex or socket). The object calls notify_all() after a change of its state, then
+     * the awaiter try the operation again on a executor task. A waiting coroutine costs
+     * no cpu time, until the object is changed or the timeout is over.
+     *
+     * @note notify_all can call from the ISR Context.
+     * @ingroup coroutine
+     */
+    class basic_co_event {
+        friend class basic_co_executor;
+    public:
+        basic_co_event();
+        /**
+         * A copy has no waiting coroutines
+         */
+        basic_co_event(const basic_co_event&);
+
+        basic_co_event& operator = (const basic_co_event&) { return *this; }
+
+        /**
+         * Let all waiting awaiter try the operation again
+         */
+        void notify_all();
+
+        /**
+         * Are coroutines waiting?
+         */
+        bool has_waiters() const;
+
+        /**
+         * notify_all for xTimerPendFunctionCall
+         *
+         * @param pEvent The basic_co_event
+         */
+        static void pended_notify(void* pEvent, uint32_t ulParameter);
+    private:
+        void add(basic_co_awaiter* pAwaiter);
+        void remove(basic_co_awaiter* pAwaiter);
+    private:
+        portMUX_TYPE m_Mux;
+        basic_co_awaiter* volatile m_pWaiters;
+    };
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
+
+#endif
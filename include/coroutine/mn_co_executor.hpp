@@ -0,0 +1,237 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_CO_EXECUTOR_H_
+#define _MINLIB_MN_CO_EXECUTOR_H_
+
+#include "../mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include <coroutine>
+#include <vector>
+
+#include "../mn_task.hpp"
+#include "../mn_mutex.hpp"
+#include "../queue/mn_queue.hpp"
+#include "mn_co_event.hpp"
+
+namespace mn {
+    class basic_co_executor;
+
+    /**
+     * The base of all awaiter, that wait for a FreeRTOS object.
+     * A awaiter first try the operation without blocking. When this fails, the
+     * coroutine is suspended and waits on the basic_co_event of the object. The event
+     * or the timeout of the awaiter queue it on the executor, a executor task try the
+     * operation again and resumes the coroutine, when it is done.
+     *
+     * @ingroup coroutine
+     */
+    class basic_co_awaiter {
+        friend class basic_co_executor;
+        friend class basic_co_event;
+    public:
+        /**
+         * @param xTicksToWait How many ticks to wait, portMAX_DELAY for ever
+         */
+        explicit basic_co_awaiter(unsigned int xTicksToWait);
+        virtual ~basic_co_awaiter() { }
+
+        bool await_ready() { return poll(); }
+
+        template <typename TPromise>
+        bool await_suspend(std::coroutine_handle<TPromise> hCoroutine);
+    protected:
+        /**
+         * Try the operation without blocking
+         * @return true when the operation is done
+         */
+        virtual bool poll() = 0;
+
+        /**
+         * Get the event, that notify this awaiter
+         * @return The event or NULL, when only the timeout resumes the awaiter
+         */
+        virtual basic_co_event* get_event() { return NULL; }
+
+        /**
+         * Called after the awaiter is added to the event, before the operation is tried again
+         */
+        virtual void on_wait() { }
+
+        /**
+         * Called when the operation is done or the timeout is over, before the coroutine is resumed
+         */
+        virtual void on_done() { }
+
+        /**
+         * Is the timeout over?
+         */
+        bool is_timeout() const;
+    private:
+        std::coroutine_handle<> m_hCoroutine;
+        basic_co_executor* m_pExecutor;
+        /**
+         * The link in the list of the event or of the notified awaiter
+         */
+        basic_co_awaiter* m_pNext;
+        /**
+         * The link in the timeout list of the executor
+         */
+        basic_co_awaiter* m_pNextTimeout;
+        TickType_t m_xStart;
+        TickType_t m_xTicksToWait;
+        volatile int m_iState;
+        bool m_bTimeout;
+    };
+
+    /**
+     * A executor, that runs coroutines on a small pool of tasks.
+     * A suspended coroutine needs no stack, so many logical flows can share few tasks.
+     *
+     * @code
+     * mn::basic_co_executor executor;
+     * executor.create();
+     *
+     * mn::future<int> f = mn::co_spawn(executor, my_coroutine());
+     * @endcode
+     *
+     * @ingroup coroutine
+     */
+    class basic_co_executor {
+        friend class basic_co_awaiter;
+        friend class basic_co_event;
+    public:
+        /**
+         * The task, that runs the coroutines
+         */
+        class co_executor_task : public basic_task {
+        public:
+            co_executor_task(char const* strName, basic_task::priority uiPriority,
+                             unsigned short usStackDepth, basic_co_executor* parent);
+        protected:
+            virtual int on_task() override;
+        private:
+            basic_co_executor* m_pParent;
+        };
+
+        /**
+         * @param uiNumWorkers How many tasks runs the coroutines
+         * @param uiPriority FreeRTOS priority of the tasks
+         * @param usStackDepth Number of "words" allocated for each task stack
+         * @param uiMaxReady How many coroutines can wait in the ready queue
+         */
+        basic_co_executor(uint8_t uiNumWorkers = MN_THREAD_CONFIG_COROUTINE_WORKER,
+                          basic_task::priority uiPriority = MN_THREAD_CONFIG_COROUTINE_PRIORITY,
+                          uint16_t usStackDepth = MN_THREAD_CONFIG_COROUTINE_STACKSIZE,
+                          uint8_t uiMaxReady = MN_THREAD_CONFIG_COROUTINE_MAX_READY);
+
+        virtual ~basic_co_executor();
+
+        /**
+         * Create and start the executor tasks
+         *
+         * @return 'ERR_COROUTINE_OK' The executor are created,
+         *         'ERR_COROUTINE_ALREADYINIT' the executor was allready created,
+         *         'ERR_COROUTINE_CANTCREATE' error to create the executor and
+         *         'ERR_COROUTINE_WARNING' not all tasks are created
+         */
+        virtual int create(int iCore = MN_THREAD_CONFIG_CORE_IFNO);
+
+        /**
+         * Stop and join the executor tasks.
+         * @note Suspended coroutines are not resumed and not destroyed
+         */
+        virtual void destroy();
+
+        /**
+         * Queue a coroutine to be resumed from one of the executor tasks, can be called from a ISR
+         *
+         * @return ERR_COROUTINE_OK or ERR_COROUTINE_CANSHEDULE when the ready queue is full
+         */
+        int schedule(std::coroutine_handle<> hCoroutine, unsigned int timeout = 0);
+
+        /**
+         * Is the executor running?
+         */
+        volatile bool& running() { return m_bRunning; }
+
+        uint8_t get_num_worker() const { return m_Workers.size(); }
+    protected:
+        /**
+         * Suspend a awaiter, until its event or its timeout
+         *
+         * @return true when suspended, false when the operation is done or the timeout is over
+         */
+        bool suspend(basic_co_awaiter* pAwaiter);
+        /**
+         * Queue a notified awaiter, it try the operation again on a executor task.
+         * Can be called from a ISR
+         */
+        void post(basic_co_awaiter* pAwaiter);
+        /**
+         * The loop of the executor tasks
+         */
+        void run();
+    private:
+        bool park(basic_co_awaiter* pAwaiter);
+        void retry(basic_co_awaiter* pAwaiter);
+        void done(basic_co_awaiter* pAwaiter);
+        basic_co_awaiter* pop_notified();
+        void add_timeout(basic_co_awaiter* pAwaiter);
+        /**
+         * Retry the awaiter with a over timeout
+         * @return How many ticks to the next timeout
+         */
+        TickType_t expire();
+        /**
+         * Wake a executor task, that waits on the ready queue
+         */
+        void wake();
+    private:
+        std::vector<co_executor_task*> m_Workers;
+        queue::queue_t* m_pReadyQueue;
+        mutex_t m_ThreadStatus;
+        /**
+         * Guards the notified and the timeout list
+         */
+        portMUX_TYPE m_Mux;
+        basic_co_awaiter* m_pNotified;
+        basic_co_awaiter* m_pNotifiedTail;
+        /**
+         * The waiting awaiter with a timeout, the next timeout first
+         */
+        basic_co_awaiter* m_pTimeouts;
+        uint8_t m_uiNumWorkers;
+        volatile bool m_bRunning;
+    };
+
+    template <typename TPromise>
+    bool basic_co_awaiter::await_suspend(std::coroutine_handle<TPromise> hCoroutine) {
+        m_hCoroutine = hCoroutine;
+        m_pExecutor = hCoroutine.promise().get_executor();
+
+        // when suspended, the awaiter can be resumed from a other task - don't touch this
+        return m_pExecutor->suspend(this);
+    }
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
+
+#endif
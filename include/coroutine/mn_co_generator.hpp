@@ -0,0 +1,143 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_CO_GENERATOR_H_
+#define _MINLIB_MN_CO_GENERATOR_H_
+
+#include "../mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include <coroutine>
+#include <stdlib.h>
+
+#include "../mn_functional.hpp"
+
+namespace mn {
+    /**
+     * A synchronous generator, that produces values with co_yield.
+     * The generator runs on the task, that iterates it.
+     *
+     * @code
+     * mn::generator<int> range(int first, int last) {
+     *     for(int i = first; i < last; i++) co_yield i;
+     * }
+     *
+     * for(int i : range(0, 10)) { ... }
+     * @endcode
+     *
+     * @tparam T The type of the values
+     * @ingroup coroutine
+     */
+    template <typename T>
+    class generator {
+    public:
+        using value_type = remove_reference_t<T>;
+        using reference = value_type&;
+        using pointer = value_type*;
+        using self_type = generator<T>;
+
+        class promise_type {
+        public:
+            promise_type() : m_pValue(NULL) { }
+
+            self_type get_return_object() noexcept {
+                return self_type(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return { }; }
+            std::suspend_always final_suspend() noexcept { return { }; }
+
+            // the yielded value lives until the generator is resumed
+            std::suspend_always yield_value(value_type& value) noexcept {
+                m_pValue = &value; return { };
+            }
+            std::suspend_always yield_value(value_type&& value) noexcept {
+                m_pValue = &value; return { };
+            }
+
+            void return_void() { }
+            void unhandled_exception() { abort(); }
+
+            // no co_await in a generator
+            template <typename U>
+            std::suspend_never await_transform(U&& value) = delete;
+
+            reference value() { return *m_pValue; }
+        private:
+            pointer m_pValue;
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        /**
+         * The end of the generator
+         */
+        struct sentinel { };
+
+        class iterator {
+        public:
+            explicit iterator(handle_type hCoroutine) : m_hCoroutine(hCoroutine) { }
+
+            iterator& operator ++ () {
+                m_hCoroutine.resume();
+                return *this;
+            }
+
+            reference operator * () const { return m_hCoroutine.promise().value(); }
+            pointer operator -> () const { return &m_hCoroutine.promise().value(); }
+
+            bool operator == (sentinel) const { return m_hCoroutine.done(); }
+            bool operator != (sentinel) const { return !m_hCoroutine.done(); }
+        private:
+            handle_type m_hCoroutine;
+        };
+
+        explicit generator(handle_type hCoroutine) : m_hCoroutine(hCoroutine) { }
+        generator(self_type&& other) : m_hCoroutine(other.m_hCoroutine) { other.m_hCoroutine = nullptr; }
+
+        ~generator() { if(m_hCoroutine) m_hCoroutine.destroy(); }
+
+        generator(const self_type&) = delete;
+        self_type& operator = (const self_type&) = delete;
+
+        self_type& operator = (self_type&& other) {
+            if(this != &other) {
+                if(m_hCoroutine) m_hCoroutine.destroy();
+                m_hCoroutine = other.m_hCoroutine;
+                other.m_hCoroutine = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * Run the generator to the first value
+         */
+        iterator begin() {
+            if(m_hCoroutine) m_hCoroutine.resume();
+            return iterator(m_hCoroutine);
+        }
+        sentinel end() { return sentinel(); }
+    private:
+        handle_type m_hCoroutine;
+    };
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
+
+#endif
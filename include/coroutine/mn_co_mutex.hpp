@@ -0,0 +1,79 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_CO_MUTEX_H_
+#define _MINLIB_MN_CO_MUTEX_H_
+
+#include "../mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include "mn_co_event.hpp"
+
+namespace mn {
+    /**
+     * A mutex for coroutines, locked with co_await co_lock(mutex).
+     *
+     * The mutex has no owner task, a coroutine can be resumed on a other executor task
+     * and unlock the mutex there. A FreeRTOS mutex must be unlocked from the task, that
+     * has locked it, and can not used for this. The unlock resumes the waiting coroutines,
+     * one of them gets the lock. There is no priority inheritance.
+     *
+     * @ingroup coroutine
+     */
+    class basic_co_mutex {
+    public:
+        basic_co_mutex() : m_bLocked(false) { }
+
+        /**
+         * Try to lock the mutex, without waiting
+         * @return true if the Lock was acquired, false when not
+         */
+        bool try_lock() {
+            bool _bExpected = false;
+
+            return __atomic_compare_exchange_n(&m_bLocked, &_bExpected, true, false,
+                                               __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Unlock the mutex and resume the waiting coroutines, can call from every task
+         */
+        void unlock() {
+            __atomic_store_n(&m_bLocked, false, __ATOMIC_SEQ_CST);
+
+            m_Event.notify_all();
+        }
+
+        bool is_locked() const { return __atomic_load_n(&m_bLocked, __ATOMIC_RELAXED); }
+
+        /**
+         * Get the event for the waiting coroutines
+         */
+        basic_co_event& get_co_event() { return m_Event; }
+    private:
+        volatile bool m_bLocked;
+        basic_co_event m_Event;
+    };
+
+    using co_mutex_t = basic_co_mutex;
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
+
+#endif
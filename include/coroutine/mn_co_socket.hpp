@@ -0,0 +1,163 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_CO_SOCKET_H_
+#define _MINLIB_MN_CO_SOCKET_H_
+
+#include "../mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include <errno.h>
+
+#include "../net/mn_basic_stream_ip_socket.hpp"
+#include "mn_co_event.hpp"
+#include "mn_co_executor.hpp"
+
+namespace mn {
+    /**
+     * The task, that waits with lwip_select for the sockets of the awaiting coroutines and
+     * resumes them, when data is received. The task is started with the first socket awaiter.
+     * A loopback UDP socket wakes the task, when a socket is added (needs LWIP_NETIF_LOOPBACK,
+     * the ESP-IDF default).
+     *
+     * @ingroup coroutine
+     */
+    class basic_co_select {
+    public:
+        /**
+         * A socket of a awaiting coroutine, lives in the awaiter
+         */
+        struct entry {
+            int iSocket;
+            basic_co_event* pEvent;
+            entry* pNext;
+            bool bLinked;
+        };
+
+        /**
+         * Get the select task, for all executors
+         */
+        static basic_co_select& instance();
+
+        /**
+         * Wait for data on the socket of the entry, the event of the entry is notified once
+         *
+         * @return ERR_COROUTINE_OK or ERR_COROUTINE_CANTCREATE when the task or the wake socket
+         *         can not created
+         */
+        int add(entry* pEntry);
+
+        /**
+         * Remove the entry, after this the event is not notified
+         */
+        void remove(entry* pEntry);
+    private:
+        /**
+         * The task, that runs the select loop
+         */
+        class co_select_task : public basic_task {
+        public:
+            explicit co_select_task(basic_co_select* parent);
+        protected:
+            virtual int on_task() override;
+        private:
+            basic_co_select* m_pParent;
+        };
+
+        basic_co_select();
+
+        int create();
+        void run();
+        void wake();
+    private:
+        mutex_t m_Lock;
+        entry* m_pEntries;
+        co_select_task* m_pTask;
+        int m_iWakeSocket;
+        struct sockaddr_in m_WakeAddress;
+    };
+
+    /**
+     * Await data from a stream socket, the executor task does not block in lwip_recv.
+     * The select task (basic_co_select) resumes the coroutine, when data is received.
+     *
+     * @code
+     * char buffer[128];
+     * int received = co_await mn::co_recive(socket, buffer, sizeof(buffer));
+     * @endcode
+     *
+     * @tparam TSocket net::basic_stream_ip_socket or net::basic_stream_ip6_socket
+     * @return The number of received bytes, 0 when the connection is closed and -1 on error or timeout
+     * @ingroup coroutine
+     */
+    template <class TSocket>
+    class basic_co_recive : public basic_co_awaiter {
+    public:
+        basic_co_recive(TSocket& socket, char* buffer, int size, unsigned int timeout = portMAX_DELAY)
+            : basic_co_awaiter(timeout), m_Socket(socket), m_pBuffer(buffer), m_iSize(size),
+              m_iResult(-1), m_bError(false), m_Event(), m_Entry() { }
+
+        int await_resume() { return m_iResult; }
+    protected:
+        virtual bool poll() override {
+            if(m_bError) return true;
+
+            m_iResult = m_Socket.recive(m_pBuffer, m_iSize, net::socket_flags::non_blocking);
+
+            if(m_iResult >= 0) return true;
+
+            // no data now - wait for the select task, all other errors are done
+            return (errno != EAGAIN) && (errno != EWOULDBLOCK);
+        }
+
+        virtual basic_co_event* get_event() override { return &m_Event; }
+
+        virtual void on_wait() override {
+            m_Entry.iSocket = m_Socket.get_handle();
+            m_Entry.pEvent = &m_Event;
+
+            if(basic_co_select::instance().add(&m_Entry) != ERR_COROUTINE_OK) {
+                m_iResult = -1;
+                m_bError = true;
+            }
+        }
+
+        virtual void on_done() override {
+            basic_co_select::instance().remove(&m_Entry);
+        }
+    private:
+        TSocket& m_Socket;
+        char* m_pBuffer;
+        int m_iSize;
+        int m_iResult;
+        bool m_bError;
+        basic_co_event m_Event;
+        basic_co_select::entry m_Entry;
+    };
+
+    template <class TSocket>
+    basic_co_recive<TSocket> co_recive(TSocket& socket, char* buffer, int size,
+                                       unsigned int timeout = portMAX_DELAY) {
+        return basic_co_recive<TSocket>(socket, buffer, size, timeout);
+    }
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
+
+#endif
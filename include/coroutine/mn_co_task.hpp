@@ -0,0 +1,233 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_CO_TASK_H_
+#define _MINLIB_MN_CO_TASK_H_
+
+#include "../mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include <coroutine>
+#include <stdlib.h>
+
+#include "../mn_future.hpp"
+#include "mn_co_executor.hpp"
+
+namespace mn {
+    template <typename T> class co_task;
+
+    namespace internal {
+        /**
+         * The common part of all co_task promises
+         */
+        class co_promise_base {
+        public:
+            /**
+             * Resume the awaiting coroutine or destroy a detached coroutine
+             */
+            struct final_awaiter {
+                bool await_ready() noexcept { return false; }
+
+                template <typename TPromise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> hCoroutine) noexcept {
+                    co_promise_base& _promise = hCoroutine.promise();
+
+                    if(_promise.m_hContinuation)
+                        return _promise.m_hContinuation;
+
+                    if(_promise.m_bDetached)
+                        hCoroutine.destroy();
+
+                    return std::noop_coroutine();
+                }
+                void await_resume() noexcept { }
+            };
+
+            co_promise_base() : m_hContinuation(), m_pExecutor(NULL), m_bDetached(false) { }
+
+            // a co_task starts when it is awaited or spawned
+            std::suspend_always initial_suspend() noexcept { return { }; }
+            final_awaiter final_suspend() noexcept { return { }; }
+
+            void unhandled_exception() { abort(); }
+
+            basic_co_executor* get_executor() { return m_pExecutor; }
+            void set_executor(basic_co_executor* pExecutor) { m_pExecutor = pExecutor; }
+
+            void set_continuation(std::coroutine_handle<> hContinuation) { m_hContinuation = hContinuation; }
+            void set_detached(bool bDetached) { m_bDetached = bDetached; }
+        private:
+            std::coroutine_handle<> m_hContinuation;
+            basic_co_executor* m_pExecutor;
+            bool m_bDetached;
+        };
+
+        template <typename T>
+        class co_promise : public co_promise_base {
+        public:
+            co_task<T> get_return_object() noexcept;
+
+            template <typename U>
+            void return_value(U&& value) { m_Value.construct(mn::forward<U>(value)); }
+
+            T& get_value() { return m_Value.get(); }
+        private:
+            future_value<T> m_Value;
+        };
+
+        template <>
+        class co_promise<void> : public co_promise_base {
+        public:
+            co_task<void> get_return_object() noexcept;
+
+            void return_void() { }
+            void get_value() { }
+        };
+    }
+
+    /**
+     * A lazy coroutine, that returns a T. A co_task starts when it is awaited
+     * from a other co_task or spawned on a executor with co_spawn.
+     *
+     * @code
+     * mn::co_task<int> read_value(mn::queue::queue_t& queue) {
+     *     int value = 0;
+     *     if(co_await mn::co_dequeue(queue, &value) != ERR_QUEUE_OK) co_return -1;
+     *     co_return value;
+     * }
+     * @endcode
+     *
+     * @tparam T The type of the result, can be void
+     * @ingroup coroutine
+     */
+    template <typename T>
+    class co_task {
+    public:
+        using promise_type = internal::co_promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+        using self_type = co_task<T>;
+
+        co_task() : m_hCoroutine() { }
+        explicit co_task(handle_type hCoroutine) : m_hCoroutine(hCoroutine) { }
+
+        co_task(self_type&& other) : m_hCoroutine(other.m_hCoroutine) { other.m_hCoroutine = nullptr; }
+
+        ~co_task() { if(m_hCoroutine) m_hCoroutine.destroy(); }
+
+        co_task(const self_type&) = delete;
+        self_type& operator = (const self_type&) = delete;
+
+        self_type& operator = (self_type&& other) {
+            if(this != &other) {
+                if(m_hCoroutine) m_hCoroutine.destroy();
+                m_hCoroutine = other.m_hCoroutine;
+                other.m_hCoroutine = nullptr;
+            }
+            return *this;
+        }
+
+        bool valid() const { return (bool)m_hCoroutine; }
+        bool is_done() const { return m_hCoroutine && m_hCoroutine.done(); }
+
+        /**
+         * Give the ownership of the coroutine to the caller
+         */
+        handle_type release() {
+            handle_type _hCoroutine = m_hCoroutine;
+            m_hCoroutine = nullptr;
+            return _hCoroutine;
+        }
+
+        bool await_ready() const { return !m_hCoroutine || m_hCoroutine.done(); }
+
+        /**
+         * Start this co_task on the executor of the awaiting coroutine
+         */
+        template <typename TPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> hAwaiting) {
+            m_hCoroutine.promise().set_continuation(hAwaiting);
+            m_hCoroutine.promise().set_executor(hAwaiting.promise().get_executor());
+
+            return m_hCoroutine;
+        }
+
+        T await_resume() {
+            if constexpr (is_void<T>::value) {
+                return;
+            } else {
+                return mn::move(m_hCoroutine.promise().get_value());
+            }
+        }
+    private:
+        handle_type m_hCoroutine;
+    };
+
+    namespace internal {
+        template <typename T>
+        co_task<T> co_promise<T>::get_return_object() noexcept {
+            return co_task<T>(co_task<T>::handle_type::from_promise(*this));
+        }
+
+        inline co_task<void> co_promise<void>::get_return_object() noexcept {
+            return co_task<void>(co_task<void>::handle_type::from_promise(*this));
+        }
+
+        template <typename T>
+        co_task<void> co_spawn_wrapper(co_task<T> task, promise<T> result) {
+            if constexpr (is_void<T>::value) {
+                co_await task;
+                result.set_value();
+            } else {
+                result.set_value(co_await task);
+            }
+        }
+    }
+
+    /**
+     * Start a co_task on a executor
+     *
+     * @param executor The executor to run the co_task
+     * @param task The co_task to start
+     * @return The future for the result of the co_task, no state when no memory. When the
+     *         co_task can not scheduled, the future get the error ERR_FUTURE_BROKEN
+     */
+    template <typename T>
+    future<T> co_spawn(basic_co_executor& executor, co_task<T>&& task) {
+        promise<T> _promise;
+        future<T> _future = _promise.get_future();
+
+        if(!_future.valid()) return _future;
+
+        co_task<void> _wrapper = internal::co_spawn_wrapper<T>(mn::move(task), mn::move(_promise));
+
+        auto _hCoroutine = _wrapper.release();
+        _hCoroutine.promise().set_executor(&executor);
+        _hCoroutine.promise().set_detached(true);
+
+        if(executor.schedule(_hCoroutine) != ERR_COROUTINE_OK) {
+            // destroy the promise in the frame, the future get ERR_FUTURE_BROKEN
+            _hCoroutine.destroy();
+        }
+        return _future;
+    }
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
+
+#endif
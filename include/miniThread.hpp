@@ -33,9 +33,19 @@
 #include "mn_def.hpp"
 #include "mn_version.hpp"
 #include "mn_autolock.hpp"
+#include "mn_shared_mutex.hpp"
+#include "mn_seqlock.hpp"
+#include "mn_rcu.hpp"
+#include "mn_hazard_pointer.hpp"
+#include "mn_lock_profiler.hpp"
+#include "mn_latch.hpp"
+#include "mn_barrier.hpp"
 #include "mn_micros.hpp"
 #include "mn_task.hpp"
 #include "mn_tasklet.hpp"
+#include "mn_mailbox_task.hpp"
+#include "mn_actor.hpp"
+#include "mn_event_bus.hpp"
 #include "mn_eventgroup.hpp"
 
 #include "mn_critical.hpp"
@@ -48,10 +58,16 @@
 
 #include "queue/mn_queue.hpp"
 #include "queue/mn_binaryqueue.hpp"
+#include "queue/mn_batch_queue.hpp"
+#include "queue/mn_typed_queue.hpp"
+#include "mn_channel.hpp"
 #include "queue/mn_deque.hpp"
 #include "queue/mn_workqueue.hpp"
+#include "mn_future.hpp"
 
 #include "mn_ringbuffer.hpp"
+#include "container/mn_spsc_ring.hpp"
+#include "container/mn_lockfree_stack.hpp"
 #include "mn_shared.hpp"
 
 #include "mn_atomic.hpp"
@@ -0,0 +1,550 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_ACTOR_
+#define MINLIB_ESP32_ACTOR_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <stdint.h>
+
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+#include "mn_mutex.hpp"
+#include "mn_task.hpp"
+#include "mn_future.hpp"
+#include "mn_typetraits.hpp"
+#include "queue/mn_queue.hpp"
+#include "queue/mn_typed_queue.hpp"
+
+namespace mn {
+    namespace ext {
+        class basic_actor_system;
+
+        /**
+         * @brief What happens, when a message is posted to a full mailbox
+         * @ingroup actor
+         */
+        enum class actor_overflow {
+            Block,          /*!< Wait for space, until the timeout */
+            DropOldest,     /*!< Drop the oldest message in the mailbox */
+            DropNew         /*!< Drop the new message and return ERR_ACTOR_FULL */
+        };
+
+        /**
+         * @brief What the supervision does with a actor, that failed on a message
+         * @ingroup actor
+         */
+        enum class actor_directive {
+            Resume,         /*!< Ignore the failure and handle the next message */
+            Restart,        /*!< Call on_restart, until MN_THREAD_CONFIG_ACTOR_MAX_RESTARTS */
+            Stop            /*!< Stop the actor, all pending asks get ERR_ACTOR_STOPPED */
+        };
+
+        /**
+         * @brief The reply type of a actor without a reply
+         * @ingroup actor
+         */
+        struct actor_no_reply { };
+
+        /**
+         * @brief The untyped part of a actor, the scheduling and the supervision.
+         *
+         * A actor has no own task. When a message is posted, the actor is put
+         * in the ready queue of the basic_actor_system and one of the worker tasks
+         * handles up to MN_THREAD_CONFIG_ACTOR_THROUGHPUT messages. A actor is never
+         * run from two workers at the same time.
+         *
+         * @ingroup actor
+         */
+        class basic_actor_base {
+            friend class basic_actor_system;
+        public:
+            /**
+             * @param overflow What happens, when a message is posted to a full mailbox
+             * @param directive What the supervision does, when the actor failed
+             */
+            basic_actor_base(actor_overflow overflow, actor_directive directive);
+            virtual ~basic_actor_base() { }
+
+            basic_actor_base(const basic_actor_base&) = delete;
+            basic_actor_base& operator=(const basic_actor_base&) = delete;
+
+            /**
+             * @brief Stop the actor. Messages in the mailbox are dropped and all
+             * pending asks get ERR_ACTOR_STOPPED. The slot of the actor in the
+             * system is released, when a worker has called on_stop.
+             */
+            void stop();
+
+            /**
+             * @brief Is the actor stopped?
+             */
+            bool is_stopped() const { return m_bStopped; }
+            /**
+             * @brief Is the actor spawned in a actor system?
+             */
+            bool is_spawned() const { return m_pSystem != NULL; }
+            /**
+             * @brief Get the actor system of this actor, NULL when not spawned
+             */
+            basic_actor_system* get_system() const { return m_pSystem; }
+            /**
+             * @brief How many times the actor was restarted by the supervision
+             */
+            uint32_t get_restarts() const { return m_uiRestarts; }
+            /**
+             * @brief How many messages the actor has handled
+             */
+            uint32_t get_processed() const { return m_uiProcessed; }
+            /**
+             * @brief Get the overflow policy of the mailbox
+             */
+            actor_overflow get_overflow() const { return m_eOverflow; }
+        protected:
+            /**
+             * @brief Called on spawn, before the first message is handled
+             */
+            virtual void on_start() { }
+            /**
+             * @brief Called from a worker, when the actor is stopped
+             */
+            virtual void on_stop() { }
+            /**
+             * @brief Called from a worker, when the supervision restarts the actor.
+             * The default calls on_stop and on_start.
+             *
+             * @param error The error of the failed message
+             */
+            virtual void on_restart(int error) { MN_UNUSED_VARIABLE(error); on_stop(); on_start(); }
+
+            /**
+             * @brief Create the mailbox, called on spawn
+             */
+            virtual int create_mailbox() = 0;
+            /**
+             * @brief Handle up to uiMax messages
+             * @return The number of handled messages
+             */
+            virtual unsigned int process(unsigned int uiMax) = 0;
+            /**
+             * @brief Has the mailbox messages?
+             */
+            virtual bool has_messages() = 0;
+            /**
+             * @brief Drop all messages, pending asks get the error
+             */
+            virtual void drain(int error) = 0;
+
+            /**
+             * @brief Put the actor in the ready queue, when it is not already there
+             */
+            int schedule();
+            /**
+             * @brief Apply the supervision, called from process on a failed message
+             */
+            void failed(int error);
+        private:
+            /**
+             * @brief Run by a worker task, when the actor is ready
+             */
+            void run();
+        protected:
+            basic_actor_system* m_pSystem;
+            actor_overflow m_eOverflow;
+            actor_directive m_eDirective;
+
+            atomic_uint32_t m_uiScheduled;
+            volatile bool m_bStopped;
+            bool m_bStopDone;
+
+            uint32_t m_uiRestarts;
+            uint32_t m_uiProcessed;
+        };
+
+        namespace internal {
+            template <typename TReply>
+            struct actor_reply {
+                using type = TReply;
+                static void set(basic_future_state<TReply>* pState, type& reply) { pState->set_value(mn::move(reply)); }
+            };
+
+            template <>
+            struct actor_reply<void> {
+                using type = actor_no_reply;
+                static void set(basic_future_state<void>* pState, type&) { pState->set_value(); }
+            };
+        }
+
+        /**
+         * @brief The typed interface of a actor: tell, ask and the message handler.
+         *
+         * @tparam TMessage The message type, stored by value and must be trivially copyable
+         * @tparam TReply The reply type of ask, void for a actor without a reply
+         *
+         * @ingroup actor
+         */
+        template <typename TMessage, typename TReply = void>
+        class basic_typed_actor : public basic_actor_base {
+            static_assert(is_trivially_copyable<TMessage>::value, "the message of a actor must be trivially copyable");
+        public:
+            using message_type = TMessage;
+            using reply_type = TReply;
+            using result_type = typename internal::actor_reply<TReply>::type;
+            using state_type = basic_future_state<TReply>;
+
+            /**
+             * @brief A message in the mailbox, with the reply state of a ask
+             */
+            struct envelope {
+                message_type message;
+                state_type* reply;
+            };
+
+            basic_typed_actor(actor_overflow overflow, actor_directive directive)
+                : basic_actor_base(overflow, directive) { }
+
+            /**
+             * @brief Post a message to the actor (fire and forget)
+             *
+             * @param msg The message
+             * @param timeout How long to wait for space, only used by actor_overflow::Block
+             *
+             * @note Called from a worker task of the system (a actor tells a other actor),
+             * actor_overflow::Block never waits: a worker blocked on a full mailbox can
+             * be the worker, that must drain it. Then ERR_ACTOR_WOULDBLOCK is returned.
+             *
+             * @return ERR_ACTOR_OK, ERR_ACTOR_FULL, ERR_ACTOR_WOULDBLOCK, ERR_ACTOR_STOPPED
+             * or ERR_ACTOR_NOSYSTEM
+             */
+            int tell(const message_type& msg, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                envelope _env = { msg, NULL };
+                return post(_env, timeout);
+            }
+
+            /**
+             * @brief Post a message to the actor and get the reply with a future (request/reply)
+             *
+             * The future gets the error, when the message can't posted, is dropped,
+             * the actor failed (the error of on_receive) or is stopped.
+             *
+             * @param msg The message
+             * @param timeout How long to wait for space, only used by actor_overflow::Block
+             */
+            future<TReply> ask(const message_type& msg, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                state_type* _pState = state_type::create();
+                if(_pState == NULL) return future<TReply>();
+
+                future<TReply> _future(_pState);
+
+                // the reference of the envelope, released when the reply is set
+                _pState->add_ref();
+
+                envelope _env = { msg, _pState };
+                int _iError = post(_env, timeout);
+
+                if(_iError != ERR_ACTOR_OK) {
+                    _pState->set_error(_iError);
+                    _pState->release();
+                }
+                return _future;
+            }
+        protected:
+            /**
+             * @brief Implementation of your actual message code, called from a worker task.
+             * @note You must override this function.
+             *
+             * @param msg The message
+             * @param reply The reply for ask, ignored for tell
+             *
+             * @return ERR_ACTOR_OK or a error, a error is given to the supervision
+             */
+            virtual int on_receive(const message_type& msg, result_type& reply) = 0;
+
+            /**
+             * @brief Add the envelope to the mailbox
+             */
+            virtual int post(const envelope& env, unsigned int timeout) = 0;
+
+            /**
+             * @brief Handle one message and set the reply of a ask
+             */
+            void dispatch(envelope& env) {
+                result_type _reply = result_type();
+                int _iError = on_receive(env.message, _reply);
+
+                if(env.reply != NULL) {
+                    if(_iError == ERR_ACTOR_OK)
+                        internal::actor_reply<TReply>::set(env.reply, _reply);
+                    else
+                        env.reply->set_error(_iError);
+
+                    env.reply->release();
+                }
+                if(_iError != ERR_ACTOR_OK) failed(_iError);
+            }
+
+            /**
+             * @brief Drop a message, a pending ask gets the error
+             */
+            static void reject(envelope& env, int error) {
+                if(env.reply != NULL) {
+                    env.reply->set_error(error);
+                    env.reply->release();
+                }
+            }
+        };
+
+        /**
+         * @brief A actor with a bounded mailbox
+         *
+         * @code
+         * struct adc_request { uint8_t channel; };
+         *
+         * class adc_actor : public mn::ext::basic_actor<adc_request, uint16_t> {
+         *     int on_receive(const adc_request& msg, uint16_t& reply) override {
+         *         reply = adc_read(msg.channel);
+         *         return ERR_ACTOR_OK;
+         *     }
+         * };
+         *
+         * mn::ext::actor_system_t system;
+         * adc_actor adc;
+         * system.spawn(adc);
+         * system.create();
+         *
+         * uint16_t value;
+         * adc.ask(adc_request{ 3 }).get(value, 100);
+         * @endcode
+         *
+         * @tparam TMessage The message type, stored by value and must be trivially copyable
+         * @tparam TReply The reply type of ask, void for a actor without a reply
+         * @tparam TMailboxSize Maximal number of messages in the mailbox
+         *
+         * @ingroup actor
+         */
+        template <typename TMessage, typename TReply = void,
+                  unsigned int TMailboxSize = MN_THREAD_CONFIG_ACTOR_MAILBOX_SIZE>
+        class basic_actor : public basic_typed_actor<TMessage, TReply> {
+            using base_type = basic_typed_actor<TMessage, TReply>;
+        public:
+            using envelope = typename base_type::envelope;
+            using queue_type = queue::typed_queue<envelope, TMailboxSize>;
+
+            /**
+             * @param overflow What happens, when a message is posted to a full mailbox
+             * @param directive What the supervision does, when the actor failed
+             */
+            explicit basic_actor(actor_overflow overflow = actor_overflow::Block,
+                                 actor_directive directive = actor_directive::Restart)
+                : base_type(overflow, directive), m_qeMailbox() { }
+
+            /**
+             * @brief Get the number of messages in the mailbox
+             */
+            unsigned int get_pending() { return m_qeMailbox.get_num_items(); }
+            /**
+             * @brief Get the maximal number of messages in the mailbox
+             */
+            static constexpr unsigned int capacity() { return TMailboxSize; }
+        protected:
+            virtual int create_mailbox() override {
+                int _iError = m_qeMailbox.create();
+                return (_iError == ERR_QUEUE_OK || _iError == ERR_QUEUE_ALREADYINIT) ? ERR_ACTOR_OK : ERR_ACTOR_CANTCREATE;
+            }
+
+            virtual int post(const envelope& env, unsigned int timeout) override {
+                if(this->m_pSystem == NULL) return ERR_ACTOR_NOSYSTEM;
+                if(this->m_bStopped) return ERR_ACTOR_STOPPED;
+
+                switch(this->m_eOverflow) {
+                case actor_overflow::Block:
+                    // a worker must not wait for a other worker, all can wait on full mailboxes
+                    if(this->m_pSystem->is_worker()) {
+                        if(m_qeMailbox.enqueue(env, 0) != ERR_QUEUE_OK) return ERR_ACTOR_WOULDBLOCK;
+                    } else if(m_qeMailbox.enqueue(env, timeout) != ERR_QUEUE_OK) {
+                        return ERR_ACTOR_FULL;
+                    }
+                    break;
+                case actor_overflow::DropNew:
+                    if(m_qeMailbox.enqueue(env, 0) != ERR_QUEUE_OK) return ERR_ACTOR_FULL;
+                    break;
+                case actor_overflow::DropOldest:
+                    while(m_qeMailbox.enqueue(env, 0) != ERR_QUEUE_OK) {
+                        envelope _old;
+                        if(m_qeMailbox.dequeue(_old, 0) == ERR_QUEUE_OK)
+                            base_type::reject(_old, ERR_ACTOR_DROPPED);
+                    }
+                    break;
+                }
+                this->schedule();
+                return ERR_ACTOR_OK;
+            }
+
+            virtual unsigned int process(unsigned int uiMax) override {
+                unsigned int _uiCount = 0;
+                envelope _env;
+
+                while(_uiCount < uiMax && !this->m_bStopped &&
+                      m_qeMailbox.dequeue(_env, 0) == ERR_QUEUE_OK) {
+                    _uiCount++;
+                    this->dispatch(_env);
+                }
+                return _uiCount;
+            }
+
+            virtual bool has_messages() override {
+                return !m_qeMailbox.is_empty();
+            }
+
+            virtual void drain(int error) override {
+                envelope _env;
+
+                while(m_qeMailbox.dequeue(_env, 0) == ERR_QUEUE_OK)
+                    base_type::reject(_env, error);
+            }
+        protected:
+            queue_type m_qeMailbox;
+        };
+
+        /**
+         * @brief A typed reference to a actor, the reference is not the owner.
+         * @ingroup actor
+         */
+        template <typename TMessage, typename TReply = void>
+        class actor_ref {
+        public:
+            using actor_type = basic_typed_actor<TMessage, TReply>;
+
+            actor_ref() : m_pActor(NULL) { }
+            actor_ref(actor_type& actor) : m_pActor(&actor) { }
+
+            int tell(const TMessage& msg, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return m_pActor ? m_pActor->tell(msg, timeout) : ERR_ACTOR_NOSYSTEM;
+            }
+
+            future<TReply> ask(const TMessage& msg, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return m_pActor ? m_pActor->ask(msg, timeout) : future<TReply>();
+            }
+
+            bool valid() const { return m_pActor != NULL; }
+            actor_type* get() const { return m_pActor; }
+
+            bool operator == (const actor_ref& other) const { return m_pActor == other.m_pActor; }
+            bool operator != (const actor_ref& other) const { return m_pActor != other.m_pActor; }
+        private:
+            actor_type* m_pActor;
+        };
+
+        /**
+         * @brief Runs many actors on a small pool of worker tasks
+         *
+         * @note The actors must live longer as the system or must stopped and the system
+         * destroyed, before a actor is destroyed.
+         *
+         * @ingroup actor
+         */
+        class basic_actor_system {
+            friend class basic_actor_base;
+        public:
+            /**
+             * @param uiPriority The priority of the worker tasks
+             * @param usStackDepth The stack size of the worker tasks
+             */
+            explicit basic_actor_system(basic_task::priority uiPriority = MN_THREAD_CONFIG_ACTOR_PRIORITY,
+                                        uint16_t usStackDepth = MN_THREAD_CONFIG_ACTOR_STACKSIZE);
+            virtual ~basic_actor_system();
+
+            basic_actor_system(const basic_actor_system&) = delete;
+            basic_actor_system& operator=(const basic_actor_system&) = delete;
+
+            /**
+             * @brief Create and start the worker tasks
+             *
+             * @return ERR_ACTOR_OK, ERR_ACTOR_ALREADYINIT or ERR_ACTOR_CANTCREATE
+             */
+            int create(int iCore = MN_THREAD_CONFIG_DEFAULT_WORKQUEUE_CORE);
+            /**
+             * @brief Stop and delete the worker tasks, waits until each worker is ended
+             */
+            void destroy();
+
+            /**
+             * @brief Add the actor to this system, on_start is called in the context of the caller
+             *
+             * @return ERR_ACTOR_OK, ERR_ACTOR_ALREADYINIT, ERR_ACTOR_TOOMANY or ERR_ACTOR_CANTCREATE
+             */
+            int spawn(basic_actor_base& actor);
+
+            /**
+             * @brief Get the number of spawned and not stopped actors
+             */
+            uint32_t get_num_actors() const { return m_uiActors.load(); }
+            /**
+             * @brief Get the number of running worker tasks
+             */
+            uint8_t get_num_worker() const { return m_uiWorkers; }
+            /**
+             * @brief Are the worker tasks running?
+             */
+            bool is_running() const { return m_bRunning; }
+            /**
+             * @brief Is the caller one of the worker tasks of this system?
+             */
+            bool is_worker() const;
+        protected:
+            /**
+             * @brief The supervision, called from a worker, when a actor failed on a message.
+             * The default returns the directive of the actor.
+             */
+            virtual actor_directive on_failure(basic_actor_base& actor, int error);
+
+            /**
+             * @brief Add the actor to the ready queue
+             */
+            int schedule(basic_actor_base* actor);
+        private:
+            class worker_task : public basic_task {
+            public:
+                worker_task(const char* strName, basic_task::priority uiPriority,
+                            uint16_t usStackDepth, basic_actor_system* pSystem);
+            protected:
+                virtual int on_task() override;
+            private:
+                basic_actor_system* m_pSystem;
+            };
+        protected:
+            queue::queue_t m_qeReady;
+            mutex_t m_mutex;
+            worker_task* m_pWorkers[MN_THREAD_CONFIG_ACTOR_WORKERS];
+            /** The task handles of the workers for is_worker, a copy so no worker object is touched */
+            volatile xTaskHandle m_hWorkers[MN_THREAD_CONFIG_ACTOR_WORKERS];
+
+            basic_task::priority m_uiPriority;
+            uint16_t m_usStackDepth;
+            uint8_t m_uiWorkers;
+            atomic_uint32_t m_uiActors;
+            volatile bool m_bRunning;
+        };
+
+        using actor_system_t = basic_actor_system;
+    }
+}
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_ADAPTIVE_MUTEX_
+#define MINLIB_ESP32_ADAPTIVE_MUTEX_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <time.h>
+
+#include "mn_error.hpp"
+#include "mn_lock.hpp"
+
+namespace mn {
+  /**
+   *  A adaptive spin-then-block mutex for short critical sections.
+   *
+   *  - The uncontended lock and unlock are one atomic CAS, without a kernel call.
+   *  - When the owner is running on the other core, the lock spins up to
+   *    MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN times, the owner will release the lock soon.
+   *  - Otherwise the task blocks on a FreeRTOS mutex. The kernel orders the waiters by
+   *    priority and raises the priority of the owner (the kernel priority inheritance).
+   *    While tasks are waiting, the unlock hands the lock over to the next waiter and the
+   *    fast path is closed, so every owner holds the FreeRTOS mutex and can be raised.
+   *
+   *  These objects are not recursively acquirable and can not use in the ISR Context.
+   *
+   * @note A owner, that got the lock with the atomic fast path, holds not the FreeRTOS mutex
+   * and is not raised by the first waiter. Keep the critical sections short.
+   *
+   * @note Select it for the whole library with MN_THREAD_CONFIG_LOCK_TYPE = MN_THREAD_CONFIG_ADAPTIVE_MUTEX
+   *
+   * @ingroup mutex
+   * @ingroup lock
+   */
+  class basic_adaptive_mutex : public ILockObject {
+  public:
+    basic_adaptive_mutex();
+    virtual ~basic_adaptive_mutex();
+
+    /**
+     *  Lock the mutex.
+     *
+     *  @param timeout How long to wait to get the Lock until giving up.
+     *  @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out
+     *  or when called from the ISR Context.
+     */
+    virtual int lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT);
+
+    /**
+     *  Lock the mutex with a absolute timeout
+     */
+    virtual int time_lock(const struct timespec *timeout);
+
+    /**
+     *  Unlock the mutex.
+     *
+     *  @return ERR_MUTEX_OK if the Lock was released, ERR_MUTEX_UNLOCK when the caller
+     *  is not the owner or when called from the ISR Context.
+     */
+    virtual int unlock();
+
+    /**
+     * Try to lock the mutex, only the atomic fast path
+     *
+     * @return true if the Lock was acquired, false when not
+     */
+    virtual bool try_lock();
+
+    virtual bool is_initialized() const   { return m_pMutex != NULL; }
+
+    virtual bool is_locked() const;
+
+    /**
+     * Get the task, that owns the mutex or NULL when not locked
+     */
+    TaskHandle_t get_owner() const;
+  private:
+    int lock_slow(TaskHandle_t pSelf, unsigned int timeout);
+    bool spin(TaskHandle_t pSelf);
+    void leave_slow();
+  private:
+    /**
+     * The owner task, the lowest bits are the flags of the owner word
+     */
+    volatile uintptr_t m_uiOwner;
+    /**
+     * How many tasks are in the blocking path
+     */
+    volatile uint32_t m_uiWaiting;
+    /**
+     * The task, that holds the FreeRTOS mutex and waits for a fast path owner
+     */
+    volatile TaskHandle_t m_pWaiter;
+    /**
+     * The FreeRTOS mutex for the blocking path
+     */
+    SemaphoreHandle_t m_pMutex;
+  #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+    StaticSemaphore_t m_MutexBuffer;
+  #endif
+  };
+
+  using adaptive_mutex_t = basic_adaptive_mutex;
+}
+
+#endif
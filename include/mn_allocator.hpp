@@ -25,6 +25,11 @@
 
 #include "allocator/mn_allocator_typetraits.hpp"
 #include "allocator/mn_default_allocator.hpp"
+#include "allocator/mn_basic_slab_allocator.hpp"
+#include "allocator/mn_basic_arena_allocator.hpp"
+#include "allocator/mn_basic_tcache_allocator.hpp"
+#include "allocator/mn_basic_tlsf_allocator.hpp"
+#include "allocator/mn_basic_allocator_profile_filter.hpp"
 
 #define config_haveDefaultAllocator 1
 
@@ -33,7 +33,7 @@ namespace mn {
 
 
     template<typename T>
-    using atomic_ptr            = _atomic_ptr<T*>;
+    using atomic_ptr            = _atomic_ptr<T>;
 
 
     // Signad basic types
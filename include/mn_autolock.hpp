@@ -23,6 +23,7 @@
 #include "mn_lock.hpp"
 
 #include "mn_mutex.hpp"
+#include "mn_adaptive_mutex.hpp"
 #include "mn_semaphore.hpp"
 #include "mn_null_lock.hpp"
 
@@ -50,6 +51,11 @@ namespace mn {
    */
   using automutx_t = basic_autolock<mutex_t>;
 
+  /**
+   * A autolock type for adaptive_mutex_t objects
+   */
+  using autoamutx_t = basic_autolock<adaptive_mutex_t>;
+
   #if (MN_THREAD_CONFIG_RECURSIVE_MUTEX == MN_THREAD_CONFIG_YES)
   //using autoremutx_t = basic_autolock<remutex_t>;
   #endif
@@ -60,6 +66,8 @@ namespace mn {
     using LockType_t = mn::binary_semaphore_t;
   #elif MN_THREAD_CONFIG_LOCK_TYPE == MN_THREAD_CONFIG_COUNTING_SEMAPHORE
     using LockType_t = mn::counting_semaphore_t;
+  #elif MN_THREAD_CONFIG_LOCK_TYPE == MN_THREAD_CONFIG_ADAPTIVE_MUTEX
+    using LockType_t = mn::adaptive_mutex_t;
   //#elif MN_THREAD_CONFIG_LOCK_TYPE == MN_THREAD_CONFIG_RECURSIVE_MUTEX
   //  using LockType_t = remutex_t;
   #endif
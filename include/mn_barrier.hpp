@@ -0,0 +1,141 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_BARRIER_
+#define MINLIB_ESP32_BARRIER_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+#include "mn_eventgroup.hpp"
+
+namespace mn {
+  /**
+   *  A reusable barrier for phase based pipelines.
+   *
+   *  Each participant arrives with a atomic decrement, the last one runs the completion
+   *  (on_completion or the completion function), starts the next phase and wakes all
+   *  waiting participants with one event group call. The phases use two event group bits
+   *  in turn, so a fast participant of the next phase never sees the bit of the last phase.
+   *
+   *  @code
+   *  void on_frame(mn::basic_barrier* barrier, void* arg) { swap_buffers(); }
+   *  mn::barrier_t frame(NUM_WORKERS, on_frame);
+   *
+   *  // each worker
+   *  while(true) { render_tile(); frame.arrive_and_wait(); }
+   *  @endcode
+   *
+   *  @note A participant that gets ERR_BARRIER_TIMEOUT has still arrived in this phase.
+   *  The completion runs in the task of the last participant, it must not wait on the barrier.
+   *
+   *  @ingroup lock
+   */
+  class basic_barrier {
+  public:
+    /**
+     * The type of the completion function
+     * @param barrier The barrier, that completes the phase
+     * @param arg The user argument
+     */
+    using completion_t = void (*)(basic_barrier* barrier, void* arg);
+
+    /**
+     * Construct the barrier
+     *
+     * @param expected The number of participants
+     * @param fnCompletion The function, that runs when a phase is completed
+     * @param arg The user argument for the completion function
+     */
+    explicit basic_barrier(uint32_t expected, completion_t fnCompletion = nullptr, void* arg = nullptr);
+    virtual ~basic_barrier() { }
+
+    basic_barrier(const basic_barrier&) = delete;
+    basic_barrier& operator=(const basic_barrier&) = delete;
+
+    /**
+     * Arrive at the barrier and do not wait
+     *
+     * @return The phase, where the participant has arrived
+     */
+    uint32_t arrive();
+
+    /**
+     * Wait until the given phase is completed
+     *
+     * @param phase The phase, from arrive()
+     * @param timeout How long to wait in ticks
+     * @return - ERR_BARRIER_OK The phase is completed
+     *         - ERR_BARRIER_TIMEOUT The phase was not completed before the timeout
+     *         - ERR_BARRIER_NOTCREATED The event group is not created
+     */
+    int wait(uint32_t phase, unsigned int timeout = portMAX_DELAY);
+
+    /**
+     * Arrive at the barrier and wait until all participants are arrived
+     */
+    int arrive_and_wait(unsigned int timeout = portMAX_DELAY);
+
+    /**
+     * Arrive at the barrier and leave it, the next phases expect one participant less
+     */
+    uint32_t arrive_and_drop();
+
+    /**
+     * Get the current phase
+     */
+    uint32_t get_phase() const      { return m_uiPhase.load(memory_order::Acquire); }
+
+    /**
+     * Get the number of participants
+     */
+    uint32_t get_expected() const   { return m_uiExpected.load(memory_order::Relaxed); }
+
+    /**
+     * Is the event group created?
+     */
+    bool is_initialized()           { return m_eventGroup.is_init(); }
+  protected:
+    /**
+     * Called from the last participant, before the next phase starts.
+     * The default calls the completion function.
+     *
+     * @param phase The completed phase
+     */
+    virtual void on_completion(uint32_t phase);
+  private:
+    uint32_t arrive_internal(uint32_t drop);
+  private:
+    atomic_uint32_t m_uiExpected;
+    atomic_uint32_t m_uiRemaining;
+    atomic_uint32_t m_uiPhase;
+
+    completion_t m_fnCompletion;
+    void* m_pArg;
+
+    basic_event_group m_eventGroup;
+  };
+
+  using barrier_t = basic_barrier;
+}
+
+#endif
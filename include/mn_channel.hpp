@@ -0,0 +1,302 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_CHANNEL_
+#define MINLIB_ESP32_CHANNEL_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mn_error.hpp"
+#include "mn_typetraits.hpp"
+
+namespace mn {
+    /**
+     * @brief The return value of channel_select, when no case was ready before the timeout
+     * @ingroup channel
+     */
+    constexpr int channel_select_timeout = -1;
+    /**
+     * @brief The return value of channel_select, when the select needs to wait and is called from a ISR
+     * @ingroup channel
+     */
+    constexpr int channel_select_error = -2;
+
+    class basic_channel_base;
+
+    /**
+     * @brief One case of select, a send or a receive on a channel.
+     * Create it with channel::send_case or channel::recv_case.
+     *
+     * @ingroup channel
+     */
+    struct channel_case {
+        basic_channel_base* pChannel;   /*!< The channel */
+        void* pItem;                    /*!< The item to send or where the received item stored */
+        bool* pOk;                      /*!< Set to false, when the channel is closed */
+        bool bSend;                     /*!< Send or receive? */
+    };
+
+    /**
+     * @brief The untyped implementation of a channel
+     *
+     * The items are copied with memcpy in a ring buffer. When a task waits, a waiter node
+     * on the stack of the task is linked in the sender or receiver list of the channel and
+     * the task is wake up with a direct to task notification. A waiting receiver gets the
+     * item directly from the sender, so a channel without a buffer is a rendezvous.
+     *
+     * @ingroup channel
+     */
+    class basic_channel_base {
+    public:
+        /**
+         * @brief The shared state of all waiter nodes of one select
+         */
+        struct select_state {
+            TaskHandle_t pTask;
+            volatile int32_t iWinner;
+        };
+        /**
+         * @brief A waiting send or receive, lives on the stack of the waiting task
+         */
+        struct waiter {
+            waiter* pNext;
+            waiter* pPrev;
+            select_state* pState;
+            void* pItem;
+            int32_t iIndex;
+            bool bLinked;
+            bool bOk;
+        };
+        /**
+         * @brief A intrusive list of waiter
+         */
+        struct waiter_list {
+            waiter* pFirst;
+            waiter* pLast;
+        };
+
+        /**
+         * @brief Close the channel. Waiting tasks are wake up, receivers can take the
+         * items in the buffer, then the receive returns ERR_CHANNEL_CLOSED.
+         */
+        void close();
+
+        /**
+         * @brief Is the channel closed?
+         */
+        bool is_closed() const { return m_bClosed; }
+
+        /**
+         * @brief Get the number of items in the buffer, a snapshot
+         */
+        uint32_t size() const { return __atomic_load_n(&m_uiCount, __ATOMIC_RELAXED); }
+        /**
+         * @brief Get the size of the buffer, 0 for a unbuffered channel
+         */
+        uint32_t capacity() const { return m_uiCapacity; }
+
+        /**
+         * @brief Wait until one of the cases can proceed and run this case.
+         *
+         * @param cases The cases
+         * @param nodes One waiter node for each case, on the stack of the caller
+         * @param uiCount The number of cases
+         * @param timeout How long to wait, 0 is the default case of a go select
+         *
+         * @return The index of the case, channel_select_timeout or channel_select_error
+         */
+        static int select(channel_case* cases, waiter* nodes, uint32_t uiCount, TickType_t timeout);
+    protected:
+        basic_channel_base(uint32_t uiItemSize, void* pBuffer, uint32_t uiCapacity);
+
+        basic_channel_base(const basic_channel_base&) = delete;
+        basic_channel_base& operator=(const basic_channel_base&) = delete;
+
+        /**
+         * @return ERR_CHANNEL_OK, ERR_CHANNEL_CLOSED, ERR_CHANNEL_TIMEOUT or ERR_CHANNEL_NOTASK
+         */
+        int send_item(const void* pItem, TickType_t timeout);
+        /**
+         * @return ERR_CHANNEL_OK, ERR_CHANNEL_CLOSED, ERR_CHANNEL_TIMEOUT or ERR_CHANNEL_NOTASK
+         */
+        int recv_item(void* pItem, TickType_t timeout);
+    private:
+        bool try_case(channel_case& c, TaskHandle_t& pWake);
+        bool is_ready(const channel_case& c, const select_state* pOwn);
+        bool try_send(const void* pItem, TaskHandle_t& pWake);
+        bool try_recv(void* pItem, bool& bOk, TaskHandle_t& pWake);
+        waiter* claim_first(waiter_list& list);
+
+        static bool claim(waiter* w);
+        static void link(waiter_list& list, waiter* w);
+        static void unlink(waiter_list& list, waiter* w);
+        static void wake(TaskHandle_t pTask);
+    protected:
+        portMUX_TYPE m_Mux;
+        waiter_list m_Senders;
+        waiter_list m_Receivers;
+
+        uint8_t* m_pBuffer;
+        uint32_t m_uiItemSize;
+        uint32_t m_uiCapacity;
+        uint32_t m_uiHead;
+        /** Changed only under m_Mux */
+        uint32_t m_uiCount;
+        volatile bool m_bClosed;
+    };
+
+    /**
+     * @brief A go style channel
+     *
+     * @code
+     * mn::channel<command_t, 8> commands;
+     * mn::channel<frame_t, 4> telemetry;
+     *
+     * command_t cmd; frame_t frame; bool ok;
+     *
+     * switch(mn::channel_select(pdMS_TO_TICKS(100), commands.recv_case(cmd, ok), telemetry.recv_case(frame))) {
+     * case 0: if(ok) handle(cmd); break;
+     * case 1: forward(frame); break;
+     * case mn::channel_select_timeout: heartbeat(); break;
+     * }
+     *
+     * // drain until closed
+     * for(const frame_t& f : telemetry) forward(f);
+     * @endcode
+     *
+     * @note T is copied with memcpy and must be trivially copyable
+     *
+     * @tparam T The type of the items
+     * @tparam TSize The size of the buffer, 0 is a unbuffered (rendezvous) channel
+     *
+     * @ingroup channel
+     */
+    template <typename T, uint32_t TSize = 0>
+    class channel : public basic_channel_base {
+        static_assert(is_trivially_copyable<T>::value, "the items of a channel must be trivially copyable");
+    public:
+        using value_type = T;
+        using self_type = channel<T, TSize>;
+
+        /**
+         * @brief The range-for iterator, receives until the channel is closed
+         */
+        class iterator {
+        public:
+            iterator() : m_pChannel(NULL) { }
+            explicit iterator(self_type* pChannel) : m_pChannel(pChannel) { next(); }
+
+            const value_type& operator * () const { return m_Value; }
+            const value_type* operator -> () const { return &m_Value; }
+
+            iterator& operator ++ () { next(); return *this; }
+
+            bool operator == (const iterator& other) const { return m_pChannel == other.m_pChannel; }
+            bool operator != (const iterator& other) const { return m_pChannel != other.m_pChannel; }
+        private:
+            void next() {
+                if(m_pChannel && m_pChannel->recv(m_Value) != ERR_CHANNEL_OK)
+                    m_pChannel = NULL;
+            }
+        private:
+            self_type* m_pChannel;
+            value_type m_Value;
+        };
+
+        channel()
+            : basic_channel_base(sizeof(T), TSize > 0 ? m_Buffer : NULL, TSize) { }
+
+        /**
+         * @brief Send a item, waits until a receiver takes it or the buffer has space
+         * @return ERR_CHANNEL_OK, ERR_CHANNEL_CLOSED, ERR_CHANNEL_TIMEOUT or ERR_CHANNEL_NOTASK
+         */
+        int send(const value_type& item, TickType_t timeout = portMAX_DELAY) {
+            return send_item(&item, timeout);
+        }
+        /**
+         * @brief Send a item without waiting
+         */
+        int try_send(const value_type& item) { return send(item, 0); }
+
+        /**
+         * @brief Receive a item, waits until a item is available
+         * @return ERR_CHANNEL_OK, ERR_CHANNEL_CLOSED (closed and empty), ERR_CHANNEL_TIMEOUT
+         * or ERR_CHANNEL_NOTASK
+         */
+        int recv(value_type& item, TickType_t timeout = portMAX_DELAY) {
+            return recv_item(&item, timeout);
+        }
+        /**
+         * @brief Receive a item without waiting
+         */
+        int try_recv(value_type& item) { return recv(item, 0); }
+
+        /**
+         * @brief Create a send case for select
+         * @param ok Set to false, when the channel is closed
+         */
+        channel_case send_case(const value_type& item, bool& ok) {
+            return channel_case{ this, const_cast<value_type*>(&item), &ok, true };
+        }
+        channel_case send_case(const value_type& item) {
+            return channel_case{ this, const_cast<value_type*>(&item), NULL, true };
+        }
+        /**
+         * @brief Create a receive case for select
+         * @param ok Set to false, when the channel is closed and empty
+         */
+        channel_case recv_case(value_type& item, bool& ok) {
+            return channel_case{ this, &item, &ok, false };
+        }
+        channel_case recv_case(value_type& item) {
+            return channel_case{ this, &item, NULL, false };
+        }
+
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(); }
+    private:
+        value_type m_Buffer[TSize > 0 ? TSize : 1];
+    };
+
+    /**
+     * @brief Wait until one of the cases can proceed and run this case.
+     *
+     * @param timeout How long to wait, 0 is the default case of a go select
+     * @param cases The cases, created with channel::send_case and channel::recv_case
+     *
+     * @return The index of the case, channel_select_timeout or channel_select_error
+     * @note Not named select, mn::select is the type selector of utils/mn_inttokey.hpp
+     * @ingroup channel
+     */
+    template <typename... TCases>
+    inline int channel_select(TickType_t timeout, TCases... cases) {
+        static_assert(sizeof...(TCases) > 0, "channel_select needs one case");
+
+        channel_case _cases[] = { cases... };
+        basic_channel_base::waiter _nodes[sizeof...(TCases)];
+
+        return basic_channel_base::select(_cases, _nodes, sizeof...(TCases), timeout);
+    }
+}
+
+#endif
@@ -38,6 +38,8 @@
 #define MN_THREAD_CONFIG_COUNTING_SEMAPHORE   2
 /// @brief Pre defined values for config items - Use a binary semaphore
 #define MN_THREAD_CONFIG_BINARY_SEMAPHORE     3
+/// @brief Pre defined values for config items - Use the adaptive spin-then-block mutex
+#define MN_THREAD_CONFIG_ADAPTIVE_MUTEX       4
 
 /// @brief Pre defined helper values for config items - Use for aktivating
 #define MN_THREAD_CONFIG_YES        1
@@ -84,6 +86,14 @@
  */
 #define MN_THREAD_CONFIG_OTHER      1
 
+/**
+ * @brief Pre defined values for config items -
+ * @note corrently use for MN_THREAD_CONFIG_BOARD
+ * Set board type to host - the FreeRTOS POSIX/Linux simulator port,
+ * for load tests and profiling off-device. See port/host
+ */
+#define MN_THREAD_CONFIG_HOST       2
+
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
     #define MN_THREAD_CONFIG_STACK_DEPTH 8192
 #endif
@@ -149,6 +159,19 @@
     #define MN_THREAD_CONFIG_BASIC_ALIGNMENT     sizeof(unsigned char*)
 #endif
 
+#ifndef MN_THREAD_CONFIG_CACHE_LINE_SIZE
+    /**
+     * The size of a cache line, the lock-free containers place the indices of producer
+     * and consumer in different cache lines.
+     * @note default: 64 on the host and 32 on the ESP32
+     */
+    #if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+        #define MN_THREAD_CONFIG_CACHE_LINE_SIZE     64
+    #else
+        #define MN_THREAD_CONFIG_CACHE_LINE_SIZE     32
+    #endif
+#endif
+
 #ifndef MN_THREAD_CONFIG_BASIC_HASHMUL_VAL
 	/// Basic value for struct::hash as basic hash calculate @see mn::hash
 	#define MN_THREAD_CONFIG_BASIC_HASHMUL_VAL 2149645487U
@@ -229,6 +252,24 @@
     #define MN_THREAD_CONFIG_MSGTASK_MAX_MESSAGES   5
 #endif
 
+#ifndef MN_THREAD_CONFIG_MSGTASK_BATCH
+    /**
+     * How many messages the message task and the mailbox task take from the queue
+     * with one wakeup - default: 8
+     *
+     * @note the batch is a array on the stack of the task
+     */
+    #define MN_THREAD_CONFIG_MSGTASK_BATCH          8
+#endif
+
+#ifndef MN_THREAD_CONFIG_MSGTASK_INLINE_SIZE
+    /**
+     * The maximal size in bytes of a payload, that a mail of the basic_mailbox_task
+     * stored inline (by value) - default: 16
+     */
+    #define MN_THREAD_CONFIG_MSGTASK_INLINE_SIZE    16
+#endif
+
 
 #ifndef MN_THREAD_CONFIG_FOREIGIN_TASK_SUPPORT
     /**
@@ -247,6 +288,7 @@
      * MN_THREAD_CONFIG_MUTEX:      using the mutex as default lock type
      * MN_THREAD_CONFIG_BINARY_SEMAPHORE using the binary semaphore as default lock type
      * MN_THREAD_CONFIG_COUNTING_SEMAPHORE: using the counting semaphore as default lock type
+     * MN_THREAD_CONFIG_ADAPTIVE_MUTEX: using the adaptive spin-then-block mutex as default lock type
      * @note default: MN_THREAD_CONFIG_BINARY_SEMAPHORE
      */
     #define MN_THREAD_CONFIG_LOCK_TYPE MN_THREAD_CONFIG_BINARY_SEMAPHORE
@@ -327,9 +369,253 @@
      */
     #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_PRIORITY      mn::basic_task::priority::Low
 #endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_WORKER
+    /**
+     * How many worker threads run in the work-stealing workqueue
+     * @note default: 2
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_WORKER      2
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_MAXITEMS
+    /**
+     * How many work items to queue in the shared submit queue of the work-stealing workqueue
+     * @note default: 16
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_MAXITEMS    16
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_DEQUE_SIZE
+    /**
+     * How many work items hold each worker in his own deque, must be a power of two
+     * @note default: 32
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_DEQUE_SIZE  32
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_STACKSIZE
+    /**
+     * Stak size for the work-stealing workqueue for all worked thread
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_STACKSIZE   MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_PRIORITY
+    /**
+     * @note default: Priority for the work-stealing workqueue for all worked thread
+     * @note default: basic_thread::PriorityLow
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_PRIORITY    mn::basic_task::priority::Low
+#endif
+
+#ifndef MN_THREAD_CONFIG_FUTURE_POOL_SIZE
+    /**
+     * How many future states of one result type are hold in the static pool, max 32.
+     * When the pool is empty, the state are allocated with new
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_FUTURE_POOL_SIZE               8
+#endif
+
+#ifndef MN_THREAD_CONFIG_FUTURE_TASK_SIZE
+    /**
+     * How many bytes can a callable for submit and a continuation for then hold inline
+     * @note default: 8 pointers
+     */
+    #define MN_THREAD_CONFIG_FUTURE_TASK_SIZE               (sizeof(void*) * 8)
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_LEVELS
+    /**
+     * How many priority levels has the priority workqueue, level 0 is the most urgent
+     * @note default: 4
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_LEVELS      4
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_AGING
+    /**
+     * After how many ticks of waiting a item in the priority workqueue is promoted one level up.
+     * In the deadline mode is this the implicit deadline per level of items without a deadline.
+     * @note default: 100
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_AGING       100
+#endif
 //==================================
 // end workqueue config
 
+// start actor config
+//==================================
+#ifndef MN_THREAD_CONFIG_ACTOR_WORKERS
+    /**
+     * How many worker tasks a basic_actor_system uses to run all actors
+     * @note default: 2
+     */
+    #define MN_THREAD_CONFIG_ACTOR_WORKERS              2
+#endif
+
+#ifndef MN_THREAD_CONFIG_ACTOR_MAX_ACTORS
+    /**
+     * How many actors can spawned in one basic_actor_system
+     * @note default: 64
+     */
+    #define MN_THREAD_CONFIG_ACTOR_MAX_ACTORS           64
+#endif
+
+#ifndef MN_THREAD_CONFIG_ACTOR_THROUGHPUT
+    /**
+     * How many messages a worker handles from one actor, before the next actor runs
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_ACTOR_THROUGHPUT           8
+#endif
+
+#ifndef MN_THREAD_CONFIG_ACTOR_MAILBOX_SIZE
+    /**
+     * The default number of messages in the mailbox of a actor
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_ACTOR_MAILBOX_SIZE         8
+#endif
+
+#ifndef MN_THREAD_CONFIG_ACTOR_MAX_RESTARTS
+    /**
+     * How many times a failed actor is restarted, before it is stopped
+     * @note default: 3
+     */
+    #define MN_THREAD_CONFIG_ACTOR_MAX_RESTARTS         3
+#endif
+
+#ifndef MN_THREAD_CONFIG_ACTOR_STACKSIZE
+    /**
+     * The stack size of the actor worker tasks, all actors run on this stacks
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE * 2
+     */
+    #define MN_THREAD_CONFIG_ACTOR_STACKSIZE            (MN_THREAD_CONFIG_MINIMAL_STACK_SIZE * 2)
+#endif
+
+#ifndef MN_THREAD_CONFIG_ACTOR_PRIORITY
+    /**
+     * The priority of the actor worker tasks
+     * @note default: mn::basic_task::priority::Normal
+     */
+    #define MN_THREAD_CONFIG_ACTOR_PRIORITY             mn::basic_task::priority::Normal
+#endif
+//==================================
+// end actor config
+
+// start event bus config
+//==================================
+#ifndef MN_THREAD_CONFIG_EVENTBUS_TOPICS
+    /**
+     * The size of the topic table of a basic_event_bus, must be a power of two
+     * @note default: 32
+     */
+    #define MN_THREAD_CONFIG_EVENTBUS_TOPICS            32
+#endif
+
+#ifndef MN_THREAD_CONFIG_EVENTBUS_SUBSCRIPTIONS
+    /**
+     * How many subscriptions (subscriber and topic) a basic_event_bus can hold
+     * @note default: 32
+     */
+    #define MN_THREAD_CONFIG_EVENTBUS_SUBSCRIPTIONS     32
+#endif
+
+#ifndef MN_THREAD_CONFIG_EVENTBUS_FANOUT
+    /**
+     * How many subscribers get one published event, the subscribers are collected on the stack
+     * @note default: 16
+     */
+    #define MN_THREAD_CONFIG_EVENTBUS_FANOUT            16
+#endif
+
+#ifndef MN_THREAD_CONFIG_EVENTBUS_DEPTH
+    /**
+     * How many topic levels ("a/b/c") are checked for wildcard subscriptions
+     * @note default: 4
+     */
+    #define MN_THREAD_CONFIG_EVENTBUS_DEPTH             4
+#endif
+
+#ifndef MN_THREAD_CONFIG_EVENTBUS_PAYLOAD
+    /**
+     * The maximal payload size in bytes of a event, that a deferred subscriber stored
+     * @note default: 16
+     */
+    #define MN_THREAD_CONFIG_EVENTBUS_PAYLOAD           16
+#endif
+
+#ifndef MN_THREAD_CONFIG_EVENTBUS_QUEUE_SIZE
+    /**
+     * The default number of events in the queue of a deferred subscriber
+     * @note default: 16
+     */
+    #define MN_THREAD_CONFIG_EVENTBUS_QUEUE_SIZE        16
+#endif
+
+#ifndef MN_THREAD_CONFIG_EVENTBUS_BATCH
+    /**
+     * How many events a deferred subscriber handles with one on_batch call
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_EVENTBUS_BATCH             8
+#endif
+//==================================
+// end event bus config
+
+// start coroutine config
+//==================================
+#ifndef MN_THREAD_CONFIG_COROUTINE
+    /**
+     * Build the C++20 coroutine support (co_task, generator, awaiter and basic_co_executor)
+     * @note default: MN_THREAD_CONFIG_NO, set MN_THREAD_CONFIG_YES with a C++20 compiler
+     */
+    #define MN_THREAD_CONFIG_COROUTINE                      MN_THREAD_CONFIG_NO
+#endif
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+    #if !defined(__cpp_impl_coroutine) || (__cplusplus < 202002L)
+        #error "MN_THREAD_CONFIG_COROUTINE needs a C++20 compiler with coroutine support"
+    #endif
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_WORKER
+    /**
+     * How many tasks run the coroutines in the basic_co_executor
+     * @note default: 2
+     */
+    #define MN_THREAD_CONFIG_COROUTINE_WORKER               2
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_MAX_READY
+    /**
+     * How many coroutines can wait in the ready queue of the basic_co_executor
+     * @note default: 32
+     */
+    #define MN_THREAD_CONFIG_COROUTINE_MAX_READY            32
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_STACKSIZE
+    /**
+     * Stak size for the executor tasks, all coroutines of the executor run on this stacks
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+     */
+    #define MN_THREAD_CONFIG_COROUTINE_STACKSIZE            MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_COROUTINE_PRIORITY
+    /**
+     * Priority for the executor tasks
+     * @note default: basic_thread::PriorityLow
+     */
+    #define MN_THREAD_CONFIG_COROUTINE_PRIORITY             mn::basic_task::priority::Low
+#endif
+//==================================
+// end coroutine config
+
 
 // start SEMAPHORE config
 //==================================
@@ -375,8 +661,102 @@
      */
     #define MN_THREAD_CONFIG_RECURSIVE_MUTEX_CHEAKING     MN_THREAD_CONFIG_YES
 #endif
+
+#ifndef MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN
+    /**
+     * How many times the adaptive mutex spins, when the owner is running on the other core,
+     * before the task is parked
+     * @note default:  200
+     */
+    #define MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN        200
+#endif
+
+#ifndef MN_THREAD_CONFIG_LOCK_PROFILER
+    /**
+     * When MN_THREAD_CONFIG_YES then each ILockObject records the acquire counts, the
+     * contended acquires and the wait and hold times, see basic_lock_profiler
+     * @note default:  MN_THREAD_CONFIG_NO
+     */
+    #define MN_THREAD_CONFIG_LOCK_PROFILER              MN_THREAD_CONFIG_NO
+#endif
+
+#ifndef MN_THREAD_CONFIG_SEQLOCK_SPIN
+    /**
+     * How many times a seqlock reader or writer retries, before it waits one tick
+     * @note default:  1000
+     */
+    #define MN_THREAD_CONFIG_SEQLOCK_SPIN               1000
+#endif
 // end mutex config
 
+// start rcu config
+//==================================
+#ifndef MN_THREAD_CONFIG_RCU
+    /**
+     * When MN_THREAD_CONFIG_YES then basic_task::yield report a quiescent state and the
+     * sleep functions of basic_task put a registered rcu reader task offline, while sleeping
+     * @note default:  MN_THREAD_CONFIG_NO
+     */
+    #define MN_THREAD_CONFIG_RCU                        MN_THREAD_CONFIG_NO
+#endif
+
+#ifndef MN_THREAD_CONFIG_RCU_MAX_READERS
+    /**
+     * How many tasks can registered as rcu reader at the same time
+     * @note default:  8
+     */
+    #define MN_THREAD_CONFIG_RCU_MAX_READERS            8
+#endif
+
+#ifndef MN_THREAD_CONFIG_RCU_CALLBACKS
+    /**
+     * How many deferred rcu callbacks (call_rcu) can wait for the end of her grace period
+     * @note default:  32
+     */
+    #define MN_THREAD_CONFIG_RCU_CALLBACKS              32
+#endif
+
+//==================================
+// end rcu config
+
+// start hazard pointer config
+//==================================
+#ifndef MN_THREAD_CONFIG_HAZARD
+    /**
+     * When MN_THREAD_CONFIG_YES then a basic_task releases its hazard pointer record,
+     * when the task ends. Else must a task, that used hazard pointers, call
+     * basic_hazard_domain::instance().release_task() before it ends.
+     * @note default:  MN_THREAD_CONFIG_NO
+     */
+    #define MN_THREAD_CONFIG_HAZARD                     MN_THREAD_CONFIG_NO
+#endif
+
+#ifndef MN_THREAD_CONFIG_HAZARD_MAX_TASKS
+    /**
+     * How many tasks can use hazard pointers at the same time
+     * @note default:  8
+     */
+    #define MN_THREAD_CONFIG_HAZARD_MAX_TASKS           8
+#endif
+
+#ifndef MN_THREAD_CONFIG_HAZARD_SLOTS
+    /**
+     * How many hazard pointers a task can hold at the same time
+     * @note default:  2
+     */
+    #define MN_THREAD_CONFIG_HAZARD_SLOTS               2
+#endif
+
+#ifndef MN_THREAD_CONFIG_HAZARD_SCAN
+    /**
+     * After how many retired objects the retired list of a task is scanned
+     * @note default:  2 * MN_THREAD_CONFIG_HAZARD_MAX_TASKS * MN_THREAD_CONFIG_HAZARD_SLOTS
+     */
+    #define MN_THREAD_CONFIG_HAZARD_SCAN                (2 * MN_THREAD_CONFIG_HAZARD_MAX_TASKS * MN_THREAD_CONFIG_HAZARD_SLOTS)
+#endif
+//==================================
+// end hazard pointer config
+
 // start queue config
 #ifndef MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT
     /**
@@ -436,6 +816,15 @@
      */
     #define MN_THREAD_CONFIG_MEMPOOL_USETIMED     MN_THREAD_CONFIG_YES
 #endif
+
+#ifndef MN_THREAD_CONFIG_SLAB_SIZE
+    /**
+     * The number of bytes, that the slab allocator carves for a size class, when the
+     * free list of the class is empty
+     * @note default: 1024
+     */
+    #define MN_THREAD_CONFIG_SLAB_SIZE            1024
+#endif
 //==================================
 // end mempool config
 
@@ -449,6 +838,99 @@
      */
     #define MN_THREAD_CONFIG_ALLOCATOR_DEFAULT        MN_THREAD_CONFIG_ALLOCATOR_SYSTEM
 #endif
+
+#ifndef MN_THREAD_CONFIG_ARENA_CHUNK_SIZE
+    /**
+     * The default size of a chunk, that the arena allocator takes from the upstream allocator
+     * default: 1024
+     */
+    #define MN_THREAD_CONFIG_ARENA_CHUNK_SIZE         1024
+#endif
+
+#ifndef MN_THREAD_CONFIG_TCACHE_TLS_INDEX
+    /**
+     * The thread local storage pointer, that the caching allocator use for the task cache.
+     * -1 disables the task caches, the caching allocator use the shared slab pool directly.
+     *
+     * To enable it, set a index less then configNUM_THREAD_LOCAL_STORAGE_POINTERS (checked
+     * with a static_assert). The index 0 is reserved: ESP-IDF use it for the pthread and
+     * thread_local storage, so use 1 and raise CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS
+     * to 2 or greater (the ESP-IDF default is 1).
+     * default: -1
+     */
+    #define MN_THREAD_CONFIG_TCACHE_TLS_INDEX         -1
+#endif
+
+#ifndef MN_THREAD_CONFIG_TCACHE_MAX_TASKS
+    /**
+     * The maximal number of tasks with a own cache, the other tasks use the shared slab pool
+     * default: 8
+     */
+    #define MN_THREAD_CONFIG_TCACHE_MAX_TASKS         8
+#endif
+
+#ifndef MN_THREAD_CONFIG_TCACHE_MAGAZINE
+    /**
+     * The maximal number of cached blocks per size class and task
+     * default: 16
+     */
+    #define MN_THREAD_CONFIG_TCACHE_MAGAZINE          16
+#endif
+
+#ifndef MN_THREAD_CONFIG_TCACHE_BATCH
+    /**
+     * How many blocks the task cache takes from or gives back to the shared slab pool at once
+     * default: 8
+     */
+    #define MN_THREAD_CONFIG_TCACHE_BATCH             8
+#endif
+
+#ifndef MN_THREAD_CONFIG_TLSF_SL_INDEX_LOG2
+    /**
+     * log2 of the number of second level lists per first level class of the TLSF heap,
+     * more lists give less internal fragmentation. Maximal 5.
+     * default: 4
+     */
+    #define MN_THREAD_CONFIG_TLSF_SL_INDEX_LOG2       4
+#endif
+
+#ifndef MN_THREAD_CONFIG_TLSF_FL_INDEX_MAX
+    /**
+     * log2 of the maximal block size of the TLSF heap, a bigger region is clamped.
+     * Maximal 30.
+     * default: 24 (16 MiB)
+     */
+    #define MN_THREAD_CONFIG_TLSF_FL_INDEX_MAX        24
+#endif
+
+#ifndef MN_THREAD_CONFIG_HEAP_PROFILER_SAMPLE
+    /**
+     * The profiling allocator filter records the call site of each n-th allocation,
+     * 0 disables the call site capture
+     * default: 64
+     */
+    #define MN_THREAD_CONFIG_HEAP_PROFILER_SAMPLE     64
+#endif
+
+#ifndef MN_THREAD_CONFIG_HEAP_PROFILER_FRAME
+    /**
+     * The frame of the return address, that the profiling allocator filter records for
+     * a sampled allocation without a site name. 0 is the caller of on_alloc, which is
+     * basic_allocator::allocate or the container code, when allocate is inlined.
+     * A greater frame needs -fno-omit-frame-pointer and is not supported by all targets,
+     * the windowed ABI of the Xtensa ESP32 only supports 0 reliably.
+     * default: 0
+     */
+    #define MN_THREAD_CONFIG_HEAP_PROFILER_FRAME      0
+#endif
+
+#ifndef MN_THREAD_CONFIG_HEAP_PROFILER_SITES
+    /**
+     * The maximal number of recorded call sites of the heap profiler
+     * default: 16
+     */
+    #define MN_THREAD_CONFIG_HEAP_PROFILER_SITES      16
+#endif
 //==================================
 // end allocator config
 
@@ -19,6 +19,8 @@
 #ifndef MINLIB_ESP32_CONVAR_
 #define MINLIB_ESP32_CONVAR_
 
+#include "mn_config.hpp"
+
 /**
  *  Condition variables are an additon to the mini Thread
  *  classes. If you want to include them, you need to define the
@@ -26,53 +28,147 @@
  */
 #if MN_THREAD_CONFIG_CONDITION_VARIABLE_SUPPORT == MN_THREAD_CONFIG_YES
 
-#include "mn_config.hpp"
-#include "mn_mutex.hpp"
-#include "mn_autolock.hpp"
-#include "mn_autounlock.hpp"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
-#include <list>
+#include "mn_error.hpp"
+#include "mn_lock.hpp"
+#include "mn_timespan.hpp"
+
+#include <utility>
 
 namespace mn {
     namespace ext {
-        /**
-         * Forward declaration. We need to prevent a circular dependency
-         * between the basic_convar_task class and the basic_condition_variable class.
-         *
-         * @ingroup condition-varible
-         */
-        class basic_convar_task;
-
         /**
          *  Class implementation of condition variable
          *
          *  A condition variable isn't really a variable. It's a list
-         *  of threads.
+         *  of waiting tasks.
+         *
+         *  Any task (basic_task or a foreign task) can wait. The waiter node lives on the stack
+         *  of the waiting task and is linked in a FIFO list, signal wakes the task with a direct
+         *  to task notification. So there is no allocation on wait or signal.
+         *
+         *  @code
+         *  mutex_t lock;
+         *  convar_t cv;
+         *
+         *  // consumer
+         *  automutx_t guard(lock);
+         *  cv.wait(lock, [&] { return !buffer.empty(); });
          *
-         *  The design here is that a basic_convar_task "waits", and a condition_variable
-         *  "signals". This affects where the public interfaces reside.
+         *  // producer
+         *  { automutx_t guard(lock); buffer.push(item); }
+         *  cv.notify_one();
+         *  @endcode
+         *
+         *  @note The wait functions use the task notification of the calling task, a other
+         *  notify to the task is a spurious wakeup and the wait goes on.
+         *
+         * @ingroup condition-varible
          */
         class basic_condition_variable : MN_DEFAULT_CLASS {
             /**
-             *  The basic_convar_task class and the basic_condition_variable class are interdependent.
-             *  If we allow the basic_convar_task class to access the internals of the
-             *  basic_condition_variable, we can reduce the public interface which is a
-             *  good thing.
+             * A waiting task, the node lives on the stack of the waiting task
              */
-            friend class basic_convar_task;
+            struct waiter {
+                TaskHandle_t pTask;
+                waiter* pNext;
+                volatile bool bSignaled;
+            };
         public:
             /**
              *  Constructor to create a condition variable.
              */
             basic_condition_variable();
 
+            basic_condition_variable(const basic_condition_variable&) = delete;
+            basic_condition_variable& operator=(const basic_condition_variable&) = delete;
+
+            /**
+             *  Wait until the condition variable is signaled. The lock is released while
+             *  waiting and locked again, before the function returns.
+             *
+             *  @param lock The lock, that protects the condition. Must be locked by the caller.
+             *  @param timeout How long to wait in ticks
+             *
+             *  @return - ERR_CONVAR_OK The condition variable was signaled
+             *          - ERR_CONVAR_TIMEOUT The timeout is expired
+             *          - ERR_CONVAR_NOTASK Called from the ISR Context or without a task
+             */
+            int wait(ILockObject& lock, TickType_t timeout = portMAX_DELAY);
+
             /**
-             *  Signal a thread waiting on this condition_variable (FIFO list).
+             *  Wait until the predicate is true.
+             *
+             *  @param lock The lock, that protects the condition. Must be locked by the caller.
+             *  @param pred The predicate, called with the locked lock
+             *  @return true - the predicate is always true, when the wait returns
+             */
+            template <class TPredicate, class = decltype(!std::declval<TPredicate&>()())>
+            bool wait(ILockObject& lock, TPredicate pred) {
+                while(!pred()) {
+                    if(wait(lock, portMAX_DELAY) == ERR_CONVAR_NOTASK) return false;
+                }
+                return true;
+            }
+
+            /**
+             *  Wait until the predicate is true or the timeout is expired.
+             *
+             *  @return The result of the predicate
+             */
+            template <class TPredicate>
+            bool wait(ILockObject& lock, TickType_t timeout, TPredicate pred) {
+                TickType_t _xStart = xTaskGetTickCount();
+
+                while(!pred()) {
+                    TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                    if(timeout != portMAX_DELAY && _xElapsed >= timeout) return false;
+
+                    TickType_t _xRemaining = (timeout == portMAX_DELAY) ? portMAX_DELAY : timeout - _xElapsed;
+                    if(wait(lock, _xRemaining) == ERR_CONVAR_NOTASK) return false;
+                }
+                return true;
+            }
+
+            /**
+             *  Wait for the given time span
+             */
+            int wait_for(ILockObject& lock, const timespan_t& rel_time) {
+                return wait(lock, to_ticks(rel_time));
+            }
+
+            /**
+             *  Wait until the given absolute time (timespan_t::now())
+             */
+            int wait_until(ILockObject& lock, const timespan_t& abs_time) {
+                return wait(lock, until_ticks(abs_time));
+            }
+
+            /**
+             *  Wait until the predicate is true or the absolute time (timespan_t::now()) is reached.
+             *
+             *  @return The result of the predicate
+             */
+            template <class TPredicate>
+            bool wait_until(ILockObject& lock, const timespan_t& abs_time, TPredicate pred) {
+                while(!pred()) {
+                    TickType_t _xRemaining = until_ticks(abs_time);
+
+                    if(_xRemaining == 0) return pred();
+                    if(wait(lock, _xRemaining) == ERR_CONVAR_NOTASK) return false;
+                }
+                return true;
+            }
+
+            /**
+             *  Signal the first task waiting on this condition_variable (FIFO list).
              */
             void signal();
 
             /**
-             * Signal all threads waiting on this condition_variable.
+             * Signal all tasks waiting on this condition_variable.
              */
             void broadcast();
 
@@ -84,23 +180,29 @@ namespace mn {
 				broadcast();
 			}
 
+            /**
+             * Has the condition variable waiting tasks, only a snapshot
+             */
+            bool has_waiters() const { return m_pFirst != NULL; }
         private:
             /**
-             *  Internal helper function to queue a basic_convar_task to
-             *  this condition_variable's wait list.
-             *
-             * @param thread The basic_convar_task to add to the waiting list
+             * Convert a relative time span to ticks, never portMAX_DELAY
+             */
+            static TickType_t to_ticks(const timespan_t& span);
+            /**
+             * Ticks from now until the given absolute time, 0 when the time is reached
              */
-            void add_list(basic_convar_task *thread);
+            static TickType_t until_ticks(const timespan_t& abs_time);
         protected:
             /**
-             *  Protect the internal condition_variable state.
+             *  Protect the internal wait list.
              */
-            mutex_t                            m_mutex;
+            portMUX_TYPE m_Mux;
             /**
-             *  Implementation of a wait list of Threads.
+             *  The intrusive FIFO list of the waiting tasks
              */
-            std::list<basic_convar_task*>    m_waitList;
+            waiter* m_pFirst;
+            waiter* m_pLast;
         };
 
         using convar_t = basic_condition_variable;
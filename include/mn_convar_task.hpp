@@ -40,13 +40,6 @@ namespace mn {
          * @ingroup condition-varible
          */
         class basic_convar_task : public ::mn::basic_task {
-            /**
-             *  The Thread class and the basic_condition_variable class are interdependent.
-             *  If we allow the basic_condition_variable class to access the internals of
-             *  the basic_convar_task class, we can reduce the public interface, which is a
-             *  good thing.
-             */
-            friend class basic_condition_variable;
         public:
             basic_convar_task();
             /**
@@ -60,7 +53,8 @@ namespace mn {
             unsigned short  usStackDepth = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE);
 
             /**
-             *  helper function to signal this thread.
+             *  helper function to signal this thread, with a task notification
+             *  (not a condition variable signal)
              */
             virtual void          signal();
 
@@ -75,21 +69,25 @@ namespace mn {
              *  @param timeOut Allows you to specify a timeout on the Wait,
              *  if desired.
              *
-             *  @return
+             *  @return ERR_CONVAR_OK on signal, ERR_CONVAR_TIMEOUT on timeout
+             *  and ERR_CONVAR_NOTASK when not called from this task
+             */
+            virtual int           wait(convar_t& cv, ILockObject& cvl, TickType_t timeOut = portMAX_DELAY);
+
+            /**
+             *  Have this thread wait on a condition variable, until the predicate is true
+             *
+             *  @return The result of the predicate
              */
-            virtual int           wait(convar_t& cv, mutex_t& cvl, TickType_t timeOut = portMAX_DELAY);
+            template <class TPredicate>
+            bool wait(convar_t& cv, ILockObject& cvl, TickType_t timeOut, TPredicate pred) {
+                return cv.wait(cvl, timeOut, pred);
+            }
         protected:
             /**
              * Call on signal functions
              */
             virtual void          on_signal() { }
-        private:
-            /**
-             *  How we wait and signal the thread when using condition variables.
-             *  Because a semaphore maintains state, this solves the race
-             *  condition between dropping the CvLock and waiting.
-             */
-            binary_semaphore_t m_waitSem;
         };
 
         using convar_task_t = basic_convar_task;
@@ -0,0 +1,41 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_COROUTINE_H_
+#define _MINLIB_MN_COROUTINE_H_
+
+#include "mn_config.hpp"
+
+/**
+ * C++20 coroutine support, build with MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES.
+ * The socket awaiter is in coroutine/mn_co_socket.hpp.
+ *
+ * @defgroup coroutine Coroutines
+ */
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include "coroutine/mn_co_event.hpp"
+#include "coroutine/mn_co_executor.hpp"
+#include "coroutine/mn_co_task.hpp"
+#include "coroutine/mn_co_generator.hpp"
+#include "coroutine/mn_co_mutex.hpp"
+#include "coroutine/mn_co_awaiter.hpp"
+
+#endif
+
+#endif
@@ -128,6 +128,18 @@
  * Tasklet can not created
  */
 #define ERR_COROUTINE_CANSHEDULE   		    0x4002
+/**
+ * The coroutine executor is allready created
+ */
+#define ERR_COROUTINE_ALREADYINIT   		0x4003
+/**
+ * The coroutine executor can't created
+ */
+#define ERR_COROUTINE_CANTCREATE   		    0x4004
+/**
+ * Not all tasks of the coroutine executor are created
+ */
+#define ERR_COROUTINE_WARNING   		    0x4005
 
 // --------------------------------
 
@@ -200,6 +212,58 @@
 #define ERR_WORKQUEUE_CANTINITMUTEX         0x7004		/*!< The mutex can not init */
 #define ERR_WORKQUEUE_ADD                   0x7005		/*!< The item can not add to the workqueue */
 
+#define ERR_FUTURE_OK                       NO_ERROR	/*!< No Error in one of the future or promise function */
+#define ERR_FUTURE_TIMEOUT                  0x7101		/*!< The result is not ready before the timeout */
+#define ERR_FUTURE_NOSTATE                  0x7102		/*!< The future or promise has no shared state */
+#define ERR_FUTURE_BROKEN                   0x7103		/*!< The promise was destroyed without a result */
+#define ERR_FUTURE_ALREADYSET               0x7104		/*!< The result or the continuation was already set */
+
+#define ERR_RCU_OK                          NO_ERROR	/*!< No Error in one of the rcu function */
+#define ERR_RCU_READERS_FULL                0x7201		/*!< All reader slots of the rcu domain are in use */
+#define ERR_RCU_NOTREGISTERED               0x7202		/*!< The calling task is not registered as rcu reader */
+#define ERR_RCU_CALLBACKS_FULL              0x7203		/*!< The deferred callback list is full (only from ISR) */
+#define ERR_RCU_NOMEM                       0x7204		/*!< The new object can not allocate */
+
+#define ERR_HAZARD_OK                       NO_ERROR	/*!< No Error in one of the hazard pointer function */
+#define ERR_HAZARD_NORECORD                 0x7301		/*!< All hazard records are owned by other tasks */
+#define ERR_HAZARD_NOSLOT                   0x7302		/*!< All hazard slots of the calling task are in use */
+
+#define ERR_LATCH_OK                        NO_ERROR	/*!< No Error in one of the latch or countdown_event function */
+#define ERR_LATCH_TIMEOUT                   0x7401		/*!< The counter has not reached zero before the timeout */
+#define ERR_LATCH_UNDERFLOW                 0x7402		/*!< Count down more than the current counter */
+#define ERR_LATCH_ALREADYSET                0x7403		/*!< The counter is already zero, can not add */
+#define ERR_LATCH_NOTCREATED                0x7404		/*!< The event group can not created */
+
+#define ERR_BARRIER_OK                      NO_ERROR	/*!< No Error in one of the barrier function */
+#define ERR_BARRIER_TIMEOUT                 0x7411		/*!< The phase was not completed before the timeout, the task is still arrived */
+#define ERR_BARRIER_NOTCREATED              0x7412		/*!< The event group can not created */
+
+#define ERR_CONVAR_OK                       NO_ERROR	/*!< No Error in one of the condition variable function */
+#define ERR_CONVAR_TIMEOUT                  0x7501		/*!< The condition variable was not signaled before the timeout */
+#define ERR_CONVAR_NOTASK                   0x7502		/*!< Called from the ISR Context or before the scheduler is started */
+
+#define ERR_ACTOR_OK                        NO_ERROR	/*!< No Error in one of the actor function */
+#define ERR_ACTOR_FULL                      0x7601		/*!< The mailbox of the actor is full, the message is dropped */
+#define ERR_ACTOR_STOPPED                   0x7602		/*!< The actor is stopped */
+#define ERR_ACTOR_DROPPED                   0x7603		/*!< The message was dropped from the mailbox (drop oldest) */
+#define ERR_ACTOR_NOSYSTEM                  0x7604		/*!< The actor is not spawned in a actor system */
+#define ERR_ACTOR_TOOMANY                   0x7605		/*!< The actor system has no free actor slot */
+#define ERR_ACTOR_CANTCREATE                0x7606		/*!< The mailbox or the worker tasks can't create */
+#define ERR_ACTOR_ALREADYINIT               0x7607		/*!< The actor is already spawned or the system already created */
+#define ERR_ACTOR_FAILED                    0x7608		/*!< The actor failed on the message */
+#define ERR_ACTOR_WOULDBLOCK                0x7609		/*!< A worker of the actor system would wait on a full mailbox, the message is dropped */
+
+#define ERR_CHANNEL_OK                      NO_ERROR	/*!< No Error in one of the channel function */
+#define ERR_CHANNEL_CLOSED                  0x7701		/*!< The channel is closed (send) or closed and empty (receive) */
+#define ERR_CHANNEL_TIMEOUT                 0x7702		/*!< The channel was not ready before the timeout */
+#define ERR_CHANNEL_NOTASK                  0x7703		/*!< A blocking wait from the ISR Context or before the scheduler is started */
+
+#define ERR_EVENTBUS_OK                     NO_ERROR	/*!< No Error in one of the event bus function */
+#define ERR_EVENTBUS_TABLEFULL              0x7801		/*!< The topic table is full */
+#define ERR_EVENTBUS_NOSUBSCRIPTION         0x7802		/*!< No free subscription, see MN_THREAD_CONFIG_EVENTBUS_SUBSCRIPTIONS */
+#define ERR_EVENTBUS_NOTFOUND               0x7803		/*!< The subscriber is not subscribed to the topic */
+#define ERR_EVENTBUS_ALREADY                0x7804		/*!< The subscriber is already subscribed to the topic */
+
 #define ERR_MEMPOOL_OK                    	NO_ERROR 	/*!< No error*/
 #define ERR_MEMPOOL_BADALIGNMENT          	0x8003 		/*!< The given ligent im mempool are bad */
 #define ERR_MEMPOOL_CREATE                	0x8004 		/*!< The mempool can not create */
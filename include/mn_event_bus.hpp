@@ -0,0 +1,555 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_EVENT_BUS_H__
+#define __MINILIB_EVENT_BUS_H__
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+#include "mn_typetraits.hpp"
+#include "mn_shared_mutex.hpp"
+#include "queue/mn_typed_queue.hpp"
+#include "queue/mn_workqueue.hpp"
+
+namespace mn {
+    /**
+     * @brief The id of a topic, the FNV-1a hash of the topic name
+     * @ingroup event
+     */
+    using topic_id_t = uint32_t;
+
+    namespace internal {
+        constexpr size_t topic_length(const char* strName) {
+            size_t _uiLength = 0;
+            while(strName[_uiLength] != '\0') _uiLength++;
+            return _uiLength;
+        }
+
+        constexpr topic_id_t topic_hash(const char* strName, size_t uiLength) {
+            topic_id_t _hash = 2166136261u;
+
+            for(size_t i = 0; i < uiLength; i++) {
+                _hash ^= static_cast<uint8_t>(strName[i]);
+                _hash *= 16777619u;
+            }
+            return _hash;
+        }
+    }
+
+    /**
+     * @brief A topic of the event bus, hashed at compile time when the name is a literal.
+     *
+     * The levels of a topic are separated with '/'. A topic that ends with '*' is a wildcard
+     * and matches all topics below: "sensor/ *" matches "sensor/temp" and "sensor/imu/gyro",
+     * "*" matches all topics.
+     *
+     * @code
+     * constexpr mn::topic TOPIC_TEMP("sensor/temp");
+     * static_assert(TOPIC_TEMP.id == mn::topic("sensor/temp").id, "");
+     * @endcode
+     *
+     * @ingroup event
+     */
+    struct topic {
+        topic_id_t id;                                          /*!< The hash of the name, for a wildcard of the prefix */
+        topic_id_t ancestors[MN_THREAD_CONFIG_EVENTBUS_DEPTH];  /*!< The hashes of the prefixes, for the wildcards */
+        uint8_t depth;                                          /*!< The number of ancestors */
+        bool wildcard;                                          /*!< Is this a wildcard topic? */
+
+        constexpr topic(const char* strName)
+            : id(0), ancestors{}, depth(0), wildcard(false) {
+
+            size_t _uiLength = internal::topic_length(strName);
+
+            if(_uiLength > 0 && strName[_uiLength - 1] == '*' &&
+               (_uiLength == 1 || strName[_uiLength - 2] == '/')) {
+                wildcard = true;
+                id = internal::topic_hash(strName, _uiLength == 1 ? 0 : _uiLength - 2);
+                return;
+            }
+            id = internal::topic_hash(strName, _uiLength);
+
+            // "" is the root, matched by "*"
+            ancestors[depth++] = internal::topic_hash(strName, 0);
+
+            for(size_t i = 0; i < _uiLength && depth < MN_THREAD_CONFIG_EVENTBUS_DEPTH; i++) {
+                if(strName[i] == '/') ancestors[depth++] = internal::topic_hash(strName, i);
+            }
+        }
+    };
+
+    namespace literals {
+        /**
+         * @brief Create a topic: "sensor/temp"_topic
+         */
+        constexpr topic operator "" _topic(const char* strName, size_t) {
+            return topic(strName);
+        }
+    }
+
+    /**
+     * @brief A event, how the subscribers see it. The payload is only valid in the handler.
+     * @ingroup event
+     */
+    struct bus_event {
+        using type_id = const void*;
+
+        topic_id_t topic;       /*!< The id of the published topic */
+        type_id type;           /*!< The type of the payload, nullptr for none */
+        uint32_t size;          /*!< The size of the payload in bytes */
+        const void* data;       /*!< The payload */
+
+        /**
+         * @brief Get the unique type id for the given type
+         */
+        template <typename T>
+        static type_id type_of() {
+            static const char _cTag = 0;
+            return &_cTag;
+        }
+
+        /**
+         * @brief Holds the event a payload of the given type?
+         */
+        template <typename T>
+        bool is() const { return type == type_of<T>(); }
+
+        /**
+         * @brief Get the payload
+         * @return A pointer to the payload or nullptr, when the payload has a other type
+         */
+        template <typename T>
+        const T* get() const {
+            return is<T>() ? static_cast<const T*>(data) : nullptr;
+        }
+    };
+
+    class basic_event_bus;
+
+    /**
+     * @brief A subscriber of the event bus, on_event is called synchronously in the
+     * context of the publishing task.
+     *
+     * @note A subscriber must be unsubscribed, before it is destroyed.
+     * @ingroup event
+     */
+    class basic_bus_subscriber {
+        friend class basic_event_bus;
+    public:
+        basic_bus_subscriber() : m_pBus(NULL), m_uiActive(0), m_pIdleWaiters(NULL) { }
+        virtual ~basic_bus_subscriber() { }
+
+        basic_bus_subscriber(const basic_bus_subscriber&) = delete;
+        basic_bus_subscriber& operator=(const basic_bus_subscriber&) = delete;
+
+        /**
+         * @brief Get the bus of the last subscribe, NULL when never subscribed
+         */
+        basic_event_bus* get_bus() const { return m_pBus; }
+    protected:
+        /**
+         * @brief Implementation of your event handler.
+         * @note You must override this function.
+         */
+        virtual void on_event(const bus_event& ev) = 0;
+
+        /**
+         * @brief Called from publish, the default calls on_event
+         */
+        virtual void deliver(const bus_event& ev) { on_event(ev); }
+
+        /**
+         * A task, that waits until the subscriber is idle, the node lives on the stack of the waiting task
+         */
+        struct idle_waiter {
+            TaskHandle_t pTask;
+            idle_waiter* pNext;
+            volatile bool bDone;
+        };
+
+        /**
+         * @brief Wake the waiting tasks, call after the last access to the subscriber
+         */
+        static void notify_idle(idle_waiter* pWaiters);
+        /**
+         * @brief Wait until the node is woken from notify_idle
+         */
+        static void wait_idle(idle_waiter& node);
+    private:
+        /**
+         * The bus of the last subscribe
+         */
+        basic_event_bus* m_pBus;
+        /**
+         * How many publish calls deliver at the moment to this subscriber
+         */
+        atomic_uint32_t m_uiActive;
+        /**
+         * The unsubscribing tasks, that wait until m_uiActive is 0, guarded from the bus
+         */
+        idle_waiter* m_pIdleWaiters;
+    };
+
+    /**
+     * @brief A subscriber with a own event queue. publish copies the event in the queue and the
+     * events are handled in batches on a work queue, or with dispatch from the owner task.
+     *
+     * The destructor calls close, so the subscriber is removed from the bus and no batch
+     * is queued or running, when the memory is released. A derived class, whose handler
+     * uses own members, calls close in its own destructor.
+     *
+     * @tparam TQueueSize Maximal number of queued events
+     * @tparam TBatch Maximal number of events for one on_batch call
+     * @tparam TPayload Maximal size of the payload of a event
+     *
+     * @ingroup event
+     */
+    template <unsigned int TQueueSize = MN_THREAD_CONFIG_EVENTBUS_QUEUE_SIZE,
+              unsigned int TBatch = MN_THREAD_CONFIG_EVENTBUS_BATCH,
+              unsigned int TPayload = MN_THREAD_CONFIG_EVENTBUS_PAYLOAD>
+    class basic_deferred_subscriber : public basic_bus_subscriber, public queue::work_queue_item {
+        /**
+         * A event in the queue, the payload is stored by value
+         */
+        struct stored_event {
+            topic_id_t topic;
+            bus_event::type_id type;
+            uint32_t size;
+            alignas(uint64_t) uint8_t data[TPayload > 0 ? TPayload : 1];
+        };
+    public:
+        using queue_type = queue::typed_queue<stored_event, TQueueSize>;
+
+        /**
+         * @param pWorkQueue The work queue that handles the events, NULL when the owner
+         * task calls dispatch
+         */
+        explicit basic_deferred_subscriber(queue::basic_work_queue* pWorkQueue = NULL)
+            : basic_bus_subscriber(), queue::work_queue_item(false),
+              m_qeEvents(), m_pWorkQueue(pWorkQueue), m_uiScheduled(0), m_uiBusy(0),
+              m_uiDropped(0), m_bClosed(false), m_pWaiters(NULL) {
+
+            vPortCPUInitializeMutex(&m_Mux);
+            m_qeEvents.create();
+        }
+
+        virtual ~basic_deferred_subscriber() { close(); }
+
+        /**
+         * @brief Remove all subscriptions from the bus and wait, until a queued or running
+         * batch has ended. Events still in the queue are dropped.
+         *
+         * @note The work queue must still run. Do not call it from on_batch or on_event.
+         */
+        void close();
+
+        /**
+         * @brief Handle the queued events in the calling task
+         *
+         * @param timeout How long to wait for the first event
+         * @return The number of handled events
+         */
+        unsigned int dispatch(unsigned int timeout = 0) {
+            stored_event _stored[TBatch];
+            bus_event _events[TBatch];
+
+            unsigned int _uiCount = m_qeEvents.dequeue_n(_stored, TBatch, timeout);
+
+            for(unsigned int i = 0; i < _uiCount; i++) {
+                _events[i].topic = _stored[i].topic;
+                _events[i].type = _stored[i].type;
+                _events[i].size = _stored[i].size;
+                _events[i].data = _stored[i].data;
+            }
+            if(_uiCount > 0) on_batch(_events, _uiCount);
+
+            return _uiCount;
+        }
+
+        /**
+         * @brief How many events are dropped, the queue was full or the payload too big
+         */
+        uint32_t get_dropped() { return m_uiDropped.load(); }
+        /**
+         * @brief Get the number of queued events
+         */
+        unsigned int get_pending() { return m_qeEvents.get_num_items(); }
+    protected:
+        /**
+         * @brief Called with each batch of events, calls on_event for each event
+         */
+        virtual void on_batch(const bus_event* events, unsigned int count) {
+            for(unsigned int i = 0; i < count; i++)
+                on_event(events[i]);
+        }
+
+        virtual void deliver(const bus_event& ev) override {
+            stored_event _stored;
+
+            if(ev.size > TPayload) { m_uiDropped.fetch_add(1); return; }
+
+            _stored.topic = ev.topic;
+            _stored.type = ev.type;
+            _stored.size = ev.size;
+            if(ev.size > 0) memcpy(_stored.data, ev.data, ev.size);
+
+            if(m_qeEvents.enqueue(_stored, 0) != ERR_QUEUE_OK) {
+                m_uiDropped.fetch_add(1);
+                return;
+            }
+            schedule();
+        }
+
+        /**
+         * @brief Run on the work queue, handles one batch
+         */
+        virtual bool on_work() override {
+            m_uiBusy.fetch_add(1);
+
+            if(!m_bClosed.load()) dispatch(0);
+
+            m_uiScheduled.store(0);
+
+            // a event queued while handling has not scheduled the subscriber
+            if(!m_qeEvents.is_empty()) schedule();
+
+            // the last access to the subscriber, close waits for it
+            leave(true);
+            return true;
+        }
+
+        /**
+         * @brief The work queue is destroyed before the batch has run
+         */
+        virtual void on_drop() override {
+            m_uiScheduled.store(0);
+            leave(false);
+        }
+    private:
+        /**
+         * Wake close, when no batch is queued or running. Don't touch the subscriber after it
+         */
+        void leave(bool bBusy) {
+            idle_waiter* _pWaiters = NULL;
+
+            portENTER_CRITICAL_SAFE(&m_Mux);
+                if(bBusy) m_uiBusy.fetch_sub(1);
+
+                if(m_uiScheduled.load() == 0 && m_uiBusy.load() == 0) {
+                    _pWaiters = m_pWaiters;
+                    m_pWaiters = NULL;
+                }
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+
+            notify_idle(_pWaiters);
+        }
+
+        void schedule() {
+            if(m_pWorkQueue == NULL || m_bClosed.load()) return;
+
+            uint32_t _uiExpected = 0;
+            if(!m_uiScheduled.compare_exchange_strong(_uiExpected, 1)) return;
+
+            // the next publish tries again
+            if(m_pWorkQueue->queue(this, 0) != ERR_WORKQUEUE_OK)
+                m_uiScheduled.store(0);
+        }
+    protected:
+        queue_type m_qeEvents;
+        queue::basic_work_queue* m_pWorkQueue;
+        atomic_uint32_t m_uiScheduled;
+        atomic_uint32_t m_uiBusy;
+        atomic_uint32_t m_uiDropped;
+        atomic_bool m_bClosed;
+    private:
+        /**
+         * Guards the end of a batch and the tasks waiting in close
+         */
+        portMUX_TYPE m_Mux;
+        idle_waiter* m_pWaiters;
+    };
+
+    /**
+     * @brief A publish-subscribe hub.
+     *
+     * The subscriptions are stored in a hash table with the topic id as key, so publish
+     * makes one table lookup for the topic and one for each level of the topic (wildcards).
+     * The matching subscribers are collected under the shared lock and called after the lock
+     * is released, so a handler can publish and subscribe.
+     *
+     * @code
+     * struct temp_event { float celsius; };
+     *
+     * class logger : public mn::basic_bus_subscriber {
+     *     void on_event(const mn::bus_event& ev) override {
+     *         if(const temp_event* t = ev.get<temp_event>()) log_temp(t->celsius);
+     *     }
+     * } log;
+     *
+     * mn::event_bus_t::instance().subscribe(mn::topic("sensor/ *"), log);
+     * mn::event_bus_t::instance().publish(mn::topic("sensor/temp"), temp_event{ 21.5f });
+     * @endcode
+     *
+     * @note Can not use in the ISR Context.
+     * @ingroup event
+     */
+    class basic_event_bus {
+        static_assert((MN_THREAD_CONFIG_EVENTBUS_TOPICS & (MN_THREAD_CONFIG_EVENTBUS_TOPICS - 1)) == 0,
+                      "MN_THREAD_CONFIG_EVENTBUS_TOPICS must be a power of two");
+
+        /**
+         * A subscriber of a topic, in a single linked list per topic
+         */
+        struct subscription {
+            basic_bus_subscriber* pSubscriber;
+            subscription* pNext;
+        };
+        /**
+         * A entry of the topic table
+         */
+        struct topic_slot {
+            topic_id_t key;
+            bool bUsed;
+            bool bWildcard;
+            subscription* pFirst;
+        };
+    public:
+        basic_event_bus();
+
+        basic_event_bus(const basic_event_bus&) = delete;
+        basic_event_bus& operator=(const basic_event_bus&) = delete;
+
+        /**
+         * @brief Get the process wide event bus
+         */
+        static basic_event_bus& instance();
+
+        /**
+         * @brief Subscribe to a topic or a wildcard topic
+         *
+         * @return ERR_EVENTBUS_OK, ERR_EVENTBUS_ALREADY, ERR_EVENTBUS_TABLEFULL or
+         * ERR_EVENTBUS_NOSUBSCRIPTION
+         */
+        int subscribe(const topic& t, basic_bus_subscriber& subscriber);
+        /**
+         * @brief Remove the subscription, waits until no publish delivers to the subscriber
+         *
+         * @note Do not call it from the handler of the same subscriber
+         * @return ERR_EVENTBUS_OK or ERR_EVENTBUS_NOTFOUND
+         */
+        int unsubscribe(const topic& t, basic_bus_subscriber& subscriber);
+        /**
+         * @brief Remove all subscriptions of the subscriber
+         * @return The number of removed subscriptions
+         */
+        uint32_t unsubscribe_all(basic_bus_subscriber& subscriber);
+
+        /**
+         * @brief Publish a event with a payload
+         *
+         * @note T is copied with memcpy by the deferred subscribers
+         * @return The number of subscribers, that got the event
+         */
+        template <typename T>
+        uint32_t publish(const topic& t, const T& payload) {
+            static_assert(is_trivially_copyable<T>::value, "the payload of a event must be trivially copyable");
+
+            bus_event _ev = { t.id, bus_event::type_of<T>(), sizeof(T), &payload };
+            return publish_event(t, _ev);
+        }
+        /**
+         * @brief Publish a event without a payload
+         * @return The number of subscribers, that got the event
+         */
+        uint32_t publish(const topic& t) {
+            bus_event _ev = { t.id, nullptr, 0, nullptr };
+            return publish_event(t, _ev);
+        }
+
+        /**
+         * @brief Publish the event
+         * @return The number of subscribers, that got the event
+         */
+        uint32_t publish_event(const topic& t, const bus_event& ev);
+
+        /**
+         * @brief How many deliveries are lost, because more as
+         * MN_THREAD_CONFIG_EVENTBUS_FANOUT subscribers matched
+         */
+        uint32_t get_dropped() { return m_uiDropped.load(); }
+        /**
+         * @brief Get the number of used subscriptions
+         */
+        uint32_t get_subscriptions() const { return m_uiSubscriptions; }
+    private:
+        topic_slot* find_slot(topic_id_t key, bool bWildcard, bool bInsert);
+        void collect(topic_slot* pSlot, basic_bus_subscriber** pList, uint32_t& uiCount);
+        void wait_idle(basic_bus_subscriber& subscriber);
+    private:
+        shared_mutex_t m_Lock;
+        /**
+         * Guards the last delivery to a subscriber and its waiting tasks
+         */
+        portMUX_TYPE m_IdleMux;
+        topic_slot m_Table[MN_THREAD_CONFIG_EVENTBUS_TOPICS];
+        subscription m_Subscriptions[MN_THREAD_CONFIG_EVENTBUS_SUBSCRIPTIONS];
+        subscription* m_pFree;
+        uint32_t m_uiSubscriptions;
+        atomic_uint32_t m_uiDropped;
+    };
+
+    using event_bus_t = basic_event_bus;
+
+    //-----------------------------------
+    //  basic_deferred_subscriber::close
+    //-----------------------------------
+    template <unsigned int TQueueSize, unsigned int TBatch, unsigned int TPayload>
+    void basic_deferred_subscriber<TQueueSize, TBatch, TPayload>::close() {
+        // waits for the running publish calls, no event is delivered after it
+        if(get_bus() != NULL) get_bus()->unsubscribe_all(*this);
+
+        m_bClosed.store(true);
+
+        // the work queue holds a pointer to the subscriber, until on_work has ended
+        idle_waiter _node;
+        bool _bIdle;
+
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            _bIdle = (m_uiScheduled.load() == 0 && m_uiBusy.load() == 0);
+
+            if(!_bIdle) {
+                _node.pTask = xTaskGetCurrentTaskHandle();
+                _node.bDone = false;
+                _node.pNext = m_pWaiters;
+                m_pWaiters = &_node;
+            }
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        if(!_bIdle) wait_idle(_node);
+    }
+}
+
+#endif // __MINILIB_EVENT_BUS_H__
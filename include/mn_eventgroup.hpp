@@ -27,6 +27,10 @@
 
 #include "mn_copyable.hpp"
 
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+#include "coroutine/mn_co_event.hpp"
+#endif
+
 namespace mn {
     /**
      * @brief Wrapper class around FreeRTOS's implementation of a event_group.
@@ -221,6 +225,14 @@ namespace mn {
          * @param strName The name of this class.
          */
         void set_name(const char* strName);
+
+    #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+        /**
+         * @brief Get the event for the coroutines, that await bits (co_wait_bits).
+         * set and sync resumes the coroutines.
+         */
+        basic_co_event& get_co_event() { return m_CoEvent; }
+    #endif
 	private:
 		/**
 		 * @brief Initialisert the eventgroup
@@ -236,6 +248,10 @@ namespace mn {
 		 */
         char m_strName[16];
 
+    #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+        basic_co_event m_CoEvent;
+    #endif
+
 	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 		/**
 		 * @brief Holder of data for the static creating eventgroup
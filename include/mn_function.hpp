@@ -40,14 +40,14 @@ namespace mn {
 
             void (*destroyer)(void *);
 
-            R (*invoke)(void const *t, Args &&...args);
+            R (*invoke)(void *t, Args &&...args);
 
             template <class T> static vtable_t const *get() {
                 static const vtable_t table = {
                     [](void *src, void *dest) { new (dest) T(move(*static_cast<T *>(src))); },
                     [](void *t) { static_cast<T *>(t)->~T(); },
-                    [](void const *t, Args &&...args) -> R {
-                        return (*static_cast<T const *>(t))(forward<Args>(args)...);
+                    [](void *t, Args &&...args) -> R {
+                        return (*static_cast<T *>(t))(forward<Args>(args)...);
                     }
 				};
                 return &table;
@@ -65,8 +65,8 @@ namespace mn {
             if (table) table->mover(&o.data, &data);
         }
 
-        template <class F, class dF = decay_t<F>, enable_if_t<!is_same<dF, small_task>{}> * = nullptr,
-                  enable_if_t<is_convertible<res_of_t<dF &(Args...)>, R>{}> * = nullptr>
+        template <class F, class dF = decay_t<F>, enable_if_t<!is_same<dF, small_task>::value> * = nullptr,
+                  enable_if_t<is_convertible<res_of_t<dF &(Args...)>, R>::value> * = nullptr>
         small_task(F &&f) : table(vtable_t::template get<dF>()) {
             static_assert(sizeof(dF) <= sz, "object too large");
             static_assert(alignof(dF) <= algn, "object too aligned");
@@ -93,8 +93,9 @@ namespace mn {
             return table;
         }
 
+        // like std::function, the stored callable is called non const, so a mutable lambda works
         return_type operator()(Args... args) const {
-            return table->invoke(&data, mn::forward<Args>(args)...);
+            return table->invoke(const_cast<aligned_storage_t<sz, algn>*>(&data), mn::forward<Args>(args)...);
         }
 	private:
 		vtable_t const *table = nullptr;
@@ -127,6 +128,5 @@ namespace mn {
 
 }
 
-#include <functional>
 
 #endif
@@ -168,7 +168,7 @@ namespace mn {
         template <class G, class... Args>
         using invoke_t = decltype(declval<G>()(declval<Args>()...));
 
-        template <class Sig, class = void>
+        template <class Sig, class = void_t<>>
         struct res_of {};
         template <class G, class... Args>
         struct res_of<G(Args...), void_t<invoke_t<G, Args...>>> : tag<invoke_t<G, Args...>> {};
@@ -176,11 +176,11 @@ namespace mn {
     }
 
     template <template <typename...> typename Z, typename... Ts>
-    using can_apply = internal::can_apply<Z, void, Ts...>;
+    using can_apply = internal::can_apply<Z, void_t<>, Ts...>;
 
 
     template <typename From, typename To>
-    struct is_convertible : internal::can_apply<internal::try_convert, From, To> {};
+    struct is_convertible : can_apply<internal::try_convert, From, To> {};
 
     template <> struct is_convertible<void, void> : true_type {};
 
@@ -0,0 +1,729 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_MN_FUTURE_H_
+#define _MINLIB_MN_FUTURE_H_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stddef.h>
+#include <new>
+
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+#include "mn_typetraits.hpp"
+#include "mn_function.hpp"
+#include "mn_timespan.hpp"
+
+namespace mn {
+    template <typename R> class future;
+    template <typename R> class basic_future_state;
+
+    namespace internal {
+        /**
+         * A static pool of N objects of type T. A slot is claimed with a CAS on a bit mask,
+         * so allocate and deallocate are lock free and can be used from an ISR.
+         * When the pool is empty, the memory comes from operator new.
+         */
+        template <typename T, size_t N = MN_THREAD_CONFIG_FUTURE_POOL_SIZE>
+        class basic_future_pool {
+            static_assert(N > 0 && N <= 32, "the future pool size must be between 1 and 32");
+
+            using slot_type = aligned_storage_t<sizeof(T), alignof(T)>;
+        public:
+            /**
+             * Get memory for one T
+             * @return The memory or NULL when the pool is empty and operator new fails
+             */
+            static void* allocate() {
+                uint32_t _uiUsed = m_uiUsed.load();
+
+                for(size_t i = 0; i < N; ) {
+                    if(_uiUsed & (1u << i)) { i++; continue; }
+
+                    // on failure _uiUsed is reloaded and the same slot is checked again
+                    if(m_uiUsed.compare_exchange_weak(_uiUsed, _uiUsed | (1u << i)))
+                        return &m_Storage[i];
+                }
+                return ::operator new(sizeof(T), std::nothrow);
+            }
+
+            /**
+             * Give the memory back to the pool or to operator delete
+             */
+            static void deallocate(void* pMem) {
+                char* _pMem = static_cast<char*>(pMem);
+                char* _pBegin = reinterpret_cast<char*>(&m_Storage[0]);
+
+                if(_pMem >= _pBegin && _pMem < reinterpret_cast<char*>(&m_Storage[N])) {
+                    uint32_t _uiSlot = (_pMem - _pBegin) / sizeof(slot_type);
+                    m_uiUsed.fetch_and(~(1u << _uiSlot));
+                } else {
+                    ::operator delete(pMem);
+                }
+            }
+        private:
+            static slot_type m_Storage[N];
+            static atomic_uint32_t m_uiUsed;
+        };
+
+        template <typename T, size_t N>
+        typename basic_future_pool<T, N>::slot_type basic_future_pool<T, N>::m_Storage[N];
+
+        template <typename T, size_t N>
+        atomic_uint32_t basic_future_pool<T, N>::m_uiUsed(0);
+
+        /**
+         * Inline storage for the result of a future
+         */
+        template <typename R>
+        class future_value {
+        public:
+            future_value() : m_bHasValue(false) { }
+            ~future_value() { if(m_bHasValue) get().~R(); }
+
+            template <typename... TArgs>
+            void construct(TArgs&&... args) {
+                new (&m_Storage) R(mn::forward<TArgs>(args)...);
+                m_bHasValue = true;
+            }
+
+            R& get() { return *reinterpret_cast<R*>(&m_Storage); }
+        private:
+            aligned_storage_t<sizeof(R), alignof(R)> m_Storage;
+            bool m_bHasValue;
+        };
+
+        template <>
+        class future_value<void> {
+        public:
+            void construct() { }
+        };
+    }
+
+    /**
+     * The shared state between a promise and a future or a submitted job and a future.
+     * The state is reference counted and lives in a static pool per result type,
+     * so creating one does not touch the heap while the pool has free slots.
+     *
+     * @note Only one task can wait on a state at a time. The wait use the task notification
+     * of the waiting task.
+     *
+     * @tparam R The type of the result
+     */
+    template <typename R>
+    class basic_future_state {
+        static_assert(!is_reference<R>::value, "a future of a reference is not supported");
+
+        enum { STATE_EMPTY = 0, STATE_CONTINUATION = 1, STATE_READY = 2 };
+    public:
+        using value_type = R;
+        using self_type = basic_future_state<R>;
+        using continuation_type = small_task<void(), MN_THREAD_CONFIG_FUTURE_TASK_SIZE, alignof(max_align_t)>;
+
+        basic_future_state()
+            : m_uiRefs(1), m_uiState(STATE_EMPTY), m_bSet(false),
+              m_iError(ERR_FUTURE_OK), m_pWaiter(NULL) { }
+
+        virtual ~basic_future_state() { }
+
+        /**
+         * Create a new state with one reference
+         * @return The new state or NULL when no memory
+         */
+        static self_type* create() {
+            void* _pMem = internal::basic_future_pool<self_type>::allocate();
+            return (_pMem != NULL) ? new (_pMem) self_type() : NULL;
+        }
+
+        void add_ref() { m_uiRefs.fetch_add(1); }
+        /**
+         * Release one reference, the last one destroy the state
+         */
+        void release() {
+            if(m_uiRefs.fetch_sub(1) == 1) destroy();
+        }
+
+        /**
+         * Is the result or a error set?
+         */
+        bool is_ready() const { return m_uiState.load() == STATE_READY; }
+        /**
+         * Get the error of the state, ERR_FUTURE_OK when the result was set
+         */
+        int get_error() const { return m_iError; }
+        /**
+         * Get the result, only valid after is_ready and no error
+         */
+        template <typename U = R>
+        enable_if_t<!is_void<U>::value, U&> get_value() { return m_Value.get(); }
+
+        /**
+         * Set the result and wake the waiting task and run the continuation
+         * @return ERR_FUTURE_OK or ERR_FUTURE_ALREADYSET
+         */
+        template <typename... TArgs>
+        int set_value(TArgs&&... args) {
+            if(m_bSet.exchange(true)) return ERR_FUTURE_ALREADYSET;
+
+            m_Value.construct(mn::forward<TArgs>(args)...);
+            finish();
+            return ERR_FUTURE_OK;
+        }
+
+        /**
+         * Set a error in place of the result and wake the waiting task and run the continuation
+         * @return ERR_FUTURE_OK or ERR_FUTURE_ALREADYSET
+         */
+        int set_error(int iError) {
+            if(m_bSet.exchange(true)) return ERR_FUTURE_ALREADYSET;
+
+            m_iError = iError;
+            finish();
+            return ERR_FUTURE_OK;
+        }
+
+        /**
+         * Wait until the state is ready
+         * @param xTicksToWait How many ticks to wait
+         * @return ERR_FUTURE_OK or ERR_FUTURE_TIMEOUT
+         */
+        int wait(unsigned int xTicksToWait) {
+            if(is_ready()) return ERR_FUTURE_OK;
+            if(xTicksToWait == 0) return ERR_FUTURE_TIMEOUT;
+
+            __atomic_store_n(&m_pWaiter, xTaskGetCurrentTaskHandle(), __ATOMIC_SEQ_CST);
+
+            TickType_t _xStart = xTaskGetTickCount();
+            TickType_t _xLeft = xTicksToWait;
+
+            while(!is_ready()) {
+                if(xTicksToWait != portMAX_DELAY) {
+                    TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                    if(_xElapsed >= xTicksToWait) break;
+
+                    _xLeft = xTicksToWait - _xElapsed;
+                }
+                ulTaskNotifyTake(pdTRUE, _xLeft);
+            }
+            __atomic_store_n(&m_pWaiter, (TaskHandle_t)NULL, __ATOMIC_SEQ_CST);
+
+            return is_ready() ? ERR_FUTURE_OK : ERR_FUTURE_TIMEOUT;
+        }
+
+        /**
+         * Set the function, that is called once when the state becomes ready. When the state is
+         * ready, the function is called now from the caller.
+         * @return ERR_FUTURE_OK or ERR_FUTURE_ALREADYSET when a continuation was already set
+         */
+        int set_continuation(continuation_type&& fn) {
+            uint32_t _uiState = m_uiState.load();
+
+            if(_uiState == STATE_CONTINUATION) return ERR_FUTURE_ALREADYSET;
+
+            if(_uiState == STATE_EMPTY) {
+                m_Continuation = mn::move(fn);
+                if(m_uiState.compare_exchange_strong(_uiState, STATE_CONTINUATION))
+                    return ERR_FUTURE_OK;
+
+                // became ready between the load and the CAS
+                continuation_type _fn(mn::move(m_Continuation));
+                _fn();
+            } else {
+                fn();
+            }
+            return ERR_FUTURE_OK;
+        }
+    protected:
+        /**
+         * Destroy this state and give the memory back, a sub class must override this
+         */
+        virtual void destroy() {
+            this->~basic_future_state();
+            internal::basic_future_pool<self_type>::deallocate(this);
+        }
+    private:
+        void finish() {
+            // the waiter or the continuation can release the last other reference
+            add_ref();
+
+            uint32_t _uiPrev = m_uiState.exchange(STATE_READY);
+            TaskHandle_t _pWaiter = __atomic_load_n(&m_pWaiter, __ATOMIC_SEQ_CST);
+
+            if(_pWaiter != NULL) {
+                if (xPortInIsrContext()) {
+                    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+                    vTaskNotifyGiveFromISR(_pWaiter, &xHigherPriorityTaskWoken);
+
+                    if(xHigherPriorityTaskWoken)
+                        _frxt_setup_switch();
+                } else {
+                    xTaskNotifyGive(_pWaiter);
+                }
+            }
+            if(_uiPrev == STATE_CONTINUATION) {
+                continuation_type _fn(mn::move(m_Continuation));
+                _fn();
+            }
+            release();
+        }
+    private:
+        atomic_uint32_t m_uiRefs;
+        atomic_uint32_t m_uiState;
+        atomic_bool m_bSet;
+        int m_iError;
+        TaskHandle_t m_pWaiter;
+        continuation_type m_Continuation;
+        internal::future_value<R> m_Value;
+    };
+
+    namespace internal {
+        /**
+         * Call a function and set the result in a future state
+         */
+        template <typename R>
+        struct future_invoker {
+            template <typename F, typename... TArgs>
+            static void invoke(basic_future_state<R>* pState, F& fn, TArgs&&... args) {
+                pState->set_value(fn(mn::forward<TArgs>(args)...));
+            }
+        };
+
+        template <>
+        struct future_invoker<void> {
+            template <typename F, typename... TArgs>
+            static void invoke(basic_future_state<void>* pState, F& fn, TArgs&&... args) {
+                fn(mn::forward<TArgs>(args)...);
+                pState->set_value();
+            }
+        };
+
+        /**
+         * A reference of a state, owned by a continuation. When the continuation is destroyed
+         * without a call, the state gets TError (not ERR_FUTURE_OK) and the reference is released.
+         */
+        template <typename TState, int TError = ERR_FUTURE_BROKEN>
+        class future_state_ref {
+        public:
+            explicit future_state_ref(TState* pState) : m_pState(pState) { }
+            future_state_ref(future_state_ref&& other) : m_pState(other.m_pState) { other.m_pState = NULL; }
+
+            ~future_state_ref() {
+                if(m_pState == NULL) return;
+
+                if(TError != ERR_FUTURE_OK) m_pState->set_error(TError);
+                m_pState->release();
+            }
+
+            future_state_ref(const future_state_ref&) = delete;
+            future_state_ref& operator = (const future_state_ref&) = delete;
+
+            TState* get() const { return m_pState; }
+            /**
+             * Release the reference, after the continuation has set the state
+             */
+            void release() {
+                if(m_pState != NULL) m_pState->release();
+                m_pState = NULL;
+            }
+        private:
+            TState* m_pState;
+        };
+    }
+
+    /**
+     * A future holds the result of a asynchronous operation: a job submitted to a work queue
+     * or a value set by a promise.
+     *
+     * @code
+     * mn::future<int> f = workqueue.submit([]() { return 42; });
+     * int value;
+     * if(f.get(value) == ERR_FUTURE_OK) { ... }
+     * @endcode
+     *
+     * @tparam R The type of the result, can be void
+     */
+    template <typename R>
+    class future {
+        template <typename> friend class future;
+    public:
+        using value_type = R;
+        using self_type = future<R>;
+        using state_type = basic_future_state<R>;
+
+        /**
+         * Construct a future without a state
+         */
+        future() : m_pState(NULL) { }
+        /**
+         * Construct a future, that adopt one reference of the given state
+         */
+        explicit future(state_type* pState) : m_pState(pState) { }
+
+        future(self_type&& other) : m_pState(other.m_pState) { other.m_pState = NULL; }
+
+        ~future() { reset(); }
+
+        future(const self_type&) = delete;
+        self_type& operator = (const self_type&) = delete;
+
+        self_type& operator = (self_type&& other) {
+            if(this != &other) {
+                reset();
+                m_pState = other.m_pState;
+                other.m_pState = NULL;
+            }
+            return *this;
+        }
+
+        /**
+         * Has this future a shared state?
+         */
+        bool valid() const { return m_pState != NULL; }
+        /**
+         * Is the result or a error ready?
+         */
+        bool is_ready() const { return (m_pState != NULL) && m_pState->is_ready(); }
+
+        /**
+         * Wait until the result is ready
+         * @param xTicksToWait How many ticks to wait
+         * @return ERR_FUTURE_OK, ERR_FUTURE_TIMEOUT or ERR_FUTURE_NOSTATE
+         */
+        int wait(unsigned int xTicksToWait = portMAX_DELAY) {
+            if(m_pState == NULL) return ERR_FUTURE_NOSTATE;
+            return m_pState->wait(xTicksToWait);
+        }
+        /**
+         * Wait until the result is ready
+         * @param time How long to wait
+         * @return ERR_FUTURE_OK, ERR_FUTURE_TIMEOUT or ERR_FUTURE_NOSTATE
+         */
+        int wait(timespan_t time) {
+            return wait(time.to_ticks());
+        }
+
+        /**
+         * Wait for the result and move it out, after this the future has no state
+         * @param value The holder for the result
+         * @param xTicksToWait How many ticks to wait
+         * @return ERR_FUTURE_OK, ERR_FUTURE_TIMEOUT, ERR_FUTURE_NOSTATE or the error of the state
+         */
+        template <typename U = R>
+        enable_if_t<!is_void<U>::value, int> get(type_t<tag<U>>& value, unsigned int xTicksToWait = portMAX_DELAY) {
+            int _iError = wait(xTicksToWait);
+            if(_iError != ERR_FUTURE_OK) return _iError;
+
+            _iError = m_pState->get_error();
+            if(_iError == ERR_FUTURE_OK)
+                value = mn::move(m_pState->get_value());
+
+            reset();
+            return _iError;
+        }
+
+        /**
+         * Wait for the end of the job, after this the future has no state
+         * @param xTicksToWait How many ticks to wait
+         * @return ERR_FUTURE_OK, ERR_FUTURE_TIMEOUT, ERR_FUTURE_NOSTATE or the error of the state
+         */
+        template <typename U = R>
+        enable_if_t<is_void<U>::value, int> get(unsigned int xTicksToWait = portMAX_DELAY) {
+            int _iError = wait(xTicksToWait);
+            if(_iError != ERR_FUTURE_OK) return _iError;
+
+            _iError = m_pState->get_error();
+            reset();
+            return _iError;
+        }
+
+        /**
+         * Attach a continuation, that is called with this future when the result is ready.
+         * The continuation run on the task, that set the result, or now when the result is ready.
+         * After this the future has no state.
+         *
+         * When the state is released without a result, the continuation is destroyed without
+         * a call and the returned future gets ERR_FUTURE_BROKEN.
+         *
+         * @param fn The continuation, called as fn(future<R>&&), must fit in MN_THREAD_CONFIG_FUTURE_TASK_SIZE,
+         * can be a mutable callable
+         * @return The future for the result of fn, no state on error
+         */
+        template <typename F, typename R2 = res_of_t<decay_t<F>&(self_type&&)>>
+        future<R2> then(F&& fn) {
+            if(m_pState == NULL) return future<R2>();
+
+            basic_future_state<R2>* _pNext = basic_future_state<R2>::create();
+            if(_pNext == NULL) return future<R2>();
+
+            state_type* _pParent = m_pState;
+
+            // one reference for the returned future and one for the continuation
+            _pNext->add_ref();
+
+            // the continuation is stored in the parent, so it holds no reference of the parent:
+            // the task that runs it (finish or this call) holds one
+            int _iError = _pParent->set_continuation(
+                [_pParent, next = internal::future_state_ref<basic_future_state<R2>>(_pNext),
+                 fn = decay_t<F>(mn::forward<F>(fn))]() mutable {
+                    _pParent->add_ref();
+                    internal::future_invoker<R2>::invoke(next.get(), fn, self_type(_pParent));
+                    next.release();
+                });
+
+            if(_iError != ERR_FUTURE_OK) {
+                // the reference of the continuation is released with the continuation
+                _pNext->release();
+                return future<R2>();
+            }
+            reset();
+            return future<R2>(_pNext);
+        }
+
+        /**
+         * Call fn once when the result is ready, the future keeps his state.
+         * Used from when_all and when_any.
+         *
+         * @return ERR_FUTURE_OK, ERR_FUTURE_NOSTATE or ERR_FUTURE_ALREADYSET
+         */
+        template <typename F>
+        int on_ready(F&& fn) {
+            if(m_pState == NULL) return ERR_FUTURE_NOSTATE;
+
+            // no reference of the own state in the continuation, the state would never released
+            return m_pState->set_continuation(
+                [fn = decay_t<F>(mn::forward<F>(fn))]() mutable { fn(); });
+        }
+    private:
+        void reset() {
+            if(m_pState != NULL) m_pState->release();
+            m_pState = NULL;
+        }
+    private:
+        state_type* m_pState;
+    };
+
+    /**
+     * A promise is the writing end of a future.
+     * When the promise is destroyed without a result, the future get ERR_FUTURE_BROKEN.
+     *
+     * @tparam R The type of the result, can be void
+     */
+    template <typename R>
+    class promise {
+    public:
+        using value_type = R;
+        using self_type = promise<R>;
+        using state_type = basic_future_state<R>;
+
+        promise() : m_pState(state_type::create()), m_bRetrieved(false) { }
+
+        promise(self_type&& other)
+            : m_pState(other.m_pState), m_bRetrieved(other.m_bRetrieved) { other.m_pState = NULL; }
+
+        ~promise() { reset(); }
+
+        promise(const self_type&) = delete;
+        self_type& operator = (const self_type&) = delete;
+
+        self_type& operator = (self_type&& other) {
+            if(this != &other) {
+                reset();
+                m_pState = other.m_pState;
+                m_bRetrieved = other.m_bRetrieved;
+                other.m_pState = NULL;
+            }
+            return *this;
+        }
+
+        /**
+         * Has this promise a shared state?
+         */
+        bool valid() const { return m_pState != NULL; }
+
+        /**
+         * Get the future of this promise, only once
+         * @return The future, no state when called twice or no memory
+         */
+        future<R> get_future() {
+            if(m_pState == NULL || m_bRetrieved) return future<R>();
+
+            m_bRetrieved = true;
+            m_pState->add_ref();
+            return future<R>(m_pState);
+        }
+
+        /**
+         * Set the result, can be called from a ISR
+         * @return ERR_FUTURE_OK, ERR_FUTURE_NOSTATE or ERR_FUTURE_ALREADYSET
+         */
+        template <typename... TArgs>
+        int set_value(TArgs&&... args) {
+            if(m_pState == NULL) return ERR_FUTURE_NOSTATE;
+            return m_pState->set_value(mn::forward<TArgs>(args)...);
+        }
+
+        /**
+         * Set a error in place of the result, can be called from a ISR
+         * @return ERR_FUTURE_OK, ERR_FUTURE_NOSTATE or ERR_FUTURE_ALREADYSET
+         */
+        int set_error(int iError) {
+            if(m_pState == NULL) return ERR_FUTURE_NOSTATE;
+            return m_pState->set_error(iError);
+        }
+    private:
+        void reset() {
+            if(m_pState != NULL) {
+                m_pState->set_error(ERR_FUTURE_BROKEN);
+                m_pState->release();
+            }
+            m_pState = NULL;
+        }
+    private:
+        state_type* m_pState;
+        bool m_bRetrieved;
+    };
+
+    namespace internal {
+        /**
+         * The state of when_all and when_any, ready when the counter is zero or
+         * for when_any the first future is ready
+         */
+        template <typename R>
+        class basic_when_state : public basic_future_state<R> {
+        public:
+            using self_type = basic_when_state<R>;
+
+            explicit basic_when_state(uint32_t uiCount) : m_uiCount(uiCount) { }
+
+            static self_type* create(uint32_t uiCount) {
+                void* _pMem = basic_future_pool<self_type>::allocate();
+                return (_pMem != NULL) ? new (_pMem) self_type(uiCount) : NULL;
+            }
+
+            /**
+             * Count one down, the last set the state ready
+             */
+            void signal() {
+                if(m_uiCount.fetch_sub(1) == 1) this->set_value();
+            }
+        protected:
+            virtual void destroy() override {
+                this->~basic_when_state();
+                basic_future_pool<self_type>::deallocate(this);
+            }
+        private:
+            atomic_uint32_t m_uiCount;
+        };
+
+        template <typename TState>
+        inline void when_all_attach(TState* pState) { MN_UNUSED_VARIABLE(pState); }
+
+        template <typename TState, typename R, typename... TFutures>
+        inline void when_all_attach(TState* pState, future<R>& first, TFutures&... rest) {
+            // a future without a state counts as ready
+            if(!first.valid()) {
+                pState->signal();
+            } else {
+                pState->add_ref();
+
+                // a dropped continuation breaks the state, it can never become ready
+                first.on_ready([ref = future_state_ref<TState>(pState)]() mutable {
+                    ref.get()->signal();
+                    ref.release();
+                });
+            }
+            when_all_attach(pState, rest...);
+        }
+
+        template <typename TState>
+        inline void when_any_attach(TState* pState, size_t uiIndex) {
+            MN_UNUSED_VARIABLE(pState); MN_UNUSED_VARIABLE(uiIndex);
+        }
+
+        template <typename TState, typename R, typename... TFutures>
+        inline void when_any_attach(TState* pState, size_t uiIndex, future<R>& first, TFutures&... rest) {
+            pState->add_ref();
+
+            // a dropped continuation only releases, a other future can still become ready
+            first.on_ready([ref = future_state_ref<TState, ERR_FUTURE_OK>(pState), uiIndex]() mutable {
+                ref.get()->set_value(uiIndex);
+                ref.release();
+            });
+
+            when_any_attach(pState, uiIndex + 1, rest...);
+        }
+    }
+
+    /**
+     * Get a future, that is ready when all given futures are ready.
+     * The futures keep the state, get the results after the wait from them.
+     *
+     * @code
+     * mn::when_all(f1, f2).wait();
+     * f1.get(a); f2.get(b);
+     * @endcode
+     *
+     * @note Use the continuation slot of the given futures, a future can only be in one
+     * when_all or when_any and not used with then. Otherwise the result is ERR_FUTURE_BROKEN.
+     */
+    template <typename... TFutures>
+    future<void> when_all(TFutures&... futures) {
+        using state_type = internal::basic_when_state<void>;
+
+        // + 1, so the state can not become ready while attach
+        state_type* _pState = state_type::create(sizeof...(TFutures) + 1);
+        if(_pState == NULL) return future<void>();
+
+        future<void> _ret(_pState);
+
+        internal::when_all_attach(_pState, futures...);
+        _pState->signal();
+
+        return _ret;
+    }
+
+    /**
+     * Get a future with the index of the first ready future from the given futures.
+     * With no futures, the result is ERR_FUTURE_NOSTATE.
+     *
+     * @note Use the continuation slot of the given futures, a future can only be in one
+     * when_all or when_any and not used with then.
+     */
+    template <typename... TFutures>
+    future<size_t> when_any(TFutures&... futures) {
+        using state_type = internal::basic_when_state<size_t>;
+
+        state_type* _pState = state_type::create(0);
+        if(_pState == NULL) return future<size_t>();
+
+        future<size_t> _ret(_pState);
+
+        if(sizeof...(TFutures) == 0)
+            _pState->set_error(ERR_FUTURE_NOSTATE);
+        else
+            internal::when_any_attach(_pState, 0, futures...);
+
+        return _ret;
+    }
+}
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_HAZARD_POINTER_
+#define MINLIB_ESP32_HAZARD_POINTER_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+
+namespace mn {
+  /**
+   *  A hazard pointer domain for the safe memory reclamation of lock-free containers.
+   *
+   *  Each task that uses hazard pointers owns a record with MN_THREAD_CONFIG_HAZARD_SLOTS
+   *  hazard slots and a private list of retired objects. A reader publishes the node it will
+   *  access in one of its slots (basic_hazard_pointer::protect), a node that was removed from
+   *  the container is retired and only freed, when no slot of any task points to it.
+   *  So the node can not freed or reused (ABA) while a other task is using it.
+   *
+   *  The retired list is scanned after MN_THREAD_CONFIG_HAZARD_SCAN retired objects, the scan
+   *  reads all slots once and keeps at most MN_THREAD_CONFIG_HAZARD_MAX_TASKS *
+   *  MN_THREAD_CONFIG_HAZARD_SLOTS objects, so the costs of a scan are amortized.
+   *
+   *  @note The records are claimed on the first use of a task and released, when a basic_task
+   *  ends and MN_THREAD_CONFIG_HAZARD is MN_THREAD_CONFIG_YES. Else, and for tasks that are
+   *  not a basic_task, must the task call release_task() before it is deleted. The retired objects of
+   *  a released record are freed by the next owner. Can not use in the ISR Context.
+   */
+  class basic_hazard_domain {
+    static_assert(MN_THREAD_CONFIG_HAZARD_SCAN > MN_THREAD_CONFIG_HAZARD_MAX_TASKS * MN_THREAD_CONFIG_HAZARD_SLOTS,
+                  "basic_hazard_domain: MN_THREAD_CONFIG_HAZARD_SCAN must be greater then all hazard slots");
+  public:
+    /**
+     * The type of the function, that frees a retired object
+     * @param context The context, for the containers the allocator
+     * @param object The retired object
+     */
+    using deleter_t = void (*)(void* context, void* object);
+
+    /**
+     * A retired object, that waits for the next scan
+     */
+    struct retired {
+      void* pObject;
+      deleter_t fnDeleter;
+      void* pContext;
+    };
+
+    /**
+     * The hazard record of a task
+     */
+    struct record {
+      /** The owner task or NULL when the record is free */
+      TaskHandle_t volatile pOwner;
+      /** The hazard slots, NULL when not used */
+      void* volatile pHazards[MN_THREAD_CONFIG_HAZARD_SLOTS];
+      /** Bit i is set when slot i is in use, only the owner use it */
+      uint32_t uiUsedSlots;
+      /** The retired objects, only the owner use it */
+      retired Retired[MN_THREAD_CONFIG_HAZARD_SCAN];
+      unsigned int uiRetired;
+    };
+  private:
+    basic_hazard_domain();
+  public:
+    /**
+     * Get the hazard domain of the library
+     */
+    static basic_hazard_domain& instance();
+
+    /**
+     * Get the record of the calling task, claim a free record on the first call.
+     *
+     * @return The record or NULL when all records are owned by other tasks
+     */
+    record* get_record();
+
+    /**
+     * Get a free hazard slot of the calling task
+     *
+     * @return The slot or NULL when no slot or record is free
+     */
+    void* volatile* acquire_slot();
+
+    /**
+     * Clear the hazard slot and give it back
+     */
+    void release_slot(void* volatile* slot);
+
+    /**
+     * Retire a object, that was removed from the container. The object is freed with
+     * the deleter, when no hazard slot points to it.
+     *
+     * @return - ERR_HAZARD_OK The object is retired or freed
+     *         - ERR_HAZARD_NORECORD The calling task has no record, the object is not retired
+     */
+    int retire(void* object, deleter_t fnDeleter, void* context);
+
+    /**
+     * Free all retired objects of the calling task, that are not protected
+     *
+     * @return How many objects are freed
+     */
+    unsigned int scan();
+
+    /**
+     * Free the unprotected retired objects of the calling task and release the record.
+     * Call it, before a task that was not a basic_task is deleted.
+     */
+    void release_task();
+
+    /**
+     * Get the number of the retired objects of all records
+     */
+    unsigned int get_retired();
+  private:
+    record* find(TaskHandle_t pTask);
+    unsigned int scan(record* pRecord);
+  private:
+    record m_Records[MN_THREAD_CONFIG_HAZARD_MAX_TASKS];
+  };
+
+  /**
+   *  A hazard pointer, a guard for one hazard slot of the calling task.
+   *
+   *  @code
+   *  mn::hazard_pointer_t hp;
+   *  node* head = hp.protect(&m_pHead);  // head can not freed, while hp protect it
+   *  ...
+   *  hp.reset();
+   *  @endcode
+   */
+  class basic_hazard_pointer {
+  public:
+    basic_hazard_pointer()
+      : m_pSlot(basic_hazard_domain::instance().acquire_slot()) { }
+
+    ~basic_hazard_pointer() {
+      if(m_pSlot != NULL) basic_hazard_domain::instance().release_slot(m_pSlot);
+    }
+
+    basic_hazard_pointer(const basic_hazard_pointer&) = delete;
+    basic_hazard_pointer& operator=(const basic_hazard_pointer&) = delete;
+
+    /**
+     * Load the pointer from source and protect it, the pointer is checked again after
+     * it is published, so it was still in the container when the protection starts.
+     *
+     * @param source The atomic source of the pointer, for example the head of a list
+     * @return The protected pointer, NULL when the hazard pointer has no slot (is_valid())
+     */
+    template <typename T>
+    T* protect(T* const volatile* source) {
+      if(m_pSlot == NULL) return NULL;
+
+      T* _pObject = __atomic_load_n(source, __ATOMIC_ACQUIRE);
+
+      while(true) {
+        set(_pObject);
+
+        T* _pCheck = __atomic_load_n(source, __ATOMIC_ACQUIRE);
+        if(_pCheck == _pObject) return _pObject;
+
+        _pObject = _pCheck;
+      }
+    }
+
+    /**
+     * Publish the given pointer, the caller must check that it is still reachable
+     *
+     * @return false when the hazard pointer has no slot, the pointer is not protected
+     */
+    bool set(void* object) {
+      if(m_pSlot == NULL) return false;
+
+      __atomic_store_n(m_pSlot, object, __ATOMIC_RELAXED);
+      // the slot is visible for the scans, before the source is checked again
+      atomic_thread_fence(memory_order::SeqCst);
+      return true;
+    }
+
+    /**
+     * Stop the protection, does nothing without a slot
+     */
+    void reset() {
+      if(m_pSlot != NULL) __atomic_store_n(m_pSlot, (void*)NULL, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Has the hazard pointer a slot?
+     */
+    bool is_valid() const                   { return m_pSlot != NULL; }
+  private:
+    void* volatile* m_pSlot;
+  };
+
+  using hazard_domain_t = basic_hazard_domain;
+  using hazard_pointer_t = basic_hazard_pointer;
+}
+
+#endif
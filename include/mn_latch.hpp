@@ -0,0 +1,161 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_LATCH_
+#define MINLIB_ESP32_LATCH_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+#include "mn_eventgroup.hpp"
+
+namespace mn {
+  /**
+   *  A single use countdown latch.
+   *
+   *  The counter is counted down with a atomic operation, only the count_down that reaches
+   *  zero sets the ready bit of the event group. This one kernel call wakes all waiting
+   *  tasks, there is no polling.
+   *
+   *  @code
+   *  mn::latch_t frame_done(NUM_WORKERS);
+   *
+   *  // each worker
+   *  render_tile(); frame_done.count_down();
+   *
+   *  // the main task
+   *  frame_done.wait();
+   *  @endcode
+   *
+   *  @ingroup lock
+   */
+  class basic_latch {
+  public:
+    /**
+     * Construct the latch
+     * @param count The initial counter
+     */
+    explicit basic_latch(uint32_t count);
+    virtual ~basic_latch() { }
+
+    basic_latch(const basic_latch&) = delete;
+    basic_latch& operator=(const basic_latch&) = delete;
+
+    /**
+     * Count the counter down, can use in the ISR Context.
+     *
+     * @param n The value to count down
+     * @return - ERR_LATCH_OK The counter is decremented
+     *         - ERR_LATCH_UNDERFLOW n is greater then the counter, the counter is not changed
+     *         - ERR_LATCH_NOTCREATED The event group is not created
+     */
+    int count_down(uint32_t n = 1);
+
+    /**
+     * Wait until the counter is zero.
+     *
+     * @param timeout How long to wait in ticks
+     * @return - ERR_LATCH_OK The counter is zero
+     *         - ERR_LATCH_TIMEOUT The counter was not zero before the timeout
+     *         - ERR_LATCH_NOTCREATED The event group is not created
+     */
+    int wait(unsigned int timeout = portMAX_DELAY);
+
+    /**
+     * Count the counter down and wait until it is zero
+     */
+    int arrive_and_wait(uint32_t n = 1, unsigned int timeout = portMAX_DELAY);
+
+    /**
+     * Is the counter zero? Does not block.
+     */
+    bool try_wait() const         { return m_uiCount.load(memory_order::Acquire) == 0; }
+
+    /**
+     * Get the current counter
+     */
+    uint32_t get_count() const    { return m_uiCount.load(memory_order::Relaxed); }
+
+    /**
+     * Is the event group created?
+     */
+    bool is_initialized()         { return m_eventGroup.is_init(); }
+  protected:
+    atomic_uint32_t m_uiCount;
+    basic_event_group m_eventGroup;
+  };
+
+  /**
+   *  A reusable countdown event, the counter can increment while it is not zero and
+   *  the event can reset.
+   *
+   *  @ingroup lock
+   */
+  class basic_countdown_event : public basic_latch {
+  public:
+    /**
+     * Construct the countdown event
+     * @param count The initial counter
+     */
+    explicit basic_countdown_event(uint32_t count);
+
+    /**
+     * Increment the counter, when it is not zero
+     *
+     * @return - ERR_LATCH_OK The counter is incremented
+     *         - ERR_LATCH_ALREADYSET The counter is zero, the event is set
+     */
+    int add_count(uint32_t n = 1);
+
+    /**
+     * Count the counter down, the same as count_down
+     */
+    int signal(uint32_t n = 1)    { return count_down(n); }
+
+    /**
+     * Reset the counter to the initial counter
+     */
+    void reset()                  { reset(m_uiInitial); }
+
+    /**
+     * Reset the counter to a new value, no task may wait on the event
+     */
+    void reset(uint32_t count);
+
+    /**
+     * Is the counter zero?
+     */
+    bool is_set() const           { return try_wait(); }
+
+    /**
+     * Get the initial counter
+     */
+    uint32_t get_initial() const  { return m_uiInitial; }
+  private:
+    uint32_t m_uiInitial;
+  };
+
+  using latch_t = basic_latch;
+  using countdown_event_t = basic_countdown_event;
+}
+
+#endif
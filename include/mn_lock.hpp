@@ -29,6 +29,7 @@
 #include "mn_copyable.hpp"
 #include "mn_error.hpp"
 #include "mn_micros.hpp"
+#include "mn_lock_profiler.hpp"
 
 /**
  * Macro for locked sections
@@ -102,6 +103,23 @@ namespace mn {
          * @return True if locked and false when not.
          */
         virtual bool is_locked() const = 0;
+
+        /**
+         * @brief Set the name of the lock for the lock profiler
+         * @param strName The name, the string must live as long as the lock
+         */
+    #if MN_THREAD_CONFIG_LOCK_PROFILER == MN_THREAD_CONFIG_YES
+        void set_lock_name(const char* strName)   { m_lockProfile.set_name(strName); }
+
+        /**
+         * @brief Get the statistics of the lock profiler
+         */
+        basic_lock_profile& get_lock_profile()    { return m_lockProfile; }
+    protected:
+        basic_lock_profile m_lockProfile;
+    #else
+        void set_lock_name(const char* strName)   { (void)strName; }
+    #endif
     };
 
 
@@ -128,7 +146,7 @@ namespace mn {
      */
     basic_autolock(LOCK &m)
       : m_ref_lock(m) {
-      assert( (m_ref_lock.lock(portMAX_DELAY) != NO_ERROR) );
+      m_ref_lock.lock(portMAX_DELAY);
     }
     /**
      * Create a basic_autolock with a specific LockType, with timeout
@@ -139,7 +157,7 @@ namespace mn {
      */
     basic_autolock(LOCK &m, unsigned long xTicksToWait)
       : m_ref_lock(m) {
-      assert( (m_ref_lock.lock(xTicksToWait) != NO_ERROR) );
+      m_ref_lock.lock(xTicksToWait);
     }
     /**
      *  Destroy a basic_autolock.
@@ -195,7 +213,7 @@ namespace mn {
      *  @post The LockObject will be locked.
      */
     ~basic_autounlock() {
-        assert( (m_ref_lock.lock(m_xTicksToWait) != NO_ERROR) );
+        m_ref_lock.lock(m_xTicksToWait);
     }
 
     void set_timeout(unsigned long xTicksToWait = portMAX_DELAY) {
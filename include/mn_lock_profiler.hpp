@@ -0,0 +1,194 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_LOCK_PROFILER_H_
+#define _MINLIB_LOCK_PROFILER_H_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+
+#if MN_THREAD_CONFIG_LOCK_PROFILER == MN_THREAD_CONFIG_YES
+
+#include "mn_atomic.hpp"
+#include "mn_micros.hpp"
+
+/// Count a uncontended acquire of the lock
+#define MN_LOCK_PROFILE_ACQUIRED()                  m_lockProfile.acquired()
+/// Start the wait time of a contended acquire
+#define MN_LOCK_PROFILE_START(start)                uint32_t start = m_lockProfile.now()
+/// Count a contended acquire or timeout, that was started with MN_LOCK_PROFILE_START
+#define MN_LOCK_PROFILE_CONTENDED(start, success)   m_lockProfile.contended(start, success)
+/// Count the hold time, call before the lock is given free
+#define MN_LOCK_PROFILE_RELEASED()                  m_lockProfile.released()
+
+namespace mn {
+  /**
+   * A snapshot of the statistics of one lock
+   */
+  struct lock_profile_stats {
+    /** The name of the lock */
+    const char* strName;
+    /** How many times the lock was acquired */
+    uint32_t uiAcquires;
+    /** How many lock calls found the lock taken */
+    uint32_t uiContended;
+    /** How many contended lock calls gave up without the lock */
+    uint32_t uiTimeouts;
+    /** The total wait time of the contended lock calls in micro seconds, wraps after ~71 minutes */
+    uint32_t uiWaitTotal;
+    /** The longest wait time in micro seconds */
+    uint32_t uiWaitMax;
+    /** The longest hold time in micro seconds */
+    uint32_t uiHoldMax;
+  };
+
+  /**
+   * The output format for basic_lock_profiler::dump
+   */
+  enum class lock_profile_format {
+    Text,     /*!< One line per lock */
+    Json      /*!< A JSON array of objects */
+  };
+
+  /**
+   *  The statistics of one lock, each ILockObject holds one when the profiler is enabled.
+   *
+   *  The uncontended acquire is one atomic add and a timestamp, the release a compare
+   *  with the max hold time. All profiles are linked in the basic_lock_profiler.
+   */
+  class basic_lock_profile {
+    friend class basic_lock_profiler;
+  public:
+    basic_lock_profile(const char* strName = "lock");
+    basic_lock_profile(const basic_lock_profile& other);
+    ~basic_lock_profile();
+
+    basic_lock_profile& operator = (const basic_lock_profile& other) = delete;
+
+    void acquired() {
+      m_uiAcquires.fetch_add(1, memory_order::Relaxed);
+      __atomic_store_n(&m_uiLockedAt, now(), __ATOMIC_RELAXED);
+    }
+
+    void contended(uint32_t start, bool success);
+    void released();
+
+    /**
+     * Set the name of the lock, the string must live as long as the lock
+     */
+    void set_name(const char* strName)  { m_strName = strName; }
+    const char* get_name() const        { return m_strName; }
+
+    /**
+     * Get a snapshot of the statistics
+     */
+    void get_stats(lock_profile_stats& stats) const;
+
+    /**
+     * Reset the statistics
+     */
+    void reset();
+
+    static uint32_t now()               { return uint32_t(micros()); }
+  private:
+    void update_max(atomic_uint32_t& max, uint32_t value);
+  private:
+    const char* m_strName;
+
+    atomic_uint32_t m_uiAcquires;
+    atomic_uint32_t m_uiContended;
+    atomic_uint32_t m_uiTimeouts;
+    atomic_uint32_t m_uiWaitTotal;
+    atomic_uint32_t m_uiWaitMax;
+    atomic_uint32_t m_uiHoldMax;
+    uint32_t m_uiLockedAt;
+
+    basic_lock_profile* m_pNext;
+  };
+
+  /**
+   *  The list of all lock profiles, with the snapshot and the dump API.
+   *
+   *  @code
+   *  mutex_t uart_lock;
+   *  uart_lock.set_lock_name("uart");
+   *  ...
+   *  mn::basic_lock_profiler::print(mn::lock_profile_format::Json);
+   *  @endcode
+   *
+   *  @note Enable it with MN_THREAD_CONFIG_LOCK_PROFILER = MN_THREAD_CONFIG_YES
+   */
+  class basic_lock_profiler {
+    friend class basic_lock_profile;
+  public:
+    /**
+     * Get a snapshot of the statistics of all locks
+     *
+     * @param stats Where the snapshots are returned to
+     * @param max The size of the stats array
+     * @return The number of all locks, can be greater then max
+     */
+    static size_t snapshot(lock_profile_stats* stats, size_t max);
+
+    /**
+     * Write the statistics of all locks to a buffer
+     *
+     * @param buffer The buffer
+     * @param size The size of the buffer, the output is truncated and null terminated
+     * @param format The output format
+     * @return The length of the full output, like snprintf
+     */
+    static size_t dump(char* buffer, size_t size, lock_profile_format format = lock_profile_format::Text);
+
+    /**
+     * Print the statistics of all locks with printf
+     */
+    static void print(lock_profile_format format = lock_profile_format::Text);
+
+    /**
+     * Reset the statistics of all locks
+     */
+    static void reset();
+
+    /**
+     * Get the number of the profiled locks
+     */
+    static size_t count();
+  private:
+    static void add(basic_lock_profile* profile);
+    static void remove(basic_lock_profile* profile);
+    static size_t format(char* buffer, size_t size, const lock_profile_stats& stats,
+                         lock_profile_format format, bool first);
+  private:
+    static basic_lock_profile* m_pFirst;
+    static portMUX_TYPE m_Mux;
+  };
+}
+
+#else
+
+#define MN_LOCK_PROFILE_ACQUIRED()
+#define MN_LOCK_PROFILE_START(start)
+#define MN_LOCK_PROFILE_CONTENDED(start, success)
+#define MN_LOCK_PROFILE_RELEASED()
+
+#endif // MN_THREAD_CONFIG_LOCK_PROFILER
+
+#endif // _MINLIB_LOCK_PROFILER_H_
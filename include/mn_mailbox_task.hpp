@@ -0,0 +1,292 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_MAILBOX_TASK_
+#define MINLIB_ESP32_MAILBOX_TASK_
+
+#include "mn_config.hpp"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mn_task.hpp"
+#include "mn_typetraits.hpp"
+#include "queue/mn_typed_queue.hpp"
+
+namespace mn {
+    namespace ext {
+        /**
+         * @brief A mail for the basic_mailbox_task, the payload is stored inline (by value)
+         *
+         * The payload is variant-like: each mail stored the type of the payload and
+         * get<T>() returns only a pointer, when the type is the same.
+         *
+         * @tparam TInlineSize The maximal size of the payload in bytes
+         * @ingroup task
+         */
+        template <unsigned int TInlineSize = MN_THREAD_CONFIG_MSGTASK_INLINE_SIZE>
+        struct basic_task_mail {
+            using message_id = int;
+            using type_id = const void*;
+            using self_type = basic_task_mail<TInlineSize>;
+
+            message_id id;              /*!< The message id */
+            type_id type;               /*!< The type of the payload, nullptr for none */
+            uint16_t size;              /*!< The size of the payload in bytes */
+            alignas(uint64_t) uint8_t data[TInlineSize > 0 ? TInlineSize : 1]; /*!< The payload */
+
+            basic_task_mail(message_id _id = 0)
+                : id(_id), type(nullptr), size(0) { }
+
+            /**
+             * @brief Get the unique type id for the given type
+             */
+            template <typename T>
+            static type_id type_of() {
+                static const char _cTag = 0;
+                return &_cTag;
+            }
+
+            /**
+             * @brief Can the given type stored in a mail?
+             */
+            template <typename T>
+            static constexpr bool fits() {
+                return sizeof(T) <= TInlineSize && alignof(T) <= alignof(uint64_t) &&
+                    is_trivially_copyable<T>::value;
+            }
+
+            /**
+             * @brief Create a mail with the given payload
+             */
+            template <typename T>
+            static self_type make(message_id _id, const T& payload) {
+                self_type _mail(_id);
+                _mail.set(payload);
+                return _mail;
+            }
+
+            /**
+             * @brief Copy the payload in the mail
+             */
+            template <typename T>
+            void set(const T& payload) {
+                static_assert(is_trivially_copyable<T>::value, "the payload of a mail must be trivially copyable");
+                static_assert(sizeof(T) <= TInlineSize, "the payload is bigger then MN_THREAD_CONFIG_MSGTASK_INLINE_SIZE");
+                static_assert(alignof(T) <= alignof(uint64_t), "the payload alignment is not supported");
+
+                memcpy(data, &payload, sizeof(T));
+                size = sizeof(T);
+                type = type_of<T>();
+            }
+
+            /**
+             * @brief Holds the mail a payload of the given type?
+             */
+            template <typename T>
+            bool is() const { return type == type_of<T>(); }
+
+            /**
+             * @brief Has the mail a payload?
+             */
+            bool has_payload() const { return type != nullptr; }
+
+            /**
+             * @brief Get the payload
+             * @return A pointer to the payload or nullptr, when the payload has a other type
+             */
+            template <typename T>
+            const T* get() const {
+                return is<T>() ? reinterpret_cast<const T*>(data) : nullptr;
+            }
+        };
+
+        /**
+         * @brief A task with a fixed size mailbox. The mails are stored by value in the queue,
+         * so posting a mail never allocate memory.
+         *
+         * The task takes up to TBatch mails with one wakeup and calls on_mail for each mail.
+         * No lock is hold while the mails are handled, so posting tasks are only blocked,
+         * when the mailbox is full.
+         *
+         * @code
+         * struct motor_cmd { int16_t speed; uint8_t dir; };
+         *
+         * class motor_task : public mn::ext::mailbox_task_t {
+         *     void on_mail(const mail_type& mail) override {
+         *         if(const motor_cmd* cmd = mail.get<motor_cmd>())
+         *             set_motor(cmd->speed, cmd->dir);
+         *     }
+         * };
+         *
+         * motor.post(CMD_MOTOR, motor_cmd{ 100, 1 });
+         * @endcode
+         *
+         * @tparam TMaxMails Maximal number of mails in the mailbox
+         * @tparam TBatch Maximal number of mails handled with one wakeup
+         * @tparam TInlineSize Maximal size of the payload of a mail
+         *
+         * @ingroup task
+         */
+        template <unsigned int TMaxMails = MN_THREAD_CONFIG_MSGTASK_MAX_MESSAGES,
+                  unsigned int TBatch = MN_THREAD_CONFIG_MSGTASK_BATCH,
+                  unsigned int TInlineSize = MN_THREAD_CONFIG_MSGTASK_INLINE_SIZE>
+        class basic_mailbox_task : public basic_task {
+            static_assert(TBatch > 0, "the mailbox task must handle one mail");
+        public:
+            using mail_type = basic_task_mail<TInlineSize>;
+            using message_id = typename mail_type::message_id;
+            using queue_type = queue::typed_queue<mail_type, TMaxMails>;
+
+            /**
+             * @brief Constructor for this task.
+             *
+             * @param strName Name of the Task. Only useful for debugging.
+             * @param uiPriority FreeRTOS priority of this Task.
+             * @param usStackDepth Number of "words" allocated for the Task stack.
+             */
+            explicit basic_mailbox_task(std::string strName = "mailbox_task",
+                                        basic_task::priority uiPriority = priority::Normal,
+                                        unsigned short  usStackDepth = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE)
+                : basic_task(strName, uiPriority, usStackDepth), m_qeMailbox() {
+
+                m_qeMailbox.create();
+            }
+
+            basic_mailbox_task(const basic_mailbox_task&) = delete;
+            basic_mailbox_task& operator=(const basic_mailbox_task&) = delete;
+
+            /**
+             * @brief Add a copy of the mail to the mailbox, can call from a ISR
+             *
+             * @param mail The mail
+             * @param timeout How long to wait to add the mail, when the mailbox is full
+             *
+             * @return ERR_QUEUE_OK the mail was added, otherwise the queue error
+             */
+            int post(const mail_type& mail, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return m_qeMailbox.enqueue(mail, timeout);
+            }
+
+            /**
+             * @brief Add a mail without a payload
+             */
+            int post(message_id id, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return post(mail_type(id), timeout);
+            }
+
+            /**
+             * @brief Add a mail with the given payload, the payload is copied in the mail
+             */
+            template <typename T>
+            int post(message_id id, const T& payload, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return post(mail_type::make(id, payload), timeout);
+            }
+
+            /**
+             * @brief Add up to count mails, only the first mail waits for space
+             * @return The number of added mails
+             */
+            unsigned int post_n(const mail_type* mails, unsigned int count,
+                                unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return m_qeMailbox.enqueue_n(mails, count, timeout);
+            }
+
+            /**
+             * @brief Stop the task: the task handles the mails before the stop request and
+             * returns from on_task. The mails after the stop request are not handled.
+             * Call after start.
+             *
+             * @param timeout How long to wait to add the stop request, when the mailbox is full
+             * @return ERR_QUEUE_OK the stop request was added, otherwise the queue error
+             */
+            int stop(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                mail_type _mail;
+                _mail.type = mail_type::template type_of<stop_request>();
+
+                return m_qeMailbox.enqueue(_mail, timeout);
+            }
+
+            /**
+             * @brief Get the number of mails in the mailbox
+             */
+            unsigned int get_pending() { return m_qeMailbox.get_num_items(); }
+
+            /**
+             * @brief Get the maximal number of mails in the mailbox
+             */
+            static constexpr unsigned int capacity() { return TMaxMails; }
+        protected:
+            /**
+             * @brief Implementation of your actual mail code.
+             * @note You must override this function.
+             *
+             * @param mail The current mail
+             */
+            virtual void on_mail(const mail_type& mail) = 0;
+
+            /**
+             * @brief Called with each taken batch, calls on_mail for each mail.
+             *
+             * @param mails The mails of this batch
+             * @param count The number of mails in this batch
+             */
+            virtual void on_batch(const mail_type* mails, unsigned int count) {
+                for(unsigned int i = 0; i < count; i++)
+                    on_mail(mails[i]);
+            }
+
+            /**
+             * @brief The mail handling code, waits for the first mail and takes
+             * the rest of the batch without waiting
+             */
+            virtual int on_task() override {
+                mail_type _batch[TBatch];
+                unsigned int _uiCount;
+
+                while(m_bRunning) {
+                    _uiCount = m_qeMailbox.dequeue_n(_batch, TBatch, portMAX_DELAY);
+
+                    // the stop request ends the batch and the loop
+                    for(unsigned int i = 0; i < _uiCount; i++) {
+                        if(_batch[i].template is<stop_request>()) {
+                            m_bRunning = false;
+                            _uiCount = i;
+                            break;
+                        }
+                    }
+                    if(_uiCount > 0) on_batch(_batch, _uiCount);
+                } //while(m_bRunning)
+
+                return ERR_TASK_OK;
+            }
+        private:
+            /**
+             * @brief The payload type of the stop request, only the task can create it
+             */
+            struct stop_request { };
+        protected:
+            queue_type m_qeMailbox;
+        };
+
+        using mailbox_task_t = basic_mailbox_task<>;
+        using task_mail_t = basic_task_mail<>;
+    }
+}
+
+#endif
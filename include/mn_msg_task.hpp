@@ -25,7 +25,7 @@
 
 #include "mn_convar.hpp"
 #include "mn_convar_task.hpp"
-#include "queue/mn_queue.hpp"
+#include "queue/mn_typed_queue.hpp"
 
 namespace mn {
     namespace ext {
@@ -39,7 +39,7 @@ namespace mn {
 			void* message;              /*!< The message*/
 
 
-			task_message(message_id _id, void* _message = nullptr)
+			task_message(message_id _id = 0, void* _message = nullptr)
 				: id(_id), message(_message) { }
 		};
 		/**
@@ -68,35 +68,56 @@ namespace mn {
 										unsigned short  usStackDepth = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE);
 
             /**
-             * @brief Add a pre-created task message to the task queue
+             * @brief Add a copy of the task message to the task queue, the message is
+             * stored by value, there is no allocation.
              *
              * @param[in] msg The specific message you are adding to the task queue
              * @param timeout How long to wait to add the item to the queue
+             *
+             * @return ERR_QUEUE_OK the message was added, otherwise the queue error
+             */
+            int post_msg(const task_message& msg, unsigned int timeout);
+
+            /**
+             * @brief Add a copy of a pre-created task message to the task queue
+             *
+             * @note The message is copied, the caller is the owner of msg.
+             *
+             * @param[in] msg The specific message you are adding to the task queue
+             * @param timeout How long to wait to add the item to the queue
+             *
+             * @return ERR_QUEUE_OK the message was added, otherwise the queue error
              */
-            void post_msg(task_message* msg, unsigned int timeout);
+            int post_msg(task_message* msg, unsigned int timeout) {
+                return post_msg(*msg, timeout);
+            }
 
             /**
-             * @brief Create the task message and add the message to the task queue,
-             * without message data
+             * @brief Add a message to the task queue, without message data
              *
              * @param msg_id The message id
              * @param timeout How long to wait to add the item to the queue
              */
-            void post_msg(message_id msg_id, unsigned int timeout) {
-                post_msg(new task_message(msg_id, nullptr), timeout );
+            int post_msg(message_id msg_id, unsigned int timeout) {
+                return post_msg(task_message(msg_id, nullptr), timeout);
             }
             /**
-             * @brief Create the task message and add the message to the task queue,
-             * with message data
+             * @brief Add a message to the task queue, with message data
              *
              * @param msg_id The message id
              * @param message_data The user message data for the task message
              * @param timeout How long to wait to add the item to the queue
              */
-            void post_msg(message_id msg_id, void* message_data, unsigned int timeout) {
-                post_msg(new task_message(msg_id, message_data), timeout );
+            int post_msg(message_id msg_id, void* message_data, unsigned int timeout) {
+                return post_msg(task_message(msg_id, message_data), timeout);
             }
 
+            /**
+             * @brief Stop the task: the task handles the posted messages and returns
+             * from on_task. Call after start.
+             */
+            void stop();
+
             basic_message_task(const basic_message_task&) = delete;
             basic_message_task& operator=(const basic_message_task&) = delete;
         protected:
@@ -115,8 +136,17 @@ namespace mn {
              */
             int  on_task();
         protected:
+            /**
+             * The lock for the condition variable, the queue self is thread safe
+             */
             mutex_t m_ltMessageQueueLock;
-            queue::queue_t m_qeMessageQueue;
+            /**
+             * The queue of the posted messages, stored by value
+             */
+            queue::typed_queue<task_message, MN_THREAD_CONFIG_MSGTASK_MAX_MESSAGES> m_qeMessageQueue;
+            /**
+             * Signaled on each posted message
+             */
             convar_t m_cvMessage;
         };
 
@@ -0,0 +1,412 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_RCU_
+#define MINLIB_ESP32_RCU_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_error.hpp"
+#include "mn_atomic.hpp"
+#include "mn_allocator.hpp"
+#include "mn_adaptive_mutex.hpp"
+
+namespace mn {
+  /**
+   *  A read-copy-update domain with quiescent state based reclamation (QSBR).
+   *
+   *  The readers of a rcu_ptr read the pointer with one plain load, without a lock and
+   *  without a atomic read-modify-write. A object that a writer has replaced may only freed,
+   *  when all registered reader tasks have passed a quiescent state, a point where the task
+   *  holds no reference to a rcu protected object (the grace period).
+   *
+   *  - A reader task registers with register_task() and reports quiescent states with
+   *    quiescent_state(), in the main loop of the task. basic_task::yield() does this
+   *    for you, when MN_THREAD_CONFIG_RCU is MN_THREAD_CONFIG_YES (default: NO).
+   *  - A reader task that blocks for a long time goes offline(), a offline task never
+   *    delays a grace period. With MN_THREAD_CONFIG_RCU the sleep functions of basic_task
+   *    do this for you. A reader that blocks in any other call (a queue, a semaphore, a
+   *    mutex, a notification ..) while online stalls synchronize(), barrier() and all
+   *    deferred callbacks until it reports the next quiescent state. Wrap such calls with
+   *    offline() and online().
+   *  - synchronize() waits until the grace period is over, call() defers a callback
+   *    (a free) until the end of the grace period and does not block.
+   *  - The deferred callbacks run in reclaim(), call it from your idle hook with
+   *    on_idle() or from a writer or worker task. From the idle hook the callbacks
+   *    (for rcu_ptr the deallocate of the allocator) run in the idle task: they must not
+   *    block and delay the idle work (e.g. the cleanup of deleted tasks). Call reclaim()
+   *    from a worker task, when the callbacks are expensive.
+   *
+   *  @code
+   *  mn::rcu_ptr<config_t> config(new_config);
+   *
+   *  // reader task
+   *  mn::basic_rcu_domain::instance().register_task();
+   *  while(true) {
+   *    const config_t* cfg = config.get(); // no lock and no atomic
+   *    use(cfg->baud);
+   *    mn::rcu_quiescent_state();          // cfg is now invalid
+   *  }
+   *
+   *  // writer task
+   *  config.emplace(115200, 80);           // the old config is freed after the grace period
+   *  @endcode
+   *
+   *  @note A task that is registered as reader must not call synchronize() and then
+   *  hold a rcu reference, synchronize() puts the caller offline while waiting.
+   *  The deferred callbacks must not block, they can run in the idle task.
+   */
+  class basic_rcu_domain {
+  public:
+    /**
+     * The type of a deferred callback
+     * @param context The context of the callback, for rcu_ptr the allocator
+     * @param object The object to free
+     */
+    using callback_t = void (*)(void* context, void* object);
+  private:
+    /**
+     * The reader record of a registered task
+     */
+    struct reader {
+      /** The registered task or NULL when the slot is free */
+      TaskHandle_t volatile pTask;
+      /** The grace period counter at the last quiescent state or 0 when offline */
+      volatile uint32_t uiCounter;
+    };
+    /**
+     * A deferred callback
+     */
+    struct callback {
+      callback_t fnCallback;
+      void* pContext;
+      void* pObject;
+      /** The grace period counter, that all online readers must have reached */
+      uint32_t uiTarget;
+    };
+    /**
+     * A task in synchronize(), the node lives on the stack of the waiting task
+     */
+    struct waiter {
+      TaskHandle_t pTask;
+      /** The grace period counter, that all online readers must have reached */
+      uint32_t uiTarget;
+      waiter* pNext;
+      volatile bool bDone;
+    };
+
+    basic_rcu_domain();
+  public:
+    /**
+     * Get the rcu domain of the library
+     */
+    static basic_rcu_domain& instance();
+
+    /**
+     * Register the calling task as rcu reader, the task is online.
+     *
+     * @return - ERR_RCU_OK The task is registered (or was already registered)
+     *         - ERR_RCU_READERS_FULL All MN_THREAD_CONFIG_RCU_MAX_READERS slots are in use
+     */
+    int register_task();
+
+    /**
+     * Unregister the calling task, the task must hold no rcu reference
+     *
+     * @return - ERR_RCU_OK The task is unregistered
+     *         - ERR_RCU_NOTREGISTERED The task was not registered
+     */
+    int unregister_task();
+
+    /**
+     * Report a quiescent state for the calling task, all rcu references of the task
+     * are invalid after this call. Does nothing, when the task is not registered.
+     */
+    void quiescent_state();
+
+    /**
+     * The calling task is offline, a offline task holds no rcu reference and never
+     * delays a grace period. Use this before a long blocking call.
+     */
+    void offline();
+
+    /**
+     * The calling task is online again.
+     */
+    void online();
+
+    /**
+     * Is the calling task registered as reader?
+     */
+    bool is_registered();
+
+    /**
+     * Wait until all objects, that are replaced before this call, can be freed.
+     * Can not call from the ISR Context.
+     *
+     * @note Blocks until every online reader has reported a quiescent state, a reader
+     * blocked online outside of sleep or yield delays this call without limit.
+     * The caller sleeps on a task notification, the reader that ends the grace period
+     * (with quiescent_state(), offline() or unregister_task()) wakes it.
+     */
+    void synchronize();
+
+    /**
+     * Defer a callback until the end of the current grace period.
+     * When the callback list is full, the call waits for the grace period and runs
+     * the ready callbacks.
+     *
+     * @param fnCallback The callback to run
+     * @param context The first argument of the callback
+     * @param object The second argument of the callback, the object to free
+     * @return - ERR_RCU_OK The callback is deferred
+     *         - ERR_RCU_CALLBACKS_FULL The list is full and the caller is a ISR
+     */
+    int call(callback_t fnCallback, void* context, void* object);
+
+    /**
+     * Run all deferred callbacks, where the grace period is over. Does not block.
+     *
+     * @return How many callbacks are run
+     */
+    unsigned int reclaim();
+
+    /**
+     * Wait for the grace period and run all deferred callbacks, that are called before.
+     */
+    void barrier();
+
+    /**
+     * The idle hook logic, calls reclaim.
+     * Call it from vApplicationIdleHook or install it with install_idle_hook()
+     *
+     * @note The deferred callbacks run in the idle task, they must not block.
+     *
+     * @return Always true, the idle task can sleep
+     */
+    bool on_idle();
+
+#if MN_THREAD_CONFIG_BOARD ==  MN_THREAD_CONFIG_ESP32
+    /**
+     * Register on_idle as ESP-IDF idle hook on the given core
+     *
+     * @return ESP_OK on success
+     */
+    int install_idle_hook(BaseType_t core = 0);
+#endif
+
+    /**
+     * Get the number of the deferred callbacks, that wait for the end of the grace period
+     */
+    unsigned int get_pending();
+
+    /**
+     * Get the number of registered reader tasks
+     */
+    unsigned int get_readers()              { return m_uiReaders.load(memory_order::Relaxed); }
+
+    /**
+     * Get the current grace period counter
+     */
+    uint32_t get_counter() const            { return __atomic_load_n(&m_uiCounter, __ATOMIC_RELAXED); }
+  private:
+    reader* find(TaskHandle_t pTask);
+    uint32_t start_grace_period();
+    uint32_t oldest_counter();
+    void wake_waiters();
+  private:
+    volatile uint32_t m_uiCounter;
+    atomic_uint32_t m_uiReaders;
+
+    reader m_Readers[MN_THREAD_CONFIG_RCU_MAX_READERS];
+
+    callback m_Callbacks[MN_THREAD_CONFIG_RCU_CALLBACKS];
+    unsigned int m_uiHead;
+    unsigned int m_uiCount;
+
+    /** The tasks in synchronize(), changed under m_Mux */
+    waiter* m_pWaiters;
+
+    portMUX_TYPE m_Mux;
+  };
+
+  /**
+   *  A pointer to a object, that is read-mostly and shared with many tasks.
+   *
+   *  The readers get the object without a lock and without a atomic read-modify-write,
+   *  a writer replace the object with a new copy and the old object is freed with the
+   *  allocator, when the grace period of the basic_rcu_domain is over.
+   *
+   *  @tparam T The type of the object
+   *  @tparam TAllocator The allocator for the objects, see mn::memory
+   *  @ingroup lock
+   */
+  template <typename T, class TAllocator = memory::default_allocator>
+  class rcu_ptr {
+  public:
+    using value_type = T;
+    using pointer = T*;
+    using allocator_type = TAllocator;
+    using self_type = rcu_ptr<T, TAllocator>;
+
+    rcu_ptr()
+      : m_pObject(nullptr), m_Allocator(), m_WriterLock() { }
+
+    /**
+     * Construct the first object with the allocator
+     */
+    template <typename... Args>
+    explicit rcu_ptr(Args&&... args)
+      : m_pObject(nullptr), m_Allocator(), m_WriterLock() {
+      m_pObject = m_Allocator.template construct<value_type>(mn::forward<Args>(args)...);
+    }
+
+    rcu_ptr(const self_type&) = delete;
+    self_type& operator=(const self_type&) = delete;
+
+    /**
+     * Retire the object and wait for all pending frees of this allocator.
+     *
+     * @note The destructor blocks in basic_rcu_domain::barrier() until the grace period
+     * is over, so the allocator is not used after the rcu_ptr is gone. Do not destroy a
+     * rcu_ptr in the ISR Context, from a reader task that holds rcu references or in a
+     * time critical path. Give a rcu_ptr a static lifetime, when possible.
+     */
+    ~rcu_ptr() {
+      retire(exchange(nullptr));
+      basic_rcu_domain::instance().barrier();
+    }
+
+    /**
+     * Read the object, the pointer is valid until the next quiescent state
+     * of the calling task. Can use in the ISR Context.
+     */
+    pointer get() const                     { return __atomic_load_n(&m_pObject, __ATOMIC_CONSUME); }
+
+    pointer operator -> () const            { return get(); }
+    value_type& operator * () const         { return *get(); }
+    explicit operator bool () const         { return get() != nullptr; }
+
+    /**
+     * Publish a new object and get the old one back, the old object is still in use
+     * by the readers, free it with retire().
+     */
+    pointer exchange(pointer object) {
+      m_WriterLock.lock();
+      pointer _pOld = publish(object);
+      m_WriterLock.unlock();
+
+      return _pOld;
+    }
+
+    /**
+     * Construct a new object with the allocator, publish it and retire the old one.
+     *
+     * @return - ERR_RCU_OK The new object is published
+     *         - ERR_RCU_NOMEM The new object can not allocate
+     */
+    template <typename... Args>
+    int emplace(Args&&... args) {
+      pointer _pNew = m_Allocator.template construct<value_type>(mn::forward<Args>(args)...);
+      if(_pNew == nullptr) return ERR_RCU_NOMEM;
+
+      return retire(exchange(_pNew));
+    }
+
+    /**
+     * Read-copy-update: copy the current object, call fn on the copy and publish it.
+     * The writers are serialized, so no update is lost and the copied object can not
+     * retired while copying, the readers are never blocked.
+     *
+     * @param fn The update function, called with a reference of the copy
+     * @return - ERR_RCU_OK The new object is published
+     *         - ERR_RCU_NOMEM The copy can not allocate
+     */
+    template <class TFunction>
+    int modify(TFunction fn) {
+      m_WriterLock.lock();
+
+      pointer _pOld = get();
+      pointer _pNew = (_pOld != nullptr)
+          ? m_Allocator.template construct<value_type>(*_pOld)
+          : m_Allocator.template construct<value_type>();
+
+      if(_pNew == nullptr) {
+        m_WriterLock.unlock();
+        return ERR_RCU_NOMEM;
+      }
+      fn(*_pNew);
+      publish(_pNew);
+
+      m_WriterLock.unlock();
+
+      return retire(_pOld);
+    }
+
+    /**
+     * Free a object, that is no longer published, after the grace period
+     */
+    int retire(pointer object) {
+      if(object == nullptr) return ERR_RCU_OK;
+
+      return basic_rcu_domain::instance().call(&self_type::free_object, &m_Allocator, object);
+    }
+
+    /**
+     * Free a object, that is no longer published, now - blocks until the grace period is over
+     */
+    void retire_sync(pointer object) {
+      if(object == nullptr) return;
+
+      basic_rcu_domain::instance().synchronize();
+      m_Allocator.template destroy<value_type>(object);
+    }
+
+    allocator_type& get_allocator()         { return m_Allocator; }
+  private:
+    pointer publish(pointer object) {
+      return __atomic_exchange_n(&m_pObject, object, __ATOMIC_ACQ_REL);
+    }
+
+    static void free_object(void* context, void* object) {
+      static_cast<allocator_type*>(context)->template destroy<value_type>(static_cast<pointer>(object));
+    }
+  private:
+    pointer m_pObject;
+    allocator_type m_Allocator;
+    /** Serialize the writers, a short lock without kernel object */
+    adaptive_mutex_t m_WriterLock;
+  };
+
+  /**
+   * Report a quiescent state of the calling task to the library rcu domain
+   */
+  inline void rcu_quiescent_state()         { basic_rcu_domain::instance().quiescent_state(); }
+
+  /**
+   * Wait for the grace period of the library rcu domain
+   */
+  inline void rcu_synchronize()             { basic_rcu_domain::instance().synchronize(); }
+
+  using rcu_domain_t = basic_rcu_domain;
+}
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_SEQLOCK_
+#define MINLIB_ESP32_SEQLOCK_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+#include "mn_atomic.hpp"
+#include "mn_typetraits.hpp"
+
+namespace mn {
+  /**
+   *  A sequence lock for small POD snapshots.
+   *
+   *  The readers copy the value and check with the sequence number that no writer was
+   *  running meanwhile, a reader does no atomic read-modify-write and never blocks the writer.
+   *  The writers are serialized with a CAS on the sequence number, a odd number means a
+   *  writer is running.
+   *
+   *  @code
+   *  struct config_t { uint32_t baud; uint16_t port; uint8_t flags; };
+   *  mn::seqlock<config_t> config;
+   *
+   *  config.write(new_config);        // writer
+   *  config_t current = config.read(); // any reader, also in ISR with try_read
+   *  @endcode
+   *
+   *  @note When a reader task has a higher priority than the writer on the same core, the reader
+   *  waits a tick after MN_THREAD_CONFIG_SEQLOCK_SPIN tries, so the writer can finish.
+   *
+   *  @tparam T The type of the value, must be trivially copyable
+   * @ingroup lock
+   */
+  template <typename T>
+  class basic_seqlock {
+    static_assert(is_trivially_copyable<T>::value, "basic_seqlock: the value must be trivially copyable");
+  public:
+    using value_type = T;
+    using self_type = basic_seqlock<T>;
+
+    basic_seqlock()
+      : m_uiSequence(0), m_Value() { }
+
+    explicit basic_seqlock(const value_type& value)
+      : m_uiSequence(0), m_Value(value) { }
+
+    /**
+     * Try to read a consistent copy of the value, once.
+     *
+     * @param value Where the copy is returned to.
+     * @return true when the copy is consistent and false when a writer was running
+     */
+    bool try_read(value_type& value) const {
+      uint32_t _uiBegin = m_uiSequence.load(memory_order::Acquire);
+      if(_uiBegin & 1) return false;
+
+      memcpy(&value, &m_Value, sizeof(value_type));
+      atomic_thread_fence(memory_order::Acquire);
+
+      return m_uiSequence.load(memory_order::Relaxed) == _uiBegin;
+    }
+
+    /**
+     * Read a consistent copy of the value, retry while a writer is running.
+     *
+     * @param value Where the copy is returned to.
+     */
+    void read(value_type& value) const {
+      for(unsigned int _uiTry = 1; !try_read(value); _uiTry++) {
+        if( (_uiTry % MN_THREAD_CONFIG_SEQLOCK_SPIN) == 0 && !xPortInIsrContext())
+          vTaskDelay(1);
+      }
+    }
+
+    /**
+     * Read a consistent copy of the value, retry while a writer is running.
+     */
+    value_type read() const {
+      value_type _value;
+      read(_value);
+      return _value;
+    }
+
+    /**
+     * Write a new value, wait for a other running writer.
+     *
+     * @param value The new value.
+     */
+    void write(const value_type& value) {
+      uint32_t _uiSequence = begin_write();
+
+      memcpy(&m_Value, &value, sizeof(value_type));
+
+      end_write(_uiSequence);
+    }
+
+    /**
+     * Change the value in place with fn(value_type&), wait for a other running writer.
+     */
+    template <typename TFunc>
+    void modify(TFunc fn) {
+      uint32_t _uiSequence = begin_write();
+
+      value_type _value;
+      memcpy(&_value, &m_Value, sizeof(value_type));
+      fn(_value);
+      memcpy(&m_Value, &_value, sizeof(value_type));
+
+      end_write(_uiSequence);
+    }
+
+    /**
+     * Get the sequence number, increases by two for each write
+     */
+    uint32_t get_sequence() const { return m_uiSequence.load(memory_order::Acquire); }
+  private:
+    uint32_t begin_write() {
+      uint32_t _uiSequence = m_uiSequence.load(memory_order::Relaxed);
+
+      for(unsigned int _uiTry = 1; ; _uiTry++) {
+        if( (_uiSequence & 1) == 0 &&
+            m_uiSequence.compare_exchange_weak(_uiSequence, _uiSequence + 1, memory_order::Acquire) )
+          break;
+
+        if( (_uiTry % MN_THREAD_CONFIG_SEQLOCK_SPIN) == 0 && !xPortInIsrContext())
+          vTaskDelay(1);
+
+        _uiSequence = m_uiSequence.load(memory_order::Relaxed);
+      }
+      atomic_thread_fence(memory_order::Release);
+
+      return _uiSequence + 1;
+    }
+
+    void end_write(uint32_t uiSequence) {
+      m_uiSequence.store(uiSequence + 1, memory_order::Release);
+    }
+  private:
+    atomic_uint32_t m_uiSequence;
+    value_type m_Value;
+  };
+
+  template <typename T>
+  using seqlock = basic_seqlock<T>;
+}
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_SHARED_MUTEX_
+#define MINLIB_ESP32_SHARED_MUTEX_
+
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <time.h>
+
+#include "mn_error.hpp"
+#include "mn_lock.hpp"
+
+namespace mn {
+  /**
+   *  A writer-preferring reader-writer lock.
+   *
+   *  Any number of readers can hold the lock with lock_shared(), or one writer with lock().
+   *  When a writer waits, new readers must wait too, so a stream of readers can't starve
+   *  the writers. The uncontended lock_shared, unlock_shared, lock and unlock are one CAS
+   *  (or fetch_sub) on the state word, the tasks are parked with a task notification.
+   *
+   *  @code
+   *  mn::shared_mutex_t table_lock;
+   *
+   *  // reader
+   *  {
+   *    mn::autoshared_t guard(table_lock);
+   *    lookup(key);
+   *  }
+   *  // writer
+   *  {
+   *    mn::autosharedmutx_t guard(table_lock);
+   *    update(key, value);
+   *  }
+   *  @endcode
+   *
+   *  @note Not recursively acquirable and can not use in the ISR Context.
+   *
+   * @ingroup mutex
+   * @ingroup lock
+   */
+  class basic_shared_mutex : public ILockObject {
+    /**
+     * A parked task, the node lives on the stack of the waiting task
+     */
+    struct waiter {
+      TaskHandle_t pTask;
+      waiter* pNext;
+      volatile bool bGranted;
+    };
+  public:
+    basic_shared_mutex();
+    virtual ~basic_shared_mutex();
+
+    /**
+     *  Lock the mutex exclusive, for writing.
+     *
+     *  @param timeout How long to wait to get the Lock until giving up.
+     *  @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out
+     */
+    virtual int lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT);
+
+    /**
+     *  Lock the mutex exclusive with a absolute timeout
+     */
+    virtual int time_lock(const struct timespec *timeout);
+
+    /**
+     *  Unlock the exclusive lock.
+     *  @return ERR_MUTEX_OK or ERR_MUTEX_UNLOCK when not exclusive locked
+     */
+    virtual int unlock();
+
+    /**
+     *  Try to lock the mutex exclusive, without waiting
+     */
+    virtual bool try_lock();
+
+    /**
+     *  Lock the mutex shared, for reading.
+     *
+     *  @param timeout How long to wait to get the Lock until giving up.
+     *  @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out
+     */
+    int lock_shared(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT);
+
+    /**
+     *  Lock the mutex shared with a absolute timeout
+     */
+    int time_lock_shared(const struct timespec *timeout);
+
+    /**
+     *  Unlock the shared lock.
+     *  @return ERR_MUTEX_OK or ERR_MUTEX_UNLOCK when not shared locked
+     */
+    int unlock_shared();
+
+    /**
+     *  Try to lock the mutex shared, without waiting
+     */
+    bool try_lock_shared();
+
+    virtual bool is_initialized() const   { return true; }
+
+    /**
+     * @brief Is exclusive locked?
+     */
+    virtual bool is_locked() const;
+
+    /**
+     * @brief Get the number of readers, only a snapshot
+     */
+    uint32_t get_readers() const;
+  private:
+    int lock_slow(unsigned int timeout);
+    int wait(waiter& node, bool bWriter, unsigned int timeout);
+    waiter* grant();
+    void notify(waiter* pGranted);
+    static TickType_t to_ticks(const struct timespec *timeout);
+  private:
+    /**
+     * The number of readers and the flags STATE_WRITER, STATE_PENDING and STATE_PARKED
+     */
+    volatile uint32_t m_uiState;
+
+    portMUX_TYPE m_Mux;
+    waiter* m_pReaders;
+    waiter* m_pWriters;
+    uint32_t m_uiWritersWaiting;
+  };
+
+  /**
+   *  A autolock for the shared (reader) side of a lock, lock_shared in the constructor
+   *  and unlock_shared in the destructor.
+   *
+   * @ingroup lock
+   */
+  template <class LOCK>
+  class basic_autolock_shared : MN_ONSIGLETN_CLASS {
+  public:
+    /**
+     *  Lock shared, without timeout
+     */
+    basic_autolock_shared(LOCK &m)
+      : m_ref_lock(m) {
+      m_bLocked = (m_ref_lock.lock_shared(portMAX_DELAY) == NO_ERROR);
+    }
+    /**
+     *  Lock shared, with timeout
+     *  @param xTicksToWait How long to wait to get the lock until giving up.
+     */
+    basic_autolock_shared(LOCK &m, unsigned long xTicksToWait)
+      : m_ref_lock(m) {
+      m_bLocked = (m_ref_lock.lock_shared(xTicksToWait) == NO_ERROR);
+    }
+    /**
+     *  Unlock shared, when locked
+     */
+    ~basic_autolock_shared() {
+      if(m_bLocked) m_ref_lock.unlock_shared();
+    }
+    /**
+     * Is the shared lock taken? False when the timeout was over.
+     */
+    operator bool () {
+      return m_bLocked;
+    }
+  private:
+    LOCK &m_ref_lock;
+    bool m_bLocked;
+  };
+
+  using shared_mutex_t = basic_shared_mutex;
+
+  /**
+   * A autolock type for the exclusive side of shared_mutex_t objects
+   */
+  using autosharedmutx_t = basic_autolock<shared_mutex_t>;
+  /**
+   * A autolock type for the shared side of shared_mutex_t objects
+   */
+  using autoshared_t = basic_autolock_shared<shared_mutex_t>;
+}
+
+#endif
@@ -34,6 +34,10 @@
 #include "mn_micros.hpp"
 #include "mn_eventgroup.hpp"
 
+#if MN_THREAD_CONFIG_RCU == MN_THREAD_CONFIG_YES
+#include "mn_rcu.hpp"
+#endif
+
 namespace mn {
 
   /**
@@ -367,26 +371,33 @@ namespace mn {
 
     /**
      * @brief Yield the scheduler.
+     * @note When the task is a rcu reader, then is this a quiescent state
      */
-    static void yield()                   { taskYIELD(); }
+    static void yield()                   { rcu_quiescent(); taskYIELD(); }
     /**
      * @brief sleep this task for n seconds
      *
      * @param secs How long seconds to sleep the task.
+     * @note When the task is a rcu reader, then is the task offline while sleeping
      */
-    static void sleep(unsigned int secs)     { mn::delay(timespan_t(0, 0, 0, secs)); }
+    static void sleep(unsigned int secs)     {
+      rcu_offline(); mn::delay(timespan_t(0, 0, 0, secs)); rcu_online();
+    }
     /**
      * @brief sleep this task for n micro seconds
      *
      * @param secs How long micro seconds to sleep the task.
+     * @note When the task is a rcu reader, then is the task offline while sleeping
      */
-    static void usleep(unsigned int usec)     { mn::delay(timespan_t(0, 0, 0, 0, usec)); }
+    static void usleep(unsigned int usec)     {
+      rcu_offline(); mn::delay(timespan_t(0, 0, 0, 0, usec)); rcu_online();
+    }
     /**
      * @brief pause execution for a specified time
      * @note see Linux nanosleep function
      */
     static void nsleep(const timespan_t& req, timespan_t* rem)     {
-      	mn::ndelay(req, rem);
+      rcu_offline(); mn::ndelay(req, rem); rcu_online();
     }
 
     /**
@@ -419,6 +430,16 @@ namespace mn {
      * specific on_task() function that interfaces with FreeRTOS.
      */
     static void runtaskstub(void* parm);
+
+#if MN_THREAD_CONFIG_RCU == MN_THREAD_CONFIG_YES
+    static void rcu_quiescent()   { basic_rcu_domain::instance().quiescent_state(); }
+    static void rcu_offline()     { basic_rcu_domain::instance().offline(); }
+    static void rcu_online()      { basic_rcu_domain::instance().online(); }
+#else
+    static void rcu_quiescent()   { }
+    static void rcu_offline()     { }
+    static void rcu_online()      { }
+#endif
   protected:
     /**
      * @brief Lock Objekt for task safty
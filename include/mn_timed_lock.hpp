@@ -47,28 +47,41 @@ namespace mn {
         /**
          *  Lock the timed mutex.
          *
-         * @param task The current canvar Task
          * @param Timeout How long to wait to get the Lock until giving up. (default = 0xffffffffUL)
+         * @return ERR_MUTEX_OK the lock is taken and ERR_MUTEX_LOCK on timeout
          */
-        void lock(basic_convar_task& task, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+        int lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
             basic_autolock<TLOCK> lock(m_lockObject);
-            while (m_bLocked) {
-                task.wait(m_cv, m_mutex, timeout);
-            }
+
+            if(!m_cv.wait(m_lockObject, timeout, [this] { return !m_bLocked; }))
+                return ERR_MUTEX_LOCK;
+
             m_bLocked = true;
+            return ERR_MUTEX_OK;
+        }
+        /**
+         *  Lock the timed mutex.
+         *
+         * @param task The current canvar Task
+         * @param Timeout How long to wait to get the Lock until giving up. (default = 0xffffffffUL)
+         */
+        int lock(ext::basic_convar_task& task, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+            (void)task; return lock(timeout);
         }
         /**
          * Unlock the timed Mutex.
          *
-         * @param signal_childs On notify the task, send a notify to the child task?
+         * @param signal_childs Wake all waiting tasks and not only the first? (default = true)
          */
         void unlock(bool signal_childs = true) {
             basic_autolock<TLOCK> lock(m_lockObject);
             m_bLocked = false;
-            m_cv.signal(signal_childs);
+
+            if(signal_childs) m_cv.broadcast();
+            else m_cv.signal();
         }
     private:
-            convar_t    m_cv;
+            ext::convar_t   m_cv;
             TLOCK       m_lockObject;
             bool        m_bLocked;
     };
@@ -22,6 +22,10 @@
 #include "mn_config.hpp"
 #include "mn_itimer.hpp"
 
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+#include "coroutine/mn_co_event.hpp"
+#endif
+
 namespace mn {
     /**
      *  Wrapper class around FreeRTOS's implementation of a timer.
@@ -155,6 +159,14 @@ namespace mn {
         virtual bool        is_running();
 
         operator bool() { return is_running(); }
+
+    #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+        /**
+         * Get the event for the coroutines, that await the expiry (co_timer).
+         * The expiry and inactive resumes the coroutines.
+         */
+        basic_co_event& get_co_event() { return m_CoEvent; }
+    #endif
     protected:
         /**
          * Implementation of your actual timer code.
@@ -199,6 +211,10 @@ namespace mn {
          */
         int m_iTimerID;
 
+        #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+            basic_co_event m_CoEvent;
+        #endif
+
         #if( configSUPPORT_STATIC_ALLOCATION == 1 )
             StaticTimer_t m_xTimerBuffer;
         #endif
@@ -18,6 +18,8 @@
 #ifndef _MINLIB_BASIC_NET_TYPES_HPP_
 #define _MINLIB_BASIC_NET_TYPES_HPP_
 
+#include "../mn_config.hpp"
+
 #include "lwip/err.h"
 #include "lwip/sockets.h"
 
@@ -29,6 +31,18 @@
 #define UDPLITE_RECV_CSCOV 0x02
 #endif // UDPLITE_RECV_CSCOV
 
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+	/// Access the in6_addr as array of 4 uint32_t (host BSD socket layout)
+	#define MNNET_IN6_ADDR_U32(addr)	(addr).s6_addr32
+	/// Access the in6_addr as array of 16 uint8_t (host BSD socket layout)
+	#define MNNET_IN6_ADDR_U8(addr)		(addr).s6_addr
+#else
+	/// Access the in6_addr as array of 4 uint32_t (lwip layout)
+	#define MNNET_IN6_ADDR_U32(addr)	(addr).un.u32_addr
+	/// Access the in6_addr as array of 16 uint8_t (lwip layout)
+	#define MNNET_IN6_ADDR_U8(addr)		(addr).un.u8_addr
+#endif // MN_THREAD_CONFIG_BOARD
+
 #define SERVICE_PROVIDES_TOS(tos) (mn::net::service_provides) ((tos) & mn::net::service_provides::tos_mask)
 
 namespace mn {
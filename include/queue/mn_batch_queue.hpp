@@ -0,0 +1,193 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_BATCH_QUEUE_
+#define MINLIB_ESP32_BATCH_QUEUE_
+
+#include "../mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdint.h>
+
+#include "mn_queue.hpp"
+
+namespace mn {
+    namespace queue {
+        /**
+         * @brief A multi producer, multi consumer queue on a ring buffer, that moves a whole
+         * batch at once.
+         *
+         * enqueue_n and dequeue_n copy the batch with one critical section and one memcpy
+         * (two, when the batch wraps around the end of the ring) and wake one blocked task
+         * with one task notification for the batch. A woken task that leaves items (or space)
+         * wakes the next blocked task. The FreeRTOS queue (basic_queue) copies and notifies
+         * for each item.
+         *
+         * The blocked tasks are parked with task notifications, the notification value of a
+         * waiting task is used (like basic_shared_mutex and the futures do).
+         *
+         * @note get_handle() is NULL, the queue is not a FreeRTOS queue.
+         * @note can use at the ISR Context, too. In a ISR the functions never wait.
+         *
+         * @ingroup queue
+         */
+        class basic_batch_queue : public basic_queue {
+            /**
+             * A blocked task, the node lives on the stack of the waiting task
+             */
+            struct waiter {
+                TaskHandle_t pTask;
+                waiter* pNext;
+                volatile bool bSignaled;
+            };
+        public:
+            /**
+             *  ctor
+             *
+             *  @param maxItems Maximum number of items this queue can hold.
+             *  @param itemSize Size of an item in a queue.
+             *  @param pStorage The ring buffer, maxItems * itemSize bytes. When NULL, create()
+             *  allocates the buffer.
+             */
+            basic_batch_queue(unsigned int maxItems, unsigned int itemSize, void* pStorage = NULL);
+
+            /**
+             *  dtor, free the ring buffer
+             */
+            virtual ~basic_batch_queue();
+
+            /**
+             * Create the queue
+             *
+             *  @return 'ERR_QUEUE_OK': the queue was created
+             *          'ERR_QUEUE_ALREADYINIT': the queue is allready created
+             *          'ERR_QUEUE_CANTCREATE': the ring buffer can not allocated
+             */
+            virtual int create() override;
+
+            /**
+             * Destroy the Queue
+             *
+             *  @return 'ERR_QUEUE_OK' the queue was destroyed
+             *          'ERR_QUEUE_NOTCREATED' the queue is not created
+             */
+            virtual int destroy() override;
+
+            /**
+             *  Add an item to the back of the queue.
+             *  @return 'ERR_QUEUE_OK' the item was added, 'ERR_QUEUE_ADD' on timeout
+             *          and 'ERR_QUEUE_NOTCREATED' when the queue not created
+             */
+            virtual int enqueue(void *item,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             *  Make a copy of the item from the front of the queue, wait for a item.
+             *  @return 'ERR_QUEUE_OK' if an item was copied, 'ERR_QUEUE_PEEK' on timeout
+             *  and 'ERR_QUEUE_NOTCREATED' when the queue not created
+             */
+            virtual int peek(void *item,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             *  Remove an item from the front of the queue.
+             *  @return 'ERR_QUEUE_OK' the item was removed, 'ERR_QUEUE_REMOVE' on timeout
+             *          and 'ERR_QUEUE_NOTCREATED' when the queue not created
+             */
+            virtual int dequeue(void *item,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             *  Add up to count items to the back of the queue, with one copy.
+             *
+             *  Waits until there is space for one item, then adds as many items as space is
+             *  left, in one critical section. Wakes one blocked consumer for the batch.
+             *
+             *  @param items Pointer to the first item, the items are itemSize bytes apart.
+             *  @param count How many items to add.
+             *  @param timeout How long to wait for space.
+             *  @return The number of added items, 0 on timeout or when the queue is not created
+             */
+            virtual unsigned int enqueue_n(const void *items, unsigned int count,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             *  Remove up to count items from the front of the queue, with one copy.
+             *
+             *  Waits until there is one item, then removes as many items as are in the queue,
+             *  in one critical section. Wakes one blocked producer for the batch.
+             *
+             *  @param items Where the removed items are returned to, space for count items.
+             *  @param count How many items to remove at most.
+             *  @param timeout How long to wait for a item.
+             *  @return The number of removed items, 0 on timeout or when the queue is not created
+             */
+            virtual unsigned int dequeue_n(void *items, unsigned int count,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            virtual bool is_empty() override;
+            virtual bool is_full() override;
+
+            /**
+             *  Remove all objects from the queue.
+             */
+            virtual int clear() override;
+
+            /**
+             *  How many items are currently in the queue.
+             */
+            virtual unsigned int get_num_items() override;
+
+            /**
+             *  How many empty spaces are currently left in the queue.
+             */
+            virtual unsigned int get_left() override;
+        private:
+            unsigned int transfer(void *items, unsigned int count, unsigned int timeout, bool bWrite, bool bRemove);
+            void copy_in(const uint8_t* pItems, unsigned int count);
+            void copy_out(uint8_t* pItems, unsigned int count, bool bRemove);
+
+            static waiter* pop(waiter** ppList);
+            static void push(waiter** ppList, waiter* pNode);
+            static bool unlink(waiter** ppList, waiter* pNode);
+            static void notify(waiter* pNode);
+        private:
+            portMUX_TYPE m_Mux;
+
+            uint8_t* m_pBuffer;
+            uint8_t* m_pStorage;
+
+            /**
+             * The index of the first item and the number of items in the ring
+             */
+            unsigned int m_uiHead;
+            unsigned int m_uiCount;
+
+            /**
+             * The blocked consumers (wait for items) and producers (wait for space), FIFO
+             */
+            waiter* m_pReaders;
+            waiter* m_pWriters;
+        };
+
+        using batch_queue_t = basic_batch_queue;
+    }
+}
+
+#endif
@@ -20,6 +20,10 @@
 
 #include "mn_config.hpp"
 
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+#include "../coroutine/mn_co_event.hpp"
+#endif
+
 namespace mn {
     namespace queue {
         /**
@@ -96,6 +100,47 @@ namespace mn {
             virtual int dequeue(void *item, 
                             unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT);
 
+            /**
+             *  Add up to count items to the back of the queue, with one wait.
+             *
+             *  Only the first item waits for space, the other items are added as long
+             *  as space is left. The items are added one by one with the queue API, so a
+             *  consumer can take items while the batch is added.
+             *
+             *  @note The FreeRTOS queue copies and notifies for each item, basic_batch_queue
+             *  (and typed_queue) moves the whole batch with one copy and one notification.
+             *
+             *  @param items Pointer to the first item, the items are itemSize bytes apart.
+             *  @param count How many items to add.
+             *  @param timeout How long to wait for space for the first item.
+             *  @return The number of added items, 0 on an error or when the queue is not created
+             */
+            virtual unsigned int enqueue_n(const void *items, unsigned int count,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT);
+            /**
+             *  Remove up to count items from the front of the queue, with one wait.
+             *
+             *  Only the first item is waited for, the other items are removed as long
+             *  as items are in the queue. The items are removed one by one with the queue API.
+             *  @see basic_batch_queue
+             *
+             *  @param items Where the removed items are returned to, space for count items.
+             *  @param count How many items to remove at most.
+             *  @param timeout How long to wait for the first item.
+             *  @return The number of removed items, 0 on an error or when the queue is not created
+             */
+            virtual unsigned int dequeue_n(void *items, unsigned int count,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT);
+            /**
+             *  Remove all items that currently in the queue, without waiting.
+             *
+             *  @param items Where the removed items are returned to, space for count items.
+             *  @param count How many items the buffer can hold.
+             *  @return The number of removed items
+             */
+            unsigned int drain(void *items, unsigned int count) {
+                return dequeue_n(items, count, 0);
+            }
             /**
              *  Is the queue empty?
              *  @return true the queue is empty and false when not
@@ -129,6 +174,22 @@ namespace mn {
              *  @return the FreeRTOS handle
              */
             void*  get_handle() { return m_pHandle; }
+
+        #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+            /**
+             *  get the event for the coroutines, that await a item (co_dequeue)
+             */
+            basic_co_event& get_co_event() { return m_CoEvent; }
+        #endif
+        protected:
+            /**
+             *  Resume the coroutines, that await a item, call after a item is added
+             */
+            void on_enqueued() {
+            #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+                m_CoEvent.notify_all();
+            #endif
+            }
         protected:
             /**
              *  FreeRTOS queue handle.
@@ -137,6 +198,9 @@ namespace mn {
 
             unsigned int m_imaxItems;
             unsigned int m_iitemSize;
+        #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+            basic_co_event m_CoEvent;
+        #endif
         };
 
         using queue_t = basic_queue;
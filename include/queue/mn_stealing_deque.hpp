@@ -0,0 +1,149 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_STEALING_DEQUE_
+#define MINLIB_ESP32_STEALING_DEQUE_
+
+#include "../mn_config.hpp"
+#include "../mn_atomic.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace mn {
+    namespace queue {
+        /**
+         * A bounded lock-free Chase-Lev work-stealing deque of pointers.
+         *
+         * Only the owner task calls push() and pop() on the bottom end, all other tasks
+         * can steal() from the top end. The indices are free running uint32_t values,
+         * the difference of both is the number of items.
+         *
+         * @tparam TItem The type of the items, the deque holds TItem*
+         * @tparam TCapacity The number of items, must be a power of two
+         *
+         * @ingroup queue
+         */
+        template <typename TItem, uint32_t TCapacity = MN_THREAD_CONFIG_WORKQUEUE_STEALING_DEQUE_SIZE>
+        class basic_stealing_deque {
+            static_assert(TCapacity > 0 && (TCapacity & (TCapacity - 1)) == 0,
+                          "basic_stealing_deque: the capacity must be a power of two");
+        public:
+            using value_type = TItem;
+            using pointer = TItem*;
+            using self_type = basic_stealing_deque<TItem, TCapacity>;
+
+            basic_stealing_deque() noexcept
+                : m_uiTop(0), m_uiBottom(0) { }
+
+            /**
+             * Push an item at the bottom, only from the owner task.
+             *
+             * @param item The item to push.
+             * @return true when the item was pushed and false when the deque is full.
+             */
+            bool push(pointer item) noexcept {
+                uint32_t _b = m_uiBottom.load(memory_order::Relaxed);
+                uint32_t _t = m_uiTop.load(memory_order::Acquire);
+
+                if( (_b - _t) >= TCapacity ) return false;
+
+                m_aBuffer[_b & MASK].store(item, memory_order::Relaxed);
+                // release, a thief that sees the new bottom sees the item too
+                m_uiBottom.store(_b + 1, memory_order::Release);
+
+                return true;
+            }
+
+            /**
+             * Pop the last pushed item from the bottom, only from the owner task.
+             *
+             * @return The item or NULL when the deque is empty or a thief got the last item.
+             */
+            pointer pop() noexcept {
+                uint32_t _b = m_uiBottom.load(memory_order::Relaxed) - 1;
+                m_uiBottom.store(_b, memory_order::Relaxed);
+
+                atomic_thread_fence(memory_order::SeqCst);
+                uint32_t _t = m_uiTop.load(memory_order::Relaxed);
+
+                if( int32_t(_b - _t) < 0 ) {
+                    // empty
+                    m_uiBottom.store(_b + 1, memory_order::Relaxed);
+                    return NULL;
+                }
+
+                pointer _item = m_aBuffer[_b & MASK].load(memory_order::Relaxed);
+
+                if(_b == _t) {
+                    // the last item - race against the thieves
+                    if(!m_uiTop.compare_exchange_strong(_t, _t + 1, memory_order::SeqCst))
+                        _item = NULL;
+                    m_uiBottom.store(_b + 1, memory_order::Relaxed);
+                }
+                return _item;
+            }
+
+            /**
+             * Steal the oldest item from the top, from any task.
+             *
+             * @return The item or NULL when the deque is empty or a other task won the race.
+             */
+            pointer steal() noexcept {
+                uint32_t _t = m_uiTop.load(memory_order::Acquire);
+                atomic_thread_fence(memory_order::SeqCst);
+                uint32_t _b = m_uiBottom.load(memory_order::Acquire);
+
+                if( int32_t(_b - _t) <= 0 ) return NULL;
+
+                pointer _item = m_aBuffer[_t & MASK].load(memory_order::Relaxed);
+
+                if(!m_uiTop.compare_exchange_strong(_t, _t + 1, memory_order::SeqCst))
+                    return NULL;
+
+                return _item;
+            }
+
+            /**
+             * Get the number of items, only a snapshot when other tasks use the deque.
+             */
+            uint32_t size() const noexcept {
+                int32_t _size = int32_t(m_uiBottom.load(memory_order::Relaxed) - m_uiTop.load(memory_order::Relaxed));
+                return (_size < 0) ? 0 : uint32_t(_size);
+            }
+
+            bool is_empty() const noexcept  { return size() == 0; }
+
+            /**
+             * Get the maximal number of items.
+             */
+            constexpr uint32_t capacity() const noexcept { return TCapacity; }
+        private:
+            basic_stealing_deque(const self_type&) = delete;
+            self_type& operator = (const self_type&) = delete;
+        private:
+            static constexpr uint32_t MASK = TCapacity - 1;
+
+            atomic_uint32_t     m_uiTop;
+            atomic_uint32_t     m_uiBottom;
+            atomic_ptr<TItem>   m_aBuffer[TCapacity];
+        };
+    }
+}
+
+#endif // MINLIB_ESP32_STEALING_DEQUE_
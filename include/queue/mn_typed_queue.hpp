@@ -0,0 +1,123 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_TYPED_QUEUE_
+#define MINLIB_ESP32_TYPED_QUEUE_
+
+#include "../mn_config.hpp"
+#include "../mn_typetraits.hpp"
+
+#include "mn_batch_queue.hpp"
+
+namespace mn {
+    namespace queue {
+        /**
+         * @brief A typed batch queue, the queue holds up to TMaxItems copies of T in a ring
+         * buffer inside the object, create() allocates nothing.
+         *
+         * @code
+         * mn::queue::typed_queue<sensor_frame_t, 64> frames;
+         * frames.create();
+         *
+         * sensor_frame_t batch[16];
+         * unsigned int n = frames.dequeue_n(batch, 16, portMAX_DELAY);
+         * @endcode
+         *
+         * @note The items are copied with memcpy, T must be trivially copyable.
+         * @see basic_batch_queue
+         *
+         * @tparam T The type of the items
+         * @tparam TMaxItems Maximum number of items this queue can hold.
+         * @ingroup queue
+         */
+        template <typename T, unsigned int TMaxItems>
+        class typed_queue : public basic_batch_queue {
+            static_assert(is_trivially_copyable<T>::value, "the items of a typed_queue must be trivially copyable");
+            static_assert(TMaxItems > 0, "a typed_queue must hold one item");
+        public:
+            using value_type = T;
+            using self_type = typed_queue<T, TMaxItems>;
+
+            typed_queue()
+                : basic_batch_queue(TMaxItems, sizeof(T), m_Storage) { }
+
+            /**
+             *  Add an item to the back of the queue.
+             *  @return ERR_QUEUE_OK, ERR_QUEUE_ADD or ERR_QUEUE_NOTCREATED
+             */
+            int enqueue(const value_type& item, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return basic_batch_queue::enqueue(const_cast<value_type*>(&item), timeout);
+            }
+            /**
+             *  Remove an item from the front of the queue.
+             *  @return ERR_QUEUE_OK, ERR_QUEUE_REMOVE or ERR_QUEUE_NOTCREATED
+             */
+            int dequeue(value_type& item, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return basic_batch_queue::dequeue(&item, timeout);
+            }
+            /**
+             *  Make a copy of the item from the front of the queue.
+             *  @return ERR_QUEUE_OK, ERR_QUEUE_PEEK or ERR_QUEUE_NOTCREATED
+             */
+            int peek(value_type& item, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return basic_batch_queue::peek(&item, timeout);
+            }
+            /**
+             *  Add up to count items with one copy, waits only when the queue is full.
+             *  @return The number of added items
+             */
+            unsigned int enqueue_n(const value_type* items, unsigned int count,
+                                   unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return basic_batch_queue::enqueue_n(items, count, timeout);
+            }
+            /**
+             *  Remove up to count items with one copy, waits only when the queue is empty.
+             *  @return The number of removed items
+             */
+            unsigned int dequeue_n(value_type* items, unsigned int count,
+                                   unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return basic_batch_queue::dequeue_n(items, count, timeout);
+            }
+            /**
+             *  Remove up to TBatch items in the given array, waits only when the queue is empty.
+             *  @return The number of removed items
+             */
+            template <unsigned int TBatch>
+            unsigned int dequeue_n(value_type (&items)[TBatch],
+                                   unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return basic_batch_queue::dequeue_n(items, TBatch, timeout);
+            }
+            /**
+             *  Remove all items that currently in the queue, without waiting.
+             *  @return The number of removed items
+             */
+            unsigned int drain(value_type* items, unsigned int count) {
+                return basic_batch_queue::dequeue_n(items, count, 0);
+            }
+
+            /**
+             *  Get the maximal number of items.
+             */
+            static constexpr unsigned int capacity() { return TMaxItems; }
+        private:
+            alignas(T) uint8_t m_Storage[sizeof(T) * TMaxItems];
+        };
+    }
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "mn_queue.hpp"
 #include "mn_workqueue_item.hpp"
+#include "mn_workqueue_future_item.hpp"
 #include "mn_workqueue_task.hpp"
 
 namespace mn {
@@ -85,6 +86,34 @@ namespace mn {
             virtual int queue(work_queue_item_t *work,
                             unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT);
 
+            /**
+             * Submit a callable to be executed and get a future for his result.
+             * The callable is stored inline in a pooled work item, no heap allocation
+             * while the pool (MN_THREAD_CONFIG_FUTURE_POOL_SIZE) has free items.
+             *
+             * @param fn The callable, called as fn(), must fit in MN_THREAD_CONFIG_FUTURE_TASK_SIZE
+             * @param timeout How long to wait, when the basic_work_queue is presently full.
+             *
+             * @return The future for the result, no state when no memory for the item.
+             *         When the item can not added, the future get the error ERR_WORKQUEUE_ADD
+             */
+            template <typename F, typename R = res_of_t<decay_t<F>&()>>
+            future<R> submit(F&& fn, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                basic_future_work_item<R>* _pItem = basic_future_work_item<R>::create(mn::forward<F>(fn));
+                if(_pItem == NULL) return future<R>();
+
+                future<R> _future(_pItem);
+
+                // the reference of the work queue, released at the end of on_work
+                _pItem->add_ref();
+
+                if(queue(_pItem, timeout) != ERR_WORKQUEUE_OK) {
+                    _pItem->set_error(ERR_WORKQUEUE_ADD);
+                    _pItem->release();
+                }
+                return _future;
+            }
+
             /**
              * Is the workqueue running?
              * 
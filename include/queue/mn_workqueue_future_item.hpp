@@ -0,0 +1,87 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_WORK_ITEM_FUTURE_
+#define MINLIB_ESP32_WORK_ITEM_FUTURE_
+
+#include "mn_config.hpp"
+
+#include "../mn_future.hpp"
+#include "mn_workqueue_item.hpp"
+
+namespace mn {
+    namespace queue {
+        /**
+         * A work item, that run a callable and set the result in his future state.
+         * The callable is stored inline and the item comes from a static pool,
+         * so basic_work_queue::submit does not allocate on the heap.
+         *
+         * The item holds two references: one for the future and one for the work queue,
+         * the work queue reference is released at the end of on_work (or in on_drop).
+         *
+         * @tparam R The result type of the callable
+         * @ingroup queue
+         */
+        template <typename R>
+        class basic_future_work_item : public work_queue_item, public basic_future_state<R> {
+        public:
+            using self_type = basic_future_work_item<R>;
+            using task_type = small_task<R(), MN_THREAD_CONFIG_FUTURE_TASK_SIZE, alignof(max_align_t)>;
+
+            /**
+             * Create a new item with one reference for the future
+             * @return The new item or NULL when no memory
+             */
+            template <typename F>
+            static self_type* create(F&& fn) {
+                void* _pMem = internal::basic_future_pool<self_type>::allocate();
+                return (_pMem != NULL) ? new (_pMem) self_type(mn::forward<F>(fn)) : NULL;
+            }
+
+            virtual bool on_work() override {
+                internal::future_invoker<R>::invoke(this, m_Task);
+
+                // the reference of the work queue, don't touch this after it
+                this->release();
+                return true;
+            }
+
+            /**
+             * The work queue is destroyed before the item was run: the future gets
+             * ERR_FUTURE_BROKEN and the reference of the work queue is released.
+             */
+            virtual void on_drop() override {
+                this->set_error(ERR_FUTURE_BROKEN);
+                this->release();
+            }
+        protected:
+            template <typename F>
+            explicit basic_future_work_item(F&& fn)
+                : work_queue_item(false), basic_future_state<R>(), m_Task(mn::forward<F>(fn)) { }
+
+            virtual void destroy() override {
+                this->~basic_future_work_item();
+                internal::basic_future_pool<self_type>::deallocate(this);
+            }
+        private:
+            task_type m_Task;
+        };
+    }
+}
+
+#endif
@@ -59,6 +59,13 @@ namespace mn {
              *  You must override this function.
              */
             virtual bool on_work() = 0;
+
+            /**
+             *  Called for a item, that is not deleted from the work queue (can_delete() is
+             *  false), when the work queue is destroyed before the item was run.
+             *  The item is not touched from the work queue after it.
+             */
+            virtual void on_drop() { }
         private:
             const bool m_bCanDelete;
         };
@@ -0,0 +1,334 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_WORK_QUEUE_PRIORITY_
+#define MINLIB_ESP32_WORK_QUEUE_PRIORITY_
+
+#include "../mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+#include "../mn_autolock.hpp"
+#include "../mn_counting_semaphore.hpp"
+#include "../mn_timespan.hpp"
+#include "mn_workqueue.hpp"
+
+namespace mn {
+    namespace queue {
+        /**
+         * Statistics for one level of the priority workqueue
+         *
+         * @ingroup queue
+         */
+        struct work_queue_level_stats {
+            uint32_t uiQueued;          /*!< How many items are queued in this level */
+            uint32_t uiDispatched;      /*!< How many items of this level are given to a worker */
+            uint32_t uiAged;            /*!< How many items are dispatched with a aging promotion */
+            uint32_t uiDeadlineMissed;  /*!< How many items are dispatched after her deadline */
+            uint32_t uiMaxWaitTicks;    /*!< The longest wait from queue to dispatch in ticks */
+            uint32_t uiDropped;         /*!< How many items of this level are removed undone on destroy */
+        };
+
+        /**
+         * How the priority workqueue selects the next item
+         */
+        enum class work_queue_schedule {
+            Priority,   /*!< The highest level first, FIFO in a level, with aging */
+            Deadline    /*!< The earliest deadline first (EDF) */
+        };
+
+        /**
+         * A priority and deadline aware workqueue, that plug into the engines
+         * basic_work_queue_single and basic_work_queue_multi.
+         *
+         * In the Priority mode the worker gets the item of the most urgent level (0 is the
+         * most urgent), FIFO in a level. A item is promoted one level up for each
+         * MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_AGING ticks of waiting, so bulk items don't starve.
+         *
+         * In the Deadline mode the worker gets the item with the earliest deadline. A item
+         * without a deadline gets the implicit deadline
+         * (level + 1) * MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_AGING ticks after queueing.
+         *
+         * The selection is a linear scan over the waiting items, the number of items is
+         * bounded from uiMaxWorkItems. Items with the same rank are dispatched in the queue order.
+         *
+         * A NULL item is a wake token for the workers (used from destroy_engine). Items, that are
+         * waiting on destroy, are not run: they are deleted, when can_delete() is true, otherwise
+         * on_drop is called, and counted in work_queue_level_stats::uiDropped.
+         *
+         * @code
+         * using urgent_workqueue_t = mn::queue::basic_work_queue_priority<mn::queue::multi_engine_workqueue_t>;
+         *
+         * urgent_workqueue_t workqueue(mn::queue::work_queue_schedule::Deadline);
+         * workqueue.create();
+         * workqueue.queue(&item, mn::timespan_t::now() + 5000, 0);
+         * @endcode
+         *
+         * @note The queue functions can not be called from a ISR.
+         *
+         * @tparam TEngine The engine: basic_work_queue_single or basic_work_queue_multi
+         * @tparam TLevels How many priority levels
+         * @ingroup queue
+         */
+        template <class TEngine, uint8_t TLevels = MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_LEVELS>
+        class basic_work_queue_priority : public TEngine {
+            static_assert(TLevels > 0, "the priority workqueue needs one level");
+
+            struct entry {
+                work_queue_item_t* pItem;
+                timespan_t tsDeadline;
+                TickType_t xQueued;
+                uint32_t uiSequence;
+                uint8_t uiLevel;
+                bool bDeadline;
+            };
+        public:
+            using engine_type = TEngine;
+            using self_type = basic_work_queue_priority<TEngine, TLevels>;
+
+            /**
+             * Our constructor.
+             * @param mode How to select the next item
+             * @param args The arguments for the engine constructor
+             */
+            template <typename... TArgs>
+            explicit basic_work_queue_priority(work_queue_schedule mode, TArgs... args)
+                : engine_type(args...),
+                  m_Mode(mode),
+                  m_FreeSlots(this->m_uiMaxWorkItems, this->m_uiMaxWorkItems),
+                  m_EntryLock(),
+                  m_pEntries(NULL),
+                  m_uiNumEntries(0),
+                  m_uiSequence(0) {
+
+                m_pEntries = new entry[this->m_uiMaxWorkItems];
+                memset(m_Stats, 0, sizeof(m_Stats));
+            }
+
+            /**
+             * Our destructor, stop the engine before the entries are gone
+             */
+            virtual ~basic_work_queue_priority() {
+                this->destroy();
+
+                if(m_pEntries != NULL)
+                    delete[] m_pEntries;
+            }
+
+            /**
+             * Stop the engine and remove the waiting items
+             */
+            virtual void destroy() override {
+                engine_type::destroy();
+
+                automutx_t lock(m_EntryLock);
+
+                for(uint32_t i = 0; i < m_uiNumEntries; i++) {
+                    m_Stats[m_pEntries[i].uiLevel].uiDropped++;
+
+                    if(m_pEntries[i].pItem->can_delete())
+                        delete m_pEntries[i].pItem;
+                    else
+                        m_pEntries[i].pItem->on_drop();
+
+                    m_FreeSlots.unlock();
+                }
+                m_uiNumEntries = 0;
+            }
+
+            /**
+             * Send a work item off to be executed in the lowest level
+             */
+            virtual int queue(work_queue_item_t *work,
+                              unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override {
+                return insert(work, TLevels - 1, timespan_t(), false, timeout);
+            }
+
+            /**
+             * Send a work item off to be executed in the given level
+             *
+             * @param work Pointer to a work_queue_item_t.
+             * @param uiLevel The priority level, 0 is the most urgent
+             * @param timeout How long to wait, when the workqueue is full
+             *
+             * @return ERR_WORKQUEUE_OK or ERR_WORKQUEUE_ADD
+             */
+            int queue(work_queue_item_t *work, uint8_t uiLevel,
+                      unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return insert(work, uiLevel, timespan_t(), false, timeout);
+            }
+
+            /**
+             * Send a work item with a deadline off to be executed
+             *
+             * @param work Pointer to a work_queue_item_t.
+             * @param tsDeadline The absolute deadline, from timespan_t::now()
+             * @param uiLevel The priority level, 0 is the most urgent
+             * @param timeout How long to wait, when the workqueue is full
+             *
+             * @return ERR_WORKQUEUE_OK or ERR_WORKQUEUE_ADD
+             */
+            int queue(work_queue_item_t *work, const timespan_t& tsDeadline, uint8_t uiLevel,
+                      unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+                return insert(work, uiLevel, tsDeadline, true, timeout);
+            }
+
+            /**
+             * Get the statistics of one level
+             */
+            work_queue_level_stats get_level_stats(uint8_t uiLevel) {
+                automutx_t lock(m_EntryLock);
+
+                return m_Stats[(uiLevel < TLevels) ? uiLevel : TLevels - 1];
+            }
+
+            /**
+             * How many items are dispatched after her deadline, over all levels
+             */
+            uint32_t get_num_deadline_missed() {
+                automutx_t lock(m_EntryLock);
+
+                uint32_t _uiMissed = 0;
+                for(uint8_t i = 0; i < TLevels; i++)
+                    _uiMissed += m_Stats[i].uiDeadlineMissed;
+
+                return _uiMissed;
+            }
+
+            work_queue_schedule get_mode() const { return m_Mode; }
+        protected:
+            /**
+             * Wait for a token in the engine queue and get the best waiting item
+             */
+            virtual work_queue_item_t* get_next_item(unsigned int timeout) override {
+                work_queue_item_t* _pToken = NULL;
+
+                if(this->m_pWorkItemQueue->dequeue(&_pToken, timeout) != ERR_QUEUE_OK)
+                    return NULL;
+
+                work_queue_item_t* _pItem = remove_best();
+
+                // a NULL token without a entry wakes the worker on destroy
+                if(_pItem != NULL)
+                    m_FreeSlots.unlock();
+
+                return _pItem;
+            }
+        private:
+            int insert(work_queue_item_t *work, uint8_t uiLevel, const timespan_t& tsDeadline,
+                       bool bDeadline, unsigned int timeout) {
+
+                if(xPortInIsrContext()) return ERR_WORKQUEUE_ADD;
+
+                // a wake token without a entry
+                if(work == NULL) {
+                    work_queue_item_t* _pToken = NULL;
+
+                    return (this->m_pWorkItemQueue->enqueue(&_pToken, timeout) == ERR_QUEUE_OK) ?
+                        ERR_WORKQUEUE_OK : ERR_WORKQUEUE_ADD;
+                }
+                if(m_FreeSlots.lock(timeout) != ERR_SPINLOCK_OK) return ERR_WORKQUEUE_ADD;
+
+                if(uiLevel >= TLevels) uiLevel = TLevels - 1;
+
+                m_EntryLock.lock();
+                    entry& _entry = m_pEntries[m_uiNumEntries++];
+
+                    _entry.pItem = work;
+                    _entry.xQueued = xTaskGetTickCount();
+                    _entry.uiSequence = m_uiSequence++;
+                    _entry.uiLevel = uiLevel;
+                    _entry.bDeadline = bDeadline;
+                    _entry.tsDeadline = bDeadline ? tsDeadline :
+                        timespan_t::now() + timespan_t::from_ticks((uiLevel + 1) * MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_AGING);
+
+                    m_Stats[uiLevel].uiQueued++;
+                m_EntryLock.unlock();
+
+                // one token for each entry, there is always space for it
+                work_queue_item_t* _pToken = NULL;
+                this->m_pWorkItemQueue->enqueue(&_pToken, 0);
+
+                return ERR_WORKQUEUE_OK;
+            }
+
+            work_queue_item_t* remove_best() {
+                automutx_t lock(m_EntryLock);
+
+                if(m_uiNumEntries == 0) return NULL;
+
+                TickType_t _xNow = xTaskGetTickCount();
+                uint32_t _uiBest = 0;
+
+                for(uint32_t i = 1; i < m_uiNumEntries; i++) {
+                    if(is_before(m_pEntries[i], m_pEntries[_uiBest], _xNow))
+                        _uiBest = i;
+                }
+
+                entry& _best = m_pEntries[_uiBest];
+                work_queue_level_stats& _stats = m_Stats[_best.uiLevel];
+                TickType_t _xWaited = _xNow - _best.xQueued;
+
+                _stats.uiDispatched++;
+                if(_xWaited > _stats.uiMaxWaitTicks) _stats.uiMaxWaitTicks = _xWaited;
+                if(effective_level(_best, _xNow) != _best.uiLevel) _stats.uiAged++;
+                if(_best.bDeadline && timespan_t::now() > _best.tsDeadline) _stats.uiDeadlineMissed++;
+
+                work_queue_item_t* _pItem = _best.pItem;
+
+                // the order in the array is not used (the sequence keeps the FIFO order),
+                // move the last entry in the hole
+                _best = m_pEntries[--m_uiNumEntries];
+
+                return _pItem;
+            }
+
+            uint8_t effective_level(const entry& e, TickType_t xNow) const {
+                TickType_t _xPromoted = (xNow - e.xQueued) / MN_THREAD_CONFIG_WORKQUEUE_PRIORITY_AGING;
+
+                return (_xPromoted >= e.uiLevel) ? 0 : e.uiLevel - _xPromoted;
+            }
+
+            bool is_before(const entry& a, const entry& b, TickType_t xNow) const {
+                if(m_Mode == work_queue_schedule::Deadline) {
+                    if(a.tsDeadline != b.tsDeadline) return a.tsDeadline < b.tsDeadline;
+                } else {
+                    uint8_t _uiLevelA = effective_level(a, xNow);
+                    uint8_t _uiLevelB = effective_level(b, xNow);
+
+                    if(_uiLevelA != _uiLevelB) return _uiLevelA < _uiLevelB;
+                    if(a.uiLevel != b.uiLevel) return a.uiLevel < b.uiLevel;
+                }
+                // the first queued one first, the sequence can wrap around
+                return (int32_t)(a.uiSequence - b.uiSequence) < 0;
+            }
+        private:
+            work_queue_schedule m_Mode;
+            counting_semaphore_t m_FreeSlots;
+            mutex_t m_EntryLock;
+            entry* m_pEntries;
+            uint32_t m_uiNumEntries;
+            uint32_t m_uiSequence;
+            work_queue_level_stats m_Stats[TLevels];
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_WORK_QUEUE_STEALING_
+#define MINLIB_ESP32_WORK_QUEUE_STEALING_
+
+#include "../mn_config.hpp"
+#include "../mn_task.hpp"
+#include "../mn_atomic.hpp"
+#include "../utils/mn_ramdom_xorshift.hpp"
+
+#include "mn_workqueue.hpp"
+#include "mn_stealing_deque.hpp"
+
+#include <vector>
+
+namespace mn {
+    namespace queue {
+        class basic_work_queue_stealing;
+
+        /**
+         * The worker task for the work-stealing workqueue engine. Each worker
+         * owns a deque, work items queued from a worker are pushed to his own deque.
+         * Work items queued from other tasks or from an ISR go to his inbox, a FreeRTOS
+         * queue, so other workers can steal from it too.
+         *
+         * @ingroup queue
+         */
+        class work_queue_stealing_task : public basic_task {
+            friend class basic_work_queue_stealing;
+        public:
+            using deque_type = basic_stealing_deque<work_queue_item_t>;
+
+            /**
+             * Constructor for this worker task.
+             *
+             * @param strName Name of the task. Only useful for debugging.
+             * @param uiPriority FreeRTOS priority of this Task.
+             * @param usStackDepth Number of "words" allocated for the Task stack.
+             * @param parent The work-stealing workqueue of this worker
+             * @param uiSeed The seed for the random victim selection
+             * @param uiInboxSize How many work items the inbox can hold
+             */
+            work_queue_stealing_task(char const* strName, basic_task::priority uiPriority,
+                                unsigned short  usStackDepth,
+                                basic_work_queue_stealing* parent,
+                                unsigned int uiSeed,
+                                unsigned int uiInboxSize);
+
+            virtual ~work_queue_stealing_task();
+        protected:
+            /**
+             * The worker loop: pop from the own deque, then the own inbox, then
+             * steal from a random victim and when all are empty park until notified.
+             */
+            virtual int on_task() override;
+
+            /**
+             * Wake this worker, when it parked.
+             * @return true When the worker was parked and is notified.
+             */
+            bool wake();
+        private:
+            /**
+             * Run a item and update the counters of the workqueue.
+             */
+            void run_item(work_queue_item_t* item);
+
+            /**
+             * Get the next item from the own inbox, never blocks.
+             * @return The item or NULL when the inbox is empty.
+             */
+            work_queue_item_t* get_inbox_item();
+
+            /**
+             * Remove all items, that are left in the deque and the inbox and delete
+             * the items that are marked for automatic deletion. Only call when the worker
+             * is not running.
+             */
+            void drain();
+        private:
+            basic_work_queue_stealing* m_parentWorkQueue;
+            deque_type m_Deque;
+            queue_t m_Inbox;
+            basic_ramdom_xorshift m_Random;
+            atomic_bool m_bParked;
+            volatile TaskHandle_t m_pTaskHandle;
+        };
+
+        /**
+         * This class is the work-stealing multi task "engine" for work_queue_items.
+         *
+         * Each worker owns a lock-free Chase-Lev deque and an inbox. Items queued from
+         * other tasks or from an ISR are distributed round-robin over the inboxes of the
+         * workers, items queued from a worker (e.g. in on_work) go to his own deque. Idle
+         * workers steal from the deques and inboxes of a random victim and park on a task
+         * notification when all are empty. The shared queue of basic_work_queue is not used.
+         *
+         * @ingroup queue
+         */
+        class basic_work_queue_stealing : public basic_work_queue {
+            friend class work_queue_stealing_task;
+        public:
+            /**
+             * Our constructor.
+             *
+             * @param uiPriority FreeRTOS priority of the worker tasks.
+             * @param usStackDepth Number of "words" allocated for the worker task stacks.
+             * @param uiMaxWorkItems Maximum number of WorkItems the inboxes of all workers can hold.
+             * @param uiMaxWorkers How many Worker tasks run with this workqueue
+             */
+            basic_work_queue_stealing(basic_task::priority uiPriority = MN_THREAD_CONFIG_WORKQUEUE_STEALING_PRIORITY,
+                        uint16_t usStackDepth = MN_THREAD_CONFIG_WORKQUEUE_STEALING_STACKSIZE,
+                        uint8_t uiMaxWorkItems = MN_THREAD_CONFIG_WORKQUEUE_STEALING_MAXITEMS,
+                        uint8_t uiMaxWorkers = MN_THREAD_CONFIG_WORKQUEUE_STEALING_WORKER);
+
+            /**
+             * Our destructor.
+             */
+            ~basic_work_queue_stealing();
+
+            /**
+             * Send a work_queue_item_t off to be executed, from any task or ISR.
+             *
+             * @param work Pointer to a work_queue_item_t.
+             * @param timeout How long to wait when all inboxes are full, not used from a worker or ISR
+             * @note This function may block if all inboxes are presently full.
+             *
+             * @return
+             *  - ERR_WORKQUEUE_OK The work_queue_item_t are added
+             *  - ERR_WORKQUEUE_ADD If The work_queue_item_t are not added
+             */
+            virtual int queue(work_queue_item_t *work,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             * Get the real num worker tasks for this workqueue engine
+             * @return The real num worker tasks
+             */
+            uint8_t get_num_worker() const;
+
+            /**
+             * Get the maximal num worker tasks for this workqueue engine
+             * @return The maximal num worker tasks
+             */
+            uint8_t get_num_max_worker() const;
+        protected:
+            int create_engine(int iCore);
+
+            void destroy_engine();
+
+            /**
+             * Get the worker of the calling task.
+             * @return The worker or NULL when the calling task is not a worker of this workqueue.
+             */
+            work_queue_stealing_task* get_current_worker();
+
+            /**
+             * Steal a item from a other worker, starting with a random victim.
+             * @param thief The worker that steals.
+             * @return The stolen item or NULL when all deques are empty.
+             */
+            work_queue_item_t* steal(work_queue_stealing_task* thief);
+
+            /**
+             * Wake one parked worker.
+             */
+            void wake_one();
+
+            /**
+             * Queue a work item from a other task or an ISR to the inbox of the next worker.
+             * @param work Pointer to a work_queue_item_t.
+             * @param timeout How long to wait when all inboxes are full, not used from an ISR
+             * @return The worker that got the item or NULL when the item is not added.
+             */
+            work_queue_stealing_task* queue_inbox(work_queue_item_t *work, unsigned int timeout);
+        private:
+            std::vector<work_queue_stealing_task*> m_Workers;
+            uint8_t m_uiMaxWorkers;
+            atomic_uint32_t m_uiParked;
+            atomic_uint32_t m_uiNextInbox;
+        };
+
+        using stealing_engine_workqueue_t = basic_work_queue_stealing;
+    }
+}
+
+#endif
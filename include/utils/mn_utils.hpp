@@ -20,6 +20,7 @@
 #define MINLIB_STL_UTILS_H_
 
 #include <string.h>
+#include <assert.h>
 
 #include "mn_inttokey.hpp"
 #include "../mn_defines.hpp"
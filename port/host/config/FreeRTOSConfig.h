@@ -0,0 +1,92 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/**
+ * FreeRTOS kernel configuration for the host build (FreeRTOS POSIX/Linux
+ * simulator port). The values follow the defaults of the ESP-IDF, so the
+ * library behaves on host like on the target.
+ */
+
+#define configUSE_PREEMPTION                        1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION     0
+#define configUSE_IDLE_HOOK                         0
+#define configUSE_TICK_HOOK                         0
+#define configTICK_RATE_HZ                          ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                        25
+#define configMINIMAL_STACK_SIZE                    ( ( unsigned short ) PTHREAD_STACK_MIN )
+#define configMAX_TASK_NAME_LEN                     16
+#define configUSE_16_BIT_TICKS                      0
+#define configIDLE_SHOULD_YIELD                     1
+#define configUSE_TASK_NOTIFICATIONS                1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES       1
+#define configUSE_MUTEXES                           1
+#define configUSE_RECURSIVE_MUTEXES                 1
+#define configUSE_COUNTING_SEMAPHORES               1
+#define configUSE_QUEUE_SETS                        1
+#define configQUEUE_REGISTRY_SIZE                   0
+#define configUSE_TIME_SLICING                      1
+#define configUSE_NEWLIB_REENTRANT                  0
+#define configENABLE_BACKWARD_COMPATIBILITY         1
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS     4
+#define configSTACK_DEPTH_TYPE                      uint32_t
+
+#define configSUPPORT_STATIC_ALLOCATION             0
+#define configSUPPORT_DYNAMIC_ALLOCATION            1
+#define configTOTAL_HEAP_SIZE                       ( ( size_t ) ( 64 * 1024 * 1024 ) )
+#define configAPPLICATION_ALLOCATED_HEAP            0
+
+#define configCHECK_FOR_STACK_OVERFLOW              0
+#define configUSE_MALLOC_FAILED_HOOK                0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK          0
+
+#define configGENERATE_RUN_TIME_STATS               0
+#define configUSE_TRACE_FACILITY                    1
+#define configUSE_STATS_FORMATTING_FUNCTIONS        1
+
+#define configUSE_TIMERS                            1
+#define configTIMER_TASK_PRIORITY                   ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                    32
+#define configTIMER_TASK_STACK_DEPTH                ( configMINIMAL_STACK_SIZE * 2 )
+
+#define INCLUDE_vTaskPrioritySet                    1
+#define INCLUDE_uxTaskPriorityGet                   1
+#define INCLUDE_vTaskDelete                         1
+#define INCLUDE_vTaskSuspend                        1
+#define INCLUDE_xResumeFromISR                      1
+#define INCLUDE_vTaskDelayUntil                     1
+#define INCLUDE_vTaskDelay                          1
+#define INCLUDE_xTaskGetSchedulerState              1
+#define INCLUDE_xTaskGetCurrentTaskHandle           1
+#define INCLUDE_uxTaskGetStackHighWaterMark         1
+#define INCLUDE_xTaskGetIdleTaskHandle              1
+#define INCLUDE_eTaskGetState                       1
+#define INCLUDE_xEventGroupSetBitFromISR            1
+#define INCLUDE_xTimerPendFunctionCall              1
+#define INCLUDE_xTaskAbortDelay                     1
+#define INCLUDE_xTaskGetHandle                      1
+#define INCLUDE_xTaskResumeFromISR                  1
+
+#include <limits.h>
+#include <assert.h>
+
+#define configASSERT( x )                           assert( x )
+
+#endif // FREERTOS_CONFIG_H
@@ -0,0 +1,37 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINLIB_HOST_ESP_LOG_H__
+#define __MINLIB_HOST_ESP_LOG_H__
+
+/**
+ * Host shim for <esp_log.h>, all log messages are written to stderr.
+ */
+#include <stdio.h>
+
+/// @brief Write a log message with level char, tag and format to stderr
+#define ESP_LOG_HOST(level, tag, format, ...) \
+    fprintf(stderr, level " %s: " format "\n", (tag), ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, format, ...)  ESP_LOG_HOST("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  ESP_LOG_HOST("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  ESP_LOG_HOST("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  ESP_LOG_HOST("D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)  ESP_LOG_HOST("V", tag, format, ##__VA_ARGS__)
+
+#endif //__MINLIB_HOST_ESP_LOG_H__
@@ -0,0 +1,176 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINLIB_HOST_FREERTOS_H__
+#define __MINLIB_HOST_FREERTOS_H__
+
+/**
+ * Host (FreeRTOS POSIX/Linux simulator port) replacement for the ESP-IDF
+ * <freertos/FreeRTOS.h>. It includes the vanilla kernel header and maps the
+ * ESP-IDF specific port extensions the library uses onto the POSIX port.
+ *
+ * The POSIX port runs every FreeRTOS task as a pthread, but only one of them
+ * runs at a time, so the host behaves like a single core target without
+ * real interrupts.
+ */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Indicating the task has no affinity core (same value as ESP-IDF)
+#ifndef tskNO_AFFINITY
+    #define tskNO_AFFINITY          INT_MAX
+#endif
+
+/// @brief Value of portMUX_TYPE::owner when the spinlock is free
+#define portMUX_FREE_VAL            0xB33FFFFF
+/// @brief Timeout for vPortCPUAcquireMutexTimeout: wait forever
+#define portMUX_NO_TIMEOUT          (-1)
+/// @brief Timeout for vPortCPUAcquireMutexTimeout: only try to take the lock
+#define portMUX_TRY_LOCK            0
+
+/**
+ * @brief Host version of the ESP-IDF cross core spinlock
+ */
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+/// @brief Initializer for a unlocked portMUX_TYPE
+#define portMUX_INITIALIZER_UNLOCKED    { portMUX_FREE_VAL, 0 }
+
+/**
+ * @brief Is the caller running in a interrupt context?
+ * @note The POSIX port has no user interrupts, the tick is a signal handler
+ * and never calls library code.
+ */
+static inline BaseType_t xPortInIsrContext(void) {
+    return pdFALSE;
+}
+
+/**
+ * @brief Get the core id of the calling task, the host is single core
+ */
+static inline BaseType_t xPortGetCoreID(void) {
+    return 0;
+}
+
+/**
+ * @brief Initialize a portMUX_TYPE spinlock
+ * @param mux The spinlock to initialize
+ */
+static inline void vPortCPUInitializeMutex(portMUX_TYPE *mux) {
+    mux->owner = portMUX_FREE_VAL;
+    mux->count = 0;
+}
+
+/**
+ * @brief Take a portMUX_TYPE spinlock, recursive for the same core
+ * @param mux The spinlock to take
+ * @param timeout How many spins to wait, portMUX_NO_TIMEOUT to wait forever
+ *  and portMUX_TRY_LOCK to only try
+ * @return true when the spinlock was taken and false on timeout
+ */
+static inline bool vPortCPUAcquireMutexTimeout(portMUX_TYPE *mux, int timeout) {
+    uint32_t core = (uint32_t)xPortGetCoreID();
+    uint32_t expected = portMUX_FREE_VAL;
+    bool ret = false;
+
+    if (__atomic_load_n(&mux->owner, __ATOMIC_ACQUIRE) == core) {
+        mux->count++;
+        ret = true;
+    } else {
+        while (!ret) {
+            expected = portMUX_FREE_VAL;
+            ret = __atomic_compare_exchange_n(&mux->owner, &expected, core, false,
+                                              __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+            if (!ret && timeout != portMUX_NO_TIMEOUT) {
+                if (timeout-- <= 0) break;
+            }
+        }
+        if (ret) mux->count = 1;
+    }
+    return ret;
+}
+
+/**
+ * @brief Release a portMUX_TYPE spinlock
+ * @param mux The spinlock to release
+ */
+static inline void vPortCPUReleaseMutex(portMUX_TYPE *mux) {
+    if (mux->count > 0 && --mux->count == 0) {
+        __atomic_store_n(&mux->owner, portMUX_FREE_VAL, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Enter a critical section guarded with a portMUX_TYPE spinlock
+ */
+#define portENTER_CRITICAL_SAFE(mux)    do { vPortEnterCritical(); \
+                                             vPortCPUAcquireMutexTimeout((mux), portMUX_NO_TIMEOUT); } while (0)
+/**
+ * @brief Exit a critical section guarded with a portMUX_TYPE spinlock
+ */
+#define portEXIT_CRITICAL_SAFE(mux)     do { vPortCPUReleaseMutex((mux)); vPortExitCritical(); } while (0)
+/// @brief Same as portENTER_CRITICAL_SAFE, there are no interrupts on host
+#define portENTER_CRITICAL_ISR(mux)     portENTER_CRITICAL_SAFE(mux)
+/// @brief Same as portEXIT_CRITICAL_SAFE, there are no interrupts on host
+#define portEXIT_CRITICAL_ISR(mux)      portEXIT_CRITICAL_SAFE(mux)
+/// @brief Mask the interrupts and return the old state
+#define portENTER_CRITICAL_NESTED()     portSET_INTERRUPT_MASK_FROM_ISR()
+/// @brief Restore the interrupt state from portENTER_CRITICAL_NESTED
+#define portEXIT_CRITICAL_NESTED(state) portCLEAR_INTERRUPT_MASK_FROM_ISR(state)
+
+/**
+ * @brief Request a context switch on exit from a (never existing) ISR
+ */
+#define _frxt_setup_switch()            portYIELD()
+
+/// @brief Yield the other core, there is no other core on host
+#define vPortYieldOtherCore(core)       do { (void)(core); } while (0)
+
+/**
+ * @brief Create a task, the core is ignored on host
+ */
+#define xTaskCreatePinnedToCore(fn, name, depth, param, prio, handle, core) \
+    xTaskCreate((fn), (name), (depth), (param), (prio), (handle))
+
+/**
+ * @brief Create a static task, the core is ignored on host
+ */
+#define xTaskCreateStaticPinnedToCore(fn, name, depth, param, prio, stack, buffer, core) \
+    xTaskCreateStatic((fn), (name), (depth), (param), (prio), (stack), (buffer))
+
+/// @brief Get the core affinity of a task, always core 0 on host
+#define xTaskGetAffinity(handle)            ((void)(handle), 0)
+/// @brief Get the idle task handle, there is only one idle task on host
+#define xTaskGetIdleTaskHandleForCPU(cpu)   ((void)(cpu), xTaskGetIdleTaskHandle())
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__MINLIB_HOST_FREERTOS_H__
@@ -0,0 +1,28 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINLIB_HOST_FREERTOS_EVENT_GROUPS_H__
+#define __MINLIB_HOST_FREERTOS_EVENT_GROUPS_H__
+
+/**
+ * ESP-IDF style forward to the kernel header of the FreeRTOS POSIX port.
+ */
+#include "freertos/FreeRTOS.h"
+#include <event_groups.h>
+
+#endif //__MINLIB_HOST_FREERTOS_EVENT_GROUPS_H__
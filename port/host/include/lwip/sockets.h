@@ -0,0 +1,164 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINLIB_HOST_LWIP_SOCKETS_H__
+#define __MINLIB_HOST_LWIP_SOCKETS_H__
+
+/**
+ * Host shim for <lwip/sockets.h>. Maps the lwip_* socket api onto the BSD
+ * socket api of the host, so the mn::net classes can be used and profiled
+ * without a network stack on the target.
+ */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "lwip/err.h"
+
+/// @brief The host stack supports all lwip features the library knows
+#define LWIP_IPV4                   1
+#define LWIP_IPV6                   1
+#define LWIP_TCP                    1
+#define LWIP_UDP                    1
+#define LWIP_UDPLITE                0
+#define LWIP_IGMP                   1
+#define LWIP_IPV6_MLD               1
+#define LWIP_MULTICAST_TX_OPTIONS   1
+
+/// @brief lwip only socket options, are ignored from the host stack
+#ifndef SO_USELOOPBACK
+    #define SO_USELOOPBACK          0x0040
+#endif
+#ifndef SO_DONTLINGER
+    #define SO_DONTLINGER           ((int)(~SO_LINGER))
+#endif
+#ifndef SO_CONTIMEO
+    #define SO_CONTIMEO             0x1009
+#endif
+#ifndef SO_NO_CHECK
+    #define SO_NO_CHECK             0x100a
+#endif
+#ifndef TCP_KEEPALIVE
+    #define TCP_KEEPALIVE           TCP_KEEPIDLE
+#endif
+
+/// @brief lwip ip address constants (host byte order)
+#define IPADDR_NONE                 ((uint32_t)0xffffffffUL)
+#define IPADDR_LOOPBACK             ((uint32_t)0x7f000001UL)
+#define IPADDR_ANY                  ((uint32_t)0x00000000UL)
+#define IPADDR_BROADCAST            ((uint32_t)0xffffffffUL)
+
+/// @brief Max length of a IPv4 address string, with the terminating null
+#define IP4ADDR_STRLEN_MAX          16
+
+/// @brief Compile time byte swap from host to network byte order (lwip def.h)
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    #define PP_HTONL(x)             (x)
+    #define PP_HTONS(x)             (x)
+#else
+    #define PP_HTONL(x)             ((((x) & 0x000000ffUL) << 24) | (((x) & 0x0000ff00UL) <<  8) | \
+                                     (((x) & 0x00ff0000UL) >>  8) | (((x) & 0xff000000UL) >> 24))
+    #define PP_HTONS(x)             ((uint16_t)((((x) & 0x00ffU) << 8) | (((x) & 0xff00U) >> 8)))
+#endif
+#define PP_NTOHL(x)                 PP_HTONL(x)
+#define PP_NTOHS(x)                 PP_HTONS(x)
+
+/// @brief lwip ip address class helpers
+#define IP_CLASSA(a)                ((((uint32_t)(a)) & 0x80000000UL) == 0)
+#define IP_CLASSB(a)                ((((uint32_t)(a)) & 0xc0000000UL) == 0x80000000UL)
+#define IP_CLASSC(a)                ((((uint32_t)(a)) & 0xe0000000UL) == 0xc0000000UL)
+#define IP_CLASSD(a)                (((uint32_t)(a) & 0xf0000000UL) == 0xe0000000UL)
+#define IP_EXPERIMENTAL(a)          (((uint32_t)(a) & 0xf0000000UL) == 0xf0000000UL)
+#define IP_BADCLASS(a)              (((uint32_t)(a) & 0xf0000000UL) == 0xf0000000UL)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int lwip_socket(int domain, int type, int protocol) {
+    return socket(domain, type, protocol);
+}
+static inline int lwip_close(int s) {
+    return close(s);
+}
+static inline int lwip_shutdown(int s, int how) {
+    return shutdown(s, how);
+}
+static inline int lwip_bind(int s, const struct sockaddr *name, socklen_t namelen) {
+    return bind(s, name, namelen);
+}
+static inline int lwip_connect(int s, const struct sockaddr *name, socklen_t namelen) {
+    return connect(s, name, namelen);
+}
+static inline int lwip_listen(int s, int backlog) {
+    return listen(s, backlog);
+}
+static inline int lwip_accept(int s, struct sockaddr *addr, socklen_t *addrlen) {
+    return accept(s, addr, addrlen);
+}
+static inline int lwip_getsockname(int s, struct sockaddr *name, socklen_t *namelen) {
+    return getsockname(s, name, namelen);
+}
+static inline int lwip_getpeername(int s, struct sockaddr *name, socklen_t *namelen) {
+    return getpeername(s, name, namelen);
+}
+static inline ssize_t lwip_send(int s, const void *data, size_t size, int flags) {
+    return send(s, data, size, flags);
+}
+static inline ssize_t lwip_recv(int s, void *mem, size_t len, int flags) {
+    return recv(s, mem, len, flags);
+}
+static inline ssize_t lwip_sendto(int s, const void *data, size_t size, int flags,
+                                  const struct sockaddr *to, socklen_t tolen) {
+    return sendto(s, data, size, flags, to, tolen);
+}
+static inline ssize_t lwip_recvfrom(int s, void *mem, size_t len, int flags,
+                                    struct sockaddr *from, socklen_t *fromlen) {
+    return recvfrom(s, mem, len, flags, from, fromlen);
+}
+static inline int lwip_ioctl(int s, long cmd, void *argp) {
+    return ioctl(s, (unsigned long)cmd, argp);
+}
+static inline int lwip_fcntl(int s, int cmd, int val) {
+    return fcntl(s, cmd, val);
+}
+static inline int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset,
+                              struct timeval *timeout) {
+    return select(maxfdp1, readset, writeset, exceptset, timeout);
+}
+
+#define lwip_htons(x)               htons(x)
+#define lwip_ntohs(x)               ntohs(x)
+#define lwip_htonl(x)               htonl(x)
+#define lwip_ntohl(x)               ntohl(x)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__MINLIB_HOST_LWIP_SOCKETS_H__
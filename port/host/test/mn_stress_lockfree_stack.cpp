@@ -0,0 +1,182 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_task.hpp"
+#include "mn_eventgroup.hpp"
+#include "mn_hazard_pointer.hpp"
+#include "container/mn_lockfree_stack.hpp"
+
+#define MN_STRESS_PRODUCERS         4
+#define MN_STRESS_CONSUMERS         4
+#define MN_STRESS_ITEMS             20000
+#define MN_STRESS_START_BIT         (1 << 0)
+
+namespace mn {
+    namespace stress {
+        using stack_type = container::lockfree_stack<uint32_t>;
+
+        /**
+         * @brief Push MN_STRESS_ITEMS unique values, wait for the start bit before.
+         */
+        class producer_task : public basic_task {
+        public:
+            producer_task(const char* strName, uint32_t uiFirst, stack_type* pStack, basic_event_group* pStart)
+                : basic_task(strName, basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                  m_uiFirst(uiFirst), m_pStack(pStack), m_pStart(pStart), m_uiFailed(0) { }
+
+            virtual int on_task() override {
+                m_pStart->wait(MN_STRESS_START_BIT, false, true, portMAX_DELAY);
+
+                for(uint32_t i = 0; i < MN_STRESS_ITEMS; i++) {
+                    while(!m_pStack->push(m_uiFirst + i)) { m_uiFailed++; basic_task::yield(); }
+
+                    if((i & 63) == 0) basic_task::yield();
+                }
+                return ERR_TASK_OK;
+            }
+
+            uint32_t get_failed() const { return m_uiFailed; }
+        private:
+            uint32_t m_uiFirst;
+            stack_type* m_pStack;
+            basic_event_group* m_pStart;
+            uint32_t m_uiFailed;
+        };
+
+        /**
+         * @brief Pop values and mark them, until all values of all producers are popped.
+         */
+        class consumer_task : public basic_task {
+        public:
+            consumer_task(const char* strName, stack_type* pStack, basic_event_group* pStart,
+                          uint8_t* pSeen, uint32_t* pPopped)
+                : basic_task(strName, basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE),
+                  m_pStack(pStack), m_pStart(pStart), m_pSeen(pSeen), m_pPopped(pPopped), m_uiDuplicates(0) { }
+
+            virtual int on_task() override {
+                const uint32_t _uiTotal = MN_STRESS_PRODUCERS * MN_STRESS_ITEMS;
+                uint32_t _uiValue;
+
+                m_pStart->wait(MN_STRESS_START_BIT, false, true, portMAX_DELAY);
+
+                while(__atomic_load_n(m_pPopped, __ATOMIC_RELAXED) < _uiTotal) {
+                    if(!m_pStack->try_pop(_uiValue)) { basic_task::yield(); continue; }
+
+                    if(_uiValue >= _uiTotal || __atomic_exchange_n(&m_pSeen[_uiValue], 1, __ATOMIC_RELAXED) != 0)
+                        m_uiDuplicates++;
+
+                    __atomic_add_fetch(m_pPopped, 1, __ATOMIC_RELAXED);
+                }
+
+                // free the retired nodes of this task, the stack is destroyed after the join
+                basic_hazard_domain::instance().release_task();
+                return ERR_TASK_OK;
+            }
+
+            uint32_t get_duplicates() const { return m_uiDuplicates; }
+        private:
+            stack_type* m_pStack;
+            basic_event_group* m_pStart;
+            uint8_t* m_pSeen;
+            uint32_t* m_pPopped;
+            uint32_t m_uiDuplicates;
+        };
+
+        /**
+         * @brief Run the producers and consumers and check, that each value is popped once.
+         */
+        class stress_main_task : public basic_task {
+        public:
+            stress_main_task()
+                : basic_task("stress_main", basic_task::priority::Normal, MN_THREAD_CONFIG_MINIMAL_STACK_SIZE * 4) { }
+
+            virtual int on_task() override {
+                const uint32_t _uiTotal = MN_STRESS_PRODUCERS * MN_STRESS_ITEMS;
+
+                producer_task* _producers[MN_STRESS_PRODUCERS];
+                consumer_task* _consumers[MN_STRESS_CONSUMERS];
+                uint8_t* _pSeen = new uint8_t[_uiTotal]();
+                uint32_t _uiPopped = 0;
+                uint32_t _uiErrors = 0;
+                char _name[32];
+
+                stack_type* _pStack = new stack_type();
+                basic_event_group _start("stress");
+                _start.create();
+
+                for(unsigned int t = 0; t < MN_STRESS_PRODUCERS; t++) {
+                    snprintf(_name, sizeof(_name), "producer_%u", t);
+                    _producers[t] = new producer_task(_name, t * MN_STRESS_ITEMS, _pStack, &_start);
+                    _producers[t]->start();
+                }
+                for(unsigned int t = 0; t < MN_STRESS_CONSUMERS; t++) {
+                    snprintf(_name, sizeof(_name), "consumer_%u", t);
+                    _consumers[t] = new consumer_task(_name, _pStack, &_start, _pSeen, &_uiPopped);
+                    _consumers[t]->start();
+                }
+                _start.set(MN_STRESS_START_BIT);
+
+                for(unsigned int t = 0; t < MN_STRESS_PRODUCERS; t++) {
+                    _producers[t]->join();
+                    if(_producers[t]->get_failed() > 0)
+                        printf("producer %u: %u failed pushes\n", t, (unsigned)_producers[t]->get_failed());
+                    delete _producers[t];
+                }
+                for(unsigned int t = 0; t < MN_STRESS_CONSUMERS; t++) {
+                    _consumers[t]->join();
+                    _uiErrors += _consumers[t]->get_duplicates();
+                    delete _consumers[t];
+                }
+                for(uint32_t i = 0; i < _uiTotal; i++) {
+                    if(_pSeen[i] == 0) _uiErrors++;
+                }
+                if(!_pStack->empty()) _uiErrors++;
+
+                delete _pStack;
+                delete[] _pSeen;
+
+                printf("lockfree_stack: %u producers, %u consumers, %u items, %u errors, %u retired\n",
+                       MN_STRESS_PRODUCERS, MN_STRESS_CONSUMERS, (unsigned)_uiTotal, (unsigned)_uiErrors,
+                       basic_hazard_domain::instance().get_retired());
+
+                exit(_uiErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+                return ERR_TASK_OK;
+            }
+        };
+    }
+}
+
+int main() {
+    static mn::stress::stress_main_task _main;
+
+    if(_main.start() != ERR_TASK_OK) {
+        fprintf(stderr, "can't start the stress task\n");
+        return EXIT_FAILURE;
+    }
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,431 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+#include "allocator/mn_basic_allocator_profile_filter.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace mn {
+	namespace memory {
+		basic_heap_profile* basic_heap_profiler::m_pFirst = NULL;
+		portMUX_TYPE basic_heap_profiler::m_Mux = portMUX_INITIALIZER_UNLOCKED;
+
+		size_t basic_heap_profiler::m_uiLive = 0;
+		size_t basic_heap_profiler::m_uiPeak = 0;
+		uint32_t basic_heap_profiler::m_uiSampleCounter = 0;
+		heap_profile_site basic_heap_profiler::m_Sites[MN_THREAD_CONFIG_HEAP_PROFILER_SITES];
+		size_t basic_heap_profiler::m_uiSites = 0;
+
+		//-----------------------------------
+		//  basic_heap_profile::basic_heap_profile
+		//-----------------------------------
+		basic_heap_profile::basic_heap_profile(const char* strName)
+			: m_strName(strName), m_uiLive(0), m_uiPeak(0), m_uiAtPeak(0),
+			  m_uiAllocs(0), m_uiFrees(0), m_pNext(NULL) {
+
+			memset(m_uiClassLive, 0, sizeof(m_uiClassLive));
+			memset(m_uiClassPeak, 0, sizeof(m_uiClassPeak));
+			memset(m_uiClassAllocs, 0, sizeof(m_uiClassAllocs));
+
+			basic_heap_profiler::add(this);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profile::~basic_heap_profile
+		//-----------------------------------
+		basic_heap_profile::~basic_heap_profile() {
+			basic_heap_profiler::remove(this);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profile::update_max
+		//-----------------------------------
+		void basic_heap_profile::update_max(size_t& max, size_t value) {
+			size_t _uiMax = __atomic_load_n(&max, __ATOMIC_RELAXED);
+
+			while(value > _uiMax) {
+				if(__atomic_compare_exchange_n(&max, &_uiMax, value, true,
+											   __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+			}
+		}
+
+		//-----------------------------------
+		//  basic_heap_profile::alloc
+		//-----------------------------------
+		void basic_heap_profile::alloc(size_t size) {
+			const size_t _uiClass = get_class(size);
+
+			update_max(m_uiPeak, __atomic_add_fetch(&m_uiLive, size, __ATOMIC_RELAXED));
+			update_max(m_uiClassPeak[_uiClass], __atomic_add_fetch(&m_uiClassLive[_uiClass], size, __ATOMIC_RELAXED));
+
+			__atomic_add_fetch(&m_uiAllocs, 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&m_uiClassAllocs[_uiClass], 1, __ATOMIC_RELAXED);
+
+			basic_heap_profiler::on_alloc(size);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profile::dealloc
+		//-----------------------------------
+		void basic_heap_profile::dealloc(size_t size) {
+			__atomic_sub_fetch(&m_uiLive, size, __ATOMIC_RELAXED);
+			__atomic_sub_fetch(&m_uiClassLive[get_class(size)], size, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&m_uiFrees, 1, __ATOMIC_RELAXED);
+
+			basic_heap_profiler::on_dealloc(size);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profile::get_stats
+		//-----------------------------------
+		void basic_heap_profile::get_stats(heap_profile_stats& stats) const {
+			stats.strName = m_strName;
+			stats.uiLive = __atomic_load_n(&m_uiLive, __ATOMIC_RELAXED);
+			stats.uiPeak = __atomic_load_n(&m_uiPeak, __ATOMIC_RELAXED);
+			stats.uiAtPeak = __atomic_load_n(&m_uiAtPeak, __ATOMIC_RELAXED);
+			stats.uiAllocs = __atomic_load_n(&m_uiAllocs, __ATOMIC_RELAXED);
+			stats.uiFrees = __atomic_load_n(&m_uiFrees, __ATOMIC_RELAXED);
+
+			for(size_t i = 0; i < MN_HEAP_PROFILE_CLASSES; i++) {
+				stats.uiClassLive[i] = __atomic_load_n(&m_uiClassLive[i], __ATOMIC_RELAXED);
+				stats.uiClassPeak[i] = __atomic_load_n(&m_uiClassPeak[i], __ATOMIC_RELAXED);
+				stats.uiClassAllocs[i] = __atomic_load_n(&m_uiClassAllocs[i], __ATOMIC_RELAXED);
+			}
+		}
+
+		//-----------------------------------
+		//  basic_heap_profile::reset
+		//-----------------------------------
+		void basic_heap_profile::reset() {
+			__atomic_store_n(&m_uiPeak, __atomic_load_n(&m_uiLive, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+			__atomic_store_n(&m_uiAtPeak, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&m_uiAllocs, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&m_uiFrees, 0, __ATOMIC_RELAXED);
+
+			for(size_t i = 0; i < MN_HEAP_PROFILE_CLASSES; i++) {
+				__atomic_store_n(&m_uiClassPeak[i], __atomic_load_n(&m_uiClassLive[i], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+				__atomic_store_n(&m_uiClassAllocs[i], 0, __ATOMIC_RELAXED);
+			}
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::add
+		//-----------------------------------
+		void basic_heap_profiler::add(basic_heap_profile* profile) {
+			portENTER_CRITICAL_SAFE(&m_Mux);
+				profile->m_pNext = m_pFirst;
+				m_pFirst = profile;
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::remove
+		//-----------------------------------
+		void basic_heap_profiler::remove(basic_heap_profile* profile) {
+			portENTER_CRITICAL_SAFE(&m_Mux);
+				basic_heap_profile** _ppNext = &m_pFirst;
+
+				while(*_ppNext != NULL && *_ppNext != profile) _ppNext = &(*_ppNext)->m_pNext;
+				if(*_ppNext != NULL) *_ppNext = profile->m_pNext;
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::on_alloc
+		//-----------------------------------
+		void basic_heap_profiler::on_alloc(size_t size) {
+			const size_t _uiLive = __atomic_add_fetch(&m_uiLive, size, __ATOMIC_RELAXED);
+
+			if(_uiLive <= __atomic_load_n(&m_uiPeak, __ATOMIC_RELAXED)) return;
+
+			// a new high-water mark: remember, which tags it is made of
+			portENTER_CRITICAL_SAFE(&m_Mux);
+				if(_uiLive > m_uiPeak) {
+					__atomic_store_n(&m_uiPeak, _uiLive, __ATOMIC_RELAXED);
+
+					for(basic_heap_profile* _pProfile = m_pFirst; _pProfile != NULL; _pProfile = _pProfile->m_pNext)
+						__atomic_store_n(&_pProfile->m_uiAtPeak,
+										 __atomic_load_n(&_pProfile->m_uiLive, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+				}
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::on_dealloc
+		//-----------------------------------
+		void basic_heap_profiler::on_dealloc(size_t size) {
+			__atomic_sub_fetch(&m_uiLive, size, __ATOMIC_RELAXED);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::record_site
+		//-----------------------------------
+		void basic_heap_profiler::record_site(const void* pAddress, const char* strSite,
+											  const basic_heap_profile& profile, size_t size) {
+			if(strSite != NULL) pAddress = NULL;
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+				size_t i = 0;
+
+				// a site name is compared by the pointer, the names are string literals
+				while(i < m_uiSites && (m_Sites[i].pAddress != pAddress || m_Sites[i].strSite != strSite ||
+										m_Sites[i].strName != profile.get_name()) ) i++;
+
+				if(i == m_uiSites && m_uiSites < MN_THREAD_CONFIG_HEAP_PROFILER_SITES) {
+					m_Sites[i].pAddress = pAddress;
+					m_Sites[i].strSite = strSite;
+					m_Sites[i].strName = profile.get_name();
+					m_Sites[i].uiSamples = 0;
+					m_Sites[i].uiBytes = 0;
+					m_uiSites++;
+				}
+				// the table is full, the new site is not recorded
+				if(i < m_uiSites) {
+					m_Sites[i].uiSamples++;
+					m_Sites[i].uiBytes += size;
+				}
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::snapshot
+		//-----------------------------------
+		size_t basic_heap_profiler::snapshot(heap_profile_stats* stats, size_t max) {
+			size_t _count = 0;
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+				for(basic_heap_profile* _pProfile = m_pFirst; _pProfile != NULL; _pProfile = _pProfile->m_pNext) {
+					if(stats != NULL && _count < max)
+						_pProfile->get_stats(stats[_count]);
+					_count++;
+				}
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return _count;
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::sites
+		//-----------------------------------
+		size_t basic_heap_profiler::sites(heap_profile_site* sites, size_t max) {
+			size_t _count;
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+				_count = m_uiSites;
+				for(size_t i = 0; sites != NULL && i < _count && i < max; i++)
+					sites[i] = m_Sites[i];
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return _count;
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::reset
+		//-----------------------------------
+		void basic_heap_profiler::reset() {
+			portENTER_CRITICAL_SAFE(&m_Mux);
+				for(basic_heap_profile* _pProfile = m_pFirst; _pProfile != NULL; _pProfile = _pProfile->m_pNext)
+					_pProfile->reset();
+
+				__atomic_store_n(&m_uiPeak, __atomic_load_n(&m_uiLive, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+				m_uiSites = 0;
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::format
+		//-----------------------------------
+		size_t basic_heap_profiler::format(char* buffer, size_t size, const heap_profile_stats& stats,
+										   heap_profile_format format, bool first) {
+			const bool _bJson = (format == heap_profile_format::Json);
+			size_t _len;
+
+			if(_bJson) {
+				_len = snprintf(buffer, size,
+					"%s{\"name\":\"%s\",\"live\":%u,\"peak\":%u,\"at_peak\":%u,\"allocs\":%u,\"frees\":%u,\"classes\":[",
+					first ? "" : ",", stats.strName, (unsigned)stats.uiLive, (unsigned)stats.uiPeak,
+					(unsigned)stats.uiAtPeak, (unsigned)stats.uiAllocs, (unsigned)stats.uiFrees);
+			} else {
+				_len = snprintf(buffer, size, "%-16s live=%u peak=%u at_peak=%u allocs=%u frees=%u\n",
+					stats.strName, (unsigned)stats.uiLive, (unsigned)stats.uiPeak,
+					(unsigned)stats.uiAtPeak, (unsigned)stats.uiAllocs, (unsigned)stats.uiFrees);
+			}
+
+			// only the used size classes
+			bool _bFirst = true;
+
+			for(size_t i = 0; i < MN_HEAP_PROFILE_CLASSES; i++) {
+				if(stats.uiClassAllocs[i] == 0 && stats.uiClassLive[i] == 0) continue;
+
+				const bool _bLast = (i == MN_HEAP_PROFILE_CLASSES - 1);
+				const unsigned _uiBound = (unsigned)((_bLast ? 4 : 8) << i);
+
+				if(_bJson) {
+					_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+						"%s{\"class\":\"%s%u\",\"live\":%u,\"peak\":%u,\"allocs\":%u}", _bFirst ? "" : ",",
+						_bLast ? ">" : "<=", _uiBound, (unsigned)stats.uiClassLive[i],
+						(unsigned)stats.uiClassPeak[i], (unsigned)stats.uiClassAllocs[i]);
+				} else {
+					_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+						"  %s%-6u live=%u peak=%u allocs=%u\n", _bLast ? ">" : "<=", _uiBound,
+						(unsigned)stats.uiClassLive[i], (unsigned)stats.uiClassPeak[i],
+						(unsigned)stats.uiClassAllocs[i]);
+				}
+				_bFirst = false;
+			}
+
+			if(_bJson)
+				_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0, "]}");
+
+			return _len;
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::dump
+		//-----------------------------------
+		size_t basic_heap_profiler::dump(char* buffer, size_t size, heap_profile_format format) {
+			const bool _bJson = (format == heap_profile_format::Json);
+			size_t _len = 0;
+			heap_profile_stats _stats;
+			heap_profile_site _site;
+
+			if(_bJson) {
+				_len += snprintf(buffer, size, "{\"live\":%u,\"peak\":%u,\"tags\":[",
+								 (unsigned)get_live(), (unsigned)get_peak());
+			} else {
+				_len += snprintf(buffer, size, "heap live=%u peak=%u\n",
+								 (unsigned)get_live(), (unsigned)get_peak());
+			}
+
+			// snprintf can not run in the critical section, so the tags are read one by one
+			for(size_t i = 0; ; i++) {
+				bool _bFound = false;
+
+				portENTER_CRITICAL_SAFE(&m_Mux);
+					basic_heap_profile* _pProfile = m_pFirst;
+					for(size_t j = 0; j < i && _pProfile != NULL; j++) _pProfile = _pProfile->m_pNext;
+
+					if(_pProfile != NULL) {
+						_pProfile->get_stats(_stats);
+						_bFound = true;
+					}
+				portEXIT_CRITICAL_SAFE(&m_Mux);
+
+				if(!_bFound) break;
+
+				_len += basic_heap_profiler::format(buffer + ((_len < size) ? _len : size),
+													(_len < size) ? size - _len : 0, _stats, format, i == 0);
+			}
+
+			if(_bJson)
+				_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+								 "],\"sites\":[");
+
+			for(size_t i = 0; ; i++) {
+				bool _bFound = false;
+
+				portENTER_CRITICAL_SAFE(&m_Mux);
+					if(i < m_uiSites) {
+						_site = m_Sites[i];
+						_bFound = true;
+					}
+				portEXIT_CRITICAL_SAFE(&m_Mux);
+
+				if(!_bFound) break;
+
+				if(_bJson && _site.strSite != NULL) {
+					_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+						"%s{\"site\":\"%s\",\"name\":\"%s\",\"samples\":%u,\"bytes\":%u}", (i == 0) ? "" : ",",
+						_site.strSite, _site.strName, (unsigned)_site.uiSamples, (unsigned)_site.uiBytes);
+				} else if(_bJson) {
+					_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+						"%s{\"address\":\"%p\",\"name\":\"%s\",\"samples\":%u,\"bytes\":%u}", (i == 0) ? "" : ",",
+						_site.pAddress, _site.strName, (unsigned)_site.uiSamples, (unsigned)_site.uiBytes);
+				} else if(_site.strSite != NULL) {
+					_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+						"site %-16s %-16s samples=%u bytes=%u\n",
+						_site.strSite, _site.strName, (unsigned)_site.uiSamples, (unsigned)_site.uiBytes);
+				} else {
+					_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+						"site %p %-16s samples=%u bytes=%u\n",
+						_site.pAddress, _site.strName, (unsigned)_site.uiSamples, (unsigned)_site.uiBytes);
+				}
+			}
+
+			if(_bJson)
+				_len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0, "]}");
+
+			return _len;
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::print
+		//-----------------------------------
+		void basic_heap_profiler::print(heap_profile_format format) {
+			size_t _len = dump(NULL, 0, format);
+			char* _buffer = new char[_len + 1];
+
+			if(_buffer != NULL) {
+				dump(_buffer, _len + 1, format);
+				printf("%s\n", _buffer);
+				delete[] _buffer;
+			}
+		}
+
+		//-----------------------------------
+		//  basic_heap_profiler::report_leaks
+		//-----------------------------------
+		size_t basic_heap_profiler::report_leaks() {
+			size_t _count = 0;
+			heap_profile_stats _stats;
+
+			for(size_t i = 0; ; i++) {
+				bool _bFound = false;
+
+				portENTER_CRITICAL_SAFE(&m_Mux);
+					basic_heap_profile* _pProfile = m_pFirst;
+					for(size_t j = 0; j < i && _pProfile != NULL; j++) _pProfile = _pProfile->m_pNext;
+
+					if(_pProfile != NULL) {
+						_pProfile->get_stats(_stats);
+						_bFound = true;
+					}
+				portEXIT_CRITICAL_SAFE(&m_Mux);
+
+				if(!_bFound) break;
+				if(_stats.uiLive == 0) continue;
+
+				printf("heap leak: %s %u bytes\n", _stats.strName, (unsigned)_stats.uiLive);
+
+				for(size_t k = 0; k < MN_HEAP_PROFILE_CLASSES; k++) {
+					if(_stats.uiClassLive[k] == 0) continue;
+
+					if(k == MN_HEAP_PROFILE_CLASSES - 1)
+						printf("  >%-6u %u bytes\n", (unsigned)(4 << k), (unsigned)_stats.uiClassLive[k]);
+					else
+						printf("  <=%-6u %u bytes\n", (unsigned)(8 << k), (unsigned)_stats.uiClassLive[k]);
+				}
+				_count++;
+			}
+
+			return _count;
+		}
+	}
+}
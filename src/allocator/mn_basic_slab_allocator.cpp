@@ -0,0 +1,335 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+#include "allocator/mn_basic_slab_allocator.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace mn {
+	namespace memory {
+#if MN_THREAD_CONFIG_MEMPOOL_USE_MAGIC == MN_THREAD_CONFIG_YES
+		static bool slab_check_guard(const char* pGuard, char cMagic, size_t uiSize) {
+			for(size_t i = 0; i < uiSize; i++)
+				if(pGuard[i] != cMagic) return false;
+			return true;
+		}
+#endif
+		//-----------------------------------
+		//  basic_slab_pool::basic_slab_pool
+		//-----------------------------------
+		basic_slab_pool::basic_slab_pool() noexcept
+			: basic_slab_pool(NULL, 0) { }
+
+		//-----------------------------------
+		//  basic_slab_pool::basic_slab_pool
+		//-----------------------------------
+		basic_slab_pool::basic_slab_pool(void* pBuffer, size_t uiSize) noexcept
+			: m_pBuffer(NULL), m_uiBufferSize(0), m_uiBufferUsed(0),
+			  m_pSlabs(NULL), m_uiSlabBytes(0), m_uiCorruptions(0) {
+
+			vPortCPUInitializeMutex(&m_Mux);
+
+			for(size_t i = 0; i < CLASSES; i++) {
+				m_pFree[i] = NULL;
+				memset(&m_Stats[i], 0, sizeof(slab_class_stats));
+				m_Stats[i].uiBlockSize = MIN_BLOCK << i;
+			}
+
+			if(pBuffer != NULL) {
+				// all blocks are aligned with mn::max_alignment
+				uintptr_t _uiStart = reinterpret_cast<uintptr_t>(pBuffer);
+				uintptr_t _uiAligned = (_uiStart + mn::max_alignment - 1) & ~(uintptr_t)(mn::max_alignment - 1);
+
+				m_pBuffer = reinterpret_cast<char*>(_uiAligned);
+				m_uiBufferSize = (uiSize > (_uiAligned - _uiStart)) ? uiSize - (_uiAligned - _uiStart) : 0;
+			}
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::~basic_slab_pool
+		//-----------------------------------
+		basic_slab_pool::~basic_slab_pool() {
+			while(m_pSlabs != NULL) {
+				slab_header* _pSlab = m_pSlabs;
+				m_pSlabs = _pSlab->pNext;
+
+				free(_pSlab);
+			}
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::instance
+		//-----------------------------------
+		basic_slab_pool& basic_slab_pool::instance() noexcept {
+			static basic_slab_pool _pool;
+			return _pool;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::allocate
+		//-----------------------------------
+		void* basic_slab_pool::allocate(size_t size, size_t alignment) noexcept {
+			// malloc and the slabs only give mn::max_alignment
+			if(alignment > mn::max_alignment) return NULL;
+
+			const size_t _uiClass = get_class(size);
+
+			if(_uiClass >= CLASSES) {
+				return (m_pBuffer == NULL) ? malloc(size) : NULL;
+			}
+
+			void* _pMem = NULL;
+			allocate_batch(_uiClass, &_pMem, 1);
+
+			return _pMem;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::allocate_batch
+		//-----------------------------------
+		size_t basic_slab_pool::allocate_batch(size_t uiClass, void** pBlocks, size_t uiCount) noexcept {
+			if(uiClass >= CLASSES || uiCount == 0) return 0;
+
+			size_t _uiGot = pop_n(uiClass, pBlocks, uiCount);
+
+			// the free list is empty, carve a new slab and try again
+			if(_uiGot < uiCount && refill(uiClass))
+				_uiGot += pop_n(uiClass, pBlocks + _uiGot, uiCount - _uiGot);
+
+			if(_uiGot == 0) {
+				portENTER_CRITICAL_SAFE(&m_Mux);
+				m_Stats[uiClass].uiFailed++;
+				portEXIT_CRITICAL_SAFE(&m_Mux);
+
+				return 0;
+			}
+
+#if MN_THREAD_CONFIG_MEMPOOL_USE_MAGIC == MN_THREAD_CONFIG_YES
+			// the free list holds the payloads, the guards are in front and behind
+			for(size_t i = 0; i < _uiGot; i++) {
+				char* _pMem = static_cast<char*>(pBlocks[i]) - GUARD;
+
+				memset(_pMem, MN_THREAD_CONFIG_MEMPOOL_MAGIC_START, GUARD);
+				memset(_pMem + GUARD + (MIN_BLOCK << uiClass), MN_THREAD_CONFIG_MEMPOOL_MAGIC_END, GUARD);
+			}
+#endif
+			return _uiGot;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::deallocate
+		//-----------------------------------
+		bool basic_slab_pool::deallocate(void* address, size_t size, size_t alignment) noexcept {
+			if(address == NULL) return true;
+
+			// allocate has failed for this alignment
+			if(alignment > mn::max_alignment) return false;
+
+			const size_t _uiClass = get_class(size);
+
+			if(_uiClass >= CLASSES) {
+				// the static pool has not allocated it
+				if(m_pBuffer != NULL) return false;
+
+				free(address);
+				return true;
+			}
+
+			return deallocate_batch(_uiClass, &address, 1) == 1;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::deallocate_batch
+		//-----------------------------------
+		size_t basic_slab_pool::deallocate_batch(size_t uiClass, void* const* pBlocks, size_t uiCount) noexcept {
+			if(uiClass >= CLASSES) return 0;
+
+			free_block* _pFirst = NULL;
+			free_block* _pLast = NULL;
+			size_t _uiFreed = 0;
+
+			// link the blocks outside the lock, then splice the chain in the free list
+			for(size_t i = 0; i < uiCount; i++) {
+				char* _pMem = static_cast<char*>(pBlocks[i]) - GUARD;
+
+				if(!check_block(_pMem, uiClass)) continue;
+
+				// the link goes behind the start guard, the guard marks the block as free
+				free_block* _pBlock = reinterpret_cast<free_block*>(_pMem + GUARD);
+				_pBlock->pNext = _pFirst;
+				_pFirst = _pBlock;
+
+				if(_pLast == NULL) _pLast = _pBlock;
+				_uiFreed++;
+			}
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			if(_pFirst != NULL) {
+				_pLast->pNext = m_pFree[uiClass];
+				m_pFree[uiClass] = _pFirst;
+			}
+			m_Stats[uiClass].uiFree += _uiFreed;
+			m_Stats[uiClass].uiFrees += _uiFreed;
+			m_uiCorruptions += uiCount - _uiFreed;
+
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return _uiFreed;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::get_stats
+		//-----------------------------------
+		bool basic_slab_pool::get_stats(size_t uiClass, slab_class_stats& stats) noexcept {
+			if(uiClass >= CLASSES) return false;
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+			stats = m_Stats[uiClass];
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return true;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::pop_n
+		//-----------------------------------
+		size_t basic_slab_pool::pop_n(size_t uiClass, void** pBlocks, size_t uiCount) noexcept {
+			size_t _uiGot = 0;
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			slab_class_stats& _stats = m_Stats[uiClass];
+
+			while(_uiGot < uiCount && m_pFree[uiClass] != NULL) {
+				free_block* _pBlock = m_pFree[uiClass];
+				m_pFree[uiClass] = _pBlock->pNext;
+
+				pBlocks[_uiGot++] = _pBlock;
+			}
+			_stats.uiFree -= _uiGot;
+			_stats.uiAllocs += _uiGot;
+			if(_stats.uiTotal - _stats.uiFree > _stats.uiPeak)
+				_stats.uiPeak = _stats.uiTotal - _stats.uiFree;
+
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return _uiGot;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::check_block
+		//-----------------------------------
+		bool basic_slab_pool::check_block(char* pMem, size_t uiClass) noexcept {
+#if MN_THREAD_CONFIG_MEMPOOL_USE_MAGIC == MN_THREAD_CONFIG_YES
+			if(!slab_check_guard(pMem, (char)MN_THREAD_CONFIG_MEMPOOL_MAGIC_START, GUARD) ||
+			   !slab_check_guard(pMem + GUARD + (MIN_BLOCK << uiClass), (char)MN_THREAD_CONFIG_MEMPOOL_MAGIC_END, GUARD)) {
+				return false;
+			}
+			// a second deallocate of the block finds a wrong start guard
+			memset(pMem, MN_THREAD_CONFIG_MEMPOOL_MAGIC_END, GUARD);
+#else
+			MN_UNUSED_VARIABLE(pMem);
+			MN_UNUSED_VARIABLE(uiClass);
+#endif
+			return true;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::refill
+		//-----------------------------------
+		bool basic_slab_pool::refill(size_t uiClass) noexcept {
+			const size_t _uiStride = get_stride(uiClass);
+
+			size_t _uiBytes = (MN_THREAD_CONFIG_SLAB_SIZE > _uiStride) ? MN_THREAD_CONFIG_SLAB_SIZE : _uiStride;
+			_uiBytes -= _uiBytes % _uiStride;
+
+			char* _pSlab = static_cast<char*>(take_slab(_uiStride, _uiBytes));
+			if(_pSlab == NULL) return false;
+
+			const size_t _uiCount = _uiBytes / _uiStride;
+
+			// link the payloads outside the lock, the slab is not visible to the other tasks
+			char* _pFirst = _pSlab + GUARD;
+
+			for(size_t i = 0; i < _uiCount - 1; i++) {
+				reinterpret_cast<free_block*>(_pFirst + i * _uiStride)->pNext =
+					reinterpret_cast<free_block*>(_pFirst + (i + 1) * _uiStride);
+			}
+			free_block* _pLast = reinterpret_cast<free_block*>(_pFirst + (_uiCount - 1) * _uiStride);
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			_pLast->pNext = m_pFree[uiClass];
+			m_pFree[uiClass] = reinterpret_cast<free_block*>(_pFirst);
+
+			m_Stats[uiClass].uiTotal += _uiCount;
+			m_Stats[uiClass].uiFree += _uiCount;
+
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return true;
+		}
+
+		//-----------------------------------
+		//  basic_slab_pool::take_slab
+		//-----------------------------------
+		void* basic_slab_pool::take_slab(size_t uiStride, size_t& uiBytes) noexcept {
+			void* _pSlab = NULL;
+
+			if(m_pBuffer != NULL) {
+				portENTER_CRITICAL_SAFE(&m_Mux);
+
+				// the rest of the buffer can be smaller then a full slab
+				size_t _uiAvail = m_uiBufferSize - m_uiBufferUsed;
+				_uiAvail -= _uiAvail % uiStride;
+
+				if(_uiAvail > 0) {
+					if(uiBytes > _uiAvail) uiBytes = _uiAvail;
+
+					_pSlab = m_pBuffer + m_uiBufferUsed;
+					m_uiBufferUsed += uiBytes;
+					m_uiSlabBytes += uiBytes;
+				}
+				portEXIT_CRITICAL_SAFE(&m_Mux);
+
+				return _pSlab;
+			}
+
+			// malloc outside the critical section, the header keeps the blocks aligned
+			const size_t _uiHeader = (sizeof(slab_header) + mn::max_alignment - 1) & ~(mn::max_alignment - 1);
+
+			char* _pMem = static_cast<char*>(malloc(_uiHeader + uiBytes));
+			if(_pMem == NULL) return NULL;
+
+			slab_header* _pHeader = reinterpret_cast<slab_header*>(_pMem);
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			_pHeader->pNext = m_pSlabs;
+			m_pSlabs = _pHeader;
+			m_uiSlabBytes += uiBytes;
+
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return _pMem + _uiHeader;
+		}
+	}
+}
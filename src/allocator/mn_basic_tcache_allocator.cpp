@@ -0,0 +1,295 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+#include "allocator/mn_basic_tcache_allocator.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if MN_THREAD_CONFIG_TCACHE_TLS_INDEX >= 0
+	#define MN_TCACHE_USE_TLS 1
+
+	static_assert(MN_THREAD_CONFIG_TCACHE_TLS_INDEX < configNUM_THREAD_LOCAL_STORAGE_POINTERS,
+		"MN_THREAD_CONFIG_TCACHE_TLS_INDEX is not a thread local storage pointer: raise "
+		"configNUM_THREAD_LOCAL_STORAGE_POINTERS or set the index to -1");
+	#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_ESP32
+	static_assert(MN_THREAD_CONFIG_TCACHE_TLS_INDEX != 0,
+		"the thread local storage pointer 0 is reserved for the ESP-IDF pthread storage");
+	#endif
+#else
+	#define MN_TCACHE_USE_TLS 0
+#endif
+
+namespace mn {
+	namespace memory {
+		namespace internal {
+			/**
+			 * A block in the remote free list
+			 */
+			struct tcache_remote_block {
+				tcache_remote_block* pNext;
+			};
+
+			/**
+			 * The cache of one task, only the owner task use the magazines
+			 */
+			struct tcache_task_cache {
+				TaskHandle_t hOwner;
+				uint32_t uiCount[basic_slab_pool::CLASSES];
+				void* pBlocks[basic_slab_pool::CLASSES][MN_THREAD_CONFIG_TCACHE_MAGAZINE];
+
+				uint32_t uiHits;
+				uint32_t uiRefills;
+				uint32_t uiFlushes;
+			};
+
+			static tcache_task_cache g_tcacheCaches[MN_THREAD_CONFIG_TCACHE_MAX_TASKS];
+			static tcache_remote_block* g_tcacheRemote[basic_slab_pool::CLASSES];
+			static uint32_t g_tcacheRemoteFrees = 0;
+
+			//-----------------------------------
+			//  tcache_release
+			//-----------------------------------
+			static void tcache_release(tcache_task_cache* pCache) {
+				basic_slab_pool& _depot = basic_slab_pool::instance();
+
+				for(size_t i = 0; i < basic_slab_pool::CLASSES; i++) {
+					if(pCache->uiCount[i] > 0)
+						_depot.deallocate_batch(i, pCache->pBlocks[i], pCache->uiCount[i]);
+					pCache->uiCount[i] = 0;
+				}
+				__atomic_store_n(&pCache->hOwner, (TaskHandle_t)NULL, __ATOMIC_RELEASE);
+			}
+
+#if MN_TCACHE_USE_TLS == 1 && defined(configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS) && (configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS == 1)
+			//-----------------------------------
+			//  tcache_delete_callback
+			//-----------------------------------
+			static void tcache_delete_callback(int index, void* pData) {
+				MN_UNUSED_VARIABLE(index);
+				if(pData != NULL) tcache_release(static_cast<tcache_task_cache*>(pData));
+			}
+#endif
+			//-----------------------------------
+			//  tcache_get
+			//-----------------------------------
+			static tcache_task_cache* tcache_get() {
+#if MN_TCACHE_USE_TLS == 1
+				if(xPortInIsrContext()) return NULL;
+
+				tcache_task_cache* _pCache = static_cast<tcache_task_cache*>(
+					pvTaskGetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TCACHE_TLS_INDEX));
+				if(_pCache != NULL) return _pCache;
+
+				TaskHandle_t _hSelf = xTaskGetCurrentTaskHandle();
+				if(_hSelf == NULL) return NULL;
+
+				for(size_t i = 0; i < MN_THREAD_CONFIG_TCACHE_MAX_TASKS; i++) {
+					TaskHandle_t _hExpected = NULL;
+
+					if(!__atomic_compare_exchange_n(&g_tcacheCaches[i].hOwner, &_hExpected, _hSelf, false,
+													__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) continue;
+
+					_pCache = &g_tcacheCaches[i];
+					for(size_t c = 0; c < basic_slab_pool::CLASSES; c++) _pCache->uiCount[c] = 0;
+
+	#if defined(configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS) && (configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS == 1)
+					vTaskSetThreadLocalStoragePointerAndDelCallback(NULL, MN_THREAD_CONFIG_TCACHE_TLS_INDEX,
+																	_pCache, tcache_delete_callback);
+	#else
+					vTaskSetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TCACHE_TLS_INDEX, _pCache);
+	#endif
+					return _pCache;
+				}
+#endif
+				// no free cache, use the shared pool
+				return NULL;
+			}
+
+			//-----------------------------------
+			//  tcache_refill
+			//-----------------------------------
+			static void tcache_refill(tcache_task_cache* pCache, size_t uiClass) {
+				basic_slab_pool& _depot = basic_slab_pool::instance();
+				void** _pMagazine = pCache->pBlocks[uiClass];
+
+				// take the whole remote list, no ABA: the list is only taken at once
+				tcache_remote_block* _pRemote = __atomic_exchange_n(&g_tcacheRemote[uiClass],
+																	(tcache_remote_block*)NULL, __ATOMIC_ACQUIRE);
+				while(_pRemote != NULL) {
+					void* _pOverflow[MN_THREAD_CONFIG_TCACHE_BATCH];
+					size_t _uiOverflow = 0;
+
+					while(_pRemote != NULL && _uiOverflow < MN_THREAD_CONFIG_TCACHE_BATCH) {
+						tcache_remote_block* _pNext = _pRemote->pNext;
+
+						if(pCache->uiCount[uiClass] < MN_THREAD_CONFIG_TCACHE_MAGAZINE)
+							_pMagazine[pCache->uiCount[uiClass]++] = _pRemote;
+						else
+							_pOverflow[_uiOverflow++] = _pRemote;
+
+						_pRemote = _pNext;
+					}
+					if(_uiOverflow > 0) _depot.deallocate_batch(uiClass, _pOverflow, _uiOverflow);
+				}
+
+				if(pCache->uiCount[uiClass] == 0) {
+					pCache->uiCount[uiClass] = _depot.allocate_batch(uiClass, _pMagazine, MN_THREAD_CONFIG_TCACHE_BATCH);
+				}
+				__atomic_store_n(&pCache->uiRefills, pCache->uiRefills + 1, __ATOMIC_RELAXED);
+			}
+
+#if MN_TCACHE_USE_TLS == 0
+			//-----------------------------------
+			//  tcache_drain_remote
+			//-----------------------------------
+			static void tcache_drain_remote(size_t uiClass) {
+				// without task caches only the frees from a ISR are in the remote list
+				if(__atomic_load_n(&g_tcacheRemote[uiClass], __ATOMIC_RELAXED) == NULL) return;
+
+				tcache_remote_block* _pRemote = __atomic_exchange_n(&g_tcacheRemote[uiClass],
+																	(tcache_remote_block*)NULL, __ATOMIC_ACQUIRE);
+				void* _pBatch[MN_THREAD_CONFIG_TCACHE_BATCH];
+				size_t _uiBatch = 0;
+
+				while(_pRemote != NULL) {
+					_pBatch[_uiBatch++] = _pRemote;
+					_pRemote = _pRemote->pNext;
+
+					if(_uiBatch == MN_THREAD_CONFIG_TCACHE_BATCH || _pRemote == NULL) {
+						basic_slab_pool::instance().deallocate_batch(uiClass, _pBatch, _uiBatch);
+						_uiBatch = 0;
+					}
+				}
+			}
+#endif
+		}
+
+		//-----------------------------------
+		//  basic_allocator_tcache_impl::allocate
+		//-----------------------------------
+		void* basic_allocator_tcache_impl::allocate(size_t size, size_t alignment) noexcept {
+			const size_t _uiClass = basic_slab_pool::get_class(size);
+
+			if(_uiClass >= basic_slab_pool::CLASSES || alignment > mn::max_alignment)
+				return basic_slab_pool::instance().allocate(size, alignment);
+
+			internal::tcache_task_cache* _pCache = internal::tcache_get();
+			if(_pCache == NULL) {
+#if MN_TCACHE_USE_TLS == 0
+				internal::tcache_drain_remote(_uiClass);
+#endif
+				return basic_slab_pool::instance().allocate(size, alignment);
+			}
+
+			if(_pCache->uiCount[_uiClass] == 0) {
+				internal::tcache_refill(_pCache, _uiClass);
+				if(_pCache->uiCount[_uiClass] == 0) return NULL;
+			} else {
+				// only the owner writes the counters, get_stats reads them
+				__atomic_store_n(&_pCache->uiHits, _pCache->uiHits + 1, __ATOMIC_RELAXED);
+			}
+			return _pCache->pBlocks[_uiClass][--_pCache->uiCount[_uiClass]];
+		}
+
+		//-----------------------------------
+		//  basic_allocator_tcache_impl::deallocate
+		//-----------------------------------
+		void basic_allocator_tcache_impl::deallocate(void* ptr, size_t size, size_t alignment) noexcept {
+			if(ptr == NULL) return;
+
+			const size_t _uiClass = basic_slab_pool::get_class(size);
+
+			if(_uiClass >= basic_slab_pool::CLASSES || alignment > mn::max_alignment) {
+				basic_slab_pool::instance().deallocate(ptr, size, alignment);
+				return;
+			}
+
+			internal::tcache_task_cache* _pCache = internal::tcache_get();
+
+#if MN_TCACHE_USE_TLS == 0
+			// no task caches, so no refill takes the remote list: only a ISR use it
+			if(_pCache == NULL && !xPortInIsrContext()) {
+				basic_slab_pool::instance().deallocate(ptr, size, alignment);
+				return;
+			}
+#endif
+			if(_pCache == NULL) {
+				// lock-free push, can use from a ISR
+				internal::tcache_remote_block* _pBlock = static_cast<internal::tcache_remote_block*>(ptr);
+				internal::tcache_remote_block* _pHead = __atomic_load_n(&internal::g_tcacheRemote[_uiClass], __ATOMIC_RELAXED);
+				do {
+					_pBlock->pNext = _pHead;
+				} while(!__atomic_compare_exchange_n(&internal::g_tcacheRemote[_uiClass], &_pHead, _pBlock, true,
+													 __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+				__atomic_fetch_add(&internal::g_tcacheRemoteFrees, 1, __ATOMIC_RELAXED);
+				return;
+			}
+
+			uint32_t& _uiCount = _pCache->uiCount[_uiClass];
+
+			if(_uiCount >= MN_THREAD_CONFIG_TCACHE_MAGAZINE) {
+				// give the oldest blocks back, the newest are hot in the cache
+				basic_slab_pool::instance().deallocate_batch(_uiClass, _pCache->pBlocks[_uiClass], MN_THREAD_CONFIG_TCACHE_BATCH);
+
+				for(uint32_t i = MN_THREAD_CONFIG_TCACHE_BATCH; i < _uiCount; i++)
+					_pCache->pBlocks[_uiClass][i - MN_THREAD_CONFIG_TCACHE_BATCH] = _pCache->pBlocks[_uiClass][i];
+
+				_uiCount -= MN_THREAD_CONFIG_TCACHE_BATCH;
+				__atomic_store_n(&_pCache->uiFlushes, _pCache->uiFlushes + 1, __ATOMIC_RELAXED);
+			}
+			_pCache->pBlocks[_uiClass][_uiCount++] = ptr;
+		}
+
+		//-----------------------------------
+		//  basic_allocator_tcache_impl::flush
+		//-----------------------------------
+		void basic_allocator_tcache_impl::flush() noexcept {
+#if MN_TCACHE_USE_TLS == 1
+			if(xPortInIsrContext()) return;
+
+			internal::tcache_task_cache* _pCache = static_cast<internal::tcache_task_cache*>(
+				pvTaskGetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TCACHE_TLS_INDEX));
+			if(_pCache == NULL) return;
+
+			vTaskSetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TCACHE_TLS_INDEX, NULL);
+			internal::tcache_release(_pCache);
+#endif
+		}
+
+		//-----------------------------------
+		//  basic_allocator_tcache_impl::get_stats
+		//-----------------------------------
+		void basic_allocator_tcache_impl::get_stats(tcache_stats& stats) noexcept {
+			stats.uiHits = stats.uiRefills = stats.uiFlushes = stats.uiCaches = 0;
+			stats.uiRemoteFrees = __atomic_load_n(&internal::g_tcacheRemoteFrees, __ATOMIC_RELAXED);
+
+			for(size_t i = 0; i < MN_THREAD_CONFIG_TCACHE_MAX_TASKS; i++) {
+				internal::tcache_task_cache& _cache = internal::g_tcacheCaches[i];
+
+				stats.uiHits += __atomic_load_n(&_cache.uiHits, __ATOMIC_RELAXED);
+				stats.uiRefills += __atomic_load_n(&_cache.uiRefills, __ATOMIC_RELAXED);
+				stats.uiFlushes += __atomic_load_n(&_cache.uiFlushes, __ATOMIC_RELAXED);
+
+				if(__atomic_load_n(&_cache.hOwner, __ATOMIC_RELAXED) != NULL) stats.uiCaches++;
+			}
+		}
+	}
+}
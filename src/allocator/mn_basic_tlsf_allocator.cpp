@@ -0,0 +1,373 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+#include "allocator/mn_basic_tlsf_allocator.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace mn {
+	namespace memory {
+		/**
+		 * The index of the highest set bit
+		 */
+		static inline size_t tlsf_fls(size_t uiValue) {
+			return sizeof(unsigned long) * 8 - 1 - __builtin_clzl(static_cast<unsigned long>(uiValue));
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::basic_tlsf_heap
+		//-----------------------------------
+		basic_tlsf_heap::basic_tlsf_heap(void* pMemory, size_t uiBytes) noexcept
+			: m_uiFlBitmap(0), m_pFirst(NULL), m_pOwned(NULL), m_uiFree(0), m_uiUsed(0),
+			  m_uiPeak(0), m_uiFailed(0), m_uiCorruptions(0) {
+
+			create(pMemory, uiBytes);
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::basic_tlsf_heap
+		//-----------------------------------
+		basic_tlsf_heap::basic_tlsf_heap(size_t uiBytes) noexcept
+			: m_uiFlBitmap(0), m_pFirst(NULL), m_pOwned(malloc(uiBytes)), m_uiFree(0), m_uiUsed(0),
+			  m_uiPeak(0), m_uiFailed(0), m_uiCorruptions(0) {
+
+			create(m_pOwned, uiBytes);
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::~basic_tlsf_heap
+		//-----------------------------------
+		basic_tlsf_heap::~basic_tlsf_heap() {
+			if(m_pOwned != NULL) free(m_pOwned);
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::create
+		//-----------------------------------
+		void basic_tlsf_heap::create(void* pMemory, size_t uiBytes) noexcept {
+			vPortCPUInitializeMutex(&m_Mux);
+
+			memset(m_uiSlBitmap, 0, sizeof(m_uiSlBitmap));
+			memset(m_pBlocks, 0, sizeof(m_pBlocks));
+
+			if(pMemory == NULL) return;
+
+			uintptr_t _uiStart = reinterpret_cast<uintptr_t>(pMemory);
+			uintptr_t _uiAligned = (_uiStart + ALIGN - 1) & ~(uintptr_t)(ALIGN - 1);
+
+			// the first block and the zero sized sentinel at the end
+			if(uiBytes < (_uiAligned - _uiStart) + 2 * HEADER + MIN_BLOCK) return;
+
+			size_t _uiSize = (uiBytes - (_uiAligned - _uiStart) - 2 * HEADER) & ~(ALIGN - 1);
+			if(_uiSize > MAX_BLOCK - ALIGN) _uiSize = MAX_BLOCK - ALIGN;
+
+			m_pFirst = reinterpret_cast<block_header*>(_uiAligned);
+			m_pFirst->pPrevPhys = NULL;
+			m_pFirst->uiSize = _uiSize | 1;
+
+			block_header* _pSentinel = get_next(m_pFirst);
+			_pSentinel->pPrevPhys = m_pFirst;
+			_pSentinel->uiSize = 0;
+
+			insert_free(m_pFirst);
+			m_uiFree = _uiSize;
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::allocate
+		//-----------------------------------
+		void* basic_tlsf_heap::allocate(size_t size, size_t alignment) noexcept {
+			if(size == 0 || m_pFirst == NULL || size > MAX_BLOCK) return NULL;
+			if(alignment < ALIGN) alignment = ALIGN;
+
+			size_t _uiSize = (size + ALIGN - 1) & ~(ALIGN - 1);
+			if(_uiSize < MIN_BLOCK) _uiSize = MIN_BLOCK;
+
+			// space for a free block in front of the aligned block
+			const size_t _uiGapMin = HEADER + MIN_BLOCK;
+			const size_t _uiSearch = (alignment > ALIGN) ? _uiSize + alignment + _uiGapMin : _uiSize;
+
+			size_t fl = 0, sl = 0;
+			block_header* _pBlock = NULL;
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			if(mapping_search(_uiSearch, fl, sl))
+				_pBlock = search_suitable(fl, sl);
+
+			if(_pBlock == NULL) {
+				m_uiFailed++;
+				portEXIT_CRITICAL_SAFE(&m_Mux);
+
+				return NULL;
+			}
+			remove_free(_pBlock);
+
+			if(alignment > ALIGN) {
+				uintptr_t _uiPayload = reinterpret_cast<uintptr_t>(get_payload(_pBlock));
+				uintptr_t _uiAligned = (_uiPayload + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+				if(_uiAligned != _uiPayload && _uiAligned - _uiPayload < _uiGapMin)
+					_uiAligned = (_uiPayload + _uiGapMin + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+				// the front stays a free block, the previous block is used
+				if(_uiAligned != _uiPayload) {
+					block_header* _pAligned = split(_pBlock, _uiAligned - _uiPayload - HEADER);
+
+					insert_free(_pBlock);
+					_pBlock = _pAligned;
+				}
+			}
+
+			// give the rest back
+			if(get_size(_pBlock) >= _uiSize + HEADER + MIN_BLOCK)
+				insert_free(split(_pBlock, _uiSize));
+
+			_pBlock->uiSize &= ~size_t(1);
+
+			m_uiFree -= get_size(_pBlock);
+			m_uiUsed += get_size(_pBlock);
+			if(m_uiUsed > m_uiPeak) m_uiPeak = m_uiUsed;
+
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return get_payload(_pBlock);
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::deallocate
+		//-----------------------------------
+		void basic_tlsf_heap::deallocate(void* address) noexcept {
+			if(address == NULL) return;
+
+			block_header* _pBlock = from_payload(address);
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			if(is_free(_pBlock)) {
+				m_uiCorruptions++;
+				portEXIT_CRITICAL_SAFE(&m_Mux);
+
+				return;
+			}
+
+			m_uiUsed -= get_size(_pBlock);
+			m_uiFree += get_size(_pBlock);
+
+			_pBlock->uiSize |= 1;
+
+			// coalesce with the previous block, the header is now free space
+			block_header* _pPrev = _pBlock->pPrevPhys;
+			if(_pPrev != NULL && is_free(_pPrev)) {
+				remove_free(_pPrev);
+
+				_pPrev->uiSize += HEADER + get_size(_pBlock);
+				get_next(_pPrev)->pPrevPhys = _pPrev;
+
+				m_uiFree += HEADER;
+				_pBlock = _pPrev;
+			}
+
+			// and with the next block
+			block_header* _pNext = get_next(_pBlock);
+			if(is_free(_pNext)) {
+				remove_free(_pNext);
+
+				_pBlock->uiSize += HEADER + get_size(_pNext);
+				get_next(_pBlock)->pPrevPhys = _pBlock;
+
+				m_uiFree += HEADER;
+			}
+			insert_free(_pBlock);
+
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::get_block_size
+		//-----------------------------------
+		size_t basic_tlsf_heap::get_block_size(void* address) const noexcept {
+			return (address == NULL) ? 0 : get_size(from_payload(address));
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::get_stats
+		//-----------------------------------
+		void basic_tlsf_heap::get_stats(tlsf_stats& stats) noexcept {
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			stats.uiFree = m_uiFree;
+			stats.uiUsed = m_uiUsed;
+			stats.uiPeak = m_uiPeak;
+			stats.uiFailed = m_uiFailed;
+			stats.uiCorruptions = m_uiCorruptions;
+			stats.uiLargestFree = 0;
+
+			// the largest block is in the highest list, the blocks in a list have not the same size
+			if(m_uiFlBitmap != 0) {
+				size_t fl = tlsf_fls(m_uiFlBitmap);
+				size_t sl = tlsf_fls(m_uiSlBitmap[fl]);
+
+				for(block_header* _pBlock = m_pBlocks[fl][sl]; _pBlock != NULL; _pBlock = _pBlock->pNextFree) {
+					if(get_size(_pBlock) > stats.uiLargestFree) stats.uiLargestFree = get_size(_pBlock);
+				}
+			}
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			stats.uiFragmentation = (stats.uiFree == 0) ? 0 :
+				static_cast<uint32_t>(100 - (stats.uiLargestFree * 100) / stats.uiFree);
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::check
+		//-----------------------------------
+		bool basic_tlsf_heap::check() noexcept {
+			if(m_pFirst == NULL) return false;
+
+			bool _bOk = true;
+			size_t _uiFree = 0;
+
+			portENTER_CRITICAL_SAFE(&m_Mux);
+
+			block_header* _pPrev = NULL;
+			for(block_header* _pBlock = m_pFirst; _bOk; _pBlock = get_next(_pBlock)) {
+				if(_pBlock->pPrevPhys != _pPrev) _bOk = false;
+				// two free neighbours are always coalesced
+				if(_pPrev != NULL && is_free(_pPrev) && is_free(_pBlock)) _bOk = false;
+
+				if(is_free(_pBlock)) {
+					size_t fl, sl;
+					mapping_insert(get_size(_pBlock), fl, sl);
+
+					if((m_uiSlBitmap[fl] & (1U << sl)) == 0) _bOk = false;
+					_uiFree += get_size(_pBlock);
+				}
+				if(get_size(_pBlock) == 0) break;
+				_pPrev = _pBlock;
+			}
+			if(_uiFree != m_uiFree) _bOk = false;
+
+			portEXIT_CRITICAL_SAFE(&m_Mux);
+
+			return _bOk;
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::mapping_insert
+		//-----------------------------------
+		void basic_tlsf_heap::mapping_insert(size_t uiSize, size_t& fl, size_t& sl) noexcept {
+			if(uiSize < SMALL_BLOCK) {
+				fl = 0;
+				sl = uiSize / (SMALL_BLOCK / SL_COUNT);
+			} else {
+				size_t _uiFls = tlsf_fls(uiSize);
+
+				sl = (uiSize >> (_uiFls - SL_LOG2)) ^ SL_COUNT;
+				fl = _uiFls - (FL_SHIFT - 1);
+			}
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::mapping_search
+		//-----------------------------------
+		bool basic_tlsf_heap::mapping_search(size_t uiSize, size_t& fl, size_t& sl) noexcept {
+			// round up to the next list, so that each block in the found list is big enough
+			if(uiSize >= SMALL_BLOCK)
+				uiSize += (size_t(1) << (tlsf_fls(uiSize) - SL_LOG2)) - 1;
+
+			mapping_insert(uiSize, fl, sl);
+			return fl < FL_COUNT;
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::search_suitable
+		//-----------------------------------
+		basic_tlsf_heap::block_header* basic_tlsf_heap::search_suitable(size_t& fl, size_t& sl) noexcept {
+			uint32_t _uiSlMap = m_uiSlBitmap[fl] & (~0U << sl);
+
+			if(_uiSlMap == 0) {
+				uint32_t _uiFlMap = m_uiFlBitmap & (~0U << (fl + 1));
+				if(_uiFlMap == 0) return NULL;
+
+				fl = __builtin_ctz(_uiFlMap);
+				_uiSlMap = m_uiSlBitmap[fl];
+			}
+			sl = __builtin_ctz(_uiSlMap);
+
+			return m_pBlocks[fl][sl];
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::insert_free
+		//-----------------------------------
+		void basic_tlsf_heap::insert_free(block_header* pBlock) noexcept {
+			size_t fl, sl;
+			mapping_insert(get_size(pBlock), fl, sl);
+
+			pBlock->uiSize |= 1;
+			pBlock->pPrevFree = NULL;
+			pBlock->pNextFree = m_pBlocks[fl][sl];
+
+			if(pBlock->pNextFree != NULL) pBlock->pNextFree->pPrevFree = pBlock;
+			m_pBlocks[fl][sl] = pBlock;
+
+			m_uiFlBitmap |= (1U << fl);
+			m_uiSlBitmap[fl] |= (1U << sl);
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::remove_free
+		//-----------------------------------
+		void basic_tlsf_heap::remove_free(block_header* pBlock) noexcept {
+			size_t fl, sl;
+			mapping_insert(get_size(pBlock), fl, sl);
+
+			if(pBlock->pNextFree != NULL) pBlock->pNextFree->pPrevFree = pBlock->pPrevFree;
+
+			if(pBlock->pPrevFree != NULL) {
+				pBlock->pPrevFree->pNextFree = pBlock->pNextFree;
+			} else {
+				m_pBlocks[fl][sl] = pBlock->pNextFree;
+
+				if(m_pBlocks[fl][sl] == NULL) {
+					m_uiSlBitmap[fl] &= ~(1U << sl);
+					if(m_uiSlBitmap[fl] == 0) m_uiFlBitmap &= ~(1U << fl);
+				}
+			}
+		}
+
+		//-----------------------------------
+		//  basic_tlsf_heap::split
+		//-----------------------------------
+		basic_tlsf_heap::block_header* basic_tlsf_heap::split(block_header* pBlock, size_t uiSize) noexcept {
+			block_header* _pRest = reinterpret_cast<block_header*>(get_payload(pBlock) + uiSize);
+
+			// the new header takes HEADER bytes of the free space
+			_pRest->uiSize = (get_size(pBlock) - uiSize - HEADER) | (pBlock->uiSize & 1);
+			_pRest->pPrevPhys = pBlock;
+			get_next(_pRest)->pPrevPhys = _pRest;
+
+			pBlock->uiSize = uiSize | (pBlock->uiSize & 1);
+
+			if(is_free(pBlock)) m_uiFree -= HEADER;
+			return _pRest;
+		}
+	}
+}
@@ -0,0 +1,521 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdio.h>
+
+#include "coroutine/mn_co_executor.hpp"
+#include "mn_autolock.hpp"
+
+/// The awaiter is added to the event and try the operation again
+#define MN_CO_AWAITER_ARMING        0
+/// The awaiter is suspended and waits for the event or the timeout
+#define MN_CO_AWAITER_PARKED        1
+/// The event or the timeout has taken the awaiter, the taker try the operation again
+#define MN_CO_AWAITER_CLAIMED       2
+/// The event came, while the awaiter was arming
+#define MN_CO_AWAITER_NOTIFIED      3
+
+namespace mn {
+    /**
+     * How many ticks are left to a timeout, 0 when it is over
+     */
+    static inline TickType_t co_ticks_left(TickType_t xNow, TickType_t xStart, TickType_t xTicksToWait) {
+        TickType_t _xElapsed = xNow - xStart;
+
+        return (_xElapsed >= xTicksToWait) ? 0 : xTicksToWait - _xElapsed;
+    }
+
+    //-----------------------------------
+    //  basic_co_event::constructor
+    //-----------------------------------
+    basic_co_event::basic_co_event()
+        : m_pWaiters(NULL) {
+        vPortCPUInitializeMutex(&m_Mux);
+    }
+
+    //-----------------------------------
+    //  basic_co_event::copy constructor
+    //-----------------------------------
+    basic_co_event::basic_co_event(const basic_co_event&)
+        : m_pWaiters(NULL) {
+        vPortCPUInitializeMutex(&m_Mux);
+    }
+
+    //-----------------------------------
+    //  basic_co_event::has_waiters
+    //-----------------------------------
+    bool basic_co_event::has_waiters() const {
+        return __atomic_load_n(&m_pWaiters, __ATOMIC_SEQ_CST) != NULL;
+    }
+
+    //-----------------------------------
+    //  basic_co_event::add
+    //-----------------------------------
+    void basic_co_event::add(basic_co_awaiter* pAwaiter) {
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            pAwaiter->m_pNext = m_pWaiters;
+            __atomic_store_n(&m_pWaiters, pAwaiter, __ATOMIC_SEQ_CST);
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+    }
+
+    //-----------------------------------
+    //  basic_co_event::remove
+    //-----------------------------------
+    void basic_co_event::remove(basic_co_awaiter* pAwaiter) {
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            basic_co_awaiter* volatile* _ppLink = &m_pWaiters;
+
+            while(*_ppLink != NULL && *_ppLink != pAwaiter)
+                _ppLink = &(*_ppLink)->m_pNext;
+
+            // a notify_all has removed the awaiter
+            if(*_ppLink != NULL) __atomic_store_n(_ppLink, pAwaiter->m_pNext, __ATOMIC_SEQ_CST);
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+    }
+
+    //-----------------------------------
+    //  basic_co_event::notify_all
+    //-----------------------------------
+    void basic_co_event::notify_all() {
+        if(!has_waiters()) return;
+
+        basic_co_awaiter* _pClaimed = NULL;
+
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            basic_co_awaiter* _pAwaiter = m_pWaiters;
+            __atomic_store_n(&m_pWaiters, (basic_co_awaiter*)NULL, __ATOMIC_SEQ_CST);
+
+            while(_pAwaiter != NULL) {
+                basic_co_awaiter* _pNext = _pAwaiter->m_pNext;
+                int _iState = __atomic_load_n(&_pAwaiter->m_iState, __ATOMIC_ACQUIRE);
+
+                for(;;) {
+                    if(_iState == MN_CO_AWAITER_PARKED) {
+                        if(__atomic_compare_exchange_n(&_pAwaiter->m_iState, &_iState, MN_CO_AWAITER_CLAIMED,
+                                                       false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                            _pAwaiter->m_pNext = _pClaimed;
+                            _pClaimed = _pAwaiter;
+                            break;
+                        }
+                    } else if(_iState == MN_CO_AWAITER_ARMING) {
+                        // the arming task sees this and try again
+                        if(__atomic_compare_exchange_n(&_pAwaiter->m_iState, &_iState, MN_CO_AWAITER_NOTIFIED,
+                                                       false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                            break;
+                    } else {
+                        // the timeout has taken it
+                        break;
+                    }
+                }
+                _pAwaiter = _pNext;
+            }
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        // the claimed awaiter are owned by this call
+        while(_pClaimed != NULL) {
+            basic_co_awaiter* _pAwaiter = _pClaimed;
+            _pClaimed = _pAwaiter->m_pNext;
+
+            _pAwaiter->m_pExecutor->post(_pAwaiter);
+        }
+    }
+
+    //-----------------------------------
+    //  basic_co_event::pended_notify
+    //-----------------------------------
+    void basic_co_event::pended_notify(void* pEvent, uint32_t ulParameter) {
+        (void)ulParameter;
+
+        static_cast<basic_co_event*>(pEvent)->notify_all();
+    }
+
+    //-----------------------------------
+    //  basic_co_awaiter::constructor
+    //-----------------------------------
+    basic_co_awaiter::basic_co_awaiter(unsigned int xTicksToWait)
+        : m_hCoroutine(), m_pExecutor(NULL), m_pNext(NULL), m_pNextTimeout(NULL),
+          m_xStart(xTaskGetTickCount()), m_xTicksToWait(xTicksToWait),
+          m_iState(MN_CO_AWAITER_ARMING), m_bTimeout(false) { }
+
+    //-----------------------------------
+    //  basic_co_awaiter::is_timeout
+    //-----------------------------------
+    bool basic_co_awaiter::is_timeout() const {
+        if(m_xTicksToWait == portMAX_DELAY) return false;
+
+        return (xTaskGetTickCount() - m_xStart) >= m_xTicksToWait;
+    }
+
+    //-----------------------------------
+    //  co_executor_task::constructor
+    //-----------------------------------
+    basic_co_executor::co_executor_task::co_executor_task(char const* strName,
+                basic_task::priority uiPriority, unsigned short usStackDepth, basic_co_executor* parent)
+        : basic_task(strName, uiPriority, usStackDepth), m_pParent(parent) { }
+
+    //-----------------------------------
+    //  co_executor_task::on_task
+    //-----------------------------------
+    int basic_co_executor::co_executor_task::on_task() {
+        basic_task::on_task();
+
+        m_pParent->run();
+
+        return ERR_TASK_OK;
+    }
+
+    //-----------------------------------
+    //  constructor
+    //-----------------------------------
+    basic_co_executor::basic_co_executor(uint8_t uiNumWorkers, basic_task::priority uiPriority,
+                                         uint16_t usStackDepth, uint8_t uiMaxReady)
+        : m_pReadyQueue(NULL),
+          m_ThreadStatus(),
+          m_pNotified(NULL),
+          m_pNotifiedTail(NULL),
+          m_pTimeouts(NULL),
+          m_uiNumWorkers(uiNumWorkers),
+          m_bRunning(false) {
+
+        char name[32];
+
+        vPortCPUInitializeMutex(&m_Mux);
+
+        m_pReadyQueue = new queue::queue_t(uiMaxReady, sizeof(void*));
+
+        for (int i = 0; i < m_uiNumWorkers; i++) {
+            sprintf(name, "co_exec_%d", i);
+
+            co_executor_task *pWorker = new co_executor_task(name, uiPriority, usStackDepth, this);
+
+            if(pWorker)
+                m_Workers.push_back(pWorker);
+        }
+    }
+
+    //-----------------------------------
+    //  deconstructor
+    //-----------------------------------
+    basic_co_executor::~basic_co_executor() {
+        destroy();
+
+        for(int i = 0; i < get_num_worker(); i++) {
+            delete m_Workers[i];
+        }
+        m_Workers.clear();
+
+        if(m_pReadyQueue != NULL) {
+            m_pReadyQueue->destroy();
+            delete m_pReadyQueue;
+        }
+    }
+
+    //-----------------------------------
+    //  create
+    //-----------------------------------
+    int basic_co_executor::create(int iCore) {
+        automutx_t lock(m_ThreadStatus);
+
+        bool _errorOnCreate = false;
+        bool _oneNoError = false;
+
+        if(m_bRunning) {
+            return ERR_COROUTINE_ALREADYINIT;
+        }
+
+        int ret = m_pReadyQueue->create();
+        if( ret != ERR_QUEUE_OK && ret != ERR_QUEUE_ALREADYINIT) {
+            return ERR_COROUTINE_CANTCREATE;
+        }
+
+        m_bRunning = true;
+
+        for(int i = 0; i < get_num_worker(); i++) {
+            if(m_Workers[i]->start(iCore) != ERR_TASK_OK) {
+                _errorOnCreate = true;
+            } else {
+                _oneNoError = true;
+            }
+        }
+        if(!_oneNoError) {
+            m_bRunning = false;
+            return ERR_COROUTINE_CANTCREATE;
+        }
+        if(_errorOnCreate || m_uiNumWorkers != get_num_worker()) {
+            return ERR_COROUTINE_WARNING;
+        }
+        return ERR_COROUTINE_OK;
+    }
+
+    //-----------------------------------
+    //  destroy
+    //-----------------------------------
+    void basic_co_executor::destroy() {
+        m_ThreadStatus.lock();
+        bool _bWasRunning = m_bRunning;
+        m_bRunning = false;
+        m_ThreadStatus.unlock();
+
+        if(!_bWasRunning) return;
+
+        // the executor tasks wait for the next timeout or event
+        for(int i = 0; i < get_num_worker(); i++) {
+            wake();
+        }
+        for(int i = 0; i < get_num_worker(); i++) {
+            m_Workers[i]->join();
+        }
+    }
+
+    //-----------------------------------
+    //  schedule
+    //-----------------------------------
+    int basic_co_executor::schedule(std::coroutine_handle<> hCoroutine, unsigned int timeout) {
+        void* _pAddress = hCoroutine.address();
+
+        if(m_pReadyQueue->enqueue(&_pAddress, timeout) != ERR_QUEUE_OK)
+            return ERR_COROUTINE_CANSHEDULE;
+
+        return ERR_COROUTINE_OK;
+    }
+
+    //-----------------------------------
+    //  wake
+    //-----------------------------------
+    void basic_co_executor::wake() {
+        void* _pNull = NULL;
+
+        // when the queue is full, the executor tasks are awake
+        m_pReadyQueue->enqueue(&_pNull, 0);
+    }
+
+    //-----------------------------------
+    //  suspend
+    //-----------------------------------
+    bool basic_co_executor::suspend(basic_co_awaiter* pAwaiter) {
+        if(park(pAwaiter)) return true;
+
+        // done while suspending, continue the coroutine on this task
+        done(pAwaiter);
+        return false;
+    }
+
+    //-----------------------------------
+    //  park
+    //-----------------------------------
+    bool basic_co_executor::park(basic_co_awaiter* pAwaiter) {
+        basic_co_event* _pEvent = pAwaiter->get_event();
+
+        for(;;) {
+            __atomic_store_n(&pAwaiter->m_iState, MN_CO_AWAITER_ARMING, __ATOMIC_SEQ_CST);
+
+            if(_pEvent != NULL) _pEvent->add(pAwaiter);
+            pAwaiter->on_wait();
+
+            // try again, a change before the add has not notified this awaiter
+            if(pAwaiter->poll() || pAwaiter->is_timeout()) {
+                if(_pEvent != NULL) _pEvent->remove(pAwaiter);
+                return false;
+            }
+
+            if(pAwaiter->m_xTicksToWait != portMAX_DELAY)
+                add_timeout(pAwaiter);
+
+            int _iExpected = MN_CO_AWAITER_ARMING;
+
+            // after this the awaiter is owned by the event or the timeout
+            if(__atomic_compare_exchange_n(&pAwaiter->m_iState, &_iExpected, MN_CO_AWAITER_PARKED,
+                                           false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                return true;
+
+            // notified while arming, the event has removed the awaiter
+        }
+    }
+
+    //-----------------------------------
+    //  retry
+    //-----------------------------------
+    void basic_co_executor::retry(basic_co_awaiter* pAwaiter) {
+        if(park(pAwaiter)) return;
+
+        done(pAwaiter);
+        pAwaiter->m_hCoroutine.resume();
+    }
+
+    //-----------------------------------
+    //  done
+    //-----------------------------------
+    void basic_co_executor::done(basic_co_awaiter* pAwaiter) {
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            if(pAwaiter->m_bTimeout) {
+                basic_co_awaiter** _ppLink = &m_pTimeouts;
+
+                while(*_ppLink != pAwaiter)
+                    _ppLink = &(*_ppLink)->m_pNextTimeout;
+
+                *_ppLink = pAwaiter->m_pNextTimeout;
+                pAwaiter->m_bTimeout = false;
+            }
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        pAwaiter->on_done();
+    }
+
+    //-----------------------------------
+    //  post
+    //-----------------------------------
+    void basic_co_executor::post(basic_co_awaiter* pAwaiter) {
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            pAwaiter->m_pNext = NULL;
+
+            if(m_pNotifiedTail != NULL)
+                m_pNotifiedTail->m_pNext = pAwaiter;
+            else
+                m_pNotified = pAwaiter;
+
+            m_pNotifiedTail = pAwaiter;
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        wake();
+    }
+
+    //-----------------------------------
+    //  pop_notified
+    //-----------------------------------
+    basic_co_awaiter* basic_co_executor::pop_notified() {
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            basic_co_awaiter* _pAwaiter = m_pNotified;
+
+            if(_pAwaiter != NULL) {
+                m_pNotified = _pAwaiter->m_pNext;
+                if(m_pNotified == NULL) m_pNotifiedTail = NULL;
+            }
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        return _pAwaiter;
+    }
+
+    //-----------------------------------
+    //  add_timeout
+    //-----------------------------------
+    void basic_co_executor::add_timeout(basic_co_awaiter* pAwaiter) {
+        TickType_t _xNow = xTaskGetTickCount();
+        bool _bFirst = false;
+
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            if(!pAwaiter->m_bTimeout) {
+                TickType_t _xLeft = co_ticks_left(_xNow, pAwaiter->m_xStart, pAwaiter->m_xTicksToWait);
+                basic_co_awaiter** _ppLink = &m_pTimeouts;
+
+                while(*_ppLink != NULL &&
+                      co_ticks_left(_xNow, (*_ppLink)->m_xStart, (*_ppLink)->m_xTicksToWait) <= _xLeft)
+                    _ppLink = &(*_ppLink)->m_pNextTimeout;
+
+                pAwaiter->m_pNextTimeout = *_ppLink;
+                *_ppLink = pAwaiter;
+                pAwaiter->m_bTimeout = true;
+
+                _bFirst = (m_pTimeouts == pAwaiter);
+            }
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        // the executor tasks must wait a shorter time
+        if(_bFirst) wake();
+    }
+
+    //-----------------------------------
+    //  expire
+    //-----------------------------------
+    TickType_t basic_co_executor::expire() {
+        TickType_t _xNow = xTaskGetTickCount();
+        TickType_t _xWait = portMAX_DELAY;
+        basic_co_awaiter* _pExpired = NULL;
+
+        portENTER_CRITICAL_SAFE(&m_Mux);
+            basic_co_awaiter** _ppLink = &m_pTimeouts;
+
+            while(*_ppLink != NULL) {
+                basic_co_awaiter* _pAwaiter = *_ppLink;
+                TickType_t _xLeft = co_ticks_left(_xNow, _pAwaiter->m_xStart, _pAwaiter->m_xTicksToWait);
+
+                if(_xLeft != 0) {
+                    if(_xLeft < _xWait) _xWait = _xLeft;
+                    break;
+                }
+
+                int _iExpected = MN_CO_AWAITER_PARKED;
+
+                if(!__atomic_compare_exchange_n(&_pAwaiter->m_iState, &_iExpected, MN_CO_AWAITER_CLAIMED,
+                                                false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                    // arming or notified: the awaiter stays linked, park() doesn't add it again
+                    // and done() removes it. Check again in the next tick, it can be parked then.
+                    _xWait = 1;
+                    _ppLink = &_pAwaiter->m_pNextTimeout;
+                    continue;
+                }
+                *_ppLink = _pAwaiter->m_pNextTimeout;
+                _pAwaiter->m_bTimeout = false;
+
+                _pAwaiter->m_pNextTimeout = _pExpired;
+                _pExpired = _pAwaiter;
+            }
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        while(_pExpired != NULL) {
+            basic_co_awaiter* _pAwaiter = _pExpired;
+            _pExpired = _pAwaiter->m_pNextTimeout;
+
+            basic_co_event* _pEvent = _pAwaiter->get_event();
+            if(_pEvent != NULL) _pEvent->remove(_pAwaiter);
+
+            retry(_pAwaiter);
+        }
+        return _xWait;
+    }
+
+    //-----------------------------------
+    //  run
+    //-----------------------------------
+    void basic_co_executor::run() {
+        void* _pAddress = NULL;
+
+        while( m_bRunning ) {
+            basic_co_awaiter* _pAwaiter;
+
+            while( (_pAwaiter = pop_notified()) != NULL ) {
+                retry(_pAwaiter);
+            }
+
+            // wait for a scheduled coroutine, a notified awaiter or the next timeout
+            TickType_t _xWait = expire();
+            _pAddress = NULL;
+
+            if(m_pReadyQueue->dequeue(&_pAddress, _xWait) == ERR_QUEUE_OK && _pAddress != NULL) {
+                std::coroutine_handle<>::from_address(_pAddress).resume();
+            }
+        }
+    }
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
@@ -0,0 +1,193 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+
+#include <string.h>
+
+#include "coroutine/mn_co_socket.hpp"
+#include "mn_autolock.hpp"
+
+namespace mn {
+    //-----------------------------------
+    //  co_select_task::constructor
+    //-----------------------------------
+    basic_co_select::co_select_task::co_select_task(basic_co_select* parent)
+        : basic_task("co_select", MN_THREAD_CONFIG_COROUTINE_PRIORITY, MN_THREAD_CONFIG_COROUTINE_STACKSIZE),
+          m_pParent(parent) { }
+
+    //-----------------------------------
+    //  co_select_task::on_task
+    //-----------------------------------
+    int basic_co_select::co_select_task::on_task() {
+        basic_task::on_task();
+
+        m_pParent->run();
+
+        return ERR_TASK_OK;
+    }
+
+    //-----------------------------------
+    //  constructor
+    //-----------------------------------
+    basic_co_select::basic_co_select()
+        : m_Lock(), m_pEntries(NULL), m_pTask(NULL), m_iWakeSocket(-1) {
+
+        memset(&m_WakeAddress, 0, sizeof(m_WakeAddress));
+    }
+
+    //-----------------------------------
+    //  instance
+    //-----------------------------------
+    basic_co_select& basic_co_select::instance() {
+        static basic_co_select _select;
+        return _select;
+    }
+
+    //-----------------------------------
+    //  create
+    //-----------------------------------
+    int basic_co_select::create() {
+        socklen_t _uiLength = sizeof(m_WakeAddress);
+
+        m_iWakeSocket = lwip_socket(AF_INET, SOCK_DGRAM, 0);
+        if(m_iWakeSocket < 0) return ERR_COROUTINE_CANTCREATE;
+
+        // a loopback socket on a free port, the task sends to itself
+        m_WakeAddress.sin_family = AF_INET;
+        m_WakeAddress.sin_addr.s_addr = lwip_htonl(IPADDR_LOOPBACK);
+        m_WakeAddress.sin_port = 0;
+
+        if(lwip_bind(m_iWakeSocket, (struct sockaddr*)&m_WakeAddress, sizeof(m_WakeAddress)) != 0 ||
+           lwip_getsockname(m_iWakeSocket, (struct sockaddr*)&m_WakeAddress, &_uiLength) != 0) {
+            lwip_close(m_iWakeSocket);
+            m_iWakeSocket = -1;
+            return ERR_COROUTINE_CANTCREATE;
+        }
+
+        m_pTask = new co_select_task(this);
+
+        if(m_pTask == NULL || m_pTask->start() != ERR_TASK_OK) {
+            delete m_pTask;
+            m_pTask = NULL;
+
+            lwip_close(m_iWakeSocket);
+            m_iWakeSocket = -1;
+            return ERR_COROUTINE_CANTCREATE;
+        }
+        return ERR_COROUTINE_OK;
+    }
+
+    //-----------------------------------
+    //  add
+    //-----------------------------------
+    int basic_co_select::add(entry* pEntry) {
+        {
+            automutx_t lock(m_Lock);
+
+            if(m_pTask == NULL && create() != ERR_COROUTINE_OK)
+                return ERR_COROUTINE_CANTCREATE;
+
+            if(!pEntry->bLinked) {
+                pEntry->pNext = m_pEntries;
+                pEntry->bLinked = true;
+                m_pEntries = pEntry;
+            }
+        }
+        // the select must wait for the new socket
+        wake();
+
+        return ERR_COROUTINE_OK;
+    }
+
+    //-----------------------------------
+    //  remove
+    //-----------------------------------
+    void basic_co_select::remove(entry* pEntry) {
+        automutx_t lock(m_Lock);
+
+        if(!pEntry->bLinked) return;
+
+        entry** _ppLink = &m_pEntries;
+
+        while(*_ppLink != pEntry)
+            _ppLink = &(*_ppLink)->pNext;
+
+        *_ppLink = pEntry->pNext;
+        pEntry->bLinked = false;
+    }
+
+    //-----------------------------------
+    //  wake
+    //-----------------------------------
+    void basic_co_select::wake() {
+        char _cWake = 0;
+
+        lwip_sendto(m_iWakeSocket, &_cWake, 1, 0, (struct sockaddr*)&m_WakeAddress, sizeof(m_WakeAddress));
+    }
+
+    //-----------------------------------
+    //  run
+    //-----------------------------------
+    void basic_co_select::run() {
+        char _cBuffer[16];
+
+        for(;;) {
+            fd_set _readSet;
+            int _iMax = m_iWakeSocket;
+
+            FD_ZERO(&_readSet);
+            FD_SET(m_iWakeSocket, &_readSet);
+
+            m_Lock.lock();
+            for(entry* _pEntry = m_pEntries; _pEntry != NULL; _pEntry = _pEntry->pNext) {
+                FD_SET(_pEntry->iSocket, &_readSet);
+                if(_pEntry->iSocket > _iMax) _iMax = _pEntry->iSocket;
+            }
+            m_Lock.unlock();
+
+            int _iReady = lwip_select(_iMax + 1, &_readSet, NULL, NULL, NULL);
+
+            if(_iReady > 0 && FD_ISSET(m_iWakeSocket, &_readSet)) {
+                while(lwip_recv(m_iWakeSocket, _cBuffer, sizeof(_cBuffer), MSG_DONTWAIT) > 0) { }
+            }
+
+            m_Lock.lock();
+            entry** _ppLink = &m_pEntries;
+
+            while(*_ppLink != NULL) {
+                entry* _pEntry = *_ppLink;
+
+                // on a error (a closed socket) all awaiter try again and get the error
+                if(_iReady < 0 || FD_ISSET(_pEntry->iSocket, &_readSet)) {
+                    *_ppLink = _pEntry->pNext;
+                    _pEntry->bLinked = false;
+
+                    _pEntry->pEvent->notify_all();
+                } else {
+                    _ppLink = &_pEntry->pNext;
+                }
+            }
+            m_Lock.unlock();
+        }
+    }
+}
+
+#endif // MN_THREAD_CONFIG_COROUTINE
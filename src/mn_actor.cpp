@@ -0,0 +1,265 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+#include "mn_actor.hpp"
+
+#include <stdio.h>
+
+namespace mn {
+    namespace ext {
+        //-----------------------------------
+        //  basic_actor_base::basic_actor_base
+        //-----------------------------------
+        basic_actor_base::basic_actor_base(actor_overflow overflow, actor_directive directive)
+            : m_pSystem(NULL), m_eOverflow(overflow), m_eDirective(directive),
+              m_uiScheduled(0), m_bStopped(false), m_bStopDone(false),
+              m_uiRestarts(0), m_uiProcessed(0) { }
+
+        //-----------------------------------
+        //  basic_actor_base::stop
+        //-----------------------------------
+        void basic_actor_base::stop() {
+            m_bStopped = true;
+
+            // a worker calls on_stop and drains the mailbox
+            schedule();
+        }
+
+        //-----------------------------------
+        //  basic_actor_base::schedule
+        //-----------------------------------
+        int basic_actor_base::schedule() {
+            if(m_pSystem == NULL) return ERR_ACTOR_NOSYSTEM;
+
+            uint32_t _uiExpected = 0;
+
+            // already in the ready queue or running, the worker checks the mailbox again
+            if(!m_uiScheduled.compare_exchange_strong(_uiExpected, 1))
+                return ERR_ACTOR_OK;
+
+            return m_pSystem->schedule(this);
+        }
+
+        //-----------------------------------
+        //  basic_actor_base::failed
+        //-----------------------------------
+        void basic_actor_base::failed(int error) {
+            actor_directive _eDirective = m_pSystem->on_failure(*this, error);
+
+            if(_eDirective == actor_directive::Restart) {
+                if(m_uiRestarts >= MN_THREAD_CONFIG_ACTOR_MAX_RESTARTS) {
+                    _eDirective = actor_directive::Stop;
+                } else {
+                    m_uiRestarts++;
+                    on_restart(error);
+                }
+            }
+            if(_eDirective == actor_directive::Stop)
+                m_bStopped = true;
+        }
+
+        //-----------------------------------
+        //  basic_actor_base::run
+        //-----------------------------------
+        void basic_actor_base::run() {
+            if(!m_bStopped)
+                m_uiProcessed += process(MN_THREAD_CONFIG_ACTOR_THROUGHPUT);
+
+            if(m_bStopped) {
+                if(!m_bStopDone) {
+                    m_bStopDone = true;
+                    on_stop();
+
+                    // release the slot, without the system mutex: destroy holds it while joining the workers
+                    m_pSystem->m_uiActors.fetch_sub(1);
+                }
+                drain(ERR_ACTOR_STOPPED);
+            }
+            m_uiScheduled.store(0);
+
+            // a message posted while running has not scheduled the actor
+            if(has_messages())
+                schedule();
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::basic_actor_system
+        //-----------------------------------
+        basic_actor_system::basic_actor_system(basic_task::priority uiPriority, uint16_t usStackDepth)
+            : m_qeReady(MN_THREAD_CONFIG_ACTOR_MAX_ACTORS + MN_THREAD_CONFIG_ACTOR_WORKERS,
+                        sizeof(basic_actor_base*)),
+              m_mutex(),
+              m_uiPriority(uiPriority),
+              m_usStackDepth(usStackDepth),
+              m_uiWorkers(0),
+              m_uiActors(0),
+              m_bRunning(false) {
+
+            for(int i = 0; i < MN_THREAD_CONFIG_ACTOR_WORKERS; i++) {
+                m_pWorkers[i] = NULL;
+                m_hWorkers[i] = NULL;
+            }
+
+            // created here, so actors can spawned and scheduled before create
+            m_qeReady.create();
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::~basic_actor_system
+        //-----------------------------------
+        basic_actor_system::~basic_actor_system() {
+            destroy();
+            m_qeReady.destroy();
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::create
+        //-----------------------------------
+        int basic_actor_system::create(int iCore) {
+            automutx_t lock(m_mutex);
+
+            if(m_bRunning) return ERR_ACTOR_ALREADYINIT;
+
+            m_bRunning = true;
+
+            char _name[24];
+
+            for(int i = 0; i < MN_THREAD_CONFIG_ACTOR_WORKERS; i++) {
+                snprintf(_name, sizeof(_name), "actor_%d", i);
+
+                worker_task* _pWorker = new worker_task(_name, m_uiPriority, m_usStackDepth, this);
+                if(_pWorker == NULL) continue;
+
+                if(_pWorker->start(iCore) != ERR_TASK_OK) {
+                    delete _pWorker;
+                    continue;
+                }
+                m_hWorkers[m_uiWorkers] = _pWorker->get_handle();
+                m_pWorkers[m_uiWorkers++] = _pWorker;
+            }
+
+            if(m_uiWorkers == 0) {
+                m_bRunning = false;
+                return ERR_ACTOR_CANTCREATE;
+            }
+            return ERR_ACTOR_OK;
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::destroy
+        //-----------------------------------
+        void basic_actor_system::destroy() {
+            automutx_t lock(m_mutex);
+
+            if(!m_bRunning) return;
+            m_bRunning = false;
+
+            // a NULL actor wakes a waiting worker, so it sees the running flag
+            basic_actor_base* _pWakeup = NULL;
+
+            for(int i = 0; i < m_uiWorkers; i++)
+                m_qeReady.enqueue(&_pWakeup, portMAX_DELAY);
+
+            for(int i = 0; i < m_uiWorkers; i++) {
+                m_pWorkers[i]->join();
+                delete m_pWorkers[i];
+                m_pWorkers[i] = NULL;
+                m_hWorkers[i] = NULL;
+            }
+            m_uiWorkers = 0;
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::spawn
+        //-----------------------------------
+        int basic_actor_system::spawn(basic_actor_base& actor) {
+            automutx_t lock(m_mutex);
+
+            if(actor.m_pSystem != NULL) return ERR_ACTOR_ALREADYINIT;
+            if(m_uiActors.load() >= MN_THREAD_CONFIG_ACTOR_MAX_ACTORS) return ERR_ACTOR_TOOMANY;
+
+            if(actor.create_mailbox() != ERR_ACTOR_OK) return ERR_ACTOR_CANTCREATE;
+
+            actor.on_start();
+
+            m_uiActors.fetch_add(1);
+            actor.m_pSystem = this;
+
+            return ERR_ACTOR_OK;
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::is_worker
+        //-----------------------------------
+        bool basic_actor_system::is_worker() const {
+            xTaskHandle _hSelf = xTaskGetCurrentTaskHandle();
+
+            for(int i = 0; i < MN_THREAD_CONFIG_ACTOR_WORKERS; i++) {
+                if(m_hWorkers[i] != NULL && m_hWorkers[i] == _hSelf)
+                    return true;
+            }
+            return false;
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::on_failure
+        //-----------------------------------
+        actor_directive basic_actor_system::on_failure(basic_actor_base& actor, int error) {
+            MN_UNUSED_VARIABLE(error);
+
+            return actor.m_eDirective;
+        }
+
+        //-----------------------------------
+        //  basic_actor_system::schedule
+        //-----------------------------------
+        int basic_actor_system::schedule(basic_actor_base* actor) {
+            // each actor is only once in the ready queue, so the queue is never full
+            int _iError = m_qeReady.enqueue(&actor, portMAX_DELAY);
+
+            return (_iError == ERR_QUEUE_OK) ? ERR_ACTOR_OK : ERR_ACTOR_FULL;
+        }
+
+        //-----------------------------------
+        //  worker_task::worker_task
+        //-----------------------------------
+        basic_actor_system::worker_task::worker_task(const char* strName, basic_task::priority uiPriority,
+                                                     uint16_t usStackDepth, basic_actor_system* pSystem)
+            : basic_task(strName, uiPriority, usStackDepth), m_pSystem(pSystem) { }
+
+        //-----------------------------------
+        //  worker_task::on_task
+        //-----------------------------------
+        int basic_actor_system::worker_task::on_task() {
+            basic_actor_base* _pActor;
+
+            while(m_pSystem->m_bRunning) {
+                _pActor = NULL;
+
+                if(m_pSystem->m_qeReady.dequeue(&_pActor, portMAX_DELAY) != ERR_QUEUE_OK)
+                    continue;
+
+                // NULL is the wakeup from destroy
+                if(_pActor != NULL)
+                    _pActor->run();
+            }
+            return ERR_TASK_OK;
+        }
+    }
+}
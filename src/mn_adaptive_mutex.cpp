@@ -0,0 +1,277 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "mn_adaptive_mutex.hpp"
+
+/// The lowest bit of the owner word: the holder of the FreeRTOS mutex waits for a fast path owner
+#define MN_ADAPTIVE_MUTEX_WAITERS      uintptr_t(1)
+/// The owner holds the FreeRTOS mutex, it got the lock over the blocking path
+#define MN_ADAPTIVE_MUTEX_KERNEL       uintptr_t(2)
+/// The owner, when the lock is taken before the scheduler is started
+#define MN_ADAPTIVE_MUTEX_NO_TASK      uintptr_t(4)
+/// The lock is free, but reserved for the tasks in the blocking path
+#define MN_ADAPTIVE_MUTEX_HANDOFF      uintptr_t(8)
+/// Mask for the flags of the owner word
+#define MN_ADAPTIVE_MUTEX_FLAGS        (MN_ADAPTIVE_MUTEX_WAITERS | MN_ADAPTIVE_MUTEX_KERNEL)
+
+namespace mn {
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_adaptive_mutex::basic_adaptive_mutex()
+    : m_uiOwner(0), m_uiWaiting(0), m_pWaiter(NULL) {
+
+  #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+    m_pMutex = xSemaphoreCreateMutexStatic(&m_MutexBuffer);
+  #else
+    m_pMutex = xSemaphoreCreateMutex();
+  #endif
+  }
+
+  //-----------------------------------
+  //  deconstrutor
+  //-----------------------------------
+  basic_adaptive_mutex::~basic_adaptive_mutex() {
+    if (m_pMutex != NULL)
+      vSemaphoreDelete(m_pMutex);
+  }
+
+  //-----------------------------------
+  //  try_lock
+  //-----------------------------------
+  bool basic_adaptive_mutex::try_lock() {
+    if (xPortInIsrContext()) return false;
+
+    uintptr_t _self = uintptr_t(xTaskGetCurrentTaskHandle());
+    uintptr_t _expected = 0;
+
+    if(_self == 0) _self = MN_ADAPTIVE_MUTEX_NO_TASK;
+
+    return __atomic_compare_exchange_n(&m_uiOwner, &_expected, _self, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+  }
+
+  //-----------------------------------
+  //  lock
+  //-----------------------------------
+  int basic_adaptive_mutex::lock(unsigned int timeout) {
+    if (xPortInIsrContext()) return ERR_MUTEX_LOCK;
+
+    TaskHandle_t _pSelf = xTaskGetCurrentTaskHandle();
+    uintptr_t _self = (_pSelf == NULL) ? MN_ADAPTIVE_MUTEX_NO_TASK : uintptr_t(_pSelf);
+    uintptr_t _expected = 0;
+
+    // fast path, uncontended
+    if(__atomic_compare_exchange_n(&m_uiOwner, &_expected, _self, false,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      MN_LOCK_PROFILE_ACQUIRED();
+      return ERR_MUTEX_OK;
+    }
+
+    MN_LOCK_PROFILE_START(_uiProfileStart);
+    int _ret = ERR_MUTEX_LOCK;
+
+    // no task can't block
+    if(timeout != 0 && _pSelf != NULL)
+      _ret = spin(_pSelf) ? ERR_MUTEX_OK : lock_slow(_pSelf, timeout);
+
+    MN_LOCK_PROFILE_CONTENDED(_uiProfileStart, _ret == ERR_MUTEX_OK);
+    return _ret;
+  }
+
+  //-----------------------------------
+  //  spin
+  //-----------------------------------
+  bool basic_adaptive_mutex::spin(TaskHandle_t pSelf) {
+  #if portNUM_PROCESSORS > 1
+    uintptr_t _owner = __atomic_load_n(&m_uiOwner, __ATOMIC_RELAXED) & ~MN_ADAPTIVE_MUTEX_FLAGS;
+
+    // only when the owner is running, this task runs on this core - the owner on the other
+    if(_owner == 0 || _owner == MN_ADAPTIVE_MUTEX_NO_TASK || _owner == MN_ADAPTIVE_MUTEX_HANDOFF ||
+       eTaskGetState(TaskHandle_t(_owner)) != eRunning) return false;
+
+    for(unsigned int i = 0; i < MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN; i++) {
+      uintptr_t _current = __atomic_load_n(&m_uiOwner, __ATOMIC_RELAXED);
+
+      if(_current == 0) {
+        if(__atomic_compare_exchange_n(&m_uiOwner, &_current, uintptr_t(pSelf), false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+          return true;
+      } else if( (_current & ~MN_ADAPTIVE_MUTEX_FLAGS) != _owner ) {
+        // a new owner or the lock is handed over to a waiter, the waiters are served first
+        return false;
+      }
+    }
+  #else
+    (void)pSelf;
+  #endif
+    return false;
+  }
+
+  //-----------------------------------
+  //  lock_slow
+  //-----------------------------------
+  int basic_adaptive_mutex::lock_slow(TaskHandle_t pSelf, unsigned int timeout) {
+    if(m_pMutex == NULL) return ERR_MUTEX_LOCK;
+
+    // from now on the unlock hands the lock over to the blocking path
+    __atomic_add_fetch(&m_uiWaiting, 1, __ATOMIC_SEQ_CST);
+
+    TickType_t _xStart = xTaskGetTickCount();
+
+    // the kernel queues the waiters by priority and raise the holder of the mutex
+    if(xSemaphoreTake(m_pMutex, timeout) != pdTRUE) {
+      leave_slow();
+      return ERR_MUTEX_LOCK;
+    }
+
+    // this task holds the FreeRTOS mutex, wait for the owner of the fast path
+    for(;;) {
+      uintptr_t _current = __atomic_load_n(&m_uiOwner, __ATOMIC_RELAXED);
+
+      if(_current == 0 || _current == MN_ADAPTIVE_MUTEX_HANDOFF) {
+        if(__atomic_compare_exchange_n(&m_uiOwner, &_current, uintptr_t(pSelf) | MN_ADAPTIVE_MUTEX_KERNEL,
+                                       false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+          break;
+        continue;
+      }
+
+      if( (_current & MN_ADAPTIVE_MUTEX_WAITERS) == 0 ) {
+        // the unlock of the fast path owner notify this task
+        __atomic_store_n(&m_pWaiter, pSelf, __ATOMIC_RELAXED);
+
+        if(!__atomic_compare_exchange_n(&m_uiOwner, &_current, _current | MN_ADAPTIVE_MUTEX_WAITERS,
+                                        false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+          continue;
+      }
+
+      TickType_t _xLeft = portMAX_DELAY;
+
+      if(timeout != portMAX_DELAY) {
+        TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+
+        if(_xElapsed >= timeout) {
+          // timeout - remove the flag, when the lock is not handed over meanwhile
+          _current |= MN_ADAPTIVE_MUTEX_WAITERS;
+
+          if(!__atomic_compare_exchange_n(&m_uiOwner, &_current, _current & ~MN_ADAPTIVE_MUTEX_WAITERS,
+                                          false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            continue;
+
+          xSemaphoreGive(m_pMutex);
+          leave_slow();
+          return ERR_MUTEX_LOCK;
+        }
+        _xLeft = timeout - _xElapsed;
+      }
+      ulTaskNotifyTake(pdTRUE, _xLeft);
+    }
+
+    __atomic_sub_fetch(&m_uiWaiting, 1, __ATOMIC_SEQ_CST);
+    return ERR_MUTEX_OK;
+  }
+
+  //-----------------------------------
+  //  leave_slow
+  //-----------------------------------
+  void basic_adaptive_mutex::leave_slow() {
+    // the last waiter gives a handed over lock free for the fast path
+    if(__atomic_sub_fetch(&m_uiWaiting, 1, __ATOMIC_SEQ_CST) == 0) {
+      uintptr_t _expected = MN_ADAPTIVE_MUTEX_HANDOFF;
+
+      __atomic_compare_exchange_n(&m_uiOwner, &_expected, 0, false,
+                                  __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    }
+  }
+
+  //-----------------------------------
+  //  time_lock
+  //-----------------------------------
+  int basic_adaptive_mutex::time_lock(const struct timespec *timeout) {
+    struct timespec currtime;
+    clock_gettime(CLOCK_REALTIME, &currtime);
+
+    TickType_t _time = ((timeout->tv_sec - currtime.tv_sec)*1000 +
+                      (timeout->tv_nsec - currtime.tv_nsec)/1000000)/portTICK_PERIOD_MS;
+
+    return lock(_time);
+  }
+
+  //-----------------------------------
+  //  unlock
+  //-----------------------------------
+  int basic_adaptive_mutex::unlock() {
+    if (xPortInIsrContext()) return ERR_MUTEX_UNLOCK;
+
+    TaskHandle_t _pSelf = xTaskGetCurrentTaskHandle();
+    uintptr_t _self = (_pSelf == NULL) ? MN_ADAPTIVE_MUTEX_NO_TASK : uintptr_t(_pSelf);
+    uintptr_t _current = __atomic_load_n(&m_uiOwner, __ATOMIC_RELAXED);
+    uintptr_t _free;
+
+    for(;;) {
+      if( (_current & ~MN_ADAPTIVE_MUTEX_FLAGS) != _self ) return ERR_MUTEX_UNLOCK;
+
+      // with waiters in the blocking path, the fast path stay closed
+      _free = (__atomic_load_n(&m_uiWaiting, __ATOMIC_SEQ_CST) != 0) ? MN_ADAPTIVE_MUTEX_HANDOFF : 0;
+
+      if(__atomic_compare_exchange_n(&m_uiOwner, &_current, _free, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        break;
+    }
+    MN_LOCK_PROFILE_RELEASED();
+
+    // all waiters have given up meanwhile
+    if(_free == MN_ADAPTIVE_MUTEX_HANDOFF && __atomic_load_n(&m_uiWaiting, __ATOMIC_SEQ_CST) == 0) {
+      __atomic_compare_exchange_n(&m_uiOwner, &_free, 0, false,
+                                  __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    }
+
+    if(_current & MN_ADAPTIVE_MUTEX_KERNEL) {
+      // the kernel gives the mutex to the waiter with the highest priority and restore our priority
+      xSemaphoreGive(m_pMutex);
+    } else if(_current & MN_ADAPTIVE_MUTEX_WAITERS) {
+      xTaskNotifyGive(__atomic_load_n(&m_pWaiter, __ATOMIC_RELAXED));
+    }
+
+    return ERR_MUTEX_OK;
+  }
+
+  //-----------------------------------
+  //  is_locked
+  //-----------------------------------
+  bool basic_adaptive_mutex::is_locked() const {
+    uintptr_t _owner = __atomic_load_n(&m_uiOwner, __ATOMIC_RELAXED);
+
+    return _owner != 0 && _owner != MN_ADAPTIVE_MUTEX_HANDOFF;
+  }
+
+  //-----------------------------------
+  //  get_owner
+  //-----------------------------------
+  TaskHandle_t basic_adaptive_mutex::get_owner() const {
+    uintptr_t _owner = __atomic_load_n(&m_uiOwner, __ATOMIC_RELAXED) & ~MN_ADAPTIVE_MUTEX_FLAGS;
+
+    return (_owner == MN_ADAPTIVE_MUTEX_NO_TASK || _owner == MN_ADAPTIVE_MUTEX_HANDOFF) ? NULL : TaskHandle_t(_owner);
+  }
+}
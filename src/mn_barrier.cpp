@@ -0,0 +1,107 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include "mn_barrier.hpp"
+
+/// The event group bit of the given phase, the even and the odd phases use a own bit
+#define MN_BARRIER_PHASE_BIT(phase)     EventBits_t(1 << ((phase) & 1))
+
+namespace mn {
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_barrier::basic_barrier(uint32_t expected, completion_t fnCompletion, void* arg)
+    : m_uiExpected(expected), m_uiRemaining(expected), m_uiPhase(0),
+      m_fnCompletion(fnCompletion), m_pArg(arg), m_eventGroup("barrier") {
+
+    m_eventGroup.create();
+  }
+
+  //-----------------------------------
+  //  arrive
+  //-----------------------------------
+  uint32_t basic_barrier::arrive() {
+    return arrive_internal(0);
+  }
+
+  //-----------------------------------
+  //  arrive_and_drop
+  //-----------------------------------
+  uint32_t basic_barrier::arrive_and_drop() {
+    return arrive_internal(1);
+  }
+
+  //-----------------------------------
+  //  arrive
+  //-----------------------------------
+  uint32_t basic_barrier::arrive_internal(uint32_t drop) {
+    // the phase can not change, before this participant has arrived
+    uint32_t _uiPhase = m_uiPhase.load(memory_order::Acquire);
+
+    if(drop != 0) m_uiExpected.fetch_sub(drop, memory_order::Relaxed);
+
+    if(m_uiRemaining.fetch_sub(1, memory_order::AcqRel) == 1) {
+      on_completion(_uiPhase);
+
+      m_uiRemaining.store(m_uiExpected.load(memory_order::Relaxed), memory_order::Relaxed);
+
+      // the bit of the next phase is set from the phase before
+      m_eventGroup.clear(MN_BARRIER_PHASE_BIT(_uiPhase + 1));
+      m_uiPhase.store(_uiPhase + 1, memory_order::Release);
+
+      // one kernel call wakes all waiting participants
+      m_eventGroup.set(MN_BARRIER_PHASE_BIT(_uiPhase));
+    }
+    return _uiPhase;
+  }
+
+  //-----------------------------------
+  //  wait
+  //-----------------------------------
+  int basic_barrier::wait(uint32_t phase, unsigned int timeout) {
+    if(m_uiPhase.load(memory_order::Acquire) != phase) return ERR_BARRIER_OK;
+    if(!m_eventGroup.is_init()) return ERR_BARRIER_NOTCREATED;
+
+    EventBits_t _uxBit = MN_BARRIER_PHASE_BIT(phase);
+    EventBits_t _uxBits = m_eventGroup.wait(_uxBit, false, true, timeout);
+
+    return (_uxBits & _uxBit) ? ERR_BARRIER_OK : ERR_BARRIER_TIMEOUT;
+  }
+
+  //-----------------------------------
+  //  arrive_and_wait
+  //-----------------------------------
+  int basic_barrier::arrive_and_wait(unsigned int timeout) {
+    return wait(arrive(), timeout);
+  }
+
+  //-----------------------------------
+  //  on_completion
+  //-----------------------------------
+  void basic_barrier::on_completion(uint32_t phase) {
+    (void)phase;
+
+    if(m_fnCompletion != nullptr)
+      m_fnCompletion(this, m_pArg);
+  }
+}
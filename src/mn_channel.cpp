@@ -0,0 +1,389 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+#include "mn_channel.hpp"
+
+#include <string.h>
+
+/// The select state is not won
+#define MN_CHANNEL_WINNER_NONE      (-3)
+/// The select found a ready channel while registration and tries again
+#define MN_CHANNEL_WINNER_RETRY     (-4)
+
+namespace mn {
+    //-----------------------------------
+    //  basic_channel_base
+    //-----------------------------------
+    basic_channel_base::basic_channel_base(uint32_t uiItemSize, void* pBuffer, uint32_t uiCapacity)
+        : m_pBuffer(static_cast<uint8_t*>(pBuffer)),
+          m_uiItemSize(uiItemSize),
+          m_uiCapacity(uiCapacity),
+          m_uiHead(0),
+          m_uiCount(0),
+          m_bClosed(false) {
+
+        vPortCPUInitializeMutex(&m_Mux);
+        m_Senders.pFirst = m_Senders.pLast = NULL;
+        m_Receivers.pFirst = m_Receivers.pLast = NULL;
+    }
+
+    //-----------------------------------
+    //  send_item
+    //-----------------------------------
+    int basic_channel_base::send_item(const void* pItem, TickType_t timeout) {
+        bool _bOk = true;
+        channel_case _case = { this, const_cast<void*>(pItem), &_bOk, true };
+        waiter _node;
+
+        int _iRet = select(&_case, &_node, 1, timeout);
+
+        if(_iRet == 0) return _bOk ? ERR_CHANNEL_OK : ERR_CHANNEL_CLOSED;
+        return (_iRet == channel_select_timeout) ? ERR_CHANNEL_TIMEOUT : ERR_CHANNEL_NOTASK;
+    }
+
+    //-----------------------------------
+    //  recv_item
+    //-----------------------------------
+    int basic_channel_base::recv_item(void* pItem, TickType_t timeout) {
+        bool _bOk = true;
+        channel_case _case = { this, pItem, &_bOk, false };
+        waiter _node;
+
+        int _iRet = select(&_case, &_node, 1, timeout);
+
+        if(_iRet == 0) return _bOk ? ERR_CHANNEL_OK : ERR_CHANNEL_CLOSED;
+        return (_iRet == channel_select_timeout) ? ERR_CHANNEL_TIMEOUT : ERR_CHANNEL_NOTASK;
+    }
+
+    //-----------------------------------
+    //  close
+    //-----------------------------------
+    void basic_channel_base::close() {
+        TaskHandle_t _pTasks[8];
+        bool _bMore = true;
+
+        // wake in batches, so no allocation is needed
+        while(_bMore) {
+            int _iCount = 0;
+
+            portENTER_CRITICAL_SAFE(&m_Mux);
+            m_bClosed = true;
+
+            while(_iCount < 8) {
+                waiter* _pWaiter = claim_first(m_Receivers);
+                if(_pWaiter == NULL) _pWaiter = claim_first(m_Senders);
+                if(_pWaiter == NULL) break;
+
+                _pWaiter->bOk = false;
+                _pTasks[_iCount++] = _pWaiter->pState->pTask;
+            }
+            _bMore = (m_Receivers.pFirst != NULL || m_Senders.pFirst != NULL);
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+
+            for(int i = 0; i < _iCount; i++)
+                wake(_pTasks[i]);
+        }
+    }
+
+    //-----------------------------------
+    //  select
+    //-----------------------------------
+    int basic_channel_base::select(channel_case* cases, waiter* nodes, uint32_t uiCount, TickType_t timeout) {
+        static volatile uint32_t s_uiRotation = 0;
+
+        if(uiCount == 0) return channel_select_error;
+
+        // start on a other case each time, so no case is starved
+        uint32_t _uiStart = __atomic_fetch_add(&s_uiRotation, 1, __ATOMIC_RELAXED) % uiCount;
+
+        TickType_t _xStart = xTaskGetTickCount();
+        TickType_t _xRemaining = timeout;
+
+        while(true) {
+            // 1. run the first ready case
+            for(uint32_t k = 0; k < uiCount; k++) {
+                uint32_t i = (_uiStart + k) % uiCount;
+                TaskHandle_t _pWake = NULL;
+
+                if(cases[i].pChannel->try_case(cases[i], _pWake)) {
+                    wake(_pWake);
+                    return (int)i;
+                }
+            }
+            if(_xRemaining == 0) return channel_select_timeout;
+
+            if(xPortInIsrContext()) return channel_select_error;
+
+            select_state _state;
+            _state.pTask = xTaskGetCurrentTaskHandle();
+            _state.iWinner = MN_CHANNEL_WINNER_NONE;
+
+            if(_state.pTask == NULL) return channel_select_error;
+
+            // 2. wait on all channels, a channel that became ready since 1. breaks
+            uint32_t _uiRegistered = 0;
+            bool _bReady = false;
+
+            for(; _uiRegistered < uiCount; _uiRegistered++) {
+                basic_channel_base* _pChannel = cases[_uiRegistered].pChannel;
+                waiter* _pNode = &nodes[_uiRegistered];
+
+                portENTER_CRITICAL_SAFE(&_pChannel->m_Mux);
+
+                if(_pChannel->is_ready(cases[_uiRegistered], &_state)) {
+                    portEXIT_CRITICAL_SAFE(&_pChannel->m_Mux);
+                    _bReady = true;
+                    break;
+                }
+
+                _pNode->pState = &_state;
+                _pNode->pItem = cases[_uiRegistered].pItem;
+                _pNode->iIndex = (int32_t)_uiRegistered;
+                _pNode->bOk = false;
+
+                link(cases[_uiRegistered].bSend ? _pChannel->m_Senders : _pChannel->m_Receivers, _pNode);
+
+                portEXIT_CRITICAL_SAFE(&_pChannel->m_Mux);
+            }
+
+            int32_t _iExpected = MN_CHANNEL_WINNER_NONE;
+
+            if(!_bReady) {
+                while(__atomic_load_n(&_state.iWinner, __ATOMIC_ACQUIRE) == MN_CHANNEL_WINNER_NONE) {
+                    if(timeout != portMAX_DELAY) {
+                        TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                        if(_xElapsed >= timeout) break;
+                        _xRemaining = timeout - _xElapsed;
+                    }
+                    ulTaskNotifyTake(pdTRUE, _xRemaining);
+                }
+                __atomic_compare_exchange_n(&_state.iWinner, &_iExpected, (int32_t)channel_select_timeout,
+                                            false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+            } else {
+                __atomic_compare_exchange_n(&_state.iWinner, &_iExpected, (int32_t)MN_CHANNEL_WINNER_RETRY,
+                                            false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+            }
+
+            // 3. remove the nodes, the lock waits for a channel that is copying the item
+            for(uint32_t i = 0; i < _uiRegistered; i++) {
+                basic_channel_base* _pChannel = cases[i].pChannel;
+
+                portENTER_CRITICAL_SAFE(&_pChannel->m_Mux);
+                if(nodes[i].bLinked)
+                    unlink(cases[i].bSend ? _pChannel->m_Senders : _pChannel->m_Receivers, &nodes[i]);
+                portEXIT_CRITICAL_SAFE(&_pChannel->m_Mux);
+            }
+
+            int32_t _iWinner = __atomic_load_n(&_state.iWinner, __ATOMIC_ACQUIRE);
+
+            if(_iWinner >= 0) {
+                if(cases[_iWinner].pOk) *cases[_iWinner].pOk = nodes[_iWinner].bOk;
+                return (int)_iWinner;
+            }
+            if(_iWinner == channel_select_timeout) return channel_select_timeout;
+
+            // retry with the rest of the timeout
+            if(timeout != portMAX_DELAY) {
+                TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                _xRemaining = (_xElapsed >= timeout) ? 0 : timeout - _xElapsed;
+            }
+        }
+    }
+
+    //-----------------------------------
+    //  try_case
+    //-----------------------------------
+    bool basic_channel_base::try_case(channel_case& c, TaskHandle_t& pWake) {
+        bool _bDone, _bOk = true;
+
+        portENTER_CRITICAL_SAFE(&m_Mux);
+        if(c.bSend) {
+            if(m_bClosed) {
+                _bOk = false;
+                _bDone = true;
+            } else {
+                _bDone = try_send(c.pItem, pWake);
+            }
+        } else {
+            _bDone = try_recv(c.pItem, _bOk, pWake);
+        }
+        portEXIT_CRITICAL_SAFE(&m_Mux);
+
+        if(_bDone && c.pOk) *c.pOk = _bOk;
+        return _bDone;
+    }
+
+    //-----------------------------------
+    //  is_ready
+    //-----------------------------------
+    bool basic_channel_base::is_ready(const channel_case& c, const select_state* pOwn) {
+        if(m_bClosed) return true;
+        if(c.bSend ? (m_uiCount < m_uiCapacity) : (m_uiCount > 0)) return true;
+
+        // a waiting partner, that is not a case of the same select
+        for(waiter* w = c.bSend ? m_Receivers.pFirst : m_Senders.pFirst; w != NULL; w = w->pNext) {
+            if(w->pState != pOwn &&
+               __atomic_load_n(&w->pState->iWinner, __ATOMIC_ACQUIRE) == MN_CHANNEL_WINNER_NONE)
+                return true;
+        }
+        return false;
+    }
+
+    //-----------------------------------
+    //  try_send
+    //-----------------------------------
+    bool basic_channel_base::try_send(const void* pItem, TaskHandle_t& pWake) {
+        waiter* _pWaiter = claim_first(m_Receivers);
+
+        if(_pWaiter != NULL) {
+            // give the item direct to the waiting receiver
+            memcpy(_pWaiter->pItem, pItem, m_uiItemSize);
+            _pWaiter->bOk = true;
+            pWake = _pWaiter->pState->pTask;
+            return true;
+        }
+        if(m_uiCount < m_uiCapacity) {
+            uint32_t _uiTail = (m_uiHead + m_uiCount) % m_uiCapacity;
+
+            memcpy(m_pBuffer + _uiTail * m_uiItemSize, pItem, m_uiItemSize);
+            m_uiCount++;
+            return true;
+        }
+        return false;
+    }
+
+    //-----------------------------------
+    //  try_recv
+    //-----------------------------------
+    bool basic_channel_base::try_recv(void* pItem, bool& bOk, TaskHandle_t& pWake) {
+        waiter* _pWaiter;
+
+        if(m_uiCount > 0) {
+            memcpy(pItem, m_pBuffer + m_uiHead * m_uiItemSize, m_uiItemSize);
+            m_uiHead = (m_uiHead + 1) % m_uiCapacity;
+            m_uiCount--;
+
+            // move the item of a waiting sender in the free place
+            _pWaiter = claim_first(m_Senders);
+
+            if(_pWaiter != NULL) {
+                uint32_t _uiTail = (m_uiHead + m_uiCount) % m_uiCapacity;
+
+                memcpy(m_pBuffer + _uiTail * m_uiItemSize, _pWaiter->pItem, m_uiItemSize);
+                m_uiCount++;
+
+                _pWaiter->bOk = true;
+                pWake = _pWaiter->pState->pTask;
+            }
+            bOk = true;
+            return true;
+        }
+
+        _pWaiter = claim_first(m_Senders);
+
+        if(_pWaiter != NULL) {
+            // take the item direct from the waiting sender
+            memcpy(pItem, _pWaiter->pItem, m_uiItemSize);
+            _pWaiter->bOk = true;
+            pWake = _pWaiter->pState->pTask;
+
+            bOk = true;
+            return true;
+        }
+        if(m_bClosed) {
+            bOk = false;
+            return true;
+        }
+        return false;
+    }
+
+    //-----------------------------------
+    //  claim_first
+    //-----------------------------------
+    basic_channel_base::waiter* basic_channel_base::claim_first(waiter_list& list) {
+        waiter* _pWaiter = list.pFirst;
+
+        while(_pWaiter != NULL) {
+            waiter* _pNext = _pWaiter->pNext;
+
+            // a node of a select, that is won or timed out, is removed too
+            unlink(list, _pWaiter);
+            if(claim(_pWaiter)) return _pWaiter;
+
+            _pWaiter = _pNext;
+        }
+        return NULL;
+    }
+
+    //-----------------------------------
+    //  claim
+    //-----------------------------------
+    bool basic_channel_base::claim(waiter* w) {
+        int32_t _iExpected = MN_CHANNEL_WINNER_NONE;
+
+        return __atomic_compare_exchange_n(&w->pState->iWinner, &_iExpected, w->iIndex,
+                                           false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+
+    //-----------------------------------
+    //  link
+    //-----------------------------------
+    void basic_channel_base::link(waiter_list& list, waiter* w) {
+        w->pNext = NULL;
+        w->pPrev = list.pLast;
+
+        if(list.pLast) list.pLast->pNext = w;
+        else list.pFirst = w;
+
+        list.pLast = w;
+        w->bLinked = true;
+    }
+
+    //-----------------------------------
+    //  unlink
+    //-----------------------------------
+    void basic_channel_base::unlink(waiter_list& list, waiter* w) {
+        if(w->pPrev) w->pPrev->pNext = w->pNext;
+        else list.pFirst = w->pNext;
+
+        if(w->pNext) w->pNext->pPrev = w->pPrev;
+        else list.pLast = w->pPrev;
+
+        w->pNext = w->pPrev = NULL;
+        w->bLinked = false;
+    }
+
+    //-----------------------------------
+    //  wake
+    //-----------------------------------
+    void basic_channel_base::wake(TaskHandle_t pTask) {
+        if(pTask == NULL) return;
+
+        if (xPortInIsrContext()) {
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+            vTaskNotifyGiveFromISR(pTask, &xHigherPriorityTaskWoken);
+
+            if(xHigherPriorityTaskWoken)
+                _frxt_setup_switch();
+        } else {
+            xTaskNotifyGive(pTask);
+        }
+    }
+}
@@ -19,8 +19,6 @@
 
 #if MN_THREAD_CONFIG_CONDITION_VARIABLE_SUPPORT == MN_THREAD_CONFIG_YES
 #include "mn_convar.hpp"
-#include "mn_convar_task.hpp"
-#include "mn_task_utils.hpp"
 
 namespace mn  {
     namespace ext {
@@ -28,48 +26,143 @@ namespace mn  {
         //  construtor
         //-----------------------------------
         basic_condition_variable::basic_condition_variable()
-            : m_mutex(), m_waitList() {
+            : m_pFirst(NULL), m_pLast(NULL) {
+
+            vPortCPUInitializeMutex(&m_Mux);
         }
 
         //-----------------------------------
-        //  add_list
+        //  wait
         //-----------------------------------
-        void basic_condition_variable::add_list(basic_convar_task *thread) {
-            automutx_t autolock(m_mutex);
+        int basic_condition_variable::wait(ILockObject& lock, TickType_t timeout) {
+            if(xPortInIsrContext()) return ERR_CONVAR_NOTASK;
+
+            waiter _waiter;
+            _waiter.pTask = xTaskGetCurrentTaskHandle();
+            _waiter.pNext = NULL;
+            _waiter.bSignaled = false;
+
+            if(_waiter.pTask == NULL) return ERR_CONVAR_NOTASK;
+
+            // enqueue before the lock is dropped, so no signal is lost
+            portENTER_CRITICAL_SAFE(&m_Mux);
+            if(m_pLast) m_pLast->pNext = &_waiter;
+            else m_pFirst = &_waiter;
+            m_pLast = &_waiter;
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+
+            lock.unlock();
+
+            TickType_t _xStart = xTaskGetTickCount();
+            TickType_t _xRemaining = timeout;
+
+            while(!__atomic_load_n(&_waiter.bSignaled, __ATOMIC_ACQUIRE)) {
+                ulTaskNotifyTake(pdTRUE, _xRemaining);
+
+                if(timeout == portMAX_DELAY) continue;
+
+                TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                if(_xElapsed >= timeout) break;
+                _xRemaining = timeout - _xElapsed;
+            }
+
+            int _iRet = ERR_CONVAR_OK;
+
+            if(!__atomic_load_n(&_waiter.bSignaled, __ATOMIC_ACQUIRE)) {
+                portENTER_CRITICAL_SAFE(&m_Mux);
+
+                if(!_waiter.bSignaled) {
+                    // timeout, the node is still listed, remove it
+                    waiter* _prev = NULL;
+                    waiter* _node = m_pFirst;
+
+                    while(_node && _node != &_waiter) { _prev = _node; _node = _node->pNext; }
+
+                    if(_node) {
+                        if(_prev) _prev->pNext = _waiter.pNext;
+                        else m_pFirst = _waiter.pNext;
+                        if(m_pLast == &_waiter) m_pLast = _prev;
+                    }
+                    _iRet = ERR_CONVAR_TIMEOUT;
+                }
+                portEXIT_CRITICAL_SAFE(&m_Mux);
+            }
+
+            lock.lock();
 
-            m_waitList.push_back(thread);
+            return _iRet;
         }
 
         //-----------------------------------
         //  signal
         //-----------------------------------
         void basic_condition_variable::signal() {
-            automutx_t autolock(m_mutex);
+            TaskHandle_t _pTask = NULL;
 
-            if ( !m_waitList.empty() ) {
-                basic_convar_task *thr = m_waitList.front();
-                m_waitList.pop_front();
+            portENTER_CRITICAL_SAFE(&m_Mux);
+            waiter* _waiter = m_pFirst;
 
-				thr->signal();
+            if(_waiter) {
+                m_pFirst = _waiter->pNext;
+                if(m_pFirst == NULL) m_pLast = NULL;
+
+                // copy the handle, the node is invalid after the flag is set
+                _pTask = _waiter->pTask;
+                __atomic_store_n(&_waiter->bSignaled, true, __ATOMIC_RELEASE);
             }
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+
+            if(_pTask) xTaskNotifyGive(_pTask);
         }
 
         //-----------------------------------
         //  broadcast
         //-----------------------------------
         void basic_condition_variable::broadcast() {
-            automutx_t autolock(m_mutex);
+            TaskHandle_t _pTasks[8];
+            bool _bMore = true;
+
+            // wake in batches, so no allocation is needed
+            while(_bMore) {
+                int _iCount = 0;
+
+                portENTER_CRITICAL_SAFE(&m_Mux);
+                while(m_pFirst && _iCount < 8) {
+                    waiter* _waiter = m_pFirst;
+                    m_pFirst = _waiter->pNext;
 
-            while ( !m_waitList.empty() ) {
-                basic_convar_task *thr = m_waitList.front();
-                m_waitList.pop_front();
+                    _pTasks[_iCount++] = _waiter->pTask;
+                    __atomic_store_n(&_waiter->bSignaled, true, __ATOMIC_RELEASE);
+                }
+                if(m_pFirst == NULL) { m_pLast = NULL; _bMore = false; }
+                portEXIT_CRITICAL_SAFE(&m_Mux);
 
-                thr->signal();
+                for(int i = 0; i < _iCount; i++)
+                    xTaskNotifyGive(_pTasks[i]);
             }
         }
-    }
-}
 
+        //-----------------------------------
+        //  to_ticks
+        //-----------------------------------
+        TickType_t basic_condition_variable::to_ticks(const timespan_t& span) {
+            uint64_t _xTicks = (span.get_total_milliseconds() * configTICK_RATE_HZ) / 1000U;
+
+            // portMAX_DELAY means forever, a time span is always finite
+            if(_xTicks >= portMAX_DELAY) return portMAX_DELAY - 1;
+            return (TickType_t)_xTicks;
+        }
+
+        //-----------------------------------
+        //  until_ticks
+        //-----------------------------------
+        TickType_t basic_condition_variable::until_ticks(const timespan_t& abs_time) {
+            timespan_t _now = timespan_t::now();
 
+            if(abs_time <= _now) return 0;
+            return to_ticks(abs_time - _now);
+        }
+    }
+}
 
 #endif
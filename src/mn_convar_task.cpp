@@ -34,18 +34,14 @@ namespace mn {
         //-----------------------------------
         basic_convar_task::basic_convar_task(std::string strName, basic_task::priority uiPriority,
             unsigned short  usStackDepth)
-            : basic_task(strName, uiPriority, usStackDepth), m_waitSem() {
+            : basic_task(strName, uiPriority, usStackDepth) {
 
-            m_waitSem.lock();
         }
 
         //-----------------------------------
         //  signal
         //-----------------------------------
         void basic_convar_task::signal() {
-            autolock_t autolock(m_runningMutex);
-            m_waitSem.unlock();
-
             task_utils::notify_give(this);
 
             on_signal();
@@ -54,18 +50,11 @@ namespace mn {
         //-----------------------------------
         //  wait
         //-----------------------------------
-        int basic_convar_task::wait(convar_t& cv, mutex_t& cvl, TickType_t timeOut)  {
-            autolock_t autolock(m_runningMutex);
-
-            cv.add_list(this);
-
-            cvl.unlock();
-            int ret = m_waitSem.lock(timeOut);
-            cvl.lock();
-
-            task_utils::notify_take(true, timeOut);
+        int basic_convar_task::wait(convar_t& cv, ILockObject& cvl, TickType_t timeOut)  {
+            if(xTaskGetCurrentTaskHandle() != get_handle())
+                return ERR_CONVAR_NOTASK;
 
-            return ret;
+            return cv.wait(cvl, timeOut);
         }
     }
 }
@@ -0,0 +1,292 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+#include "mn_event_bus.hpp"
+
+#include <freertos/task.h>
+
+namespace mn {
+    //-----------------------------------
+    //  basic_event_bus::basic_event_bus
+    //-----------------------------------
+    basic_event_bus::basic_event_bus()
+        : m_Lock(), m_pFree(NULL), m_uiSubscriptions(0), m_uiDropped(0) {
+
+        vPortCPUInitializeMutex(&m_IdleMux);
+
+        for(uint32_t i = 0; i < MN_THREAD_CONFIG_EVENTBUS_TOPICS; i++) {
+            m_Table[i].key = 0;
+            m_Table[i].bUsed = false;
+            m_Table[i].bWildcard = false;
+            m_Table[i].pFirst = NULL;
+        }
+        for(uint32_t i = 0; i < MN_THREAD_CONFIG_EVENTBUS_SUBSCRIPTIONS; i++) {
+            m_Subscriptions[i].pSubscriber = NULL;
+            m_Subscriptions[i].pNext = m_pFree;
+            m_pFree = &m_Subscriptions[i];
+        }
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::instance
+    //-----------------------------------
+    basic_event_bus& basic_event_bus::instance() {
+        static basic_event_bus _instance;
+        return _instance;
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::subscribe
+    //-----------------------------------
+    int basic_event_bus::subscribe(const topic& t, basic_bus_subscriber& subscriber) {
+        int _iRet = ERR_EVENTBUS_OK;
+
+        m_Lock.lock();
+
+        topic_slot* _pSlot = find_slot(t.id, t.wildcard, true);
+
+        if(_pSlot == NULL) {
+            _iRet = ERR_EVENTBUS_TABLEFULL;
+        } else {
+            for(subscription* _pSub = _pSlot->pFirst; _pSub != NULL; _pSub = _pSub->pNext) {
+                if(_pSub->pSubscriber == &subscriber) { _iRet = ERR_EVENTBUS_ALREADY; break; }
+            }
+        }
+
+        if(_iRet == ERR_EVENTBUS_OK) {
+            if(m_pFree == NULL) {
+                _iRet = ERR_EVENTBUS_NOSUBSCRIPTION;
+            } else {
+                subscription* _pSub = m_pFree;
+                m_pFree = _pSub->pNext;
+
+                // append, the subscribers are called in the subscribe order
+                _pSub->pSubscriber = &subscriber;
+                _pSub->pNext = NULL;
+
+                subscription** _ppLast = &_pSlot->pFirst;
+                while(*_ppLast != NULL) _ppLast = &(*_ppLast)->pNext;
+                *_ppLast = _pSub;
+
+                subscriber.m_pBus = this;
+                m_uiSubscriptions++;
+            }
+        }
+
+        m_Lock.unlock();
+        return _iRet;
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::unsubscribe
+    //-----------------------------------
+    int basic_event_bus::unsubscribe(const topic& t, basic_bus_subscriber& subscriber) {
+        int _iRet = ERR_EVENTBUS_NOTFOUND;
+
+        m_Lock.lock();
+
+        topic_slot* _pSlot = find_slot(t.id, t.wildcard, false);
+
+        if(_pSlot != NULL) {
+            for(subscription** _ppSub = &_pSlot->pFirst; *_ppSub != NULL; _ppSub = &(*_ppSub)->pNext) {
+                if((*_ppSub)->pSubscriber != &subscriber) continue;
+
+                subscription* _pSub = *_ppSub;
+                *_ppSub = _pSub->pNext;
+
+                _pSub->pSubscriber = NULL;
+                _pSub->pNext = m_pFree;
+                m_pFree = _pSub;
+
+                m_uiSubscriptions--;
+                _iRet = ERR_EVENTBUS_OK;
+                break;
+            }
+        }
+
+        m_Lock.unlock();
+
+        if(_iRet == ERR_EVENTBUS_OK) wait_idle(subscriber);
+        return _iRet;
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::unsubscribe_all
+    //-----------------------------------
+    uint32_t basic_event_bus::unsubscribe_all(basic_bus_subscriber& subscriber) {
+        uint32_t _uiRemoved = 0;
+
+        m_Lock.lock();
+
+        for(uint32_t i = 0; i < MN_THREAD_CONFIG_EVENTBUS_TOPICS; i++) {
+            subscription** _ppSub = &m_Table[i].pFirst;
+
+            while(*_ppSub != NULL) {
+                if((*_ppSub)->pSubscriber != &subscriber) { _ppSub = &(*_ppSub)->pNext; continue; }
+
+                subscription* _pSub = *_ppSub;
+                *_ppSub = _pSub->pNext;
+
+                _pSub->pSubscriber = NULL;
+                _pSub->pNext = m_pFree;
+                m_pFree = _pSub;
+
+                m_uiSubscriptions--;
+                _uiRemoved++;
+            }
+        }
+
+        m_Lock.unlock();
+
+        if(_uiRemoved > 0) wait_idle(subscriber);
+        return _uiRemoved;
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::publish_event
+    //-----------------------------------
+    uint32_t basic_event_bus::publish_event(const topic& t, const bus_event& ev) {
+        basic_bus_subscriber* _pList[MN_THREAD_CONFIG_EVENTBUS_FANOUT];
+        uint32_t _uiCount = 0;
+
+        // only subscribers can use wildcards
+        if(t.wildcard) return 0;
+
+        if(m_Lock.lock_shared() != NO_ERROR) return 0;
+
+        collect(find_slot(t.id, false, false), _pList, _uiCount);
+
+        for(uint8_t i = 0; i < t.depth; i++)
+            collect(find_slot(t.ancestors[i], true, false), _pList, _uiCount);
+
+        m_Lock.unlock_shared();
+
+        // deliver without the lock, the subscriber can not removed, m_uiActive is set
+        for(uint32_t i = 0; i < _uiCount; i++) {
+            basic_bus_subscriber::idle_waiter* _pWaiters = NULL;
+
+            _pList[i]->deliver(ev);
+
+            // the last access to the subscriber, a unsubscribe waits for it
+            portENTER_CRITICAL_SAFE(&m_IdleMux);
+                if(_pList[i]->m_uiActive.fetch_sub(1) == 1) {
+                    _pWaiters = _pList[i]->m_pIdleWaiters;
+                    _pList[i]->m_pIdleWaiters = NULL;
+                }
+            portEXIT_CRITICAL_SAFE(&m_IdleMux);
+
+            basic_bus_subscriber::notify_idle(_pWaiters);
+        }
+        return _uiCount;
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::find_slot
+    //-----------------------------------
+    basic_event_bus::topic_slot* basic_event_bus::find_slot(topic_id_t key, bool bWildcard, bool bInsert) {
+        const uint32_t _uiMask = MN_THREAD_CONFIG_EVENTBUS_TOPICS - 1;
+        topic_slot* _pFree = NULL;
+
+        // linear probing, a slot without subscribers stays used so that the probe chain is not broken
+        for(uint32_t i = 0, _uiIndex = key & _uiMask; i < MN_THREAD_CONFIG_EVENTBUS_TOPICS;
+            i++, _uiIndex = (_uiIndex + 1) & _uiMask) {
+
+            topic_slot* _pSlot = &m_Table[_uiIndex];
+
+            if(!_pSlot->bUsed) {
+                if(_pFree == NULL) _pFree = _pSlot;
+                break;
+            }
+            if(_pSlot->key == key && _pSlot->bWildcard == bWildcard) return _pSlot;
+
+            if(_pFree == NULL && _pSlot->pFirst == NULL) _pFree = _pSlot;
+        }
+
+        if(!bInsert || _pFree == NULL) return NULL;
+
+        _pFree->key = key;
+        _pFree->bWildcard = bWildcard;
+        _pFree->bUsed = true;
+        _pFree->pFirst = NULL;
+
+        return _pFree;
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::collect
+    //-----------------------------------
+    void basic_event_bus::collect(topic_slot* pSlot, basic_bus_subscriber** pList, uint32_t& uiCount) {
+        if(pSlot == NULL) return;
+
+        for(subscription* _pSub = pSlot->pFirst; _pSub != NULL; _pSub = _pSub->pNext) {
+            if(uiCount >= MN_THREAD_CONFIG_EVENTBUS_FANOUT) {
+                m_uiDropped.fetch_add(1);
+                continue;
+            }
+            _pSub->pSubscriber->m_uiActive.fetch_add(1);
+            pList[uiCount++] = _pSub->pSubscriber;
+        }
+    }
+
+    //-----------------------------------
+    //  basic_event_bus::wait_idle
+    //-----------------------------------
+    void basic_event_bus::wait_idle(basic_bus_subscriber& subscriber) {
+        basic_bus_subscriber::idle_waiter _node;
+        bool _bIdle;
+
+        // a publish, that has collected the subscriber before unsubscribe, delivers now
+        portENTER_CRITICAL_SAFE(&m_IdleMux);
+            _bIdle = (subscriber.m_uiActive.load() == 0);
+
+            if(!_bIdle) {
+                _node.pTask = xTaskGetCurrentTaskHandle();
+                _node.bDone = false;
+                _node.pNext = subscriber.m_pIdleWaiters;
+                subscriber.m_pIdleWaiters = &_node;
+            }
+        portEXIT_CRITICAL_SAFE(&m_IdleMux);
+
+        if(!_bIdle) basic_bus_subscriber::wait_idle(_node);
+    }
+
+    //-----------------------------------
+    //  basic_bus_subscriber::notify_idle
+    //-----------------------------------
+    void basic_bus_subscriber::notify_idle(idle_waiter* pWaiters) {
+        while(pWaiters != NULL) {
+            idle_waiter* _pNext = pWaiters->pNext;
+            TaskHandle_t _pTask = pWaiters->pTask;
+
+            // after this the node can leave the stack of the waiter
+            __atomic_store_n(&pWaiters->bDone, true, __ATOMIC_RELEASE);
+            xTaskNotifyGive(_pTask);
+
+            pWaiters = _pNext;
+        }
+    }
+
+    //-----------------------------------
+    //  basic_bus_subscriber::wait_idle
+    //-----------------------------------
+    void basic_bus_subscriber::wait_idle(idle_waiter& node) {
+        while(!__atomic_load_n(&node.bDone, __ATOMIC_ACQUIRE))
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
@@ -21,6 +21,9 @@
 
 #include <esp_log.h>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+
 
 
 #include "mn_eventgroup.hpp"
@@ -63,9 +66,14 @@ namespace mn {
     EventBits_t basic_event_group::sync( const EventBits_t bitstoset, const EventBits_t bitstowaitfor,
                                         TickType_t timeout) {
 
-		if( is_init() )
-			return xEventGroupSync( m_pHandle, bitstoset, bitstowaitfor, timeout);
-		else {
+		if( is_init() ) {
+			EventBits_t _uxBits = xEventGroupSync( m_pHandle, bitstoset, bitstowaitfor, timeout);
+
+		#if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+			m_CoEvent.notify_all();
+		#endif
+			return _uxBits;
+		} else {
 			ESP_LOGE(m_strName, "the event group handle is not created, call create first");
 			return portMAX_DELAY;
 		}
@@ -151,10 +159,21 @@ namespace mn {
         if(xPortInIsrContext()) {
             BaseType_t xHigherPriorityTaskWoken = pdFALSE;
             success = xEventGroupSetBitsFromISR(m_pHandle, uxBitsToSet, &xHigherPriorityTaskWoken);
+
+        #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+            // the timer task sets the bits later, the coroutines are resumed after that
+            if(success == pdPASS && m_CoEvent.has_waiters())
+                xTimerPendFunctionCallFromISR(basic_co_event::pended_notify, &m_CoEvent, 0,
+                                              &xHigherPriorityTaskWoken);
+        #endif
             if(xHigherPriorityTaskWoken)
                 _frxt_setup_switch();
         } else {
             success = xEventGroupSetBits(m_pHandle, (EventBits_t)uxBitsToSet);
+
+        #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+            m_CoEvent.notify_all();
+        #endif
         }
         return success;
     }
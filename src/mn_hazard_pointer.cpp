@@ -0,0 +1,208 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_hazard_pointer.hpp"
+
+/// The number of all hazard slots
+#define MN_HAZARD_ALL_SLOTS     (MN_THREAD_CONFIG_HAZARD_MAX_TASKS * MN_THREAD_CONFIG_HAZARD_SLOTS)
+
+namespace mn {
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_hazard_domain::basic_hazard_domain() {
+    for(int i = 0; i < MN_THREAD_CONFIG_HAZARD_MAX_TASKS; i++) {
+      m_Records[i].pOwner = NULL;
+      m_Records[i].uiUsedSlots = 0;
+      m_Records[i].uiRetired = 0;
+
+      for(int j = 0; j < MN_THREAD_CONFIG_HAZARD_SLOTS; j++)
+        m_Records[i].pHazards[j] = NULL;
+    }
+  }
+
+  //-----------------------------------
+  //  instance
+  //-----------------------------------
+  basic_hazard_domain& basic_hazard_domain::instance() {
+    static basic_hazard_domain _domain;
+    return _domain;
+  }
+
+  //-----------------------------------
+  //  find
+  //-----------------------------------
+  basic_hazard_domain::record* basic_hazard_domain::find(TaskHandle_t pTask) {
+    for(int i = 0; i < MN_THREAD_CONFIG_HAZARD_MAX_TASKS; i++) {
+      if(__atomic_load_n(&m_Records[i].pOwner, __ATOMIC_RELAXED) == pTask)
+        return &m_Records[i];
+    }
+    return NULL;
+  }
+
+  //-----------------------------------
+  //  get_record
+  //-----------------------------------
+  basic_hazard_domain::record* basic_hazard_domain::get_record() {
+    TaskHandle_t _pSelf = xTaskGetCurrentTaskHandle();
+    record* _pRecord = find(_pSelf);
+
+    if(_pRecord != NULL) return _pRecord;
+
+    for(int i = 0; i < MN_THREAD_CONFIG_HAZARD_MAX_TASKS; i++) {
+      TaskHandle_t _pExpected = NULL;
+
+      if(__atomic_compare_exchange_n(&m_Records[i].pOwner, &_pExpected, _pSelf, false,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return &m_Records[i];
+      }
+    }
+    return NULL;
+  }
+
+  //-----------------------------------
+  //  acquire_slot
+  //-----------------------------------
+  void* volatile* basic_hazard_domain::acquire_slot() {
+    record* _pRecord = get_record();
+    if(_pRecord == NULL) return NULL;
+
+    for(int i = 0; i < MN_THREAD_CONFIG_HAZARD_SLOTS; i++) {
+      if((_pRecord->uiUsedSlots & (1u << i)) == 0) {
+        _pRecord->uiUsedSlots |= (1u << i);
+        return &_pRecord->pHazards[i];
+      }
+    }
+    return NULL;
+  }
+
+  //-----------------------------------
+  //  release_slot
+  //-----------------------------------
+  void basic_hazard_domain::release_slot(void* volatile* slot) {
+    record* _pRecord = find(xTaskGetCurrentTaskHandle());
+    if(_pRecord == NULL) return;
+
+    int _iSlot = int(slot - _pRecord->pHazards);
+    if(_iSlot < 0 || _iSlot >= MN_THREAD_CONFIG_HAZARD_SLOTS) return;
+
+    __atomic_store_n(slot, (void*)NULL, __ATOMIC_RELEASE);
+    _pRecord->uiUsedSlots &= ~(1u << _iSlot);
+  }
+
+  //-----------------------------------
+  //  retire
+  //-----------------------------------
+  int basic_hazard_domain::retire(void* object, deleter_t fnDeleter, void* context) {
+    if(object == NULL) return ERR_HAZARD_OK;
+
+    record* _pRecord = get_record();
+    if(_pRecord == NULL) return ERR_HAZARD_NORECORD;
+
+    retired& _entry = _pRecord->Retired[_pRecord->uiRetired++];
+    _entry.pObject = object;
+    _entry.fnDeleter = fnDeleter;
+    _entry.pContext = context;
+
+    // after the scan are at most MN_HAZARD_ALL_SLOTS objects left, so there is always space
+    if(_pRecord->uiRetired == MN_THREAD_CONFIG_HAZARD_SCAN)
+      scan(_pRecord);
+
+    return ERR_HAZARD_OK;
+  }
+
+  //-----------------------------------
+  //  scan
+  //-----------------------------------
+  unsigned int basic_hazard_domain::scan() {
+    record* _pRecord = find(xTaskGetCurrentTaskHandle());
+
+    return (_pRecord != NULL) ? scan(_pRecord) : 0;
+  }
+
+  //-----------------------------------
+  //  scan
+  //-----------------------------------
+  unsigned int basic_hazard_domain::scan(record* pRecord) {
+    void* _pProtected[MN_HAZARD_ALL_SLOTS];
+    unsigned int _uiProtected = 0;
+    unsigned int _uiKept = 0;
+
+    // the objects are removed from the containers, before the slots are read
+    atomic_thread_fence(memory_order::SeqCst);
+
+    for(int i = 0; i < MN_THREAD_CONFIG_HAZARD_MAX_TASKS; i++) {
+      for(int j = 0; j < MN_THREAD_CONFIG_HAZARD_SLOTS; j++) {
+        void* _pHazard = __atomic_load_n(&m_Records[i].pHazards[j], __ATOMIC_ACQUIRE);
+        if(_pHazard != NULL) _pProtected[_uiProtected++] = _pHazard;
+      }
+    }
+
+    for(unsigned int i = 0; i < pRecord->uiRetired; i++) {
+      retired& _entry = pRecord->Retired[i];
+      bool _bProtected = false;
+
+      for(unsigned int j = 0; j < _uiProtected && !_bProtected; j++)
+        _bProtected = (_pProtected[j] == _entry.pObject);
+
+      if(_bProtected)
+        pRecord->Retired[_uiKept++] = _entry;
+      else
+        _entry.fnDeleter(_entry.pContext, _entry.pObject);
+    }
+
+    unsigned int _uiFreed = pRecord->uiRetired - _uiKept;
+    pRecord->uiRetired = _uiKept;
+
+    return _uiFreed;
+  }
+
+  //-----------------------------------
+  //  release_task
+  //-----------------------------------
+  void basic_hazard_domain::release_task() {
+    record* _pRecord = find(xTaskGetCurrentTaskHandle());
+    if(_pRecord == NULL) return;
+
+    for(int j = 0; j < MN_THREAD_CONFIG_HAZARD_SLOTS; j++)
+      __atomic_store_n(&_pRecord->pHazards[j], (void*)NULL, __ATOMIC_RELAXED);
+    _pRecord->uiUsedSlots = 0;
+
+    scan(_pRecord);
+
+    // the left retired objects are freed by the next owner
+    __atomic_store_n(&_pRecord->pOwner, (TaskHandle_t)NULL, __ATOMIC_RELEASE);
+  }
+
+  //-----------------------------------
+  //  get_retired
+  //-----------------------------------
+  unsigned int basic_hazard_domain::get_retired() {
+    unsigned int _uiRetired = 0;
+
+    for(int i = 0; i < MN_THREAD_CONFIG_HAZARD_MAX_TASKS; i++)
+      _uiRetired += __atomic_load_n(&m_Records[i].uiRetired, __ATOMIC_RELAXED);
+
+    return _uiRetired;
+  }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include "mn_latch.hpp"
+
+/// The event group bit, that is set when the counter reaches zero
+#define MN_LATCH_BIT_READY      (1 << 0)
+
+namespace mn {
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_latch::basic_latch(uint32_t count)
+    : m_uiCount(count), m_eventGroup("latch") {
+
+    if(m_eventGroup.create() == NO_ERROR && count == 0)
+      m_eventGroup.set(MN_LATCH_BIT_READY);
+  }
+
+  //-----------------------------------
+  //  count_down
+  //-----------------------------------
+  int basic_latch::count_down(uint32_t n) {
+    if(!m_eventGroup.is_init()) return ERR_LATCH_NOTCREATED;
+
+    uint32_t _uiCount = m_uiCount.load(memory_order::Relaxed);
+
+    do {
+      if(n > _uiCount) return ERR_LATCH_UNDERFLOW;
+    } while(!m_uiCount.compare_exchange_weak(_uiCount, _uiCount - n, memory_order::AcqRel));
+
+    // only the last one wakes all waiting tasks
+    if(_uiCount == n && n != 0)
+      m_eventGroup.set(MN_LATCH_BIT_READY);
+
+    return ERR_LATCH_OK;
+  }
+
+  //-----------------------------------
+  //  wait
+  //-----------------------------------
+  int basic_latch::wait(unsigned int timeout) {
+    if(try_wait()) return ERR_LATCH_OK;
+    if(!m_eventGroup.is_init()) return ERR_LATCH_NOTCREATED;
+
+    EventBits_t _uxBits = m_eventGroup.wait(MN_LATCH_BIT_READY, false, true, timeout);
+
+    return (_uxBits & MN_LATCH_BIT_READY) ? ERR_LATCH_OK : ERR_LATCH_TIMEOUT;
+  }
+
+  //-----------------------------------
+  //  arrive_and_wait
+  //-----------------------------------
+  int basic_latch::arrive_and_wait(uint32_t n, unsigned int timeout) {
+    int _ret = count_down(n);
+    if(_ret != ERR_LATCH_OK) return _ret;
+
+    return wait(timeout);
+  }
+
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_countdown_event::basic_countdown_event(uint32_t count)
+    : basic_latch(count), m_uiInitial(count) { }
+
+  //-----------------------------------
+  //  add_count
+  //-----------------------------------
+  int basic_countdown_event::add_count(uint32_t n) {
+    uint32_t _uiCount = m_uiCount.load(memory_order::Relaxed);
+
+    do {
+      if(_uiCount == 0) return ERR_LATCH_ALREADYSET;
+    } while(!m_uiCount.compare_exchange_weak(_uiCount, _uiCount + n, memory_order::AcqRel));
+
+    return ERR_LATCH_OK;
+  }
+
+  //-----------------------------------
+  //  reset
+  //-----------------------------------
+  void basic_countdown_event::reset(uint32_t count) {
+    if(count == 0) {
+      m_uiCount.store(0, memory_order::Release);
+      m_eventGroup.set(MN_LATCH_BIT_READY);
+    } else {
+      m_eventGroup.clear(MN_LATCH_BIT_READY);
+      m_uiCount.store(count, memory_order::Release);
+    }
+  }
+}
@@ -0,0 +1,248 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <stdio.h>
+
+#include "mn_lock_profiler.hpp"
+
+#if MN_THREAD_CONFIG_LOCK_PROFILER == MN_THREAD_CONFIG_YES
+
+namespace mn {
+  basic_lock_profile* basic_lock_profiler::m_pFirst = NULL;
+  portMUX_TYPE basic_lock_profiler::m_Mux = portMUX_INITIALIZER_UNLOCKED;
+
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_lock_profile::basic_lock_profile(const char* strName)
+    : m_strName(strName), m_uiAcquires(0), m_uiContended(0), m_uiTimeouts(0),
+      m_uiWaitTotal(0), m_uiWaitMax(0), m_uiHoldMax(0), m_uiLockedAt(0), m_pNext(NULL) {
+
+    basic_lock_profiler::add(this);
+  }
+
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_lock_profile::basic_lock_profile(const basic_lock_profile& other)
+    : basic_lock_profile(other.m_strName) { }
+
+  //-----------------------------------
+  //  deconstrutor
+  //-----------------------------------
+  basic_lock_profile::~basic_lock_profile() {
+    basic_lock_profiler::remove(this);
+  }
+
+  //-----------------------------------
+  //  update_max
+  //-----------------------------------
+  void basic_lock_profile::update_max(atomic_uint32_t& max, uint32_t value) {
+    uint32_t _uiMax = max.load(memory_order::Relaxed);
+
+    while(value > _uiMax) {
+      if(max.compare_exchange_weak(_uiMax, value, memory_order::Relaxed)) break;
+    }
+  }
+
+  //-----------------------------------
+  //  contended
+  //-----------------------------------
+  void basic_lock_profile::contended(uint32_t start, bool success) {
+    uint32_t _uiWait = now() - start;
+
+    m_uiContended.fetch_add(1, memory_order::Relaxed);
+    m_uiWaitTotal.fetch_add(_uiWait, memory_order::Relaxed);
+    update_max(m_uiWaitMax, _uiWait);
+
+    if(success) {
+      m_uiAcquires.fetch_add(1, memory_order::Relaxed);
+      __atomic_store_n(&m_uiLockedAt, now(), __ATOMIC_RELAXED);
+    } else {
+      m_uiTimeouts.fetch_add(1, memory_order::Relaxed);
+    }
+  }
+
+  //-----------------------------------
+  //  released
+  //-----------------------------------
+  void basic_lock_profile::released() {
+    update_max(m_uiHoldMax, now() - __atomic_load_n(&m_uiLockedAt, __ATOMIC_RELAXED));
+  }
+
+  //-----------------------------------
+  //  get_stats
+  //-----------------------------------
+  void basic_lock_profile::get_stats(lock_profile_stats& stats) const {
+    stats.strName = m_strName;
+    stats.uiAcquires = m_uiAcquires.load(memory_order::Relaxed);
+    stats.uiContended = m_uiContended.load(memory_order::Relaxed);
+    stats.uiTimeouts = m_uiTimeouts.load(memory_order::Relaxed);
+    stats.uiWaitTotal = m_uiWaitTotal.load(memory_order::Relaxed);
+    stats.uiWaitMax = m_uiWaitMax.load(memory_order::Relaxed);
+    stats.uiHoldMax = m_uiHoldMax.load(memory_order::Relaxed);
+  }
+
+  //-----------------------------------
+  //  reset
+  //-----------------------------------
+  void basic_lock_profile::reset() {
+    m_uiAcquires.store(0, memory_order::Relaxed);
+    m_uiContended.store(0, memory_order::Relaxed);
+    m_uiTimeouts.store(0, memory_order::Relaxed);
+    m_uiWaitTotal.store(0, memory_order::Relaxed);
+    m_uiWaitMax.store(0, memory_order::Relaxed);
+    m_uiHoldMax.store(0, memory_order::Relaxed);
+  }
+
+  //-----------------------------------
+  //  add
+  //-----------------------------------
+  void basic_lock_profiler::add(basic_lock_profile* profile) {
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      profile->m_pNext = m_pFirst;
+      m_pFirst = profile;
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+  }
+
+  //-----------------------------------
+  //  remove
+  //-----------------------------------
+  void basic_lock_profiler::remove(basic_lock_profile* profile) {
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      basic_lock_profile** _ppNext = &m_pFirst;
+
+      while(*_ppNext != NULL && *_ppNext != profile) _ppNext = &(*_ppNext)->m_pNext;
+      if(*_ppNext != NULL) *_ppNext = profile->m_pNext;
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+  }
+
+  //-----------------------------------
+  //  count
+  //-----------------------------------
+  size_t basic_lock_profiler::count() {
+    return snapshot(NULL, 0);
+  }
+
+  //-----------------------------------
+  //  snapshot
+  //-----------------------------------
+  size_t basic_lock_profiler::snapshot(lock_profile_stats* stats, size_t max) {
+    size_t _count = 0;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      for(basic_lock_profile* _pProfile = m_pFirst; _pProfile != NULL; _pProfile = _pProfile->m_pNext) {
+        if(stats != NULL && _count < max)
+          _pProfile->get_stats(stats[_count]);
+        _count++;
+      }
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    return _count;
+  }
+
+  //-----------------------------------
+  //  reset
+  //-----------------------------------
+  void basic_lock_profiler::reset() {
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      for(basic_lock_profile* _pProfile = m_pFirst; _pProfile != NULL; _pProfile = _pProfile->m_pNext)
+        _pProfile->reset();
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+  }
+
+  //-----------------------------------
+  //  format
+  //-----------------------------------
+  size_t basic_lock_profiler::format(char* buffer, size_t size, const lock_profile_stats& stats,
+                                     lock_profile_format format, bool first) {
+    int _len;
+
+    if(format == lock_profile_format::Json) {
+      _len = snprintf(buffer, size,
+        "%s{\"name\":\"%s\",\"acquires\":%u,\"contended\":%u,\"timeouts\":%u,"
+        "\"wait_total_us\":%u,\"wait_max_us\":%u,\"hold_max_us\":%u}",
+        first ? "" : ",", stats.strName,
+        (unsigned)stats.uiAcquires, (unsigned)stats.uiContended, (unsigned)stats.uiTimeouts,
+        (unsigned)stats.uiWaitTotal, (unsigned)stats.uiWaitMax, (unsigned)stats.uiHoldMax);
+    } else {
+      _len = snprintf(buffer, size, "%-16s acquires=%u contended=%u timeouts=%u wait_total=%uus wait_max=%uus hold_max=%uus\n",
+        stats.strName,
+        (unsigned)stats.uiAcquires, (unsigned)stats.uiContended, (unsigned)stats.uiTimeouts,
+        (unsigned)stats.uiWaitTotal, (unsigned)stats.uiWaitMax, (unsigned)stats.uiHoldMax);
+    }
+    return (_len < 0) ? 0 : size_t(_len);
+  }
+
+  //-----------------------------------
+  //  dump
+  //-----------------------------------
+  size_t basic_lock_profiler::dump(char* buffer, size_t size, lock_profile_format format) {
+    const bool _bJson = (format == lock_profile_format::Json);
+    size_t _len = 0;
+    lock_profile_stats _stats;
+
+    // snprintf can not run in the critical section, so the locks are read one by one
+    for(size_t i = 0; ; i++) {
+      bool _bFound = false;
+
+      portENTER_CRITICAL_SAFE(&m_Mux);
+        basic_lock_profile* _pProfile = m_pFirst;
+        for(size_t j = 0; j < i && _pProfile != NULL; j++) _pProfile = _pProfile->m_pNext;
+
+        if(_pProfile != NULL) {
+          _pProfile->get_stats(_stats);
+          _bFound = true;
+        }
+      portEXIT_CRITICAL_SAFE(&m_Mux);
+
+      if(!_bFound) break;
+
+      if(_bJson && i == 0)
+        _len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0, "[");
+
+      _len += basic_lock_profiler::format(buffer + ((_len < size) ? _len : size),
+                                          (_len < size) ? size - _len : 0, _stats, format, i == 0);
+    }
+
+    if(_bJson)
+      _len += snprintf(buffer + ((_len < size) ? _len : size), (_len < size) ? size - _len : 0,
+                       (_len == 0) ? "[]" : "]");
+
+    return _len;
+  }
+
+  //-----------------------------------
+  //  print
+  //-----------------------------------
+  void basic_lock_profiler::print(lock_profile_format format) {
+    size_t _len = dump(NULL, 0, format);
+    char* _buffer = new char[_len + 1];
+
+    if(_buffer != NULL) {
+      dump(_buffer, _len + 1, format);
+      printf("%s\n", _buffer);
+      delete[] _buffer;
+    }
+  }
+}
+
+#endif // MN_THREAD_CONFIG_LOCK_PROFILER
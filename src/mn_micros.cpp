@@ -33,10 +33,22 @@
 #include <esp_partition.h>
 
 #include <sys/time.h>
+#include <time.h>
 
 MN_EXTERNC_BEGINN
 
 namespace mn {
+#if MN_THREAD_CONFIG_BOARD == MN_THREAD_CONFIG_HOST
+  //-----------------------------------
+  //  micros
+  //-----------------------------------
+  unsigned long micros() {
+      struct timespec now;
+
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      return (unsigned long)now.tv_sec * 1000000UL + (unsigned long)(now.tv_nsec / 1000);
+  }
+#else
   portMUX_TYPE microsMux = portMUX_INITIALIZER_UNLOCKED;
 
   //-----------------------------------
@@ -55,6 +67,7 @@ namespace mn {
       portEXIT_CRITICAL_ISR(&microsMux);
       return overflow + (ccount / CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ);
   }
+#endif // MN_THREAD_CONFIG_BOARD
 
   //-----------------------------------
   //  millis
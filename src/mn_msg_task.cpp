@@ -29,7 +29,7 @@ namespace mn {
             unsigned short  usStackDepth)
             : basic_convar_task(strName, uiPriority, usStackDepth),
             m_ltMessageQueueLock(),
-            m_qeMessageQueue(MN_THREAD_CONFIG_MSGTASK_MAX_MESSAGES, sizeof(task_message*)),
+            m_qeMessageQueue(),
             m_cvMessage() {
 
             m_qeMessageQueue.create();
@@ -38,9 +38,25 @@ namespace mn {
         //-----------------------------------
         //  post_msg
         //-----------------------------------
-        void basic_message_task::post_msg(task_message* msg, unsigned int timeout) {
+        int basic_message_task::post_msg(const task_message& msg, unsigned int timeout) {
+            // the queue is thread safe, only the signal needs the lock. So a full
+            // queue can not block the task, that wait for the lock to dequeue
+            int _iRet = m_qeMessageQueue.enqueue(msg, timeout);
+
+            if(_iRet == ERR_QUEUE_OK) {
+                automutx_t lock(m_ltMessageQueueLock);
+                m_cvMessage.signal();
+            }
+            return _iRet;
+        }
+
+        //-----------------------------------
+        //  stop
+        //-----------------------------------
+        void basic_message_task::stop() {
             automutx_t lock(m_ltMessageQueueLock);
-            m_qeMessageQueue.enqueue(msg, timeout);
+
+            m_bRunning = false;
             m_cvMessage.signal();
         }
 
@@ -48,29 +64,28 @@ namespace mn {
         //  on_task
         //-----------------------------------
         int basic_message_task::on_task() {
-            bool m_bRunning = true;
-            task_message *msg;
-
-            while(m_bRunning) {
-                msg = nullptr;
-
-				m_ltMessageQueueLock.lock();
-
-				while (m_qeMessageQueue.is_empty())
-					wait(m_cvMessage, m_ltMessageQueueLock);
+            task_message _batch[MN_THREAD_CONFIG_MSGTASK_BATCH];
+            unsigned int _uiCount;
 
-				if(m_qeMessageQueue.is_empty())
-					continue;
+            // m_bRunning is only read and cleared (from stop) with the lock
+            m_ltMessageQueueLock.lock();
 
-				m_qeMessageQueue.dequeue(msg);
+            // after stop the left messages are handled, then the loop ends
+            while(m_bRunning || !m_qeMessageQueue.is_empty()) {
+                m_cvMessage.wait(m_ltMessageQueueLock, [this] {
+                    return !m_qeMessageQueue.is_empty() || !m_bRunning; });
 
-				if(msg) {
-					on_message(msg->id, msg->message);
-				}
+                _uiCount = m_qeMessageQueue.drain(_batch, MN_THREAD_CONFIG_MSGTASK_BATCH);
+                m_ltMessageQueueLock.unlock();
 
-				m_ltMessageQueueLock.unlock();
+                // handle the messages without the lock, so post_msg is never blocked
+                for(unsigned int i = 0; i < _uiCount; i++) {
+                    on_message(_batch[i].id, _batch[i].message);
+                }
+                m_ltMessageQueueLock.lock();
             } //while(m_bRunning)
 
+            m_ltMessageQueueLock.unlock();
             return ERR_TASK_OK;
         }
     }
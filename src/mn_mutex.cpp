@@ -68,7 +68,18 @@ namespace mn {
         if(xHigherPriorityTaskWoken)
           _frxt_setup_switch();
     } else {
+#if MN_THREAD_CONFIG_LOCK_PROFILER == MN_THREAD_CONFIG_YES
+      success = xSemaphoreTake(m_pSpinlock, 0);
+      if(success == pdTRUE) {
+        MN_LOCK_PROFILE_ACQUIRED();
+      } else {
+        MN_LOCK_PROFILE_START(_uiProfileStart);
+        if(timeout != 0) success = xSemaphoreTake(m_pSpinlock, timeout);
+        MN_LOCK_PROFILE_CONTENDED(_uiProfileStart, success == pdTRUE);
+      }
+#else
       success = xSemaphoreTake(m_pSpinlock, timeout);
+#endif
     }
 
     if(success != pdTRUE ) {
@@ -90,6 +101,7 @@ namespace mn {
         if(xHigherPriorityTaskWoken)
           _frxt_setup_switch();
     } else {
+        MN_LOCK_PROFILE_RELEASED();
         success = xSemaphoreGive(m_pSpinlock);
     }
 
@@ -0,0 +1,384 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_rcu.hpp"
+
+#if MN_THREAD_CONFIG_BOARD ==  MN_THREAD_CONFIG_ESP32
+#include <esp_freertos_hooks.h>
+#endif
+
+/// The first grace period counter, the counter is always odd, 0 means offline
+#define MN_RCU_COUNTER_START        uint32_t(1)
+/// The grace period counter step
+#define MN_RCU_COUNTER_STEP         uint32_t(2)
+
+namespace mn {
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_rcu_domain::basic_rcu_domain()
+    : m_uiCounter(MN_RCU_COUNTER_START), m_uiReaders(0), m_uiHead(0), m_uiCount(0),
+      m_pWaiters(NULL) {
+
+    for(int i = 0; i < MN_THREAD_CONFIG_RCU_MAX_READERS; i++) {
+      m_Readers[i].pTask = NULL;
+      m_Readers[i].uiCounter = 0;
+    }
+    vPortCPUInitializeMutex(&m_Mux);
+  }
+
+  //-----------------------------------
+  //  instance
+  //-----------------------------------
+  basic_rcu_domain& basic_rcu_domain::instance() {
+    static basic_rcu_domain _domain;
+    return _domain;
+  }
+
+  //-----------------------------------
+  //  find
+  //-----------------------------------
+  basic_rcu_domain::reader* basic_rcu_domain::find(TaskHandle_t pTask) {
+    for(int i = 0; i < MN_THREAD_CONFIG_RCU_MAX_READERS; i++) {
+      if(__atomic_load_n(&m_Readers[i].pTask, __ATOMIC_RELAXED) == pTask)
+        return &m_Readers[i];
+    }
+    return NULL;
+  }
+
+  //-----------------------------------
+  //  register_task
+  //-----------------------------------
+  int basic_rcu_domain::register_task() {
+    TaskHandle_t _pSelf = xTaskGetCurrentTaskHandle();
+    int _ret = ERR_RCU_OK;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+    if(find(_pSelf) == NULL) {
+      reader* _pSlot = find(NULL);
+
+      if(_pSlot != NULL) {
+        __atomic_store_n(&_pSlot->uiCounter, get_counter(), __ATOMIC_RELAXED);
+        __atomic_store_n(&_pSlot->pTask, _pSelf, __ATOMIC_RELEASE);
+        m_uiReaders.fetch_add(1, memory_order::Relaxed);
+      } else {
+        _ret = ERR_RCU_READERS_FULL;
+      }
+    }
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    atomic_thread_fence(memory_order::SeqCst);
+    return _ret;
+  }
+
+  //-----------------------------------
+  //  unregister_task
+  //-----------------------------------
+  int basic_rcu_domain::unregister_task() {
+    TaskHandle_t _pSelf = xTaskGetCurrentTaskHandle();
+    int _ret = ERR_RCU_NOTREGISTERED;
+
+    atomic_thread_fence(memory_order::SeqCst);
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+    reader* _pSlot = find(_pSelf);
+
+    if(_pSlot != NULL) {
+      __atomic_store_n(&_pSlot->uiCounter, 0, __ATOMIC_RELEASE);
+      __atomic_store_n(&_pSlot->pTask, NULL, __ATOMIC_RELAXED);
+      m_uiReaders.fetch_sub(1, memory_order::Relaxed);
+      _ret = ERR_RCU_OK;
+    }
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    if(_ret == ERR_RCU_OK) wake_waiters();
+    return _ret;
+  }
+
+  //-----------------------------------
+  //  is_registered
+  //-----------------------------------
+  bool basic_rcu_domain::is_registered() {
+    if(m_uiReaders.load(memory_order::Relaxed) == 0) return false;
+
+    return find(xTaskGetCurrentTaskHandle()) != NULL;
+  }
+
+  //-----------------------------------
+  //  quiescent_state
+  //-----------------------------------
+  void basic_rcu_domain::quiescent_state() {
+    if(m_uiReaders.load(memory_order::Relaxed) == 0) return;
+
+    reader* _pSlot = find(xTaskGetCurrentTaskHandle());
+    if(_pSlot == NULL) return;
+
+    // all reads of the task are done, before the new counter is seen
+    atomic_thread_fence(memory_order::SeqCst);
+    __atomic_store_n(&_pSlot->uiCounter, get_counter(), __ATOMIC_RELEASE);
+
+    wake_waiters();
+  }
+
+  //-----------------------------------
+  //  offline
+  //-----------------------------------
+  void basic_rcu_domain::offline() {
+    if(m_uiReaders.load(memory_order::Relaxed) == 0) return;
+
+    reader* _pSlot = find(xTaskGetCurrentTaskHandle());
+    if(_pSlot == NULL) return;
+
+    atomic_thread_fence(memory_order::SeqCst);
+    __atomic_store_n(&_pSlot->uiCounter, 0, __ATOMIC_RELEASE);
+
+    wake_waiters();
+  }
+
+  //-----------------------------------
+  //  online
+  //-----------------------------------
+  void basic_rcu_domain::online() {
+    if(m_uiReaders.load(memory_order::Relaxed) == 0) return;
+
+    reader* _pSlot = find(xTaskGetCurrentTaskHandle());
+    if(_pSlot == NULL) return;
+
+    __atomic_store_n(&_pSlot->uiCounter, get_counter(), __ATOMIC_RELAXED);
+    atomic_thread_fence(memory_order::SeqCst);
+  }
+
+  //-----------------------------------
+  //  start_grace_period
+  //-----------------------------------
+  uint32_t basic_rcu_domain::start_grace_period() {
+    return __atomic_add_fetch(&m_uiCounter, MN_RCU_COUNTER_STEP, __ATOMIC_SEQ_CST);
+  }
+
+  //-----------------------------------
+  //  oldest_counter
+  //-----------------------------------
+  uint32_t basic_rcu_domain::oldest_counter() {
+    atomic_thread_fence(memory_order::SeqCst);
+
+    uint32_t _uiOldest = get_counter();
+
+    for(int i = 0; i < MN_THREAD_CONFIG_RCU_MAX_READERS; i++) {
+      uint32_t _uiCounter = __atomic_load_n(&m_Readers[i].uiCounter, __ATOMIC_ACQUIRE);
+
+      // 0: the slot is free or the task is offline
+      if(_uiCounter != 0 && int32_t(_uiCounter - _uiOldest) < 0)
+        _uiOldest = _uiCounter;
+    }
+    // the frees are done after the reads of the counters
+    atomic_thread_fence(memory_order::SeqCst);
+    return _uiOldest;
+  }
+
+  //-----------------------------------
+  //  wake_waiters
+  //-----------------------------------
+  void basic_rcu_domain::wake_waiters() {
+    // the new counter of the reader is seen, before the waiters are checked
+    atomic_thread_fence(memory_order::SeqCst);
+    if(__atomic_load_n(&m_pWaiters, __ATOMIC_RELAXED) == NULL) return;
+
+    uint32_t _uiOldest = oldest_counter();
+    waiter* _pReady = NULL;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+    waiter** _ppLink = &m_pWaiters;
+    while(*_ppLink != NULL) {
+      waiter* _pNode = *_ppLink;
+
+      if(int32_t(_uiOldest - _pNode->uiTarget) >= 0) {
+        __atomic_store_n(_ppLink, _pNode->pNext, __ATOMIC_RELAXED);
+        _pNode->pNext = _pReady;
+        _pReady = _pNode;
+      } else {
+        _ppLink = &_pNode->pNext;
+      }
+    }
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    while(_pReady != NULL) {
+      waiter* _pNext = _pReady->pNext;
+      TaskHandle_t _pTask = _pReady->pTask;
+
+      // after this the node can leave the stack of the waiter
+      __atomic_store_n(&_pReady->bDone, true, __ATOMIC_RELEASE);
+      xTaskNotifyGive(_pTask);
+
+      _pReady = _pNext;
+    }
+  }
+
+  //-----------------------------------
+  //  synchronize
+  //-----------------------------------
+  void basic_rcu_domain::synchronize() {
+    reader* _pSelf = NULL;
+
+    // a online reader would wait for itself
+    if(m_uiReaders.load(memory_order::Relaxed) != 0) {
+      _pSelf = find(xTaskGetCurrentTaskHandle());
+      if(_pSelf != NULL && __atomic_load_n(&_pSelf->uiCounter, __ATOMIC_RELAXED) == 0)
+        _pSelf = NULL;
+    }
+    if(_pSelf != NULL) offline();
+
+    waiter _node;
+    _node.pTask = xTaskGetCurrentTaskHandle();
+    _node.bDone = false;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+    _node.uiTarget = start_grace_period();
+    _node.pNext = m_pWaiters;
+    __atomic_store_n(&m_pWaiters, &_node, __ATOMIC_RELAXED);
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    // the readers see the node, or this check sees their new counters
+    if(int32_t(oldest_counter() - _node.uiTarget) >= 0) {
+      portENTER_CRITICAL_SAFE(&m_Mux);
+      waiter** _ppLink = &m_pWaiters;
+      while(*_ppLink != NULL && *_ppLink != &_node) _ppLink = &(*_ppLink)->pNext;
+      if(*_ppLink == &_node) {
+        __atomic_store_n(_ppLink, _node.pNext, __ATOMIC_RELAXED);
+        _node.bDone = true;
+      }
+      portEXIT_CRITICAL_SAFE(&m_Mux);
+    }
+
+    // not found: a reader has taken the node, the notify is on the way
+    while(!__atomic_load_n(&_node.bDone, __ATOMIC_ACQUIRE)) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    if(_pSelf != NULL) online();
+  }
+
+  //-----------------------------------
+  //  call
+  //-----------------------------------
+  int basic_rcu_domain::call(callback_t fnCallback, void* context, void* object) {
+    bool _bDeferred = false;
+
+    while(!_bDeferred) {
+      portENTER_CRITICAL_SAFE(&m_Mux);
+      if(m_uiCount < MN_THREAD_CONFIG_RCU_CALLBACKS) {
+        callback& _entry = m_Callbacks[(m_uiHead + m_uiCount) % MN_THREAD_CONFIG_RCU_CALLBACKS];
+
+        _entry.fnCallback = fnCallback;
+        _entry.pContext = context;
+        _entry.pObject = object;
+        _entry.uiTarget = start_grace_period();
+
+        m_uiCount++;
+        _bDeferred = true;
+      }
+      portEXIT_CRITICAL_SAFE(&m_Mux);
+
+      if(!_bDeferred) {
+        if (xPortInIsrContext()) return ERR_RCU_CALLBACKS_FULL;
+        barrier();
+      }
+    }
+    return ERR_RCU_OK;
+  }
+
+  //-----------------------------------
+  //  reclaim
+  //-----------------------------------
+  unsigned int basic_rcu_domain::reclaim() {
+    unsigned int _uiRun = 0;
+    uint32_t _uiOldest = oldest_counter();
+    callback _entry;
+
+    while(true) {
+      bool _bReady = false;
+
+      portENTER_CRITICAL_SAFE(&m_Mux);
+      if(m_uiCount > 0) {
+        _entry = m_Callbacks[m_uiHead];
+
+        // the targets are in order, when the first is not ready then no one is ready
+        if(int32_t(_uiOldest - _entry.uiTarget) >= 0) {
+          m_uiHead = (m_uiHead + 1) % MN_THREAD_CONFIG_RCU_CALLBACKS;
+          m_uiCount--;
+          _bReady = true;
+        }
+      }
+      portEXIT_CRITICAL_SAFE(&m_Mux);
+
+      if(!_bReady) break;
+
+      // run outside the critical section, the callback can free with a locked allocator
+      _entry.fnCallback(_entry.pContext, _entry.pObject);
+      _uiRun++;
+    }
+    return _uiRun;
+  }
+
+  //-----------------------------------
+  //  barrier
+  //-----------------------------------
+  void basic_rcu_domain::barrier() {
+    synchronize();
+    reclaim();
+  }
+
+  //-----------------------------------
+  //  get_pending
+  //-----------------------------------
+  unsigned int basic_rcu_domain::get_pending() {
+    portENTER_CRITICAL_SAFE(&m_Mux);
+    unsigned int _uiCount = m_uiCount;
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    return _uiCount;
+  }
+
+  //-----------------------------------
+  //  on_idle
+  //-----------------------------------
+  bool basic_rcu_domain::on_idle() {
+    reclaim();
+    return true;
+  }
+
+#if MN_THREAD_CONFIG_BOARD ==  MN_THREAD_CONFIG_ESP32
+  //-----------------------------------
+  //  rcu_idle_hook
+  //-----------------------------------
+  static bool rcu_idle_hook() {
+    return basic_rcu_domain::instance().on_idle();
+  }
+
+  //-----------------------------------
+  //  install_idle_hook
+  //-----------------------------------
+  int basic_rcu_domain::install_idle_hook(BaseType_t core) {
+    return esp_register_freertos_idle_hook_for_cpu(&rcu_idle_hook, core);
+  }
+#endif
+}
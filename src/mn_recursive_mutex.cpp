@@ -51,8 +51,22 @@ namespace mn {
     //  lock
     //-----------------------------------
     int recursive_mutex::lock(unsigned int timeout) {
+        BaseType_t success;
 
-        if(xSemaphoreTakeRecursive(m_pSpinlock, timeout) != pdTRUE) {
+    #if MN_THREAD_CONFIG_LOCK_PROFILER == MN_THREAD_CONFIG_YES
+        success = xSemaphoreTakeRecursive(m_pSpinlock, 0);
+        if(success == pdTRUE) {
+            MN_LOCK_PROFILE_ACQUIRED();
+        } else {
+            MN_LOCK_PROFILE_START(_uiProfileStart);
+            if(timeout != 0) success = xSemaphoreTakeRecursive(m_pSpinlock, timeout);
+            MN_LOCK_PROFILE_CONTENDED(_uiProfileStart, success == pdTRUE);
+        }
+    #else
+        success = xSemaphoreTakeRecursive(m_pSpinlock, timeout);
+    #endif
+
+        if(success != pdTRUE) {
             return ERR_MUTEX_LOCK;
         }
         m_isLocked = true;
@@ -63,6 +77,7 @@ namespace mn {
     //  unlock
     //-----------------------------------
     int recursive_mutex::unlock() {
+        MN_LOCK_PROFILE_RELEASED();
 
         if(xSemaphoreGiveRecursive(m_pSpinlock) != pdTRUE) {
             return ERR_MUTEX_UNLOCK;
@@ -0,0 +1,367 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "mn_shared_mutex.hpp"
+
+/// The number of readers in the state word
+#define MN_SHARED_MUTEX_READERS        0x0FFFFFFFUL
+/// One or more tasks are parked
+#define MN_SHARED_MUTEX_PARKED         0x20000000UL
+/// One or more writers wait, new readers must wait too
+#define MN_SHARED_MUTEX_PENDING        0x40000000UL
+/// A writer holds the lock
+#define MN_SHARED_MUTEX_WRITER         0x80000000UL
+
+#define MN_SHARED_MUTEX_CAS(OLD, NEW) \
+  __atomic_compare_exchange_n(&m_uiState, &(OLD), (NEW), false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+
+namespace mn {
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_shared_mutex::basic_shared_mutex()
+    : m_uiState(0), m_pReaders(NULL), m_pWriters(NULL), m_uiWritersWaiting(0) {
+
+    vPortCPUInitializeMutex(&m_Mux);
+  }
+
+  //-----------------------------------
+  //  deconstrutor
+  //-----------------------------------
+  basic_shared_mutex::~basic_shared_mutex() { }
+
+  //-----------------------------------
+  //  try_lock_shared
+  //-----------------------------------
+  bool basic_shared_mutex::try_lock_shared() {
+    uint32_t _uiState = __atomic_load_n(&m_uiState, __ATOMIC_RELAXED);
+
+    while( (_uiState & (MN_SHARED_MUTEX_WRITER | MN_SHARED_MUTEX_PENDING)) == 0 ) {
+      if(MN_SHARED_MUTEX_CAS(_uiState, _uiState + 1)) return true;
+    }
+    return false;
+  }
+
+  //-----------------------------------
+  //  lock_shared
+  //-----------------------------------
+  int basic_shared_mutex::lock_shared(unsigned int timeout) {
+    if(try_lock_shared()) return ERR_MUTEX_OK;
+    if(timeout == 0 || xPortInIsrContext()) return ERR_MUTEX_LOCK;
+
+    waiter _waiter;
+    _waiter.pTask = xTaskGetCurrentTaskHandle();
+    _waiter.pNext = NULL;
+    _waiter.bGranted = false;
+
+    if(_waiter.pTask == NULL) return ERR_MUTEX_LOCK;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      for(;;) {
+        uint32_t _uiState = __atomic_load_n(&m_uiState, __ATOMIC_RELAXED);
+
+        if( (_uiState & (MN_SHARED_MUTEX_WRITER | MN_SHARED_MUTEX_PENDING)) == 0 ) {
+          if(MN_SHARED_MUTEX_CAS(_uiState, _uiState + 1)) {
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+            return ERR_MUTEX_OK;
+          }
+        } else if(MN_SHARED_MUTEX_CAS(_uiState, _uiState | MN_SHARED_MUTEX_PARKED)) {
+          break;
+        }
+      }
+
+      waiter** _ppNext = &m_pReaders;
+      while(*_ppNext != NULL) _ppNext = &(*_ppNext)->pNext;
+      *_ppNext = &_waiter;
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    return wait(_waiter, false, timeout);
+  }
+
+  //-----------------------------------
+  //  time_lock_shared
+  //-----------------------------------
+  int basic_shared_mutex::time_lock_shared(const struct timespec *timeout) {
+    return lock_shared(to_ticks(timeout));
+  }
+
+  //-----------------------------------
+  //  unlock_shared
+  //-----------------------------------
+  int basic_shared_mutex::unlock_shared() {
+    uint32_t _uiState = __atomic_load_n(&m_uiState, __ATOMIC_RELAXED);
+
+    if( (_uiState & MN_SHARED_MUTEX_READERS) == 0 ) return ERR_MUTEX_UNLOCK;
+
+    _uiState = __atomic_fetch_sub(&m_uiState, 1, __ATOMIC_RELEASE);
+
+    // the last reader wakes the parked tasks
+    if( (_uiState & MN_SHARED_MUTEX_READERS) == 1 && (_uiState & MN_SHARED_MUTEX_PARKED) ) {
+      portENTER_CRITICAL_SAFE(&m_Mux);
+        waiter* _pGranted = grant();
+      portEXIT_CRITICAL_SAFE(&m_Mux);
+
+      notify(_pGranted);
+    }
+    return ERR_MUTEX_OK;
+  }
+
+  //-----------------------------------
+  //  try_lock
+  //-----------------------------------
+  bool basic_shared_mutex::try_lock() {
+    uint32_t _uiState = 0;
+
+    return MN_SHARED_MUTEX_CAS(_uiState, MN_SHARED_MUTEX_WRITER);
+  }
+
+  //-----------------------------------
+  //  lock
+  //-----------------------------------
+  int basic_shared_mutex::lock(unsigned int timeout) {
+    if(try_lock()) {
+      MN_LOCK_PROFILE_ACQUIRED();
+      return ERR_MUTEX_OK;
+    }
+
+    MN_LOCK_PROFILE_START(_uiProfileStart);
+    int _ret = ERR_MUTEX_LOCK;
+
+    if(timeout != 0 && !xPortInIsrContext())
+      _ret = lock_slow(timeout);
+
+    MN_LOCK_PROFILE_CONTENDED(_uiProfileStart, _ret == ERR_MUTEX_OK);
+    return _ret;
+  }
+
+  //-----------------------------------
+  //  lock_slow
+  //-----------------------------------
+  int basic_shared_mutex::lock_slow(unsigned int timeout) {
+
+    waiter _waiter;
+    _waiter.pTask = xTaskGetCurrentTaskHandle();
+    _waiter.pNext = NULL;
+    _waiter.bGranted = false;
+
+    if(_waiter.pTask == NULL) return ERR_MUTEX_LOCK;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      for(;;) {
+        uint32_t _uiState = __atomic_load_n(&m_uiState, __ATOMIC_RELAXED);
+
+        if( (_uiState & (MN_SHARED_MUTEX_READERS | MN_SHARED_MUTEX_WRITER)) == 0 ) {
+          uint32_t _uiNew = MN_SHARED_MUTEX_WRITER | (_uiState & MN_SHARED_MUTEX_PARKED) |
+                            ((m_uiWritersWaiting > 0) ? MN_SHARED_MUTEX_PENDING : 0);
+
+          if(MN_SHARED_MUTEX_CAS(_uiState, _uiNew)) {
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+            return ERR_MUTEX_OK;
+          }
+        } else if(MN_SHARED_MUTEX_CAS(_uiState, _uiState | MN_SHARED_MUTEX_PARKED | MN_SHARED_MUTEX_PENDING)) {
+          break;
+        }
+      }
+
+      m_uiWritersWaiting++;
+
+      waiter** _ppNext = &m_pWriters;
+      while(*_ppNext != NULL) _ppNext = &(*_ppNext)->pNext;
+      *_ppNext = &_waiter;
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    return wait(_waiter, true, timeout);
+  }
+
+  //-----------------------------------
+  //  time_lock
+  //-----------------------------------
+  int basic_shared_mutex::time_lock(const struct timespec *timeout) {
+    return lock(to_ticks(timeout));
+  }
+
+  //-----------------------------------
+  //  unlock
+  //-----------------------------------
+  int basic_shared_mutex::unlock() {
+    uint32_t _uiState = MN_SHARED_MUTEX_WRITER;
+
+  #if MN_THREAD_CONFIG_LOCK_PROFILER == MN_THREAD_CONFIG_YES
+    if(__atomic_load_n(&m_uiState, __ATOMIC_RELAXED) & MN_SHARED_MUTEX_WRITER)
+      MN_LOCK_PROFILE_RELEASED();
+  #endif
+
+    // fast path, no parked tasks
+    if(MN_SHARED_MUTEX_CAS(_uiState, 0)) return ERR_MUTEX_OK;
+    if( (_uiState & MN_SHARED_MUTEX_WRITER) == 0 ) return ERR_MUTEX_UNLOCK;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      while(!MN_SHARED_MUTEX_CAS(_uiState, _uiState & ~MN_SHARED_MUTEX_WRITER)) { }
+
+      waiter* _pGranted = grant();
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    notify(_pGranted);
+
+    return ERR_MUTEX_OK;
+  }
+
+  //-----------------------------------
+  //  grant
+  //-----------------------------------
+  basic_shared_mutex::waiter* basic_shared_mutex::grant() {
+    for(;;) {
+      uint32_t _uiState = __atomic_load_n(&m_uiState, __ATOMIC_RELAXED);
+
+      if(_uiState & MN_SHARED_MUTEX_WRITER) return NULL;
+
+      if(m_pWriters != NULL) {
+        // the last reader grants the writer
+        if(_uiState & MN_SHARED_MUTEX_READERS) return NULL;
+
+        waiter* _pWriter = m_pWriters;
+        uint32_t _uiNew = MN_SHARED_MUTEX_WRITER |
+          ((m_uiWritersWaiting > 1) ? MN_SHARED_MUTEX_PENDING : 0) |
+          ((_pWriter->pNext != NULL || m_pReaders != NULL) ? MN_SHARED_MUTEX_PARKED : 0);
+
+        if(!MN_SHARED_MUTEX_CAS(_uiState, _uiNew)) continue;
+
+        m_pWriters = _pWriter->pNext;
+        m_uiWritersWaiting--;
+
+        _pWriter->pNext = NULL;
+        return _pWriter;
+      }
+
+      if(m_pReaders != NULL) {
+        uint32_t _uiCount = 0;
+        for(waiter* _pReader = m_pReaders; _pReader != NULL; _pReader = _pReader->pNext)
+          _uiCount++;
+
+        if(!MN_SHARED_MUTEX_CAS(_uiState, (_uiState & MN_SHARED_MUTEX_READERS) + _uiCount)) continue;
+
+        waiter* _pReaders = m_pReaders;
+        m_pReaders = NULL;
+
+        return _pReaders;
+      }
+
+      // nothing parked
+      if( (_uiState & (MN_SHARED_MUTEX_PARKED | MN_SHARED_MUTEX_PENDING)) == 0 ||
+          MN_SHARED_MUTEX_CAS(_uiState, _uiState & MN_SHARED_MUTEX_READERS) )
+        return NULL;
+    }
+  }
+
+  //-----------------------------------
+  //  notify
+  //-----------------------------------
+  void basic_shared_mutex::notify(waiter* pGranted) {
+    while(pGranted != NULL) {
+      waiter* _pNext = pGranted->pNext;
+      TaskHandle_t _pTask = pGranted->pTask;
+
+      // after this the node can leave the stack of the waiter
+      __atomic_store_n(&pGranted->bGranted, true, __ATOMIC_RELEASE);
+      xTaskNotifyGive(_pTask);
+
+      pGranted = _pNext;
+    }
+  }
+
+  //-----------------------------------
+  //  wait
+  //-----------------------------------
+  int basic_shared_mutex::wait(waiter& node, bool bWriter, unsigned int timeout) {
+    TickType_t _xStart = xTaskGetTickCount();
+    TickType_t _xLeft = timeout;
+
+    while(!__atomic_load_n(&node.bGranted, __ATOMIC_ACQUIRE)) {
+      if(timeout != portMAX_DELAY) {
+        TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+        if(_xElapsed >= timeout) break;
+
+        _xLeft = timeout - _xElapsed;
+      }
+      ulTaskNotifyTake(pdTRUE, _xLeft);
+    }
+
+    if(__atomic_load_n(&node.bGranted, __ATOMIC_ACQUIRE))
+      return ERR_MUTEX_OK;
+
+    // timeout - remove the node, when it is not granted meanwhile
+    bool _bFound = false;
+    waiter* _pGranted = NULL;
+
+    portENTER_CRITICAL_SAFE(&m_Mux);
+      waiter** _ppNext = bWriter ? &m_pWriters : &m_pReaders;
+
+      while(*_ppNext != NULL && *_ppNext != &node) _ppNext = &(*_ppNext)->pNext;
+
+      if(*_ppNext == &node) {
+        *_ppNext = node.pNext;
+        _bFound = true;
+
+        // a gone writer can let the parked readers in
+        if(bWriter) m_uiWritersWaiting--;
+        _pGranted = grant();
+      }
+    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+    if(_bFound) {
+      notify(_pGranted);
+      return ERR_MUTEX_LOCK;
+    }
+
+    // granted, the notify is on the way
+    while(!__atomic_load_n(&node.bGranted, __ATOMIC_ACQUIRE))
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    return ERR_MUTEX_OK;
+  }
+
+  //-----------------------------------
+  //  is_locked
+  //-----------------------------------
+  bool basic_shared_mutex::is_locked() const {
+    return (__atomic_load_n(&m_uiState, __ATOMIC_RELAXED) & MN_SHARED_MUTEX_WRITER) != 0;
+  }
+
+  //-----------------------------------
+  //  get_readers
+  //-----------------------------------
+  uint32_t basic_shared_mutex::get_readers() const {
+    return __atomic_load_n(&m_uiState, __ATOMIC_RELAXED) & MN_SHARED_MUTEX_READERS;
+  }
+
+  //-----------------------------------
+  //  to_ticks
+  //-----------------------------------
+  TickType_t basic_shared_mutex::to_ticks(const struct timespec *timeout) {
+    struct timespec currtime;
+    clock_gettime(CLOCK_REALTIME, &currtime);
+
+    return ((timeout->tv_sec - currtime.tv_sec)*1000 +
+           (timeout->tv_nsec - currtime.tv_nsec)/1000000)/portTICK_PERIOD_MS;
+  }
+}
@@ -28,6 +28,9 @@
 #include "mn_task.hpp"
 #include "mn_task_list.hpp"
 #include "mn_atomic_counter.hpp"
+#if MN_THREAD_CONFIG_HAZARD == MN_THREAD_CONFIG_YES
+#include "mn_hazard_pointer.hpp"
+#endif
 
 #define EVENTGROUP_BIT_JOINABLE (1 << 0)
 #define EVENTGROUP_BIT_STARTED	(1 << 2)
@@ -95,6 +98,7 @@ namespace mn {
 		ESP_LOGE(m_strName.c_str(), "can create the event group for this task");
 		return ERR_TASK_CANTCREATEEVENTGROUP;
     }
+    m_eventGroup.clear(EVENTGROUP_BIT_JOINABLE | EVENTGROUP_BIT_STARTED);
 
     #if( configSUPPORT_STATIC_ALLOCATION == 1 )
       xTaskCreateStaticPinnedToCore(&runtaskstub, m_strName.c_str(),
@@ -155,9 +159,9 @@ namespace mn {
   //  join
   //-----------------------------------
   int basic_task::join(unsigned int xTimeOut) {
-  	if(!joinable()) return ERR_TASK_NOTRUNNING;
+  	// never started - nothing to join
+  	if(!m_eventGroup.is_init()) return ERR_TASK_NOTRUNNING;
 
-  	if(!m_bRunning) return ERR_TASK_NOTRUNNING;
   	if(m_pHandle == xTaskGetCurrentTaskHandle())  {
   		ESP_LOGW("WARNING BOT", "Don't do this!! Don't do this.... only you are a cake! ... Bob?");
 		return ERR_TASK_CALLFROMSELFTASK;
@@ -378,17 +382,28 @@ namespace mn {
 		// clean up
 		esp_task->on_cleanup();
 
+#if MN_THREAD_CONFIG_RCU == MN_THREAD_CONFIG_YES
+		// a finished reader task must not delay the rcu grace periods
+		basic_rcu_domain::instance().unregister_task();
+#endif
+#if MN_THREAD_CONFIG_HAZARD == MN_THREAD_CONFIG_YES
+		// free the retired nodes and give the hazard record free for other tasks
+		basic_hazard_domain::instance().release_task();
+#endif
+
 		// set the return value and delete the task
 		esp_task->m_runningMutex.lock();
 		esp_task->m_bRunning = false;
 		esp_task->m_retval = ret;
-		vTaskDelete(esp_task->m_pHandle);
 		esp_task->m_pHandle = 0;
 		esp_task->m_runningMutex.unlock();
 		esp_task->m_continuemutex.unlock();
 
 		// set the join bit
 		esp_task->m_eventGroup.set(EVENTGROUP_BIT_JOINABLE);
+
+		// the task object may be gone after the join bit is set, delete only ourself
+		vTaskDelete(NULL);
     }
   }
 }
@@ -101,10 +101,22 @@ namespace mn {
         if (xPortInIsrContext()) {
             BaseType_t xHigherPriorityTaskWoken = pdFALSE;
             success = xTimerStopFromISR( m_pHandle, &xHigherPriorityTaskWoken );
+
+        #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+            // the timer task stops the timer later, the coroutines are resumed after that
+            if(success == pdTRUE && m_CoEvent.has_waiters())
+                xTimerPendFunctionCallFromISR(basic_co_event::pended_notify, &m_CoEvent, 0,
+                                              &xHigherPriorityTaskWoken);
+        #endif
             if(xHigherPriorityTaskWoken)
                 _frxt_setup_switch();
     } else {
             success = xTimerStop(m_pHandle, timeout);
+
+        #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+            if(success == pdTRUE && m_CoEvent.has_waiters())
+                xTimerPendFunctionCall(basic_co_event::pended_notify, &m_CoEvent, 0, timeout);
+        #endif
     }
 
     return success == pdTRUE ? ERR_TIMER_OK : ERR_TIMER_INAKTIVATE;
@@ -161,6 +173,11 @@ namespace mn {
         timer->on_enter();
         timer->on_timer();
         timer->on_exit();
+
+    #if MN_THREAD_CONFIG_COROUTINE == MN_THREAD_CONFIG_YES
+        // a one shot timer is not running now
+        timer->m_CoEvent.notify_all();
+    #endif
     }
 
     //-----------------------------------
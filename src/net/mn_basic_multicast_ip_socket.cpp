@@ -125,8 +125,10 @@ namespace net {
 		int __erRet = NO_ERROR;
 		struct ipv6_mreq mr;
 
-		mr.ipv6mr_multiaddr = { groupAddress.get_int(0), groupAddress.get_int(1),
-								  groupAddress.get_int(2), groupAddress.get_int(3)};
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[0] = groupAddress.get_int(0);
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[1] = groupAddress.get_int(1);
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[2] = groupAddress.get_int(2);
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[3] = groupAddress.get_int(3);
 		mr.ipv6mr_interface = uiInterface;
 
 
@@ -151,8 +153,10 @@ namespace net {
 		int __erRet = NO_ERROR;
 		struct ipv6_mreq mr;
 
-		mr.ipv6mr_multiaddr = { groupAddress.get_int(0), groupAddress.get_int(1),
-								  groupAddress.get_int(2), groupAddress.get_int(3)};
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[0] = groupAddress.get_int(0);
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[1] = groupAddress.get_int(1);
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[2] = groupAddress.get_int(2);
+		MNNET_IN6_ADDR_U32(mr.ipv6mr_multiaddr)[3] = groupAddress.get_int(3);
 		mr.ipv6mr_interface = uiInterface;
 
 
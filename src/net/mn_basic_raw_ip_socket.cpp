@@ -271,10 +271,10 @@ namespace mn {
 			memset((char *) &addr, 0, sizeof(addr));
 			addr.sin6_family = AF_INET6;
 			addr.sin6_port = htons(port);
-			addr.sin6_addr.un.u32_addr[0] = ip.get_int(0);
-			addr.sin6_addr.un.u32_addr[1] = ip.get_int(1);
-			addr.sin6_addr.un.u32_addr[2] = ip.get_int(2);
-			addr.sin6_addr.un.u32_addr[3] = ip.get_int(3);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[0] = ip.get_int(0);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[1] = ip.get_int(1);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[2] = ip.get_int(2);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[3] = ip.get_int(3);
 
 			bool _ret = lwip_connect(m_iHandle, (struct sockaddr*)&addr, sizeof(addr) ) != -1 ;
 			if(_ret) set_blocking(false);
@@ -306,9 +306,9 @@ namespace mn {
 			if(clientfd >= 0) {
 				auto port = lwip_ntohs(client_addr.sin6_port);
 		#if MN_THREAD_CONFIG_NET_IPADDRESS6_USE_SCOPEID  == MN_THREAD_CONFIG_YES
-				auto ip = basic_ip6_address( client_addr.sin6_addr.un.u8_addr ,  client_addr.sin6_scope_id );
+				auto ip = basic_ip6_address( MNNET_IN6_ADDR_U8(client_addr.sin6_addr) ,  client_addr.sin6_scope_id );
 		#else
-				auto ip = basic_ip6_address( client_addr.sin6_addr.un.u8_addr );
+				auto ip = basic_ip6_address( MNNET_IN6_ADDR_U8(client_addr.sin6_addr) );
 		#endif
 				socket_return = new self_type(clientfd, new endpoint_type( ip, port) );
 			}
@@ -334,8 +334,8 @@ namespace mn {
 
 			if(_iret > 0) {
 				if(ep != NULL) {
-					basic_ip6_address _ipx( addr.sin6_addr.un.u32_addr[0],  addr.sin6_addr.un.u32_addr[1],
-											addr.sin6_addr.un.u32_addr[2],  addr.sin6_addr.un.u32_addr[3]  );
+					basic_ip6_address _ipx( MNNET_IN6_ADDR_U32(addr.sin6_addr)[0],  MNNET_IN6_ADDR_U32(addr.sin6_addr)[1],
+											MNNET_IN6_ADDR_U32(addr.sin6_addr)[2],  MNNET_IN6_ADDR_U32(addr.sin6_addr)[3]  );
 
 				#if MN_THREAD_CONFIG_NET_IPADDRESS6_USE_SCOPEID  == MN_THREAD_CONFIG_YES
 					_ipx->set_scopeid(addr.sin6_scope_id);
@@ -371,10 +371,10 @@ namespace mn {
 			memset((char *) &addr, 0, sizeof(addr));
 			addr.sin6_family = AF_INET6;
 			addr.sin6_port = htons(port);
-			addr.sin6_addr.un.u32_addr[0] = ip.get_int(0);
-			addr.sin6_addr.un.u32_addr[1] = ip.get_int(1);
-			addr.sin6_addr.un.u32_addr[2] = ip.get_int(2);
-			addr.sin6_addr.un.u32_addr[3] = ip.get_int(3);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[0] = ip.get_int(0);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[1] = ip.get_int(1);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[2] = ip.get_int(2);
+			MNNET_IN6_ADDR_U32(addr.sin6_addr)[3] = ip.get_int(3);
 
 			return lwip_sendto(m_iHandle, &buffer[offset], size-offset, static_cast<int>(socketFlags),
 							   (struct sockaddr*)&addr,
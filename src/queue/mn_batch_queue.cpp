@@ -0,0 +1,342 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "queue/mn_batch_queue.hpp"
+#include "mn_error.hpp"
+
+namespace mn {
+    namespace queue {
+        //-----------------------------------
+        //  basic_batch_queue
+        //-----------------------------------
+        basic_batch_queue::basic_batch_queue(unsigned int maxItems, unsigned int itemSize, void* pStorage)
+            : basic_queue(maxItems, itemSize), m_pBuffer(NULL), m_pStorage(static_cast<uint8_t*>(pStorage)),
+              m_uiHead(0), m_uiCount(0), m_pReaders(NULL), m_pWriters(NULL) {
+
+            vPortCPUInitializeMutex(&m_Mux);
+        }
+
+        //-----------------------------------
+        //  ~basic_batch_queue
+        //-----------------------------------
+        basic_batch_queue::~basic_batch_queue() {
+            destroy();
+        }
+
+        //-----------------------------------
+        //  create
+        //-----------------------------------
+        int basic_batch_queue::create() {
+            if(m_pBuffer != NULL) return ERR_QUEUE_ALREADYINIT;
+
+            m_pBuffer = (m_pStorage != NULL) ? m_pStorage
+                        : static_cast<uint8_t*>(malloc(m_imaxItems * m_iitemSize));
+            m_uiHead = 0;
+            m_uiCount = 0;
+
+            return (m_pBuffer != NULL) ? ERR_QUEUE_OK : ERR_QUEUE_CANTCREATE;
+        }
+
+        //-----------------------------------
+        //  destroy
+        //-----------------------------------
+        int basic_batch_queue::destroy() {
+            if(m_pBuffer == NULL) return ERR_QUEUE_NOTCREATED;
+
+            if(m_pBuffer != m_pStorage) free(m_pBuffer);
+            m_pBuffer = NULL;
+
+            return ERR_QUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  enqueue
+        //-----------------------------------
+        int basic_batch_queue::enqueue(void *item, unsigned int timeout) {
+            if(m_pBuffer == NULL) return ERR_QUEUE_NOTCREATED;
+
+            return (transfer(item, 1, timeout, true, true) == 1) ? ERR_QUEUE_OK : ERR_QUEUE_ADD;
+        }
+
+        //-----------------------------------
+        //  peek
+        //-----------------------------------
+        int basic_batch_queue::peek(void *item, unsigned int timeout) {
+            if(m_pBuffer == NULL) return ERR_QUEUE_NOTCREATED;
+
+            return (transfer(item, 1, timeout, false, false) == 1) ? ERR_QUEUE_OK : ERR_QUEUE_PEEK;
+        }
+
+        //-----------------------------------
+        //  dequeue
+        //-----------------------------------
+        int basic_batch_queue::dequeue(void *item, unsigned int timeout) {
+            if(m_pBuffer == NULL) return ERR_QUEUE_NOTCREATED;
+
+            return (transfer(item, 1, timeout, false, true) == 1) ? ERR_QUEUE_OK : ERR_QUEUE_REMOVE;
+        }
+
+        //-----------------------------------
+        //  enqueue_n
+        //-----------------------------------
+        unsigned int basic_batch_queue::enqueue_n(const void *items, unsigned int count, unsigned int timeout) {
+            return transfer(const_cast<void*>(items), count, timeout, true, true);
+        }
+
+        //-----------------------------------
+        //  dequeue_n
+        //-----------------------------------
+        unsigned int basic_batch_queue::dequeue_n(void *items, unsigned int count, unsigned int timeout) {
+            return transfer(items, count, timeout, false, true);
+        }
+
+        //-----------------------------------
+        //  transfer
+        //-----------------------------------
+        unsigned int basic_batch_queue::transfer(void *items, unsigned int count, unsigned int timeout,
+                                                 bool bWrite, bool bRemove) {
+            if(m_pBuffer == NULL || items == NULL || count == 0) return 0;
+
+            // a ISR never waits
+            const bool _bIsr = xPortInIsrContext();
+            if(_bIsr) timeout = 0;
+
+            waiter** _ppList = bWrite ? &m_pWriters : &m_pReaders;
+            waiter _node;
+
+            TickType_t _xStart = (timeout != 0) ? xTaskGetTickCount() : 0;
+            TickType_t _xLeft = timeout;
+
+            for(;;) {
+                unsigned int _uiDone = 0;
+                waiter* _pWake = NULL;
+                waiter* _pNext = NULL;
+
+                if(timeout != 0 && timeout != portMAX_DELAY) {
+                    TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                    _xLeft = (_xElapsed >= timeout) ? 0 : timeout - _xElapsed;
+                }
+
+                portENTER_CRITICAL_SAFE(&m_Mux);
+                    unsigned int _uiReady = bWrite ? (m_imaxItems - m_uiCount) : m_uiCount;
+
+                    if(_uiReady > 0) {
+                        _uiDone = (count < _uiReady) ? count : _uiReady;
+
+                        if(bWrite)
+                            copy_in(static_cast<const uint8_t*>(items), _uiDone);
+                        else
+                            copy_out(static_cast<uint8_t*>(items), _uiDone, bRemove);
+
+                        // one notification for the batch, a peek doesn't make space
+                        if(bRemove) _pWake = pop(bWrite ? &m_pReaders : &m_pWriters);
+
+                        // items (or space) are left, pass it on to the next blocked task
+                        _uiReady = bWrite ? (m_imaxItems - m_uiCount) : m_uiCount;
+                        if(_uiReady > 0) _pNext = pop(_ppList);
+                    } else if(_xLeft != 0) {
+                        _node.pTask = xTaskGetCurrentTaskHandle();
+                        _node.bSignaled = false;
+                        push(_ppList, &_node);
+                    }
+                portEXIT_CRITICAL_SAFE(&m_Mux);
+
+                if(_uiDone > 0) {
+                    notify(_pWake);
+                    notify(_pNext);
+
+                    if(bWrite) on_enqueued();
+                    return _uiDone;
+                }
+                if(_xLeft == 0) return 0;
+
+                while(!__atomic_load_n(&_node.bSignaled, __ATOMIC_ACQUIRE)) {
+                    if(timeout != portMAX_DELAY) {
+                        TickType_t _xElapsed = xTaskGetTickCount() - _xStart;
+                        if(_xElapsed >= timeout) break;
+
+                        _xLeft = timeout - _xElapsed;
+                    }
+                    ulTaskNotifyTake(pdTRUE, _xLeft);
+                }
+
+                if(!__atomic_load_n(&_node.bSignaled, __ATOMIC_ACQUIRE)) {
+                    // timeout - remove the node, when it is not signaled meanwhile
+                    portENTER_CRITICAL_SAFE(&m_Mux);
+                        bool _bFound = unlink(_ppList, &_node);
+                    portEXIT_CRITICAL_SAFE(&m_Mux);
+
+                    if(_bFound) return 0;
+
+                    // signaled, the notify is on the way
+                    while(!__atomic_load_n(&_node.bSignaled, __ATOMIC_ACQUIRE))
+                        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                }
+                // signaled: try again, a other task can be faster
+            }
+        }
+
+        //-----------------------------------
+        //  copy_in
+        //-----------------------------------
+        void basic_batch_queue::copy_in(const uint8_t* pItems, unsigned int count) {
+            unsigned int _uiTail = (m_uiHead + m_uiCount) % m_imaxItems;
+            unsigned int _uiFirst = m_imaxItems - _uiTail;
+
+            if(_uiFirst > count) _uiFirst = count;
+
+            memcpy(m_pBuffer + _uiTail * m_iitemSize, pItems, _uiFirst * m_iitemSize);
+            if(count > _uiFirst)
+                memcpy(m_pBuffer, pItems + _uiFirst * m_iitemSize, (count - _uiFirst) * m_iitemSize);
+
+            m_uiCount += count;
+        }
+
+        //-----------------------------------
+        //  copy_out
+        //-----------------------------------
+        void basic_batch_queue::copy_out(uint8_t* pItems, unsigned int count, bool bRemove) {
+            unsigned int _uiFirst = m_imaxItems - m_uiHead;
+
+            if(_uiFirst > count) _uiFirst = count;
+
+            memcpy(pItems, m_pBuffer + m_uiHead * m_iitemSize, _uiFirst * m_iitemSize);
+            if(count > _uiFirst)
+                memcpy(pItems + _uiFirst * m_iitemSize, m_pBuffer, (count - _uiFirst) * m_iitemSize);
+
+            if(bRemove) {
+                m_uiHead = (m_uiHead + count) % m_imaxItems;
+                m_uiCount -= count;
+            }
+        }
+
+        //-----------------------------------
+        //  pop
+        //-----------------------------------
+        basic_batch_queue::waiter* basic_batch_queue::pop(waiter** ppList) {
+            waiter* _pNode = *ppList;
+
+            if(_pNode != NULL) *ppList = _pNode->pNext;
+            return _pNode;
+        }
+
+        //-----------------------------------
+        //  push
+        //-----------------------------------
+        void basic_batch_queue::push(waiter** ppList, waiter* pNode) {
+            pNode->pNext = NULL;
+
+            while(*ppList != NULL) ppList = &(*ppList)->pNext;
+            *ppList = pNode;
+        }
+
+        //-----------------------------------
+        //  unlink
+        //-----------------------------------
+        bool basic_batch_queue::unlink(waiter** ppList, waiter* pNode) {
+            while(*ppList != NULL && *ppList != pNode) ppList = &(*ppList)->pNext;
+
+            if(*ppList != pNode) return false;
+
+            *ppList = pNode->pNext;
+            return true;
+        }
+
+        //-----------------------------------
+        //  notify
+        //-----------------------------------
+        void basic_batch_queue::notify(waiter* pNode) {
+            if(pNode == NULL) return;
+
+            TaskHandle_t _pTask = pNode->pTask;
+
+            // after this the node can leave the stack of the waiter
+            __atomic_store_n(&pNode->bSignaled, true, __ATOMIC_RELEASE);
+
+            if (xPortInIsrContext()) {
+                BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+                vTaskNotifyGiveFromISR(_pTask, &xHigherPriorityTaskWoken);
+
+                if(xHigherPriorityTaskWoken)
+                    _frxt_setup_switch();
+            } else {
+                xTaskNotifyGive(_pTask);
+            }
+        }
+
+        //-----------------------------------
+        //  is_empty
+        //-----------------------------------
+        bool basic_batch_queue::is_empty() {
+            return get_num_items() == 0;
+        }
+
+        //-----------------------------------
+        //  is_full
+        //-----------------------------------
+        bool basic_batch_queue::is_full() {
+            return get_left() == 0;
+        }
+
+        //-----------------------------------
+        //  clear
+        //-----------------------------------
+        int basic_batch_queue::clear() {
+            if(m_pBuffer == NULL) return ERR_QUEUE_NOTCREATED;
+
+            portENTER_CRITICAL_SAFE(&m_Mux);
+                m_uiHead = 0;
+                m_uiCount = 0;
+
+                waiter* _pWake = pop(&m_pWriters);
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+
+            notify(_pWake);
+            return ERR_QUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  get_num_items
+        //-----------------------------------
+        unsigned int basic_batch_queue::get_num_items() {
+            portENTER_CRITICAL_SAFE(&m_Mux);
+                unsigned int _uiCount = m_uiCount;
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+
+            return _uiCount;
+        }
+
+        //-----------------------------------
+        //  get_left
+        //-----------------------------------
+        unsigned int basic_batch_queue::get_left() {
+            portENTER_CRITICAL_SAFE(&m_Mux);
+                unsigned int _uiLeft = m_imaxItems - m_uiCount;
+            portEXIT_CRITICAL_SAFE(&m_Mux);
+
+            return _uiLeft;
+        }
+    }
+}
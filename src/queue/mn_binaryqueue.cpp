@@ -46,6 +46,8 @@ namespace mn {
             } else {
                 (void)xQueueOverwrite(m_pHandle, item);
             }
+            on_enqueued();
+
             return ERR_QUEUE_OK;
         }
     }
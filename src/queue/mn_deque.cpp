@@ -46,7 +46,10 @@ namespace mn {
             } else {
                 success = xQueueSendToFront(m_pHandle, item, timeout);
             }
-            return success == pdTRUE ? ERR_QUEUE_OK : ERR_QUEUE_ADD;
+            if(success != pdTRUE) return ERR_QUEUE_ADD;
+
+            on_enqueued();
+            return ERR_QUEUE_OK;
         }
     }
 }
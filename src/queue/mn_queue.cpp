@@ -17,6 +17,7 @@
 */
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/task.h"
 
 #include "queue/mn_queue.hpp"
 #include "mn_error.hpp"
@@ -62,8 +63,10 @@ namespace mn {
             } else {
                 success = xQueueSendToBack(m_pHandle, item, timeout);
             }
+            if(success != pdTRUE) return ERR_QUEUE_ADD;
 
-            return success == pdTRUE ? ERR_QUEUE_OK : ERR_QUEUE_ADD;
+            on_enqueued();
+            return ERR_QUEUE_OK;
         }
         int basic_queue::dequeue(void *item, unsigned int timeout) {
             BaseType_t success;
@@ -83,6 +86,63 @@ namespace mn {
 
             return success == pdTRUE ? ERR_QUEUE_OK : ERR_QUEUE_REMOVE;
         }
+        unsigned int basic_queue::enqueue_n(const void *items, unsigned int count, unsigned int timeout) {
+            if(m_pHandle == NULL || items == NULL || count == 0) return 0;
+
+            const uint8_t* _pItem = static_cast<const uint8_t*>(items);
+            unsigned int _uiSent = 0;
+
+            if (xPortInIsrContext()) {
+                BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+                while(_uiSent < count) {
+                    if(xQueueSendToBackFromISR(m_pHandle, _pItem, &xHigherPriorityTaskWoken) != pdTRUE)
+                        break;
+                    _pItem += m_iitemSize; _uiSent++;
+                }
+
+                if(xHigherPriorityTaskWoken)
+                    _frxt_setup_switch();
+            } else {
+                // only the first item waits, the other items never block
+                while(_uiSent < count) {
+                    if(xQueueSendToBack(m_pHandle, _pItem, (_uiSent == 0) ? timeout : 0) != pdTRUE)
+                        break;
+                    _pItem += m_iitemSize; _uiSent++;
+                }
+            }
+            if(_uiSent > 0) on_enqueued();
+
+            return _uiSent;
+        }
+        unsigned int basic_queue::dequeue_n(void *items, unsigned int count, unsigned int timeout) {
+            if(m_pHandle == NULL || items == NULL || count == 0) return 0;
+
+            uint8_t* _pItem = static_cast<uint8_t*>(items);
+            unsigned int _uiReceived = 0;
+
+            if (xPortInIsrContext()) {
+                BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+                while(_uiReceived < count) {
+                    if(xQueueReceiveFromISR(m_pHandle, _pItem, &xHigherPriorityTaskWoken) != pdTRUE)
+                        break;
+                    _pItem += m_iitemSize; _uiReceived++;
+                }
+
+                if(xHigherPriorityTaskWoken)
+                    _frxt_setup_switch();
+            } else {
+                // only the first item is waited for, the other items never block
+                while(_uiReceived < count) {
+                    if(xQueueReceive(m_pHandle, _pItem, (_uiReceived == 0) ? timeout : 0) != pdTRUE)
+                        break;
+                    _pItem += m_iitemSize; _uiReceived++;
+                }
+            }
+
+            return _uiReceived;
+        }
         int basic_queue::peek(void *item, unsigned int timeout) {
             BaseType_t success;
 
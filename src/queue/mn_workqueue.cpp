@@ -52,7 +52,11 @@ namespace mn {
         //  deconstructor
         //-----------------------------------
         basic_work_queue::~basic_work_queue() {
-            destroy();
+            // the engine is gone here, the derived class destroy it
+            if(m_pWorkItemQueue != NULL) {
+                m_pWorkItemQueue->destroy();
+                delete m_pWorkItemQueue;
+            }
         }
 
         //-----------------------------------
@@ -61,7 +65,14 @@ namespace mn {
         int basic_work_queue::create(int iCore) {
             m_ThreadJob.lock();
 
-            int ret = create_engine(iCore);
+            int ret = m_pWorkItemQueue->create();
+
+            if( ret != ERR_QUEUE_OK && ret != ERR_QUEUE_ALREADYINIT) {
+                m_ThreadJob.unlock();
+                return ERR_WORKQUEUE_CANTCREATE;
+            }
+
+            ret = create_engine(iCore);
 
             if( ret != NO_ERROR) {
                 m_ThreadJob.unlock();
@@ -83,15 +94,26 @@ namespace mn {
             m_ThreadStatus.unlock();
 
             destroy_engine();
+
+            // the workers are gone, drop the items that never run
+            work_queue_item_t* _item = NULL;
+
+            while(m_pWorkItemQueue->dequeue(&_item, 0) == ERR_QUEUE_OK) {
+                if(_item == NULL) continue;
+
+                if(_item->can_delete()) delete _item;
+                else _item->on_drop();
+            }
+            m_pWorkItemQueue->destroy();
         }
 
         //-----------------------------------
         //  queue
         //-----------------------------------
         int basic_work_queue::queue(work_queue_item_t *work, unsigned int timeout) {
-            automutx_t lock(m_ThreadJob);
-
-            int ret = m_pWorkItemQueue->enqueue(work, timeout);
+            // no m_ThreadJob lock, the FreeRTOS queue is thread safe and a lock held
+            // while the enqueue blocks would stall all other tasks that queue items
+            int ret = m_pWorkItemQueue->enqueue(&work, timeout);
 
             return ret == 0 ? ERR_WORKQUEUE_OK : ERR_WORKQUEUE_ADD;
         }
@@ -100,13 +122,11 @@ namespace mn {
         //  get_next_item
         //-----------------------------------
         work_queue_item* basic_work_queue::get_next_item(unsigned int timeout) {
-            automutx_t lock(m_ThreadJob);
-
             work_queue_item_t* job = 0;
 
-            if(m_pWorkItemQueue->is_empty()) return NULL;
-
-            m_pWorkItemQueue->dequeue(&job, timeout);
+            // no m_ThreadJob lock, the workers wait here in parallel
+            if(m_pWorkItemQueue->dequeue(&job, timeout) != ERR_QUEUE_OK)
+                return NULL;
 
             return job;
         }
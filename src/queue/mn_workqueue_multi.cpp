@@ -45,6 +45,13 @@ namespace mn {
             }
         }
 
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_multi::~basic_work_queue_multi() {
+            destroy();
+        }
+
         //-----------------------------------
         //  create_engine
         //-----------------------------------
@@ -83,11 +90,16 @@ namespace mn {
         //  destroy_engine
         //-----------------------------------
         void basic_work_queue_multi::destroy_engine() {
+            // a NULL item wakes a waiting worker, so it sees the running flag
             for(int i = 0; i < get_num_worker(); i++) {
-                m_Workers[i]->kill();
+                queue(NULL, 0);
+            }
+            for(int i = 0; i < get_num_worker(); i++) {
+                m_Workers[i]->join();
+                delete m_Workers[i];
             }
             m_Workers.clear();
-            
+
         }
 
         //-----------------------------------
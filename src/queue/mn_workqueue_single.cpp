@@ -31,6 +31,15 @@ namespace mn {
             m_pWorker = new work_queue_task("single_workqueue_thread", uiPriority, usStackDepth, this);
         }
 
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_single::~basic_work_queue_single() {
+            destroy();
+
+            delete m_pWorker;
+        }
+
         //-----------------------------------
         //  create_engine
         //-----------------------------------
@@ -50,7 +59,9 @@ namespace mn {
         //  destroy_engine
         //-----------------------------------
         void basic_work_queue_single::destroy_engine() {
-            m_pWorker->kill();
+            // a NULL item wakes the waiting worker, so it sees the running flag
+            queue(NULL, 0);
+            m_pWorker->join();
         }
     }
 }
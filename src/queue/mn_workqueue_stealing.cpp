@@ -0,0 +1,377 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#include "mn_config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdio.h>
+
+#include "queue/mn_workqueue_stealing.hpp"
+
+namespace mn {
+    namespace queue {
+        //-----------------------------------
+        //  work_queue_stealing_task::constructor
+        //-----------------------------------
+        work_queue_stealing_task::work_queue_stealing_task(char const* strName,
+                                            basic_task::priority uiPriority,
+                                            unsigned short  usStackDepth,
+                                            basic_work_queue_stealing* parent,
+                                            unsigned int uiSeed,
+                                            unsigned int uiInboxSize)
+
+            : basic_task(strName, uiPriority, usStackDepth),
+              m_parentWorkQueue(parent),
+              m_Deque(),
+              m_Inbox(uiInboxSize, sizeof(work_queue_item_t *)),
+              m_Random(uiSeed),
+              m_bParked(false),
+              m_pTaskHandle(NULL) { }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::deconstructor
+        //-----------------------------------
+        work_queue_stealing_task::~work_queue_stealing_task() { }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::on_task
+        //-----------------------------------
+        int work_queue_stealing_task::on_task() {
+            basic_task::on_task();
+
+            work_queue_item_t* work_item = NULL;
+            __atomic_store_n(&m_pTaskHandle, xTaskGetCurrentTaskHandle(), __ATOMIC_RELEASE);
+
+            while ( m_parentWorkQueue->running() ) {
+                work_item = m_Deque.pop();
+
+                if(work_item == NULL)
+                    work_item = get_inbox_item();
+                if(work_item == NULL)
+                    work_item = m_parentWorkQueue->steal(this);
+
+                if(work_item == NULL) {
+                    // park, and look again after the flag is set, so no wake up is lost
+                    m_bParked.store(true);
+                    m_parentWorkQueue->m_uiParked.fetch_add(1);
+
+                    work_item = get_inbox_item();
+                    if(work_item == NULL)
+                        work_item = m_parentWorkQueue->steal(this);
+
+                    if(work_item == NULL)
+                        ulTaskNotifyTake(pdTRUE, MN_THREAD_CONFIG_WORKQUEUE_GETNEXTITEM_TIMEOUT);
+
+                    // not woken by wake(), then clear the flag self
+                    if(m_bParked.exchange(false))
+                        m_parentWorkQueue->m_uiParked.fetch_sub(1);
+
+                    if(work_item == NULL) continue;
+                }
+                run_item(work_item);
+            }
+            __atomic_store_n(&m_pTaskHandle, (TaskHandle_t)NULL, __ATOMIC_RELEASE);
+
+            return ERR_TASK_OK;
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::run_item
+        //-----------------------------------
+        void work_queue_stealing_task::run_item(work_queue_item_t* item) {
+            // read before on_work, a item can be released in on_work
+            bool _bCanDelete = item->can_delete();
+
+            // the counters are updated atomic, a lock here would serialize the workers
+            if(item->on_work())
+                __atomic_add_fetch(&m_parentWorkQueue->m_uiNumWorks, 1, __ATOMIC_RELAXED);
+            else
+                __atomic_add_fetch(&m_parentWorkQueue->m_uiErrorsNumWorks, 1, __ATOMIC_RELAXED);
+
+            if (_bCanDelete) {
+                delete item;
+            }
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::get_inbox_item
+        //-----------------------------------
+        work_queue_item_t* work_queue_stealing_task::get_inbox_item() {
+            work_queue_item_t* _item = NULL;
+
+            if(m_Inbox.dequeue(&_item, 0) != ERR_QUEUE_OK)
+                return NULL;
+
+            return _item;
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::drain
+        //-----------------------------------
+        void work_queue_stealing_task::drain() {
+            work_queue_item_t* _item = NULL;
+
+            while( (_item = m_Deque.pop()) != NULL ) {
+                if(_item->can_delete()) delete _item;
+                else _item->on_drop();
+            }
+            while( (_item = get_inbox_item()) != NULL ) {
+                if(_item->can_delete()) delete _item;
+                else _item->on_drop();
+            }
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::wake
+        //-----------------------------------
+        bool work_queue_stealing_task::wake() {
+            bool _parked = true;
+            TaskHandle_t _handle = __atomic_load_n(&m_pTaskHandle, __ATOMIC_ACQUIRE);
+
+            if(_handle == NULL) return false;
+            if(!m_bParked.compare_exchange_strong(_parked, false)) return false;
+
+            m_parentWorkQueue->m_uiParked.fetch_sub(1);
+
+            if (xPortInIsrContext()) {
+                BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+                vTaskNotifyGiveFromISR(_handle, &xHigherPriorityTaskWoken);
+
+                if(xHigherPriorityTaskWoken)
+                    _frxt_setup_switch();
+            } else {
+                xTaskNotifyGive(_handle);
+            }
+            return true;
+        }
+
+        //-----------------------------------
+        //  constructor
+        //-----------------------------------
+        basic_work_queue_stealing::basic_work_queue_stealing( basic_task::priority uiPriority,
+                        uint16_t usStackDepth, uint8_t uiMaxWorkItems, uint8_t uiMaxWorkers)
+
+            : basic_work_queue(uiPriority, usStackDepth, uiMaxWorkItems),
+              m_uiMaxWorkers(uiMaxWorkers),
+              m_uiParked(0),
+              m_uiNextInbox(0) {
+
+            char name[32];
+
+            // the inboxes of all workers together hold uiMaxWorkItems items
+            unsigned int _uiInboxSize = (m_uiMaxWorkers > 0) ?
+                    (uiMaxWorkItems + m_uiMaxWorkers - 1) / m_uiMaxWorkers : 0;
+            if(_uiInboxSize == 0) _uiInboxSize = 1;
+
+            for (int i = 0; i < m_uiMaxWorkers; i++) {
+                sprintf(name, "work_steal_%d", i);
+
+                work_queue_stealing_task *pWorker = new work_queue_stealing_task(name,
+                                                                m_uiPriority,
+                                                                m_usStackDepth,
+                                                                this, 0x9E3779B9u * (i + 1),
+                                                                _uiInboxSize);
+
+                if(pWorker)
+                    m_Workers.push_back(pWorker);
+            }
+        }
+
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_stealing::~basic_work_queue_stealing() {
+            destroy();
+        }
+
+        //-----------------------------------
+        //  create_engine
+        //-----------------------------------
+        int basic_work_queue_stealing::create_engine(int iCore) {
+            automutx_t lock(m_ThreadStatus);
+
+            bool _errorOnCreate = false;
+            bool _oneNoError = false;
+
+            if(m_bRunning) {
+                return ERR_WORKQUEUE_ALREADYINIT;
+            }
+
+            m_bRunning = true;
+
+            // no core pinning, the workers balance the load self
+            MN_UNUSED_VARIABLE(iCore);
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                int _ret = m_Workers[i]->m_Inbox.create();
+
+                if(_ret != ERR_QUEUE_OK && _ret != ERR_QUEUE_ALREADYINIT) {
+                    _errorOnCreate = true;
+                } else if(m_Workers[i]->start(MN_THREAD_CONFIG_CORE_IFNO) != ERR_TASK_OK) {
+                    _errorOnCreate = true;
+                } else {
+                    _oneNoError = true;
+                }
+            }
+            if(!_oneNoError) {
+                return ERR_WORKQUEUE_CANTCREATE;
+            }
+            if(_errorOnCreate) {
+                return ERR_WORKQUEUE_WARNING;
+            }
+            return ( m_uiMaxWorkers == get_num_worker() ) ? ERR_WORKQUEUE_OK : ERR_WORKQUEUE_WARNING;
+        }
+
+        //-----------------------------------
+        //  destroy_engine
+        //-----------------------------------
+        void basic_work_queue_stealing::destroy_engine() {
+            // the running flag is false, wake all parked workers so they can exit
+            for(int i = 0; i < get_num_worker(); i++) {
+                m_Workers[i]->wake();
+            }
+            for(int i = 0; i < get_num_worker(); i++) {
+                m_Workers[i]->join();
+            }
+            // all workers are gone, the left items can not be stolen anymore
+            for(int i = 0; i < get_num_worker(); i++) {
+                m_Workers[i]->drain();
+                m_Workers[i]->m_Inbox.destroy();
+
+                delete m_Workers[i];
+            }
+            m_Workers.clear();
+        }
+
+        //-----------------------------------
+        //  queue
+        //-----------------------------------
+        int basic_work_queue_stealing::queue(work_queue_item_t *work, unsigned int timeout) {
+            if(work == NULL) return ERR_WORKQUEUE_ADD;
+
+            work_queue_stealing_task* _worker = xPortInIsrContext() ? NULL : get_current_worker();
+
+            if(_worker != NULL) {
+                // from a worker: to the own deque and never block, a blocked worker can't work
+                if(!_worker->m_Deque.push(work)) {
+                    if(_worker->m_Inbox.enqueue(&work, 0) != ERR_QUEUE_OK)
+                        return ERR_WORKQUEUE_ADD;
+                }
+                wake_one();
+            } else {
+                _worker = queue_inbox(work, timeout);
+
+                if(_worker == NULL)
+                    return ERR_WORKQUEUE_ADD;
+
+                // the owner of the inbox is busy, then an other worker can steal the item
+                if(!_worker->wake())
+                    wake_one();
+            }
+
+            return ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  queue_inbox
+        //-----------------------------------
+        work_queue_stealing_task* basic_work_queue_stealing::queue_inbox(work_queue_item_t *work,
+                                                                        unsigned int timeout) {
+            const int _num = get_num_worker();
+            if(_num == 0) return NULL;
+
+            const uint32_t _start = m_uiNextInbox.fetch_add(1);
+
+            // round-robin, the next inbox with space gets the item
+            for(int i = 0; i < _num; i++) {
+                work_queue_stealing_task* _worker = m_Workers[(_start + i) % _num];
+
+                if(_worker->m_Inbox.enqueue(&work, 0) == ERR_QUEUE_OK)
+                    return _worker;
+            }
+            // all full, an ISR can't wait
+            if(timeout == 0 || xPortInIsrContext()) return NULL;
+
+            work_queue_stealing_task* _worker = m_Workers[_start % _num];
+
+            return (_worker->m_Inbox.enqueue(&work, timeout) == ERR_QUEUE_OK) ? _worker : NULL;
+        }
+
+        //-----------------------------------
+        //  get_current_worker
+        //-----------------------------------
+        work_queue_stealing_task* basic_work_queue_stealing::get_current_worker() {
+            TaskHandle_t _current = xTaskGetCurrentTaskHandle();
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(__atomic_load_n(&m_Workers[i]->m_pTaskHandle, __ATOMIC_ACQUIRE) == _current)
+                    return m_Workers[i];
+            }
+            return NULL;
+        }
+
+        //-----------------------------------
+        //  steal
+        //-----------------------------------
+        work_queue_item_t* basic_work_queue_stealing::steal(work_queue_stealing_task* thief) {
+            const int _num = get_num_worker();
+            if(_num < 2) return NULL;
+
+            const int _start = thief->m_Random.rand32() % _num;
+            work_queue_item_t* _item = NULL;
+
+            for(int i = 0; i < _num && _item == NULL; i++) {
+                work_queue_stealing_task* _victim = m_Workers[(_start + i) % _num];
+
+                if(_victim == thief) continue;
+
+                _item = _victim->m_Deque.steal();
+                if(_item == NULL)
+                    _item = _victim->get_inbox_item();
+            }
+            return _item;
+        }
+
+        //-----------------------------------
+        //  wake_one
+        //-----------------------------------
+        void basic_work_queue_stealing::wake_one() {
+            if(m_uiParked.load() == 0) return;
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->wake()) return;
+            }
+        }
+
+        //-----------------------------------
+        //  get_num_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_stealing::get_num_worker() const  {
+            return m_Workers.size();
+        }
+
+        //-----------------------------------
+        //  get_num_max_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_stealing::get_num_max_worker() const   {
+            return m_uiMaxWorkers;
+        }
+    }
+}
@@ -52,20 +52,27 @@ namespace mn {
             while ( m_parentWorkQueue->running() ) {
                 work_item = m_parentWorkQueue->get_next_item(MN_THREAD_CONFIG_WORKQUEUE_GETNEXTITEM_TIMEOUT);
 
+                // timeout - check the running flag and wait again
                 if (work_item == NULL) {
-                    break;
+                    continue;
                 }
 
+                // read before on_work, a item can be released in on_work
+                bool _bCanDelete = work_item->can_delete();
+
+                // the lock is only taken for the counters, on_work can run long
+                bool _bWorked = work_item->on_work();
+
                 m_parentWorkQueue->m_ThreadStatus.lock();
 
-                    if(work_item->on_work())
+                    if(_bWorked)
                         m_parentWorkQueue->m_uiNumWorks++;
                     else
                         m_parentWorkQueue->m_uiErrorsNumWorks++;
 
                 m_parentWorkQueue->m_ThreadStatus.unlock();
 
-                if (work_item->can_delete()) {
+                if (_bCanDelete) {
                     delete work_item; work_item = NULL;
                 }
             }